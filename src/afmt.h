@@ -0,0 +1,46 @@
+/*
+ * afmt.h: sample formats of OSS, including those of OSS 4
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AFMT_H
+#define AFMT_H
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+/* sample formats of OSS 4, missing in older soundcard.h */
+#ifndef AFMT_S32_LE
+#define AFMT_S32_LE 0x00001000
+#define AFMT_S32_BE 0x00002000
+#endif
+#ifndef AFMT_FLOAT
+#define AFMT_FLOAT 0x00004000
+#endif
+#ifndef AFMT_S24_LE
+#define AFMT_S24_LE 0x00008000
+#define AFMT_S24_BE 0x00010000
+#endif
+#ifndef AFMT_S24_PACKED
+#define AFMT_S24_PACKED 0x00040000
+#endif
+
+#endif /* AFMT_H */
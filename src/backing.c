@@ -0,0 +1,412 @@
+/*
+ * backing.c: recording played along with the click
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "backing.h"
+
+/*
+ * opens the file of <backing>: mapped if it is a plain WAV file, decoded by
+ * libsndfile otherwise (e.g. FLAC)
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int open_source(backing_t* backing)
+{
+#ifdef WITH_SNDFILE
+  SF_INFO sfinfo;
+#endif
+
+  if ((backing->map = wavfile_map(backing->filename))) {
+    backing->length = backing->map->n;
+    backing->rate_in = backing->map->rate;
+    backing->channels_in = backing->map->channels;
+    return backing->length > 0 ? 0 : -1;
+  }
+
+#ifdef WITH_SNDFILE
+  sfinfo.format = 0;
+  if (!(backing->sndfile = sf_open(backing->filename, SFM_READ, &sfinfo)))
+    return -1;
+  if (sfinfo.channels < 1 || sfinfo.samplerate < 1 || sfinfo.frames <= 0)
+    return -1;
+  backing->length = sfinfo.frames;
+  backing->rate_in = sfinfo.samplerate;
+  backing->channels_in = sfinfo.channels;
+  backing->chunk = (short*) g_malloc((BACKING_CHUNK + 1) * sfinfo.channels *
+                                     sizeof(short));
+  backing->chunk_start = 0;
+  backing->chunk_frames = 0;
+  backing->chunk_previous = 0;
+  return 0;
+#else
+  return -1;
+#endif /* WITH_SNDFILE */
+}
+
+static void close_source(backing_t* backing)
+{
+  if (backing->map) {
+    wavfile_unmap(backing->map);
+    backing->map = NULL;
+  }
+#ifdef WITH_SNDFILE
+  if (backing->sndfile) {
+    sf_close(backing->sndfile);
+    backing->sndfile = NULL;
+  }
+#endif
+  if (backing->chunk) {
+    free(backing->chunk);
+    backing->chunk = NULL;
+  }
+}
+
+/*
+ * returns new backing track for <spec>: "FILE[@BAR][:FROM-TO]", starting
+ * at bar BAR of the click (default: 1) and repeating bars FROM to TO of the
+ * track, e.g. "/music/blues.flac@3:5-12" for two bars of count-in and a
+ * loop over the second eight bars
+ *
+ * returns NULL on error
+ */
+backing_t* backing_new(const char* spec)
+{
+  backing_t* result;
+  char* copy = strdup(spec);
+  char* loop = strrchr(copy, ':');
+  char* bar;
+  char* end = NULL;
+  int error = 0;
+
+  result = (backing_t*) g_malloc0(sizeof(backing_t));
+  result->offset = 1;
+  g_mutex_init(&result->mutex);
+  g_cond_init(&result->cond);
+
+  if (loop && sscanf(loop + 1, "%d-%d", &result->loop_from,
+                     &result->loop_to) == 2)
+  {
+    *loop = '\0';
+    error = result->loop_from < 1 || result->loop_to < result->loop_from;
+  } else {
+    result->loop_from = 0;
+  }
+  if ((bar = strrchr(copy, '@'))) {
+    result->offset = strtol(bar + 1, &end, 10);
+    error |= end == bar + 1 || *end || result->offset < 1;
+    *bar = '\0';
+  }
+  result->filename = copy;
+
+  if (error || !*copy) {
+    fprintf(stderr, "Warning: Bad backing track specification \"%s\".\n",
+            spec);
+    backing_delete(result);
+    return NULL;
+  }
+  if (open_source(result) == -1) {
+    fprintf(stderr, "Warning: Couldn't read backing track \"%s\".\n",
+            result->filename);
+    backing_delete(result);
+    return NULL;
+  }
+  return result;
+}
+
+void backing_delete(backing_t* backing)
+{
+  backing_stop(backing);
+  close_source(backing);
+  g_mutex_clear(&backing->mutex);
+  g_cond_clear(&backing->cond);
+  free(backing->filename);
+  free(backing);
+}
+
+/*
+ * returns frame <index> of the file mixed down to mono, silence after its
+ * end; the last frame of a chunk is kept when the next one is decoded in
+ * sequence, so interpolating across chunks doesn't decode one again
+ */
+static int input_frame(backing_t* backing, long long index)
+{
+  const short* frame;
+  int sum = 0;
+  int c;
+
+  if (index >= backing->length)
+    return 0;
+
+  if (backing->map) {
+    frame = &backing->map->frames[index * backing->channels_in];
+  } else {
+#ifdef WITH_SNDFILE
+    int channels = backing->channels_in;
+    sf_count_t frames;
+
+    if (index < backing->chunk_start - backing->chunk_previous ||
+        index >= backing->chunk_start + backing->chunk_frames)
+    {
+      if (index != backing->chunk_start + backing->chunk_frames) {
+        sf_seek(backing->sndfile, index, SEEK_SET);
+        backing->chunk_previous = 0;
+      } else if (backing->chunk_frames > 0) {
+        memcpy(backing->chunk,
+               backing->chunk + backing->chunk_frames * channels,
+               channels * sizeof(short));
+        backing->chunk_previous = 1;
+      }
+      backing->chunk_start = index;
+      frames = sf_readf_short(backing->sndfile, backing->chunk + channels,
+                              BACKING_CHUNK);
+      backing->chunk_frames = MAX(frames, 0);
+      if (backing->chunk_frames == 0)
+        return 0;
+    }
+#endif /* WITH_SNDFILE */
+    frame = &backing->chunk[(index - backing->chunk_start + 1) *
+                            backing->channels_in];
+  }
+
+  for (c = 0; c < backing->channels_in; c++)
+    sum += frame[c];
+  return sum / backing->channels_in;
+}
+
+/*
+ * returns frame <index> of the track at the rate of the sound device,
+ * interpolated linearly if the file has another rate
+ */
+static short track_frame(backing_t* backing, long long index)
+{
+  long long position;
+  long long frac;
+
+  if (backing->rate_in == backing->rate)
+    return input_frame(backing, index);
+
+  /* in units of 1 / rate of an input frame, see mixer_resample() */
+  position = index * backing->rate_in;
+  frac = position % backing->rate;
+  position /= backing->rate;
+  return ((backing->rate - frac) * input_frame(backing, position) +
+          frac * input_frame(backing, position + 1)) / backing->rate;
+}
+
+/*
+ * moves the prefetch position of <backing> <frames> ahead, jumping back to
+ * the start of the loop at its end
+ */
+static void advance(backing_t* backing, long long frames)
+{
+  backing->position += frames;
+  if (backing->loop_from) {
+    long long barlen = g_atomic_int_get(&backing->barlen);
+    long long start = (backing->loop_from - 1) * barlen;
+    long long end = backing->loop_to * barlen;
+
+    if (backing->position >= end && end > start)
+      backing->position = start + (backing->position - start) %
+                                  (end - start);
+  }
+}
+
+/*
+ * fills the free part of the ring, published in chunks; frames the audio
+ * thread found missing are skipped first, so the track stays in time
+ */
+static void prefetch(backing_t* backing)
+{
+  guint mask = backing->size - 1;
+  guint head = (guint) backing->head;
+  int skipped = g_atomic_int_get(&backing->skipped);
+
+  if (skipped) {
+    advance(backing, skipped);
+    g_atomic_int_add(&backing->skipped, -skipped);
+  }
+
+  for (;;) {
+    guint space = backing->size -
+      (head - (guint) g_atomic_int_get(&backing->tail));
+    guint n = MIN(space, BACKING_CHUNK);
+    guint i;
+
+    if (n == 0)
+      break;
+    for (i = 0; i < n; i++) {
+      backing->ring[(head + i) & mask] =
+        track_frame(backing, backing->position);
+      advance(backing, 1);
+    }
+    head += n;
+    g_atomic_int_set(&backing->head, (gint) head);
+  }
+}
+
+/*
+ * thread of <backing>: keeps the ring filled until stopped, waking up four
+ * times per ring
+ */
+static gpointer reader_loop(backing_t* backing)
+{
+  gint64 period =
+    (gint64) backing->size * G_USEC_PER_SEC / backing->rate / 4;
+
+  g_mutex_lock(&backing->mutex);
+  while (!backing->stop) {
+    g_mutex_unlock(&backing->mutex);
+    prefetch(backing);
+    g_mutex_lock(&backing->mutex);
+    if (!backing->stop)
+      g_cond_wait_until(&backing->cond, &backing->mutex,
+                        g_get_monotonic_time() + period);
+  }
+  g_mutex_unlock(&backing->mutex);
+  return NULL;
+}
+
+/*
+ * prepares <backing> for the sound device at <rate> with a buffer of
+ * <latency> frames and bars of <barlen> frames: the ring is filled from the
+ * start of the track, then kept filled by the reader thread if <threaded>,
+ * else by backing_mix() itself (offline rendering)
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int backing_start(backing_t* backing, int rate, int latency, int barlen,
+                  int threaded)
+{
+  int frames = MAX(latency * BACKING_LATENCIES,
+                   lrint(BACKING_MIN_PREFETCH * rate));
+
+  if (backing->running || rate <= 0)
+    return -1;
+
+  for (backing->size = 1; backing->size < frames; backing->size <<= 1);
+  backing->ring = (short*) g_malloc(backing->size * sizeof(short));
+  backing->rate = rate;
+  backing->head = 0;
+  backing->tail = 0;
+  backing->skipped = 0;
+  backing->barlen = barlen;
+  backing->position = 0;
+  backing->bars = 0;
+  backing->playing = 0;
+  backing->underruns = 0;
+  backing->stop = 0;
+  prefetch(backing);
+
+  backing->thread = threaded ?
+    g_thread_new("backing", (GThreadFunc) reader_loop, backing) : NULL;
+  backing->running = 1;
+  return 0;
+}
+
+/*
+ * stops the reader thread and frees the ring
+ */
+void backing_stop(backing_t* backing)
+{
+  if (!backing->running)
+    return;
+
+  if (backing->thread) {
+    g_mutex_lock(&backing->mutex);
+    backing->stop = 1;
+    g_cond_signal(&backing->cond);
+    g_mutex_unlock(&backing->mutex);
+    g_thread_join(backing->thread);
+    backing->thread = NULL;
+  }
+  if (backing->underruns)
+    fprintf(stderr, "Warning: %d frames of backing track \"%s\" missed.\n",
+            backing->underruns, backing->filename);
+  free(backing->ring);
+  backing->ring = NULL;
+  backing->running = 0;
+}
+
+/*
+ * called by the audio thread at the start of each bar of <barlen> frames:
+ * the track starts with its bar, loops follow the bar length at its start
+ */
+void backing_bar(backing_t* backing, int barlen)
+{
+  if (!backing->running || backing->playing)
+    return;
+
+  g_atomic_int_set(&backing->barlen, barlen);
+  if (++backing->bars >= backing->offset)
+    backing->playing = 1;
+}
+
+/*
+ * adds the next <frames> of the track, if playing, to the accumulator
+ * <dest> (NULL: skipped, e.g. not routed), without waiting for the reader;
+ * missing frames are played as silence
+ */
+void backing_mix(backing_t* backing, int* dest, int frames)
+{
+  guint mask;
+  guint tail;
+  int n;
+  int i;
+
+  if (!backing->running || !backing->playing)
+    return;
+
+  if (!backing->thread)
+    prefetch(backing);
+
+  mask = backing->size - 1;
+  tail = (guint) backing->tail;
+  n = MIN((guint) frames,
+          (guint) g_atomic_int_get(&backing->head) - tail);
+  if (dest) {
+    for (i = 0; i < n; i++)
+      dest[i] += backing->ring[(tail + i) & mask];
+  }
+  g_atomic_int_set(&backing->tail, (gint) (tail + n));
+
+  if (n < frames) {
+    backing->underruns += frames - n;
+    g_atomic_int_add(&backing->skipped, frames - n);
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ * Backing track interface: recording played along with the click
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKING_H
+#define BACKING_H
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef WITH_SNDFILE
+#include <sndfile.h>
+#endif
+
+/* own headers */
+#include "wavfile.h"
+
+/*
+ * prefetch ring: at least BACKING_LATENCIES times the buffer of the sound
+ * device, and at least BACKING_MIN_PREFETCH seconds for slow disks
+ */
+#define BACKING_LATENCIES 8
+#define BACKING_MIN_PREFETCH 0.25
+
+/* number of frames decoded at once by libsndfile */
+#define BACKING_CHUNK 4096
+
+/*
+ * recording streamed from file by its own thread into a ring of mono frames
+ * at the rate of the sound device, taken from the ring by the audio thread
+ * without locking, starting at a bar of the click and looping over bars
+ */
+typedef struct backing_t {
+  char* filename;
+  int offset;              /* bar of the click the track starts at, 1: first */
+  int loop_from;           /* first bar of loop, 1: first of track, 0: none */
+  int loop_to;             /* last bar of loop */
+
+  /* source, opened by backing_new() */
+  wavmap_t* map;           /* plain WAV file, NULL: decoded by libsndfile */
+#ifdef WITH_SNDFILE
+  SNDFILE* sndfile;
+#endif
+  short* chunk;            /* libsndfile: interleaved frames decoded last,
+                              after the frame before them */
+  long long chunk_start;   /* number of first frame in chunk */
+  int chunk_frames;        /* number of frames in chunk */
+  int chunk_previous;      /* frame before chunk_start kept: 1, else 0 */
+  long long length;        /* number of frames of file */
+  int rate_in;             /* of file */
+  int channels_in;         /* of file */
+
+  /* set up by backing_start() */
+  int rate;                /* of sound device */
+  short* ring;             /* prefetched frames */
+  int size;                /* number of frames of ring, power of 2 */
+  gint head;               /* frames written to ring (reader thread) */
+  gint tail;               /* frames taken from ring (audio thread) */
+  gint skipped;            /* frames missed by the audio thread, to be
+                              skipped by the reader */
+  gint barlen;             /* frames of a bar: loop points */
+  long long position;      /* next frame of track to prefetch */
+
+  GThread* thread;         /* reader, NULL: prefetched by audio thread
+                              (offline rendering) */
+  GMutex mutex;
+  GCond cond;              /* signalled to stop the reader */
+  int stop;
+
+  int running;
+  int bars;                /* bars of the click started */
+  int playing;             /* bar of offset reached */
+  int underruns;           /* frames missing in ring: silence played */
+} backing_t;
+
+backing_t* backing_new(const char* spec);
+void backing_delete(backing_t* backing);
+
+int backing_start(backing_t* backing, int rate, int latency, int barlen,
+                  int threaded);
+void backing_stop(backing_t* backing);
+void backing_bar(backing_t* backing, int barlen);
+void backing_mix(backing_t* backing, int* dest, int frames);
+
+#endif /* BACKING_H */
@@ -0,0 +1,268 @@
+/*
+ * beatshm.c: beat position export via POSIX shared memory
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "beatshm.h"
+
+/*
+ * returns monotonic time in seconds
+ */
+static double now_seconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* seqlock: makes sequence odd before changing the record */
+static void begin_write(beatshm_record_t* record)
+{
+  __atomic_store_n(&record->sequence, record->sequence + 1,
+                   __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/* seqlock: makes sequence even again, publishing the changes */
+static void end_write(beatshm_record_t* record)
+{
+  __atomic_store_n(&record->sequence, record->sequence + 1,
+                   __ATOMIC_RELEASE);
+}
+
+/*
+ * returns new writer of shared memory object <name> (e.g. BEATSHM_NAME),
+ * created or taken over
+ *
+ * returns NULL on error
+ */
+beatshm_t* beatshm_new(const char* name)
+{
+  beatshm_t* result;
+  void* record = MAP_FAILED;
+  int fd;
+
+  if ((fd = shm_open(name, O_CREAT | O_RDWR, 0644)) == -1 ||
+      ftruncate(fd, sizeof(beatshm_record_t)) == -1 ||
+      (record = mmap(NULL, sizeof(beatshm_record_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0)) == MAP_FAILED)
+  {
+    perror("Warning: Couldn't set up beat export");
+    if (fd != -1) {
+      close(fd);
+      shm_unlink(name);
+    }
+    return NULL;
+  }
+  close(fd);
+
+  result = (beatshm_t*) calloc(1, sizeof(beatshm_t));
+  result->name = strdup(name);
+  result->record = (beatshm_record_t*) record;
+  memset(result->record, 0, sizeof(beatshm_record_t));
+  result->record->magic = BEATSHM_MAGIC;
+  result->record->version = BEATSHM_VERSION;
+  result->bar = -1;
+
+  return result;
+}
+
+/*
+ * destroys writer, removing the shared memory object (readers still
+ * attached keep their mapping, showing the metronome stopped)
+ */
+void beatshm_delete(beatshm_t* shm)
+{
+  beatshm_stop(shm);
+  munmap(shm->record, sizeof(beatshm_record_t));
+  shm_unlink(shm->name);
+  free(shm->name);
+  free(shm);
+}
+
+/*
+ * prepares mapping of frames to monotonic time for playback at <rate>
+ * frames per second, counting bars from 0
+ */
+void beatshm_start(beatshm_t* shm, int rate)
+{
+  shm->rate = rate;
+  shm->anchored = 0;
+  shm->bar = -1;
+}
+
+/*
+ * tells readers that the metronome stopped
+ */
+void beatshm_stop(beatshm_t* shm)
+{
+  begin_write(shm->record);
+  shm->record->running = 0;
+  end_write(shm->record);
+}
+
+/*
+ * updates the mapping of frames to monotonic time: <frame> will be heard
+ * after <delay> seconds (smoothed like netsync_anchor())
+ */
+void beatshm_anchor(beatshm_t* shm, long long frame, double delay)
+{
+  double offset = now_seconds() + delay - (double) frame / shm->rate;
+
+  if (shm->anchored) {
+    shm->offset += (offset - shm->offset) / BEATSHM_SMOOTHING;
+  } else {
+    shm->offset = offset;
+    shm->anchored = 1;
+  }
+}
+
+/*
+ * publishes sub beat <subbeat> (0: the tick itself) of tick number <beat>
+ * in bar with <meter> ticks of note value <unit>, starting at <frame>; the
+ * tick is <ticklen> frames long and divided into <subdivision> sub beats
+ */
+void beatshm_publish(beatshm_t* shm, long long frame, long long ticklen,
+                     int beat, int subbeat, int meter, int unit,
+                     int subdivision)
+{
+  beatshm_record_t* record = shm->record;
+
+  if (!shm->anchored || ticklen <= 0)
+    return;
+
+  if (beat == 0 && subbeat == 0)
+    shm->bar++;
+
+  begin_write(record);
+  record->running = 1;
+  record->bar = shm->bar < 0 ? 0 : shm->bar;
+  record->beat = beat;
+  record->subbeat = subbeat;
+  record->meter = meter;
+  record->unit = unit;
+  record->subdivision = subdivision;
+  record->bpm = 60.0 * shm->rate / ticklen;
+  record->tick_time =
+    llrint((shm->offset + (double) frame / shm->rate) * 1e9);
+  record->tick_length = llrint((double) ticklen / shm->rate * 1e9);
+  end_write(record);
+}
+
+/*
+ * reader: maps shared memory object <name> (e.g. BEATSHM_NAME) read-only
+ *
+ * returns NULL on error (no such object or incompatible version)
+ */
+const beatshm_record_t* beatshm_attach(const char* name)
+{
+  struct stat buf;
+  void* record = MAP_FAILED;
+  int fd;
+
+  if ((fd = shm_open(name, O_RDONLY, 0)) == -1)
+    return NULL;
+  if (fstat(fd, &buf) == 0 &&
+      buf.st_size >= (off_t) sizeof(beatshm_record_t))
+    record = mmap(NULL, sizeof(beatshm_record_t), PROT_READ, MAP_SHARED,
+                  fd, 0);
+  close(fd);
+  if (record == MAP_FAILED)
+    return NULL;
+
+  if (((beatshm_record_t*) record)->magic != BEATSHM_MAGIC ||
+      ((beatshm_record_t*) record)->version != BEATSHM_VERSION)
+  {
+    munmap(record, sizeof(beatshm_record_t));
+    return NULL;
+  }
+  return (const beatshm_record_t*) record;
+}
+
+/*
+ * reader: unmaps <record> of beatshm_attach()
+ */
+void beatshm_detach(const beatshm_record_t* record)
+{
+  munmap((void*) record, sizeof(beatshm_record_t));
+}
+
+/*
+ * reader: takes a consistent <copy> of shared <record> without system call,
+ * retrying while the audio thread writes it
+ */
+void beatshm_read(const beatshm_record_t* record, beatshm_record_t* copy)
+{
+  uint32_t sequence;
+
+  do {
+    sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+    memcpy(copy, record, sizeof(beatshm_record_t));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  } while ((sequence & 1) ||
+           sequence != __atomic_load_n(&record->sequence, __ATOMIC_RELAXED));
+}
+
+/*
+ * returns CLOCK_MONOTONIC time in nanoseconds (served by the vDSO, i.e.
+ * without system call, on common platforms)
+ */
+int64_t beatshm_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/*
+ * returns time of the first (sub) tick at or after <now>, extrapolated from
+ * <copy> of the record at its tempo
+ */
+int64_t beatshm_next_tick(const beatshm_record_t* copy, int64_t now)
+{
+  int64_t step = copy->tick_length / (copy->subdivision > 0 ?
+                                      copy->subdivision : 1);
+
+  if (copy->tick_time >= now || step <= 0)
+    return copy->tick_time;
+  return copy->tick_time + ((now - copy->tick_time + step - 1) / step) * step;
+}
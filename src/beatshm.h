@@ -0,0 +1,106 @@
+/*
+ * shared memory beat position export interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BEATSHM_H
+#define BEATSHM_H
+
+/*
+ * This header is installed for readers (libgtickbeat), so it doesn't
+ * depend on GLib or other GTick headers.
+ */
+
+#include <stdint.h>
+
+/* default name of shared memory object (see shm_open()) */
+#define BEATSHM_NAME "/gtick"
+
+#define BEATSHM_MAGIC 0x6b695447 /* "GTik" in little endian */
+#define BEATSHM_VERSION 2
+
+/*
+ * number of fragments over which the mapping of frames to monotonic time
+ * follows changes of the output delay
+ */
+#define BEATSHM_SMOOTHING 32
+
+/*
+ * record in shared memory, written by the audio thread at each tick and
+ * sub beat as soon as it is rendered, i.e. before it is heard
+ *
+ * sequence is a seqlock: odd while the record is being written, so readers
+ * copy the record and retry if sequence was odd or changed meanwhile (see
+ * beatshm_read())
+ */
+typedef struct beatshm_record_t {
+  uint32_t magic;        /* BEATSHM_MAGIC */
+  uint32_t version;      /* BEATSHM_VERSION */
+  uint32_t sequence;     /* seqlock, incremented twice per update */
+  uint32_t running;      /* 0: metronome stopped, other fields stale */
+
+  int64_t bar;           /* number of bar since start (from 0) */
+  int32_t beat;          /* number of tick in bar (from 0) */
+  int32_t subbeat;       /* number of sub beat in tick (0: the tick) */
+  int32_t meter;         /* number of ticks in bar */
+  int32_t unit;          /* note value of a tick, e.g. 8 for 6/8 */
+  int32_t subdivision;   /* number of sub beats per tick, 1: none */
+  double bpm;            /* tempo of current tick */
+
+  int64_t tick_time;     /* CLOCK_MONOTONIC nanoseconds at which the
+                            (sub) tick above is heard: the next audible
+                            tick as long as the output delay is shorter
+                            than a sub beat */
+  int64_t tick_length;   /* nanoseconds of whole tick, divided evenly by
+                            sub beats */
+} beatshm_record_t;
+
+/*
+ * writer (audio thread): owns the shared memory object
+ */
+typedef struct beatshm_t {
+  char* name;
+  beatshm_record_t* record;
+
+  int rate;              /* frames per second */
+  double offset;         /* monotonic time of frame 0 in seconds */
+  int anchored;          /* offset known */
+  long long bar;         /* number of current bar, -1: before first tick */
+} beatshm_t;
+
+/* writer */
+beatshm_t* beatshm_new(const char* name);
+void beatshm_delete(beatshm_t* shm);
+void beatshm_start(beatshm_t* shm, int rate);
+void beatshm_stop(beatshm_t* shm);
+void beatshm_anchor(beatshm_t* shm, long long frame, double delay);
+void beatshm_publish(beatshm_t* shm, long long frame, long long ticklen,
+                     int beat, int subbeat, int meter, int unit,
+                     int subdivision);
+
+/* reader */
+const beatshm_record_t* beatshm_attach(const char* name);
+void beatshm_detach(const beatshm_record_t* record);
+void beatshm_read(const beatshm_record_t* record, beatshm_record_t* copy);
+int64_t beatshm_now(void);
+int64_t beatshm_next_tick(const beatshm_record_t* copy, int64_t now);
+
+#endif /* BEATSHM_H */
@@ -0,0 +1,792 @@
+/*
+ * control socket: drives the audio thread from other processes
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "control.h"
+#include "dsp.h"
+#include "threadtalk.h"
+
+/*
+ * requests and replies: 16 bit length, then as many bytes of
+ *
+ *   request: commands (see control.h)
+ *   reply:   result, running, tempo (32 bit, milli BPM), volume, beat,
+ *            meter, meter * accent
+ *
+ * in network byte order, all other fields 8 bit
+ */
+#define REPLY_SIZE 9
+
+static void put16(unsigned char* p, unsigned int x)
+{
+  p[0] = x >> 8;
+  p[1] = x;
+}
+
+static unsigned int get16(const unsigned char* p)
+{
+  return (unsigned int) p[0] << 8 | p[1];
+}
+
+static void put32(unsigned char* p, unsigned int x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+static unsigned int get32(const unsigned char* p)
+{
+  return (unsigned int) p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+/*
+ * writes <size> bytes completely
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int write_all(int fd, const unsigned char* data, int size)
+{
+  while (size > 0) {
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+
+    if (n == -1 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    data += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/*
+ * reads <size> bytes completely
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int read_all(int fd, unsigned char* data, int size)
+{
+  while (size > 0) {
+    ssize_t n = read(fd, data, size);
+
+    if (n == -1 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    data += n;
+    size -= n;
+  }
+  return 0;
+}
+
+/*
+ * returns newly allocated default socket path: in $XDG_RUNTIME_DIR or,
+ * if not set, in the temporary directory
+ */
+char* control_default_path(void)
+{
+  const char* dir = getenv("XDG_RUNTIME_DIR");
+
+  if (dir && *dir)
+    return g_strdup_printf("%s/" CONTROL_SOCKET_NAME, dir);
+  else
+    return g_strdup_printf("%s/gtick-%d.sock", g_get_tmp_dir(), getuid());
+}
+
+/*
+ * fills <address> with socket <path>
+ *
+ * returns 0 on success, -1 if path is too long
+ */
+static int make_address(struct sockaddr_un* address, const char* path)
+{
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(address->sun_path))
+    return -1;
+  strcpy(address->sun_path, path);
+  return 0;
+}
+
+/*
+ * server side
+ */
+
+static void free_profiles(control_profile_t* table)
+{
+  control_profile_t* profile;
+
+  if (!table)
+    return;
+
+  for (profile = table; profile->name; profile++) {
+    free(profile->name);
+    free(profile->speed);
+    free(profile->meter);
+    free(profile->accents);
+  }
+  free(table);
+}
+
+/*
+ * returns profile <name> (or number <name>, counted from 1), NULL if not
+ * available
+ */
+static control_profile_t* find_profile(control_t* control, const char* name)
+{
+  control_profile_t* table;
+  char* end;
+  int number;
+  int i;
+
+  /* take over latest table from main thread */
+  while ((table = g_async_queue_try_pop(control->profiles))) {
+    free_profiles(control->table);
+    control->table = table;
+  }
+
+  if (!control->table)
+    return NULL;
+
+  number = (int) strtol(name, &end, 10);
+  for (i = 0; control->table[i].name; i++) {
+    if ((*end == '\0' && i + 1 == number) ||
+        !strcmp(control->table[i].name, name))
+      return &control->table[i];
+  }
+  return NULL;
+}
+
+/*
+ * adds queries for <accents> as in rc file ('1': accent, other: normal) to
+ * <batch>
+ */
+static void add_accents(comm_batch_t* batch, const char* accents)
+{
+  int* message = (int*) g_malloc0(sizeof(int) * MAX_METER);
+  int i;
+
+  for (i = 0; i < MAX_METER && accents[i]; i++)
+    message[i] = accents[i] == '1' ? DSP_BEAT_ACCENT : DSP_BEAT_NORMAL;
+  comm_batch_add(batch, MESSAGE_TYPE_SET_ACCENTS, message);
+}
+
+/*
+ * translates <size> bytes of commands to queries of <batch>
+ *
+ * returns CONTROL_OK on success, error code otherwise (leaving <batch>
+ * empty)
+ */
+static int parse_request(control_t* control, comm_batch_t* batch,
+                         const unsigned char* data, int size)
+{
+  int pos = 0;
+  int result = CONTROL_OK;
+  int i;
+
+  while (pos < size && result == CONTROL_OK) {
+    int command = data[pos++];
+    int left = size - pos;
+
+    switch (command) {
+      case CONTROL_TEMPO:
+        if (left < 4) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          double bpm = get32(data + pos) / 1000.0;
+          double* frequency;
+
+          pos += 4;
+          if (bpm < MIN_BPM || bpm > MAX_BPM) {
+            result = CONTROL_BAD_REQUEST;
+            break;
+          }
+          frequency = (double*) g_malloc(sizeof(double));
+          *frequency = bpm / 60.0;
+          comm_batch_add(batch, MESSAGE_TYPE_SET_FREQUENCY, frequency);
+        }
+        break;
+      case CONTROL_METER:
+        if (left < 1 || data[pos] < 1 || data[pos] > MAX_METER) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          int* meter = (int*) g_malloc(sizeof(int));
+
+          *meter = data[pos++];
+          comm_batch_add(batch, MESSAGE_TYPE_SET_METER, meter);
+        }
+        break;
+      case CONTROL_ACCENTS:
+        if (left < 1 || data[pos] > MAX_METER || left < 1 + data[pos]) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          int n = data[pos++];
+          int* accents = (int*) g_malloc0(sizeof(int) * MAX_METER);
+
+          for (i = 0; i < n; i++) {
+            if (data[pos + i] > DSP_BEAT_OFF)
+              result = CONTROL_BAD_REQUEST;
+            accents[i] = data[pos + i];
+          }
+          pos += n;
+          comm_batch_add(batch, MESSAGE_TYPE_SET_ACCENTS, accents);
+        }
+        break;
+      case CONTROL_VOLUME:
+        if (left < 1 || data[pos] > VOLUME_MAX) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          double* volume = (double*) g_malloc(sizeof(double));
+
+          *volume = data[pos++] / 100.0;
+          comm_batch_add(batch, MESSAGE_TYPE_SET_VOLUME, volume);
+        }
+        break;
+      case CONTROL_START:
+        comm_batch_add(batch, MESSAGE_TYPE_START_METRONOME, NULL);
+        break;
+      case CONTROL_STOP:
+        comm_batch_add(batch, MESSAGE_TYPE_STOP_METRONOME, NULL);
+        break;
+      case CONTROL_PROFILE:
+        if (left < 1 || left < 1 + data[pos]) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          char* name = g_strndup((const char*) data + pos + 1, data[pos]);
+          control_profile_t* profile = find_profile(control, name);
+
+          pos += 1 + data[pos];
+          free(name);
+          if (!profile) {
+            result = CONTROL_NO_PROFILE;
+            break;
+          }
+          if (profile->meter) {
+            int* meter = (int*) g_malloc(sizeof(int));
+
+            *meter = CLAMP((int) strtol(profile->meter, NULL, 0),
+                           1, MAX_METER);
+            comm_batch_add(batch, MESSAGE_TYPE_SET_METER, meter);
+          }
+          if (profile->speed) {
+            double* frequency = (double*) g_malloc(sizeof(double));
+
+            *frequency = CLAMP(g_ascii_strtod(profile->speed, NULL),
+                               MIN_BPM, MAX_BPM) / 60.0;
+            comm_batch_add(batch, MESSAGE_TYPE_SET_FREQUENCY, frequency);
+          }
+          if (profile->accents)
+            add_accents(batch, profile->accents);
+        }
+        break;
+      case CONTROL_SOUND:
+        if (left < 1 || data[pos] == 0 || left < 1 + data[pos]) {
+          result = CONTROL_BAD_REQUEST;
+        } else {
+          comm_batch_add(batch, MESSAGE_TYPE_SET_SOUND,
+                         g_strndup((const char*) data + pos + 1, data[pos]));
+          pos += 1 + data[pos];
+        }
+        break;
+      default:
+        result = CONTROL_BAD_REQUEST;
+    }
+  }
+
+  if (result != CONTROL_OK) { /* nothing applied */
+    for (i = 0; i < batch->n; i++)
+      free(batch->messages[i].body);
+    batch->n = 0;
+  }
+  return result;
+}
+
+/*
+ * hands request of <size> bytes to the audio thread and answers it with
+ * the resulting status
+ *
+ * returns 0 on success, -1 on connection error
+ */
+static int handle_request(control_t* control, int fd,
+                          const unsigned char* data, int size)
+{
+  unsigned char reply[2 + REPLY_SIZE + MAX_METER];
+  comm_batch_t* batch;
+  dsp_status_t* status;
+  int result;
+  int i;
+
+  batch = comm_batch_new(++control->sequence, control->reply);
+  result = parse_request(control, batch, data, size);
+  comm_client_query(control->comm, MESSAGE_TYPE_BATCH, batch);
+
+  /* wait for status, skipping late ones of earlier batches */
+  while ((status = g_async_queue_timeout_pop(control->reply,
+                                             CONTROL_TIMEOUT * 1000)) &&
+         status->sequence != control->sequence)
+    free(status);
+
+  memset(reply, 0, sizeof(reply));
+  put16(reply, REPLY_SIZE);
+  if (status) {
+    reply[2] = result;
+    reply[3] = status->running;
+    put32(reply + 4, lrint(status->bpm * 1000.0));
+    reply[8] = lrint(status->volume * 100.0);
+    reply[9] = status->beat;
+    reply[10] = status->meter;
+    for (i = 0; i < status->meter; i++)
+      reply[2 + REPLY_SIZE + i] = status->accents[i];
+    put16(reply, REPLY_SIZE + status->meter);
+    free(status);
+  } else {
+    reply[2] = CONTROL_NO_ENGINE;
+  }
+
+  return write_all(fd, reply, 2 + get16(reply));
+}
+
+static void close_client(control_client_t* client)
+{
+  close(client->fd);
+  client->fd = -1;
+}
+
+/*
+ * reads from <client> and handles its complete requests
+ */
+static void receive(control_t* control, control_client_t* client)
+{
+  ssize_t n;
+  int size;
+
+  n = read(client->fd, client->buffer + client->length,
+           sizeof(client->buffer) - client->length);
+  if (n <= 0) {
+    if (n == 0 || errno != EINTR)
+      close_client(client);
+    return;
+  }
+  client->length += n;
+
+  while (client->length >= 2) {
+    size = get16(client->buffer);
+    if (size > CONTROL_MAX_BATCH) { /* protocol error */
+      close_client(client);
+      return;
+    }
+    if (client->length < 2 + size)
+      return;
+    if (handle_request(control, client->fd, client->buffer + 2, size) == -1) {
+      close_client(client);
+      return;
+    }
+    client->length -= 2 + size;
+    memmove(client->buffer, client->buffer + 2 + size, client->length);
+  }
+}
+
+/*
+ * server thread: waits for connections and requests until woken up by
+ * control_delete()
+ */
+static gpointer serve(control_t* control)
+{
+  struct pollfd fds[2 + CONTROL_MAX_CLIENTS];
+  int i;
+
+  for (;;) {
+    int n = 2;
+
+    fds[0].fd = control->wakeup[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = control->fd;
+    fds[1].events = POLLIN;
+    for (i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+      fds[n].fd = control->clients[i].fd; /* -1: ignored by poll() */
+      fds[n].events = POLLIN;
+      n++;
+    }
+
+    if (poll(fds, n, -1) == -1) {
+      if (errno == EINTR)
+        continue;
+      perror("poll");
+      break;
+    }
+
+    if (fds[0].revents)
+      break;
+
+    if (fds[1].revents & POLLIN) {
+      int fd = accept(control->fd, NULL, NULL);
+
+      for (i = 0; fd != -1 && i < CONTROL_MAX_CLIENTS; i++) {
+        if (control->clients[i].fd == -1) {
+          control->clients[i].fd = fd;
+          control->clients[i].length = 0;
+          fd = -1;
+        }
+      }
+      if (fd != -1) { /* too many clients */
+        if (debug)
+          fprintf(stderr, "Warning: Control connection refused.\n");
+        close(fd);
+      }
+    }
+
+    for (i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+      if (fds[2 + i].revents && control->clients[i].fd != -1)
+        receive(control, &control->clients[i]);
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * returns listening socket at <path>, taking over the socket of a terminated
+ * instance, -1 on error (e.g. socket served by another instance)
+ */
+static int open_socket(const char* path)
+{
+  struct sockaddr_un address;
+  int fd;
+
+  if (make_address(&address, path) == -1) {
+    fprintf(stderr, "Warning: Control socket path too long: %s\n", path);
+    return -1;
+  }
+
+  if ((fd = control_connect(path)) != -1) {
+    fprintf(stderr, "Warning: Control socket %s already in use.\n", path);
+    close(fd);
+    return -1;
+  }
+  unlink(path); /* stale */
+
+  if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1 ||
+      bind(fd, (struct sockaddr*) &address, sizeof(address)) ||
+      listen(fd, CONTROL_MAX_CLIENTS))
+  {
+    perror("Warning: Couldn't set up control socket");
+    if (fd != -1)
+      close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+/*
+ * returns new control socket server at <path> (NULL: default path),
+ * driving the audio thread of <comm>
+ *
+ * returns NULL on error
+ */
+control_t* control_new(const char* path, comm_t* comm)
+{
+  control_t* result;
+  int i;
+
+  result = (control_t*) g_malloc0(sizeof(control_t));
+  result->path = path ? strdup(path) : control_default_path();
+  result->comm = comm;
+
+  if ((result->fd = open_socket(result->path)) == -1 ||
+      pipe(result->wakeup) == -1)
+  {
+    if (result->fd != -1) {
+      perror("pipe");
+      close(result->fd);
+      unlink(result->path);
+    }
+    free(result->path);
+    free(result);
+    return NULL;
+  }
+
+  for (i = 0; i < CONTROL_MAX_CLIENTS; i++)
+    result->clients[i].fd = -1;
+  result->reply = g_async_queue_new();
+  result->profiles = g_async_queue_new();
+  result->thread = g_thread_new("control", (GThreadFunc) serve, result);
+
+  if (debug)
+    fprintf(stderr, "Control socket: %s\n", result->path);
+
+  return result;
+}
+
+/*
+ * terminates server thread and destroys control socket
+ */
+void control_delete(control_t* control)
+{
+  control_profile_t* table;
+  void* status;
+  int i;
+
+  if (write(control->wakeup[1], "", 1) != 1)
+    perror("write");
+  g_thread_join(control->thread);
+
+  for (i = 0; i < CONTROL_MAX_CLIENTS; i++) {
+    if (control->clients[i].fd != -1)
+      close_client(&control->clients[i]);
+  }
+  close(control->wakeup[0]);
+  close(control->wakeup[1]);
+  close(control->fd);
+  unlink(control->path);
+
+  while ((status = g_async_queue_try_pop(control->reply)))
+    free(status);
+  g_async_queue_unref(control->reply);
+  while ((table = g_async_queue_try_pop(control->profiles)))
+    free_profiles(table);
+  g_async_queue_unref(control->profiles);
+  free_profiles(control->table);
+
+  free(control->path);
+  free(control);
+}
+
+static char* copy(const char* s)
+{
+  return s ? strdup(s) : NULL;
+}
+
+/*
+ * sets the <n> profiles loadable by clients (copied)
+ */
+void control_set_profiles(control_t* control,
+                          const control_profile_t* profiles, int n)
+{
+  control_profile_t* table;
+  int i;
+
+  table = (control_profile_t*) g_malloc0((n + 1) * sizeof(control_profile_t));
+  for (i = 0; i < n; i++) {
+    table[i].name = strdup(profiles[i].name ? profiles[i].name : "");
+    table[i].speed = copy(profiles[i].speed);
+    table[i].meter = copy(profiles[i].meter);
+    table[i].accents = copy(profiles[i].accents);
+  }
+  g_async_queue_push(control->profiles, table);
+}
+
+/*
+ * client side
+ */
+
+/*
+ * returns socket connected to server at <path> (NULL: default path),
+ * -1 on error
+ */
+int control_connect(const char* path)
+{
+  struct sockaddr_un address;
+  char* name = path ? strdup(path) : control_default_path();
+  int fd;
+
+  if (make_address(&address, name) == -1 ||
+      (fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1) {
+    free(name);
+    return -1;
+  }
+  free(name);
+
+  if (connect(fd, (struct sockaddr*) &address, sizeof(address)) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void control_batch_init(control_batch_t* batch)
+{
+  batch->length = 0;
+}
+
+/*
+ * reserves <size> bytes in <batch> for <command> and its arguments
+ *
+ * returns pointer to the arguments, NULL if batch is full
+ */
+static unsigned char* reserve(control_batch_t* batch, int command, int size)
+{
+  unsigned char* result;
+
+  if (batch->length + 1 + size > CONTROL_MAX_BATCH)
+    return NULL;
+
+  batch->data[batch->length] = command;
+  result = batch->data + batch->length + 1;
+  batch->length += 1 + size;
+  return result;
+}
+
+/*
+ * adds command without arguments (CONTROL_START, CONTROL_STOP) to <batch>
+ *
+ * returns 0 on success, -1 if batch is full
+ */
+int control_add_command(control_batch_t* batch, int command)
+{
+  return reserve(batch, command, 0) ? 0 : -1;
+}
+
+int control_add_tempo(control_batch_t* batch, double bpm)
+{
+  unsigned char* p = reserve(batch, CONTROL_TEMPO, 4);
+
+  if (!p)
+    return -1;
+  put32(p, lrint(bpm * 1000.0));
+  return 0;
+}
+
+int control_add_meter(control_batch_t* batch, int meter)
+{
+  unsigned char* p = reserve(batch, CONTROL_METER, 1);
+
+  if (!p)
+    return -1;
+  *p = meter;
+  return 0;
+}
+
+/*
+ * adds <accents> as string of DSP_BEAT_* digits, e.g. "1020", to <batch>
+ *
+ * returns 0 on success, -1 on error
+ */
+int control_add_accents(control_batch_t* batch, const char* accents)
+{
+  int n = strlen(accents);
+  unsigned char* p;
+  int i;
+
+  if (n > MAX_METER || !(p = reserve(batch, CONTROL_ACCENTS, 1 + n)))
+    return -1;
+  p[0] = n;
+  for (i = 0; i < n; i++)
+    p[1 + i] = accents[i] - '0';
+  return 0;
+}
+
+int control_add_volume(control_batch_t* batch, int volume)
+{
+  unsigned char* p = reserve(batch, CONTROL_VOLUME, 1);
+
+  if (!p)
+    return -1;
+  *p = volume;
+  return 0;
+}
+
+int control_add_profile(control_batch_t* batch, const char* name)
+{
+  int n = strlen(name);
+  unsigned char* p;
+
+  if (n > 255 || !(p = reserve(batch, CONTROL_PROFILE, 1 + n)))
+    return -1;
+  p[0] = n;
+  memcpy(p + 1, name, n);
+  return 0;
+}
+
+int control_add_sound(control_batch_t* batch, const char* name)
+{
+  int n = strlen(name);
+  unsigned char* p;
+
+  if (n == 0 || n > 255 || !(p = reserve(batch, CONTROL_SOUND, 1 + n)))
+    return -1;
+  p[0] = n;
+  memcpy(p + 1, name, n);
+  return 0;
+}
+
+/*
+ * sends <batch> to be applied at once and receives the resulting status
+ *
+ * returns 0 on success (see status->result), -1 on connection error
+ */
+int control_request(int fd, const control_batch_t* batch,
+                    control_status_t* status)
+{
+  unsigned char request[2 + CONTROL_MAX_BATCH];
+  unsigned char reply[REPLY_SIZE + MAX_METER];
+  int size;
+  int i;
+
+  put16(request, batch->length);
+  memcpy(request + 2, batch->data, batch->length);
+  if (write_all(fd, request, 2 + batch->length) == -1 ||
+      read_all(fd, reply, 2) == -1)
+    return -1;
+
+  size = get16(reply);
+  if (size < REPLY_SIZE || size > (int) sizeof(reply) ||
+      read_all(fd, reply, size) == -1)
+    return -1;
+
+  memset(status, 0, sizeof(*status));
+  status->result = reply[0];
+  status->running = reply[1];
+  status->bpm = get32(reply + 2) / 1000.0;
+  status->volume = reply[6];
+  status->beat = reply[7];
+  status->meter = MIN(reply[8], size - REPLY_SIZE);
+  for (i = 0; i < status->meter; i++)
+    status->accents[i] = reply[REPLY_SIZE + i];
+
+  return 0;
+}
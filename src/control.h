@@ -0,0 +1,144 @@
+/*
+ * control socket interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+/* GTK+ headers */
+#include <glib.h>
+
+/* own headers */
+#include "globals.h"
+#include "threadtalk.h"
+
+/* name of socket in $XDG_RUNTIME_DIR */
+#define CONTROL_SOCKET_NAME "gtick.sock"
+
+/* maximum size of commands in one request (batch) in bytes */
+#define CONTROL_MAX_BATCH 1024
+
+/* maximum number of connected clients */
+#define CONTROL_MAX_CLIENTS 8
+
+/* milliseconds to wait for the audio thread to apply a batch */
+#define CONTROL_TIMEOUT 1000
+
+/*
+ * commands in a request, each an opcode byte followed by its arguments
+ * (integers in network byte order)
+ */
+enum {
+  CONTROL_TEMPO = 1, /* 32 bit: tempo in milli BPM */
+  CONTROL_METER,     /* 8 bit: meter */
+  CONTROL_ACCENTS,   /* 8 bit: n, n * 8 bit: DSP_BEAT_* of each tick */
+  CONTROL_VOLUME,    /* 8 bit: volume in percent */
+  CONTROL_START,
+  CONTROL_STOP,
+  CONTROL_PROFILE,   /* 8 bit: n, n bytes: name or number (from 1) */
+  CONTROL_SOUND      /* 8 bit: n, n bytes: sound name or file name */
+};
+
+/* result codes in replies */
+enum {
+  CONTROL_OK = 0,
+  CONTROL_BAD_REQUEST, /* unknown command or bad argument: nothing applied */
+  CONTROL_NO_PROFILE,  /* profile not found: nothing applied */
+  CONTROL_NO_ENGINE    /* audio thread didn't answer */
+};
+
+/* profile to be loaded by clients, values as in rc file */
+typedef struct control_profile_t {
+  char* name;
+  char* speed;
+  char* meter;
+  char* accents;
+} control_profile_t;
+
+/* status in reply to a request */
+typedef struct control_status_t {
+  int result;             /* CONTROL_OK, ... */
+  int running;
+  double bpm;
+  int volume;             /* percent */
+  int beat;               /* number of current tick in bar */
+  int meter;
+  int accents[MAX_METER]; /* DSP_BEAT_* */
+} control_status_t;
+
+/* request being composed by a client */
+typedef struct control_batch_t {
+  unsigned char data[CONTROL_MAX_BATCH];
+  int length;
+} control_batch_t;
+
+/* connection of a client at the server */
+typedef struct control_client_t {
+  int fd;                                     /* -1: unused */
+  unsigned char buffer[2 + CONTROL_MAX_BATCH]; /* incomplete request */
+  int length;
+} control_client_t;
+
+/*
+ * server: receives requests on a UNIX domain socket in its own thread and
+ * hands each one to the audio thread as one batch of queries, answered with
+ * the resulting status
+ */
+typedef struct control_t {
+  char* path;
+  int fd;                   /* listening socket */
+  int wakeup[2];            /* pipe to terminate thread */
+  GThread* thread;
+
+  comm_t* comm;             /* of audio thread */
+  GAsyncQueue* reply;       /* status from audio thread */
+  unsigned int sequence;    /* number of last batch */
+
+  GAsyncQueue* profiles;    /* new profile tables from main thread */
+  control_profile_t* table; /* profiles (terminated by name NULL), owned by
+                               server thread */
+
+  control_client_t clients[CONTROL_MAX_CLIENTS];
+} control_t;
+
+char* control_default_path(void);
+
+/* server */
+control_t* control_new(const char* path, comm_t* comm);
+void control_delete(control_t* control);
+void control_set_profiles(control_t* control,
+                          const control_profile_t* profiles, int n);
+
+/* client */
+int control_connect(const char* path);
+void control_batch_init(control_batch_t* batch);
+int control_add_command(control_batch_t* batch, int command);
+int control_add_tempo(control_batch_t* batch, double bpm);
+int control_add_meter(control_batch_t* batch, int meter);
+int control_add_accents(control_batch_t* batch, const char* accents);
+int control_add_volume(control_batch_t* batch, int volume);
+int control_add_profile(control_batch_t* batch, const char* name);
+int control_add_sound(control_batch_t* batch, const char* name);
+int control_request(int fd, const control_batch_t* batch,
+                    control_status_t* status);
+
+#endif /* CONTROL_H */
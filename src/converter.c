@@ -21,55 +21,130 @@
  * along with GTick; if not, see <http://www.gnu.org/licenses/>.
  *
  */
- 
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
 
+/* GTK+ headers */
+#include <glib.h>
+
 #ifdef USE_DMALLOC
 #include <dmalloc.h>
 #endif
 
+/* own headers */
+#include "soundbank.h"
+#include "mixer.h"
+
 #define SAMPLESIZE sizeof(short)
 
+/* rate of the raw sample file */
+#define SOURCE_RATE 44100
+
+/* device rates the variants of the tick are prepared for */
+static const int rates[] = { 44100, 48000, 88200, 96000 };
+
+static const char* variants[VOICE_VARIANT_NUMBER] = {
+  [VOICE_VARIANT_NORMAL] = "normal",
+  [VOICE_VARIANT_ACCENT] = "accent",
+  [VOICE_VARIANT_SECONDARY] = "secondary"
+};
+
+/*
+ * prints array <name> of <size> samples
+ */
+static void print_table(const char* name, const short* data, int size) {
+  int i;
+
+  printf("static const short %s[] = {", name);
+  for (i = 0; i < size; i++) {
+    if (i % 8)
+      printf(" ");
+    else
+      printf("\n");
+    printf("%6d", data[i]);
+    if (i < size - 1) printf(",");
+  }
+  printf("\n};\n");
+}
+
 int main(int argc, char* argv[]) {
-  short x;
+  short* data;
+  int frames[sizeof(rates) / sizeof(rates[0])][VOICE_VARIANT_NUMBER];
+  unsigned int r;
+  int v;
   int fd;
-  int i = 0;
   int size;
-  
+
   if (argc != 2) {
     fprintf(stderr, "usage: converter [raw 16 bit signed sample file]\n");
     return 0;
-  } else {
-    printf("/*                                                          */\n");
-    printf("/* This file was automatically generated by converter.      */\n");
-    printf("/* It contains samples in signed 16 bit format.             */\n");
-    printf("/*                                                          */\n");
-    printf("\n");
-    printf("static short tickdata[] = {");
-  
-    fd = open(argv[1], O_RDONLY);
-    if (fd == -1) {
-      fprintf(stderr, "Error: Couldn't open file.\n");
-      return -1;
-    } else {
-      size = lseek(fd, 0, SEEK_END) / SAMPLESIZE;
-      lseek(fd, 0, SEEK_SET);
-      while (read(fd, &x, SAMPLESIZE) == SAMPLESIZE) {
-        if (i % 8)
-          printf(" ");
-        else
-          printf("\n");
-        printf("%6d", x);
-        if (i < size - 1) printf(",");
-        i++;
+  }
+
+  fd = open(argv[1], O_RDONLY);
+  if (fd == -1) {
+    fprintf(stderr, "Error: Couldn't open file.\n");
+    return -1;
+  }
+  size = lseek(fd, 0, SEEK_END) / SAMPLESIZE;
+  lseek(fd, 0, SEEK_SET);
+  data = (short*) malloc(size * SAMPLESIZE);
+  if (read(fd, data, size * SAMPLESIZE) != (ssize_t) (size * SAMPLESIZE)) {
+    fprintf(stderr, "Error: Couldn't read file.\n");
+    return -1;
+  }
+  close(fd);
+
+  printf("/*                                                          */\n");
+  printf("/* This file was automatically generated by converter.      */\n");
+  printf("/* It contains samples in signed 16 bit format.             */\n");
+  printf("/*                                                          */\n");
+  printf("\n");
+  printf("#define TICKDATA_RATE %d\n", SOURCE_RATE);
+  printf("\n");
+  print_table("tickdata", data, size);
+
+  /* variants as prepared by the sound bank, ready for the device */
+  for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    for (v = 0; v < VOICE_VARIANT_NUMBER; v++) {
+      short* variant;
+      char* name;
+
+      frames[r][v] = soundbank_render_variant(data, size, SOURCE_RATE, 1, v,
+                                              rates[r], &variant,
+                                              MIXER_FIXED_POINT, 0);
+      if (frames[r][v] == -1) {
+        fprintf(stderr, "Error: Couldn't prepare %s tick at %d Hz.\n",
+                variants[v], rates[r]);
+        return -1;
       }
-      close(fd);
-      printf("\n};\n");
+      name = g_strdup_printf("tickdata_%d_%s", rates[r], variants[v]);
+      printf("\n");
+      print_table(name, variant, frames[r][v]);
+      free(name);
+      free(variant);
     }
   }
+
+  printf("\n");
+  printf("static const struct {\n");
+  printf("  int rate;\n");
+  printf("  const short* data[VOICE_VARIANT_NUMBER];\n");
+  printf("  int frames[VOICE_VARIANT_NUMBER];\n");
+  printf("} tickdata_rates[] = {\n");
+  for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    printf("  { %d,\n    {", rates[r]);
+    for (v = 0; v < VOICE_VARIANT_NUMBER; v++)
+      printf(" tickdata_%d_%s%s", rates[r], variants[v],
+             v < VOICE_VARIANT_NUMBER - 1 ? "," : " },\n    {");
+    for (v = 0; v < VOICE_VARIANT_NUMBER; v++)
+      printf(" %d%s", frames[r][v], v < VOICE_VARIANT_NUMBER - 1 ? "," : "");
+    printf(" } }%s\n", r < sizeof(rates) / sizeof(rates[0]) - 1 ? "," : "");
+  }
+  printf("};\n");
+
+  free(data);
   return 0;
 }
-
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
 #include <time.h>
 #include <assert.h>
 
@@ -51,16 +52,20 @@
 #endif
 
 #include <pulse/simple.h>
+#include <pulse/pulseaudio.h>
 #include <pulse/error.h>
 #include <pulse/gccmacro.h>
 
 /* own headers */
+#include "afmt.h"
 #include "g711.h"
 #include "globals.h"
-#include "metro.h"
 #include "dsp.h"
+#include "mixer.h"
 #include "option.h"
+#include "synth.h"
 #include "threadtalk.h"
+#include "wavfile.h"
 
 /* default sampled sound effect */
 #include "tickdata.c"
@@ -73,10 +78,25 @@
 #define DEFAULT_FORMAT AFMT_S16_LE
 #define DEFAULT_CHANNELS 1
 
-/* sine generator settings */
-#define SIN_FREQ 880.0
-#define SIN_DUR 0.01
-#define FADE_DUR 0.002
+/*
+ * sound files end at their first SILENCE_DURATION (in seconds) of frames not
+ * above SILENCE_LEVEL (-60 dB)
+ */
+#define SILENCE_LEVEL 32
+#define SILENCE_DURATION 0.02
+
+/* frames decoded at once from sound files */
+#define SNDFILE_CHUNK 4096
+
+/* sync pulse: sound name and duration of high level in seconds */
+#define PULSE_NAME "<pulse>"
+#define PULSE_DUR 0.005
+
+/*
+ * maximum change of tick length (share of master's tick) when aligning the
+ * ticks to a MIDI clock master, so the click never jumps
+ */
+#define FOLLOW_CORRECTION 0.1
 
 /* OSS sample format type */
 typedef struct format_t {
@@ -86,7 +106,7 @@ typedef struct format_t {
   char* description;
 } format_t;
 
-static format_t formats[] = {
+static const format_t formats[] = {
   { AFMT_MU_LAW,    "AFMT_MU_LAW",     8, "8 bit mu-law"                     },
   { AFMT_A_LAW,     "AFMT_A_LAW",      8, "8 bit A-law"                      },
   { AFMT_IMA_ADPCM, "AFMT_IMA_ADPCM",  4, "4 bit IMA ADPCM"                  },
@@ -95,16 +115,275 @@ static format_t formats[] = {
   { AFMT_S16_BE,    "AFMT_S16_BE",    16, "signed, 16 bit (big endian)"      },
   /* equals AFMT_S16_LE or AFMT_S16_BE, shouldn't be reported: */
   { AFMT_S16_NE,    "AFMT_S16_NE",    16, "signed, 16 bit (local CPU endian)"},
-  /* not supported by default soundcard.h
   { AFMT_S32_LE,    "AFMT_S32_LE",    32, "signed, 32 bit (little endian)"   },
   { AFMT_S32_BE,    "AFMT_S32_BE",    32, "signed, 32 bit (big endian)"      },
-  */
+  { AFMT_S24_LE,    "AFMT_S24_LE",    32, "signed, 24 in 32 bit (little e.)" },
+  { AFMT_S24_BE,    "AFMT_S24_BE",    32, "signed, 24 in 32 bit (big e.)"    },
+  { AFMT_S24_PACKED, "AFMT_S24_PACKED", 24, "signed, 24 bit (little endian)" },
+  { AFMT_FLOAT,     "AFMT_FLOAT",     32, "float, 32 bit (local CPU endian)" },
   { AFMT_U16_LE,    "AFMT_U16_LE",    16, "unsigned, 16 bit (little endian)" },
   { AFMT_U16_BE,    "AFMT_U16_BE",    16, "unsigned, 16 bit (big endian)"    },
 
   { 0,              "unknown",        0,  "???"                              }
 };
 
+/*
+ * formats of the device used by preference, the first ones are encoded
+ * fastest
+ */
+static const int preferred_formats[] = {
+  AFMT_S16_LE, AFMT_S16_BE, AFMT_S32_LE, AFMT_S32_BE, AFMT_S24_LE,
+  AFMT_S24_BE, AFMT_FLOAT, AFMT_S24_PACKED, AFMT_U8, AFMT_MU_LAW, AFMT_A_LAW,
+  AFMT_U16_LE, AFMT_U16_BE
+};
+
+#ifdef SNDCTL_DSP_COOKEDMODE
+/*
+ * formats used by preference when the driver doesn't convert (OSS 4 with
+ * cooked mode off): the full resolution of the device first
+ */
+static const int native_formats[] = {
+  AFMT_S32_LE, AFMT_S32_BE, AFMT_S24_LE, AFMT_S24_BE, AFMT_S24_PACKED,
+  AFMT_FLOAT, AFMT_S16_LE, AFMT_S16_BE, AFMT_U16_LE, AFMT_U16_BE, AFMT_U8,
+  AFMT_MU_LAW, AFMT_A_LAW
+};
+#endif
+
+/* PulseAudio sample formats of the formats above */
+static const struct {
+  pa_sample_format_t pulse;
+  int format;
+} pulse_formats[] = {
+  { PA_SAMPLE_S16LE,     AFMT_S16_LE     },
+  { PA_SAMPLE_S16BE,     AFMT_S16_BE     },
+  { PA_SAMPLE_S32LE,     AFMT_S32_LE     },
+  { PA_SAMPLE_S32BE,     AFMT_S32_BE     },
+  { PA_SAMPLE_S24_32LE,  AFMT_S24_LE     },
+  { PA_SAMPLE_S24_32BE,  AFMT_S24_BE     },
+  { PA_SAMPLE_S24LE,     AFMT_S24_PACKED },
+  { PA_SAMPLE_FLOAT32NE, AFMT_FLOAT      },
+  { PA_SAMPLE_U8,        AFMT_U8         },
+  { PA_SAMPLE_ULAW,      AFMT_MU_LAW     },
+  { PA_SAMPLE_ALAW,      AFMT_A_LAW      }
+};
+
+/*
+ * returns new parameter block, initialized with defaults
+ */
+dsp_params_t* dsp_params_new(void) {
+  dsp_params_t* result;
+
+  result = (dsp_params_t*) g_malloc0(sizeof(dsp_params_t));
+  result->frequency = DEFAULT_SPEED / 60.0;
+  result->meter = DEFAULT_METER;
+  result->accents[0] = 1;
+  result->subdivision = 1;
+  result->subgain = DEFAULT_SUBBEAT_VOLUME / 100.0;
+  result->quantize = DSP_QUANTIZE_NOW;
+
+  return result;
+}
+
+/*
+ * returns (deep) copy of specified parameter block
+ */
+dsp_params_t* dsp_params_copy(const dsp_params_t* params) {
+  dsp_params_t* result;
+  int i;
+
+  result = (dsp_params_t*) g_malloc(sizeof(dsp_params_t));
+  memcpy(result, params, sizeof(dsp_params_t));
+  if (params->soundname)
+    result->soundname = g_strdup(params->soundname);
+  for (i = 0; i < MAX_METER; i++) {
+    if (params->sounds[i])
+      result->sounds[i] = g_strdup(params->sounds[i]);
+  }
+  if (params->subsound)
+    result->subsound = g_strdup(params->subsound);
+  for (i = 0; i < DSP_MAX_LAYERS; i++) {
+    if (params->layers[i].soundname)
+      result->layers[i].soundname = g_strdup(params->layers[i].soundname);
+  }
+  result->voices_acquired = 0;
+
+  return result;
+}
+
+/*
+ * destroys parameter block
+ */
+void dsp_params_delete(dsp_params_t* params) {
+  int i;
+
+  if (params->soundname) free(params->soundname);
+  for (i = 0; i < MAX_METER; i++) {
+    if (params->sounds[i]) free(params->sounds[i]);
+  }
+  if (params->subsound) free(params->subsound);
+  for (i = 0; i < DSP_MAX_LAYERS; i++) {
+    if (params->layers[i].soundname) free(params->layers[i].soundname);
+  }
+  free(params);
+}
+
+/*
+ * sets the pulse layers of <params> from specification <layers>:
+ * layers separated by ';', each as accents (one character per pulse:
+ * '1' accentuated, '-' off, else normal), optionally followed by ','
+ * and the sound of the layer, e.g. "100;10000,<sine>"
+ *
+ * returns 0 on success, -1 otherwise (params unchanged then)
+ */
+int dsp_params_set_layers(dsp_params_t* params, const char* layers)
+{
+  dsp_layer_t result[DSP_MAX_LAYERS];
+  char* copy = strdup(layers);
+  char* state;
+  char* layer;
+  int n = 0;
+  int i;
+
+  memset(result, 0, sizeof(result));
+  for (layer = strtok_r(copy, ";", &state);
+       layer;
+       layer = strtok_r(NULL, ";", &state))
+  {
+    char* sound = strchr(layer, ',');
+    int pulses;
+
+    if (sound)
+      *sound++ = '\0';
+    pulses = strlen(layer);
+    if (n == DSP_MAX_LAYERS || pulses == 0 || pulses > MAX_METER)
+      break;
+
+    result[n].pulses = pulses;
+    for (i = 0; i < pulses; i++) {
+      result[n].accents[i] = layer[i] == '1' ? DSP_BEAT_ACCENT :
+                             layer[i] == '-' ? DSP_BEAT_OFF : DSP_BEAT_NORMAL;
+    }
+    if (sound && *sound)
+      result[n].soundname = strdup(sound);
+    result[n].gain = 1.0;
+    n++;
+  }
+
+  if (layer) { /* stopped on error */
+    for (i = 0; i < n; i++) {
+      if (result[i].soundname) free(result[i].soundname);
+    }
+    free(copy);
+    return -1;
+  }
+
+  for (i = 0; i < DSP_MAX_LAYERS; i++) {
+    if (params->layers[i].soundname) free(params->layers[i].soundname);
+  }
+  memcpy(params->layers, result, sizeof(result));
+  params->n_layers = n;
+  free(copy);
+
+  return 0;
+}
+
+/*
+ * sets the tempo ramp of <params> from specification <ramp>:
+ * "<shape> <target BPM> <length> <unit>" with shape "linear" or
+ * "exponential" and unit "bars" or "seconds", e.g. "linear 160 16 bars";
+ * an empty specification switches the ramp off
+ *
+ * the ramp starts at params->frequency
+ *
+ * returns 0 on success, -1 otherwise (params unchanged then)
+ */
+int dsp_params_set_ramp(dsp_params_t* params, const char* ramp)
+{
+  char shape[16];
+  char unit[16];
+  double target;
+  double length;
+  int n;
+
+  if (ramp[strspn(ramp, " \t")] == '\0') {
+    params->ramp_target = 0.0;
+    return 0;
+  }
+
+  if (sscanf(ramp, " %15s %lf %lf %15s %n", shape, &target, &length, unit, &n)
+      < 4)
+  {
+    return -1;
+  }
+
+  if (ramp[n] != '\0' || target < MIN_BPM || target > MAX_BPM || length <= 0.0)
+    return -1;
+
+  if (!strcmp(shape, "linear"))
+    params->ramp_shape = DSP_RAMP_LINEAR;
+  else if (!strcmp(shape, "exponential"))
+    params->ramp_shape = DSP_RAMP_EXPONENTIAL;
+  else
+    return -1;
+
+  if (!strcmp(unit, "bars"))
+    params->ramp_unit = DSP_RAMP_BARS;
+  else if (!strcmp(unit, "seconds"))
+    params->ramp_unit = DSP_RAMP_SECONDS;
+  else
+    return -1;
+
+  params->ramp_target = target / 60.0;
+  params->ramp_length = length;
+
+  return 0;
+}
+
+/*
+ * returns new channel map from specification <spec>: the bus of each
+ * channel, separated by ',': "click", "cue" (accentuated ticks), "pulse"
+ * (sync pulse), "track" (backing track) or "none", e.g.
+ * "click,click,cue,pulse"
+ *
+ * returns NULL on error
+ */
+dsp_channel_map_t* dsp_channel_map_new(const char* spec)
+{
+  static const char* names[DSP_BUSES] = {
+    [DSP_BUS_SILENCE] = "none", [DSP_BUS_CLICK] = "click",
+    [DSP_BUS_CUE] = "cue", [DSP_BUS_PULSE] = "pulse",
+    [DSP_BUS_TRACK] = "track"
+  };
+  dsp_channel_map_t* result;
+  char* copy = strdup(spec);
+  char* state;
+  char* channel;
+  int bus = 0;
+
+  result = (dsp_channel_map_t*) g_malloc0(sizeof(dsp_channel_map_t));
+  for (channel = strtok_r(copy, ", \t", &state);
+       channel;
+       channel = strtok_r(NULL, ", \t", &state))
+  {
+    for (bus = 0; bus < DSP_BUSES && strcmp(channel, names[bus]); bus++);
+    if (bus == DSP_BUSES || result->channels == DSP_MAX_CHANNELS)
+      break;
+    result->buses[result->channels++] = bus;
+  }
+  free(copy);
+
+  if (channel || result->channels == 0) { /* stopped on error */
+    free(result);
+    return NULL;
+  }
+  return result;
+}
+
+void dsp_channel_map_delete(dsp_channel_map_t* map)
+{
+  free(map);
+}
+
 /*
  * returns new dsp object
  */
@@ -113,6 +392,9 @@ dsp_t* dsp_new(comm_t* comm) {
 
   result = (dsp_t*) g_malloc0(sizeof(dsp_t));
   result->dspfd = -1;
+  result->params = dsp_params_new();
+  result->params->soundname = strdup(DEFAULT_SAMPLE_FILENAME);
+  result->fixed_point = MIXER_FIXED_POINT;
   comm_server_register(comm);
   result->inter_thread_comm = comm;
 
@@ -125,19 +407,43 @@ dsp_t* dsp_new(comm_t* comm) {
 void dsp_delete(dsp_t* dsp) {
   comm_server_unregister(dsp->inter_thread_comm);
   if (dsp->devicename) free(dsp->devicename);
-  if (dsp->soundname) free(dsp->soundname);
+  if (dsp->soundsystem) free(dsp->soundsystem);
+  if (dsp->params) dsp_params_delete(dsp->params);
+  if (dsp->pending) dsp_params_delete(dsp->pending);
+  if (dsp->timeline) timeline_delete(dsp->timeline);
+  if (dsp->clock) midiclock_delete(dsp->clock);
+  if (dsp->master) midiclock_delete(dsp->master);
+  if (dsp->pll) pll_delete(dsp->pll);
+  if (dsp->netsync) netsync_delete(dsp->netsync);
+  if (dsp->beatshm) beatshm_delete(dsp->beatshm);
+  if (dsp->fanout) fanout_delete(dsp->fanout);
+  if (dsp->backing) backing_delete(dsp->backing);
+  if (dsp->channel_map) dsp_channel_map_delete(dsp->channel_map);
   free(dsp);
 }
 
 /*
- * Writes the specified <sample> (16 bit signed) to raw buffer <dest> with
- * specified <format> (see formats, above)
+ * sends response <type> with <body> (taken over) to the client, unless
+ * nobody reads it: rendering offline or dsp->quiet
  */
-static void encode_sample(short sample, int format, unsigned char* dest)
+static void send_response(dsp_t* dsp, message_type_t type, void* body)
 {
-  static int error = 0;
+  if (dsp->offline || dsp->quiet) {
+    if (body)
+      free(body);
+  } else {
+    comm_server_send_response(dsp->inter_thread_comm, type, body);
+  }
+}
 
-  switch (format) {
+/*
+ * Writes the specified <sample> (16 bit signed) to raw buffer <dest> with
+ * the format of <dsp> (see formats, above), 32 bit formats are encoded by
+ * encode_fragment() only
+ */
+static void encode_sample(dsp_t* dsp, short sample, unsigned char* dest)
+{
+  switch (dsp->format) {
   case AFMT_MU_LAW:
     *dest = linear2ulaw(sample);
     break;
@@ -145,10 +451,10 @@ static void encode_sample(short sample, int format, unsigned char* dest)
     *dest = linear2alaw(sample);
     break;
   case AFMT_IMA_ADPCM:
-    if (!error) {
+    if (!(dsp->reported & DSP_REPORTED_FORMAT)) {
       fprintf(stderr, "NOTE: Can't generate samples due to still unsupported "
 	              "format (AFMT_IMA_ADPCM).\n");
-      error = 1;
+      dsp->reported |= DSP_REPORTED_FORMAT;
     }
     *dest = 0;
     break;
@@ -163,6 +469,11 @@ static void encode_sample(short sample, int format, unsigned char* dest)
     *dest = (unsigned char) (sample >> 8 & 0xff);
     *(dest + 1) = (unsigned char) (sample & 0xff);
     break;
+  case AFMT_S24_PACKED:
+    *dest = 0;
+    *(dest + 1) = (unsigned char) (sample & 0xff);
+    *(dest + 2) = (unsigned char) (sample >> 8 & 0xff);
+    break;
   case AFMT_U16_LE:
     *dest = (unsigned char) ((sample ^ 0x8000) & 0xff);
     *(dest + 1) = (unsigned char) ((sample ^ 0x8000) >> 8 & 0xff);
@@ -172,167 +483,116 @@ static void encode_sample(short sample, int format, unsigned char* dest)
     *(dest + 1) = (unsigned char) ((sample ^ 0x8000) & 0xff);
     break;
   default:
-    if (!error) {
+    if (!(dsp->reported & DSP_REPORTED_FORMAT)) {
       fprintf(stderr,
 	      "NOTE: Can't generate samples due to unsupported format.\n");
-      error = 1;
+      dsp->reported |= DSP_REPORTED_FORMAT;
     }
   }
 }
 
 /*
- * returns x if x < limit, else (limit - 1); thus it returns an exclusively
- * limited value
+ * converts the first <frames> of the accumulator to the sample format of the
+ * device in <dest>, clipping overloaded samples
  */
-static int limit_int(int x, int limit) {
-  if (x < limit)
-    return x;
-  else
-    return limit - 1;
-}
-
-/*
- * Generates Audio data fit for playback on initialized DSP, parameters of
- * which are stored in dsp
- *
- * input:
- *     from:          the sample data source in signed 16 bit format
- *     from_size:     number of frames in <from>
- *     from_rate:     the rate of <from>
- *     from_channels: number of channels in <from>
- *     dsp:           the dsp_t structure holding rate, channels, samplesize
- *                    and format of the initialized dsp
- *
- * output:
- *     to:            the pointer to the allocated data, ready for playback
- *     return value:  number of bytes generated, -1 on error
- *
- * NOTES:
- *  - If fromchannels equals the number of channels of playback device,
- *    no mixing is performed.
- *    Else (fromchannels != channels), the input is mixed down to 1 channel
- *    which is equally directed to all output channels
- *  - <to> will be allocated by generate_data, but has to be free()d by caller
- */
-static int generate_data(short* from,
-                         int from_size, int from_rate, int from_channels,
-                         dsp_t* dsp, unsigned char** to)
-{
-  double speed_factor = (double) from_rate / dsp->rate; /* output to input */
-  int result_size = (long long)from_size * dsp->rate / from_rate; /* number of frames */
-  unsigned char* result;
-  int i, j;
-
-  result = (unsigned char*)
-	  g_malloc(result_size * dsp->samplesize / 8 * dsp->channels);
-
-  for (i = 0; i < result_size; i++) { /* for each output frame */
-    double mixdown = 0.0; /* only needed if dsp->channels != from_channels */
-
-    if (dsp->channels != from_channels) { /* mixdown */
-      double leftbound = i * speed_factor;
-      double rightbound = (i + 1) * speed_factor;
-
-      while (leftbound < rightbound) {
-	int index = (int)leftbound;
-	double dummy;
-	double frac = modf(leftbound, &dummy);
-        double weight;
-
-	if (rightbound - leftbound < 1)
-	  weight = rightbound - leftbound;
-	else
-	  weight = 1.0;
-
-        for (j = 0; j < from_channels; j++) {
-	  mixdown += weight * (
-	      (1.0 - frac) * from[from_channels * index + j] +
-	      frac * from[from_channels * limit_int(index + 1, from_size) + j]);
-        }
-
-	leftbound += 1.0;
-      }
-      mixdown /= (speed_factor * from_channels);
-    }
-    for (j = 0; j < dsp->channels; j++) { /* for each channel */
-      double sample;
-
-      if (dsp->channels != from_channels) {
-	sample = mixdown;
-      } else {
-        double leftbound = i * speed_factor;
-        double rightbound = (i + 1) * speed_factor;
-
-	sample = 0.0;
-        while (leftbound < rightbound) {
-	  int index = (int)leftbound;
-	  double dummy;
-	  double frac = modf(leftbound, &dummy);
-          double weight;
-
-	  if (rightbound - leftbound < 1)
-	    weight = rightbound - leftbound;
-	  else
-	    weight = 1.0;
-
-	  sample += weight * (
-	      (1.0 - frac) * from[from_channels * index + j] +
-	      frac * from[from_channels * limit_int(index + 1, from_size) + j]);
-
-	  leftbound += 1.0;
-        }
-        sample /= speed_factor;
-      }
-
-      encode_sample((short) (sample * dsp->volume), dsp->format,
-          &result[(i * dsp->channels + j) * dsp->samplesize / 8]);
+static void encode_fragment(dsp_t* dsp, unsigned char* dest, int frames)
+{
+  int n = frames * dsp->channels;
+  int i;
 
+  switch (dsp->format) {
+  case AFMT_S16_LE:
+    mixer_encode_s16_le(dest, dsp->mix, n);
+    break;
+  case AFMT_S16_BE:
+    mixer_encode_s16_be(dest, dsp->mix, n);
+    break;
+  case AFMT_S32_LE:
+    mixer_encode_s32_le(dest, dsp->mix, n, 32);
+    break;
+  case AFMT_S32_BE:
+    mixer_encode_s32_be(dest, dsp->mix, n, 32);
+    break;
+  case AFMT_S24_LE:
+    mixer_encode_s32_le(dest, dsp->mix, n, 24);
+    break;
+  case AFMT_S24_BE:
+    mixer_encode_s32_be(dest, dsp->mix, n, 24);
+    break;
+  case AFMT_FLOAT:
+    mixer_encode_float((float*) dest, dsp->mix, n);
+    break;
+  default:
+    for (i = 0; i < n; i++) {
+      encode_sample(dsp, mixer_saturate(dsp->mix[i]),
+	            &dest[i * dsp->samplesize / 8]);
     }
   }
-
-  *to = result;
-  return result_size * dsp->channels * dsp->samplesize / 8;
 }
 
 /*
- * generates sine signal
- *
- * input:   samplefreq: sampling frequency, (e.g. 44100) in Hz
- *          sinfreq:    frequency of sine (e.g. 440.0) in Hz
- *          sigdur:     duration of signal in seconds
- *          fadedur:    duration of fadein / fadeout in seconds
- * output:  samples:    buffer containing the (signed short) samples
+ * generates square sync pulse: <duration> seconds of full level at
+ * <samplefreq> (e.g. 44100) in Hz, without any ramp so the edge is at the
+ * first frame
  *
- * returns: number of samples returned in <samples>,
- *          -1 on error
+ * returns number of samples returned in <samples>
  *
  * NOTE: caller has to free *samples himself
  */
-int generate_sine(int samplefreq, double sinfreq, double sigdur, double fadedur,
-                  short** samples)
+static int generate_pulse(int samplefreq, double duration, short** samples)
 {
-  int size = samplefreq * sigdur;
+  int size = samplefreq * duration;
   short* s = (short*) g_malloc(size * sizeof(short));
-  int scale = -SHRT_MIN < SHRT_MAX ? -SHRT_MIN : SHRT_MAX;
   int i;
-  double sample;
 
-  for (i = 0; i < size; i++) {
-    sample = sin((double)i / samplefreq * sinfreq * 2 * M_PI);
-    if (i < samplefreq * fadedur)
-      sample *= (-cos((double)i / (samplefreq * sigdur) * 2 * M_PI) + 1) * 0.5;
-    if (i > samplefreq * (sigdur - fadedur))
-      sample *=
-	(-cos((double)(size - i) / (samplefreq * sigdur) * 2 * M_PI) + 1) * 0.5;
-    s[i] = sample * scale;
-  }
+  for (i = 0; i < size; i++)
+    s[i] = SHRT_MAX;
 
   *samples = s;
   return size;
 }
 
 /*
- * returns (unsigned short) samples from specified file
+ * search for the end of a sound: the first SILENCE_DURATION of silence
+ * after the sound started
+ */
+typedef struct silence_t {
+  int started;   /* frame above SILENCE_LEVEL found */
+  int run;       /* number of silent frames in a row */
+} silence_t;
+
+/*
+ * continues the search of <silence> in frames <pos> ... <pos> + <n> - 1 of
+ * <frames> (<channels> channels), a sound ending after <run> silent frames
+ *
+ * returns number of frames of the sound up to its first silent frame, -1 if
+ * not found yet
+ */
+static int find_sound_end(silence_t* silence, const short* frames,
+                          int pos, int n, int channels, int run)
+{
+  int i, c;
+
+  for (i = pos; i < pos + n; i++) {
+    int loud = 0;
+
+    for (c = 0; c < channels; c++)
+      loud |= abs(frames[i * channels + c]) > SILENCE_LEVEL;
+    if (loud) {
+      silence->started = 1;
+      silence->run = 0;
+    } else if (silence->started && ++silence->run == run) {
+      return i + 1 - run;
+    }
+  }
+  return -1;
+}
+
+/*
+ * returns (signed short) samples from specified file, decoded in chunks of
+ * SNDFILE_CHUNK frames up to the end of the sound (see find_sound_end()),
+ * at most VOICE_MAX_DURATION: memory stays bounded for long files and
+ * streams
  *
  * input: filename: file to read samples from, must be in a format
  *                  recognized by libsndfile
@@ -346,158 +606,361 @@ int generate_sine(int samplefreq, double sinfreq, double sigdur, double fadedur,
  * NOTE: caller has to free *samples himself
  */
 #ifdef WITH_SNDFILE
-int sndfile_get_samples(const char* filename,
-                        short** samples, int* rate, int* channels)
+static int sndfile_get_samples(const char* filename,
+                               short** samples, int* rate, int* channels)
 {
   SF_INFO sfinfo;
   SNDFILE* sf;
-  int frames;
+  silence_t silence = { 0, 0 };
+  short* result;
+  int frames = 0;
+  int end = -1;
+  int max_frames;
+  int size;
 
   sfinfo.format = 0;
-  if (!(sf = sf_open(filename, SFM_READ, &sfinfo))) {
-    if (debug)
-      fprintf(stderr, "Error opening file \"%s\".\n", filename);
+  if (!(sf = sf_open(filename, SFM_READ, &sfinfo)))
     return -1;
+  if (sfinfo.channels < 1 || sfinfo.samplerate < 1) {
+    sf_close(sf);
+    return -1;
+  }
+
+  max_frames = sfinfo.samplerate * VOICE_MAX_DURATION;
+  size = sfinfo.frames > 0 && sfinfo.frames < max_frames ?
+         sfinfo.frames : MIN(SNDFILE_CHUNK, max_frames);
+  result = (short*) g_malloc(size * sfinfo.channels * sizeof(short));
+
+  while (end == -1 && frames < max_frames) {
+    sf_count_t n;
+
+    if (frames == size) {
+      size = MIN(size * 2, max_frames);
+      result = (short*) g_realloc(result,
+                                  size * sfinfo.channels * sizeof(short));
+    }
+    n = sf_readf_short(sf, result + frames * sfinfo.channels,
+                       MIN(SNDFILE_CHUNK, size - frames));
+    if (n <= 0)
+      break;
+    end = find_sound_end(&silence, result, frames, n, sfinfo.channels,
+                         sfinfo.samplerate * SILENCE_DURATION);
+    frames += n;
   }
-  if (!sfinfo.seekable)
+  sf_close(sf);
+
+  if (end != -1)
+    frames = end;
+  if (frames == 0) {
+    free(result);
     return -1;
+  }
 
-  frames = sfinfo.frames;
+  *samples = (short*) g_realloc(result,
+                                frames * sfinfo.channels * sizeof(short));
   *rate = sfinfo.samplerate;
-  *channels = sfinfo.channels ;
+  *channels = sfinfo.channels;
+  return frames;
+}
+#endif /* WITH_SNDFILE */
 
-  *samples = (short*) g_malloc(frames * sizeof(short) * sfinfo.channels);
+/*
+ * maps WAV file <filename> with frames usable as they are, without any
+ * decoding, to dsp->frames, up to the end of the sound (see
+ * find_sound_end()), at most VOICE_MAX_DURATION
+ *
+ * returns number of frames, -1 if <filename> needs decoding
+ */
+static int map_samples(dsp_t* dsp, const char* filename)
+{
+  wavmap_t* map = wavfile_map(filename);
+  silence_t silence = { 0, 0 };
+  int frames;
+  int end;
 
-  sf_readf_short(sf, *samples, frames);
+  if (!map)
+    return -1;
+  frames = MIN(map->n, map->rate * VOICE_MAX_DURATION);
+  end = find_sound_end(&silence, map->frames, 0, frames, map->channels,
+                       map->rate * SILENCE_DURATION);
+  if (end != -1)
+    frames = end;
+  if (frames == 0) {
+    wavfile_unmap(map);
+    return -1;
+  }
 
-  sf_close(sf);
+  dsp->frames_map = map;
+  dsp->frames = map->frames;
+  dsp->rate_in = map->rate;
+  dsp->channels_in = map->channels;
   return frames;
 }
-#endif /* WITH_SNDFILE */
 
 /*
- * allocates and initializes dsp->frames
- * and initializes dsp->number_of_frames
- * according to dsp->soundname
+ * frees (or unmaps) dsp->frames
+ */
+static void free_frames(dsp_t* dsp)
+{
+  if (dsp->frames_map) {
+    wavfile_unmap(dsp->frames_map);
+    dsp->frames_map = NULL;
+  } else if (dsp->frames) {
+    g_free((short*) dsp->frames);
+  }
+  dsp->frames = NULL;
+  if (dsp->frames_name) {
+    free(dsp->frames_name);
+    dsp->frames_name = NULL;
+  }
+}
+
+/*
+ * initializes dsp->frames (allocated, or mapped from a WAV file)
+ * and dsp->number_of_frames
+ * according to sound <name>
+ *
+ * the frames of the last loaded sound are kept for further variants
  *
  * returns 0 on success, -1 otherwise
  */
-static int init_sample(dsp_t* dsp) {
-  if (!strcmp(dsp->soundname, "<default>")) {
-    dsp->frames = (short*) g_malloc(sizeof(tickdata));
-    memcpy(dsp->frames, tickdata, sizeof(tickdata));
+static int load_sample(dsp_t* dsp, const char* name) {
+  synth_params_t synth;
+  short* frames = NULL;
+  int max_frames;
+
+  if (dsp->frames_name && !strcmp(dsp->frames_name, name))
+    return 0;
+
+  free_frames(dsp);
+
+  if (!strcmp(name, "<default>")) {
+    frames = (short*) g_malloc(sizeof(tickdata));
+    memcpy(frames, tickdata, sizeof(tickdata));
     dsp->number_of_frames = (signed int) sizeof(tickdata) / sizeof(short);
-    dsp->rate_in = 44100;
+    dsp->rate_in = TICKDATA_RATE;
     dsp->channels_in = 1;
-  } else if (!strcmp(dsp->soundname, "<sine>")) {
-    dsp->number_of_frames =
-      generate_sine(44100, SIN_FREQ, SIN_DUR, FADE_DUR, &dsp->frames);
-    dsp->rate_in = 44100;
+  } else if (synth_parse(&synth, name) == 0) { /* at device rate */
+    dsp->number_of_frames = synth_render(&synth, dsp->rate, &frames,
+                                          dsp->fixed_point);
+    dsp->rate_in = dsp->rate;
     dsp->channels_in = 1;
+  } else if (!strcmp(name, PULSE_NAME)) { /* at device rate: no resampling */
+    dsp->number_of_frames = generate_pulse(dsp->rate, PULSE_DUR, &frames);
+    dsp->rate_in = dsp->rate;
+    dsp->channels_in = 1;
+  } else if ((dsp->number_of_frames = map_samples(dsp, name)) != -1) {
+    if (dsp->debug)
+      fprintf(stderr, "Mapped %d frames of \"%s\".\n",
+              dsp->number_of_frames, name);
   } else {
 #ifdef WITH_SNDFILE
-    dsp->number_of_frames = sndfile_get_samples(dsp->soundname, &dsp->frames,
+    dsp->number_of_frames = sndfile_get_samples(name, &frames,
 	&dsp->rate_in, &dsp->channels_in);
+    if (dsp->number_of_frames == -1 && dsp->debug)
+      fprintf(stderr, "Error opening file \"%s\".\n", name);
 #else
-    fprintf(stderr, "Warning: Unhandled sample name case: \"%s\".\n",
-	    dsp->soundname);
+    fprintf(stderr, "Warning: Unhandled sample name case: \"%s\".\n", name);
+    dsp->number_of_frames = -1;
 #endif /* WITH_SNDFILE */
   }
 
   if (dsp->number_of_frames == -1)
     return -1;
+  if (!dsp->frames_map)
+    dsp->frames = frames;
+
+  /* generated sounds are bounded as well */
+  max_frames = dsp->rate_in * VOICE_MAX_DURATION;
+  if (dsp->number_of_frames > max_frames) {
+    if (dsp->debug)
+      fprintf(stderr, "Cutting sound \"%s\" to %d frames.\n", name, max_frames);
+    dsp->number_of_frames = max_frames;
+  }
+
+  dsp->frames_name = strdup(name);
 
   return 0;
 }
 
 /*
- * allocates and initializes dsp->tickdata{0,1,2}
- * and initializes dsp->td{0,1,2}_size
- * according to dsp->frames and dsp->number_of_frames
+ * sets *data to <variant> of the default tick prepared at build time for
+ * the rate of the opened device (see converter.c)
  *
- * returns 0 on success, -1 otherwise
+ * returns number of frames, -1 if not prepared for this rate
  */
-static int prepare_buffers(dsp_t* dsp) {
-  short *tmp_buf; /* temporary buffer for generation of different sounds */
-  int i;
-
-  int attack = 0;
+static int lookup_tickdata(dsp_t* dsp, voice_variant_t variant,
+                           const short** data)
+{
+  unsigned int i;
 
-  /* generate single ticks */
-  if ((dsp->td0_size = generate_data(dsp->frames, dsp->number_of_frames,
-	  dsp->rate_in, dsp->channels_in, dsp, &dsp->tickdata0)) == -1)
-  {
-    return -1;
+  for (i = 0; i < sizeof(tickdata_rates) / sizeof(tickdata_rates[0]); i++) {
+    if (tickdata_rates[i].rate == dsp->rate) {
+      *data = tickdata_rates[i].data[variant];
+      return tickdata_rates[i].frames[variant];
+    }
   }
+  return -1;
+}
 
-  /* generate first tick */
-  if ((dsp->td1_size = generate_data(dsp->frames, dsp->number_of_frames,
-	  dsp->rate_in * 2, dsp->channels_in, dsp, &dsp->tickdata1)) == -1)
-  {
-    return -1;
-  }
+/*
+ * sound bank callback: generates <variant> of sound <name>
+ * according to the opened device
+ *
+ * returns number of frames in *data, -1 on error
+ */
+static int prepare_voice(dsp_t* dsp, const char* name,
+                         voice_variant_t variant, const short** data,
+                         int* shared)
+{
+  short* result = NULL;
+  int size;
 
-  /* attack padding for accents */
-  while (attack <
-      dsp->number_of_frames && abs(dsp->frames[attack]) < SHRT_MAX / 20)
+  if (!strcmp(name, "<default>") &&
+      (size = lookup_tickdata(dsp, variant, data)) != -1)
   {
-    attack++;
+    *shared = 1;
+    return size;
   }
 
-  if (attack < dsp->number_of_frames / 3) {
-    unsigned char* newdata;
-    int offset;
+  if (load_sample(dsp, name) == -1)
+    return -1;
+
+  size = soundbank_render_variant(dsp->frames, dsp->number_of_frames,
+                                  dsp->rate_in, dsp->channels_in, variant,
+                                  dsp->rate, &result, dsp->fixed_point,
+                                  dsp->debug);
+  *data = result;
+  *shared = 0;
+  return size;
+}
 
-    offset = attack / 2 * dsp->channels * dsp->samplesize / 8;
-    if ((newdata = realloc(dsp->tickdata1, dsp->td1_size + offset))) {
-      int modul = dsp->channels * dsp->samplesize / 8;
-      int i;
+/*
+ * state of the query of the default sink of the PulseAudio server
+ */
+typedef struct pulse_query_t {
+  pa_sample_spec spec;
+  int done;              /* 1: spec of sink found, -1: failed */
+} pulse_query_t;
 
-      dsp->tickdata1 = newdata;
+static void pulse_sink_info(pa_context* context _U_, const pa_sink_info* info,
+                            int eol, void* userdata)
+{
+  pulse_query_t* query = (pulse_query_t*) userdata;
 
-      for (i = dsp->td1_size - 1; i >= 0; i--)
-	dsp->tickdata1[i + offset] = dsp->tickdata1[i];
-      for (i = 0; i < offset; i++)
-	dsp->tickdata1[i] = dsp->silence[i % modul];
+  if (info) {
+    query->spec = info->sample_spec;
+    query->done = 1;
+  } else if (eol && !query->done) {
+    query->done = -1;
+  }
+}
 
-      dsp->td1_size += offset;
+static void pulse_server_info(pa_context* context, const pa_server_info* info,
+                              void* userdata)
+{
+  pulse_query_t* query = (pulse_query_t*) userdata;
+  pa_operation* operation;
 
-      if (debug)
-        fprintf(stderr, "Attack padding for accents: %d frames.\n", attack / 2);
-    }
+  if (!info || !info->default_sink_name ||
+      !(operation = pa_context_get_sink_info_by_name(context,
+          info->default_sink_name, pulse_sink_info, query)))
+  {
+    query->done = -1;
+    return;
   }
+  pa_operation_unref(operation);
+}
 
-  /* generate secondary ticks */
-  tmp_buf = (short*) g_malloc(dsp->number_of_frames * sizeof(short));
-  for (i = 0; i < dsp->number_of_frames; i++) {
-    tmp_buf[i] = dsp->frames[i] / 2;
+static void pulse_context_state(pa_context* context, void* userdata)
+{
+  pulse_query_t* query = (pulse_query_t*) userdata;
+  pa_operation* operation;
+
+  switch (pa_context_get_state(context)) {
+  case PA_CONTEXT_READY:
+    if ((operation =
+           pa_context_get_server_info(context, pulse_server_info, query)))
+      pa_operation_unref(operation);
+    else
+      query->done = -1;
+    break;
+  case PA_CONTEXT_FAILED:
+  case PA_CONTEXT_TERMINATED:
+    query->done = -1;
+    break;
+  default:
+    break;
   }
-  if ((dsp->td2_size = generate_data(tmp_buf, dsp->number_of_frames,
-	  dsp->rate_in, dsp->channels_in, dsp, &dsp->tickdata2)) == -1)
-  {
+}
+
+/*
+ * queries the sample format, rate and channels of the default sink of the
+ * PulseAudio server to <spec>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int pulse_query_sink(pa_sample_spec* spec)
+{
+  pulse_query_t query = { { PA_SAMPLE_INVALID, 0, 0 }, 0 };
+  pa_mainloop* mainloop;
+  pa_context* context;
+
+  if (!(mainloop = pa_mainloop_new()))
     return -1;
+  if ((context = pa_context_new(pa_mainloop_get_api(mainloop),
+                                "GTick metronome")))
+  {
+    pa_context_set_state_callback(context, pulse_context_state, &query);
+    if (pa_context_connect(context, NULL, PA_CONTEXT_NOAUTOSPAWN, NULL) < 0)
+      query.done = -1;
+    while (!query.done && pa_mainloop_iterate(mainloop, 1, NULL) >= 0);
+    pa_context_disconnect(context);
+    pa_context_unref(context);
   }
-  free(tmp_buf);
+  pa_mainloop_free(mainloop);
 
+  if (query.done != 1)
+    return -1;
+  *spec = query.spec;
   return 0;
 }
 
 /*
- * Opens pulseaudio connection
+ * Opens pulseaudio connection in the sample format, rate and channels of
+ * the default sink, so the server doesn't convert the stream
  *
  * returns 0 on success, -1 otherwise
  */
 static int pulse_open(dsp_t *dsp)
 {
-  static int debug_todo = 1;
+  int verbose = dsp->debug && !(dsp->reported & DSP_REPORTED_OPEN);
   /* The Sample format to use */
-  static const pa_sample_spec pulse_format = {
+  pa_sample_spec pulse_format = {
       .format = PA_SAMPLE_S16LE, /* DEFAULT_FORMAT */
       .rate = DEFAULT_RATE,
       .channels = DEFAULT_CHANNELS
   };
+  pa_sample_spec sink;
   int error;
   unsigned int format_index;
+  unsigned int i;
+
+  dsp->format = DEFAULT_FORMAT;
+  if (pulse_query_sink(&sink) == 0) {
+    for (i = 0; i < sizeof(pulse_formats) / sizeof(pulse_formats[0]); i++) {
+      if (pulse_formats[i].pulse == sink.format) {
+        pulse_format.format = sink.format;
+        dsp->format = pulse_formats[i].format;
+      }
+    }
+    pulse_format.rate = sink.rate;
+    pulse_format.channels = sink.channels;
+  } else if (verbose) {
+    g_print("pulse_open: Couldn't query default sink, using defaults\n");
+  }
+  if (dsp->channels_requested)
+    pulse_format.channels = dsp->channels_requested;
 
   dsp->pas = NULL;
   /* Create a new playback stream */
@@ -506,58 +969,101 @@ static int pulse_open(dsp_t *dsp)
     return -1;
   }
 
-  dsp->format = DEFAULT_FORMAT;
   for (format_index = 0;
        formats[format_index].format != 0 &&
        formats[format_index].format != dsp->format;
        format_index++);
 
-  if (debug && debug_todo) {
+  if (verbose) {
     g_print("pulse_open: Used sample format: %s (%s)\n",
     formats[format_index].name, formats[format_index].description);
   }
 
-  dsp->rate = DEFAULT_RATE; /* requested default */
-  if (debug && debug_todo) {
+  dsp->rate = pulse_format.rate;
+  if (verbose) {
     g_print("pulse_open: Sampling rate = %d\n", dsp->rate);
   }
 
-  dsp->channels = DEFAULT_CHANNELS;
-  if (debug && debug_todo) {
+  dsp->channels = pulse_format.channels;
+  if (verbose) {
     g_print("pulse_open: Number of channels = %d\n", dsp->channels);
   }
 
   dsp->samplesize = formats[format_index].samplesize;
   dsp->fragmentsize = dsp->rate / 10 /*0.1s fragment time*/ * dsp->channels * dsp->samplesize / 8;
 
-  if (debug && debug_todo)
+  if (verbose)
     g_print ("pulse_open: fragment size = %d\n", dsp->fragmentsize);
 
   dsp->fragment = g_malloc(dsp->fragmentsize);
 
+  dsp->reported |= DSP_REPORTED_OPEN;
   return 0;
 }
 
 /*
- * Opens sound device specified in dsp
+ * sets <rate> and <channels> to the nearest ones the device (<fd>) supports
+ * natively, as reported by the OSS 4 driver
  *
- * returns 0 on success, -1 otherwise
+ * returns 0 on success, -1 if the driver doesn't report them (e.g. OSS 3)
  */
-int dsp_open(dsp_t* dsp) {
-  static int debug_todo = 1;
-  unsigned int format_index;
-  int requested_format = DEFAULT_FORMAT;
-  audio_buf_info info;
+static int native_parameters(int fd _U_, int* rate _U_, int* channels _U_)
+{
+#ifdef SNDCTL_ENGINEINFO
+  oss_audioinfo info;
+  unsigned int i;
 
-  dsp->fragmentsize = 0x7fff0008; /* at least request fragment size 2^8=256 */
-                                    /* = minimum recommended size */
-  if (debug && debug_todo)
-    g_print ("dsp_open: Initialising %s ...\n", dsp->devicename);
+  info.dev = -1; /* the device opened as <fd> */
+  if (ioctl(fd, SNDCTL_ENGINEINFO, &info) == -1)
+    return -1;
 
-  /* Initialise sound device */
-  if(!strcmp(dsp->soundsystem, "<pulseaudio>"))
-    return pulse_open(dsp);
-  else if ((dsp->dspfd = open(dsp->devicename, O_WRONLY)) == -1)
+  if (info.nrates > 0) {
+    int nearest = info.rates[0];
+
+    for (i = 1; i < info.nrates && i < sizeof(info.rates) / sizeof(int); i++)
+    {
+      if (abs((int) info.rates[i] - *rate) < abs(nearest - *rate))
+        nearest = info.rates[i];
+    }
+    *rate = nearest;
+  } else if (info.max_rate > 0) {
+    *rate = CLAMP(*rate, info.min_rate, info.max_rate);
+  }
+  if (info.max_channels > 0)
+    *channels = CLAMP(*channels, info.min_channels, info.max_channels);
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+/*
+ * Opens sound device specified in dsp
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int dsp_open(dsp_t* dsp) {
+  int verbose = dsp->debug && !(dsp->reported & DSP_REPORTED_OPEN);
+  unsigned int format_index;
+  int requested_format = DEFAULT_FORMAT;
+  const int* formats_used = preferred_formats; /* by preference */
+  unsigned int n_formats = sizeof(preferred_formats) / sizeof(int);
+  int native = 0; /* no conversions in the driver */
+  int requested_rate = DEFAULT_RATE;
+  int requested_channels;
+  audio_buf_info info;
+  unsigned int i;
+  int mask;
+
+  dsp->fragmentsize = 0x7fff0008; /* at least request fragment size 2^8=256 */
+                                    /* = minimum recommended size */
+  if (verbose)
+    g_print ("dsp_open: Initialising %s ...\n", dsp->devicename);
+
+  /* Initialise sound device */
+  if(!strcmp(dsp->soundsystem, "<pulseaudio>"))
+    return pulse_open(dsp);
+  else if ((dsp->dspfd = open(dsp->devicename, O_WRONLY)) == -1)
     {
       perror(dsp->devicename);
       return -1;
@@ -568,20 +1074,41 @@ int dsp_open(dsp_t* dsp) {
     return -1;
   }
 
-  /* Query driver for supported formats for debugging convenience */
-  if (debug && debug_todo) {
-    unsigned int i;
-    int mask;
-
-    if (ioctl(dsp->dspfd, SNDCTL_DSP_GETFMTS, &mask) == -1) {
-      perror("SNDCTL_DSP_GETFMTS");
+#ifdef SNDCTL_DSP_COOKEDMODE
+  /* OSS 4: no conversions in the driver, only formats and rates of the
+     device are offered and set */
+  {
+    int cooked = 0;
+
+    if (ioctl(dsp->dspfd, SNDCTL_DSP_COOKEDMODE, &cooked) == -1) {
+      if (verbose)
+        perror("SNDCTL_DSP_COOKEDMODE");
+    } else {
+      native = 1;
+      formats_used = native_formats;
+      n_formats = sizeof(native_formats) / sizeof(int);
     }
+  }
+#endif
+
+  /* Query driver for supported formats, using the preferred one */
+  if (ioctl(dsp->dspfd, SNDCTL_DSP_GETFMTS, &mask) == -1) {
+    perror("SNDCTL_DSP_GETFMTS");
+    mask = 0;
+  }
+  if (verbose) {
     g_print("Supported formats:\n");
     for (i = 0; i < sizeof(formats) / sizeof(format_t); i++) {
       if (mask & formats[i].format)
 	g_print("  %s (%s)\n", formats[i].name, formats[i].description);
     }
   }
+  for (i = 0; i < n_formats; i++) {
+    if (mask & formats_used[i]) {
+      requested_format = formats_used[i];
+      break;
+    }
+  }
 
   /* set up output format */
   dsp->format = requested_format;
@@ -596,30 +1123,39 @@ int dsp_open(dsp_t* dsp) {
       formats[format_index].format != dsp->format;
     format_index++);
 
-  if (debug && debug_todo) {
+  if (verbose) {
     g_print("dsp_open: Used sample format: %s (%s)\n",
 	    formats[format_index].name, formats[format_index].description);
   }
 
   dsp->samplesize = formats[format_index].samplesize;
 
-  /* Set dsp to default: mono */
-  dsp->channels = DEFAULT_CHANNELS;
+  /* Set dsp to default: mono, unless requested otherwise, and rate to
+     default, both the nearest native ones without conversions */
+  requested_channels =
+    dsp->channels_requested ? dsp->channels_requested : DEFAULT_CHANNELS;
+  if (native &&
+      native_parameters(dsp->dspfd, &requested_rate,
+                        &requested_channels) == -1 && verbose)
+  {
+    g_print("dsp_open: Native rates and channels not reported.\n");
+  }
+  dsp->channels = requested_channels;
   if (ioctl (dsp->dspfd, SNDCTL_DSP_CHANNELS, &dsp->channels) == -1) {
     perror("SNDCTL_DSP_CHANNELS");
     return -1;
   }
-  if (debug && debug_todo) {
+  if (verbose) {
     g_print("dsp_open: Number of channels = %d\n", dsp->channels);
   }
 
   /* Set the DSP rate (in Hz) */
-  dsp->rate = DEFAULT_RATE; /* requested default */
+  dsp->rate = requested_rate;
   if (ioctl (dsp->dspfd, SNDCTL_DSP_SPEED, &dsp->rate) == -1) {
     perror("SNDCTL_DSP_SPEED");
     return -1;
   }
-  if (debug && debug_todo) {
+  if (verbose) {
     g_print("dsp_open: Sampling rate = %d\n", dsp->rate);
   }
 
@@ -630,7 +1166,7 @@ int dsp_open(dsp_t* dsp) {
     perror("SNDCTL_DSP_GETBLKSIZE");
   }
 
-  if (debug && debug_todo)
+  if (verbose)
     g_print ("dsp_open: fragment size = %d\n", dsp->fragmentsize);
 
   dsp->fragment = g_malloc(dsp->fragmentsize);
@@ -640,11 +1176,11 @@ int dsp_open(dsp_t* dsp) {
     perror("SNDCTL_DSP_GETOSPACE");
   }
   dsp->fragstotal = info.fragstotal;
-  if (debug && debug_todo)
+  if (verbose)
     g_print("dsp_open: Total number of fragments in DSP buffer = %d.\n",
 	    dsp->fragstotal);
 
-  debug_todo = 0;
+  dsp->reported |= DSP_REPORTED_OPEN;
   return 0;
 }
 
@@ -652,9 +1188,7 @@ int dsp_open(dsp_t* dsp) {
  * close sound device
  */
 void dsp_close(dsp_t* dsp) {
-  static int debug_todo = 1;
-
-  if (debug && debug_todo)
+  if (dsp->debug && !(dsp->reported & DSP_REPORTED_CLOSE))
     g_print ("dsp_close: Closing sound device ...\n");
   if (dsp->dspfd != -1) {
     if (ioctl(dsp->dspfd, SNDCTL_DSP_RESET, 0) == -1) {
@@ -673,330 +1207,1727 @@ void dsp_close(dsp_t* dsp) {
     dsp->pas = NULL;
   }
 
-  debug_todo = 0;
+  dsp->reported |= DSP_REPORTED_CLOSE;
 }
 
 /*
- * Opens DSP and prepare metronome <dsp> to play
+ * returns frame in current bar at which pulse <n> of layer <l> starts
+ */
+static int pulse_offset(dsp_t* dsp, int l, int n)
+{
+  return (long long) n * dsp->params->meter * dsp->ticklen /
+         dsp->params->layers[l].pulses;
+}
+
+/*
+ * sets the pulse counters of the layers to the current position in bar,
+ * e.g. after a change of meter or speed
  *
- * returns 0 on success, -1 otherwise
+ * all layers are derived from the position of the ticks, so they never drift
  */
-int dsp_init(dsp_t* dsp)
+static void sync_layers(dsp_t* dsp)
 {
-  short silencelevel = 0;
+  long long barpos = (long long) dsp->cyclepos * dsp->ticklen + dsp->tickpos;
+  long long barlen = (long long) dsp->params->meter * dsp->ticklen;
+  int l;
 
-  if (dsp_open(dsp) == -1)
-    return -1;
+  for (l = 0; l < dsp->params->n_layers; l++)
+    dsp->pulsepos[l] = barpos * dsp->params->layers[l].pulses / barlen;
+}
 
-  dsp->frames = NULL;
-  dsp->silence = NULL;
-  dsp->tickdata0 = NULL;
-  dsp->tickdata1 = NULL;
-  dsp->tickdata2 = NULL;
+/*
+ * returns the ticking frequency at the current position of the tempo ramp
+ * of the parameters (or the constant frequency if there is no ramp)
+ *
+ * the position is counted in whole ticks or frames since the start of the
+ * ramp, so a ramp is reproduced exactly on every run
+ */
+static double ramp_frequency(dsp_t* dsp)
+{
+  dsp_params_t* params = dsp->params;
+  double progress;
 
-  /* silence */
-  generate_data(&silencelevel, 1, dsp->rate, 1, dsp, &dsp->silence);
+  if (params->ramp_target <= 0.0)
+    return params->frequency;
 
-  /* allocate and initialize dsp->frames */
-  if (init_sample(dsp) == -1) {
-    return -1;
-  }
-  /* allocate and initialize dsp->tickdata{0,1,2} */
-  if (prepare_buffers(dsp) == -1) {
-    return -1;
-  }
+  if (params->ramp_unit == DSP_RAMP_BARS)
+    progress = dsp->ramp_ticks / (params->ramp_length * params->meter);
+  else
+    progress = dsp->ramp_frames / (params->ramp_length * dsp->rate);
+  progress = MIN(progress, 1.0);
 
-  dsp->cyclepos = 0; /* init */
-  dsp->tickpos = 0;
+  if (params->ramp_shape == DSP_RAMP_EXPONENTIAL)
+    return params->frequency *
+           pow(params->ramp_target / params->frequency, progress);
+  else
+    return params->frequency +
+           (params->ramp_target - params->frequency) * progress;
+}
 
-  dsp->running = 1;
+/*
+ * returns 1 if <a> and <b> describe the same tempo ramp, 0 otherwise
+ */
+static int same_ramp(dsp_params_t* a, dsp_params_t* b)
+{
+  return a->frequency == b->frequency &&
+         a->ramp_target == b->ramp_target &&
+         a->ramp_length == b->ramp_length &&
+         a->ramp_unit == b->ramp_unit &&
+         a->ramp_shape == b->ramp_shape;
+}
 
-  return 0;
+/*
+ * recalculates dsp->ticklen from current frequency and device settings
+ */
+static void update_ticklen(dsp_t* dsp)
+{
+  dsp->frequency = ramp_frequency(dsp);
+  dsp->ticklen = rint(dsp->rate / dsp->frequency);
+  sync_layers(dsp);
 }
 
 /*
- * close device and clean up
+ * returns sound bank voice for a tick of sound <name> with accent value
+ * <accent> (DSP_BEAT_*) in a cycle of <meter> ticks, -1 on error
  */
-void dsp_deinit(dsp_t* dsp)
+static int acquire_voice(dsp_t* dsp, const char* name, int accent, int meter)
 {
-  dsp->running = 0;
-  dsp_close(dsp);
+  voice_variant_t variant;
 
-  if (dsp->tickdata0) {
-    g_free(dsp->tickdata0);
-    dsp->tickdata0 = NULL;
-  }
-  if (dsp->tickdata1) {
-    g_free(dsp->tickdata1);
-    dsp->tickdata1 = NULL;
-  }
-  if (dsp->tickdata2) {
-    g_free(dsp->tickdata2);
-    dsp->tickdata2 = NULL;
+  if (accent == DSP_BEAT_OFF)
+    return SOUNDBANK_SILENCE;
+
+  if (meter == 1)
+    variant = VOICE_VARIANT_NORMAL;
+  else if (accent)
+    variant = VOICE_VARIANT_ACCENT;
+  else
+    variant = VOICE_VARIANT_SECONDARY;
+
+  return soundbank_acquire(dsp->bank, name, variant);
+}
+
+/*
+ * sets up params->voices: the (shared) sound bank voice for each tick,
+ * silence beyond the meter, params->subvoice for sub beats and
+ * the voices of the pulse layers
+ *
+ * returns 0 on success, -1 if a sound couldn't be prepared (silence then)
+ */
+static int acquire_voices(dsp_t* dsp, dsp_params_t* params)
+{
+  int result = 0;
+  int i, l;
+
+  for (i = 0; i < MAX_METER; i++) {
+    int voice = SOUNDBANK_SILENCE;
+
+    if (i < params->meter &&
+        (voice = acquire_voice(dsp, params->sounds[i] ?
+                                    params->sounds[i] : params->soundname,
+                               params->accents[i], params->meter)) == -1)
+    {
+      voice = SOUNDBANK_SILENCE;
+      result = -1;
+    }
+    params->voices[i] = voice;
   }
-  if (dsp->silence) {
-    g_free(dsp->silence);
-    dsp->silence = NULL;
+
+  for (l = 0; l < DSP_MAX_LAYERS; l++) {
+    dsp_layer_t* layer = &params->layers[l];
+
+    for (i = 0; i < MAX_METER; i++) {
+      int voice = SOUNDBANK_SILENCE;
+
+      if (l < params->n_layers && i < layer->pulses &&
+          (voice = acquire_voice(dsp, layer->soundname ?
+                                      layer->soundname : params->soundname,
+                                 layer->accents[i], layer->pulses)) == -1)
+      {
+        voice = SOUNDBANK_SILENCE;
+        result = -1;
+      }
+      layer->voices[i] = voice;
+    }
   }
-  if (dsp->frames) {
-    g_free(dsp->frames);
-    dsp->frames = NULL;
+
+  params->subvoice = SOUNDBANK_SILENCE;
+  if (params->subdivision > 1) {
+    int voice = soundbank_acquire(dsp->bank, params->subsound ?
+                                  params->subsound : params->soundname,
+                                  VOICE_VARIANT_NORMAL);
+    if (voice == -1)
+      result = -1;
+    else
+      params->subvoice = voice;
   }
+  params->voices_acquired = 1;
+
+  return result;
 }
 
 /*
- * starts counting tickpos / cyclepos limits are exceeded
+ * gives back the sound bank voices of <params>
  */
-static void wrap_position(dsp_t* dsp, int ticklen) {
-  unsigned int* reply;
+static void release_voices(dsp_t* dsp, dsp_params_t* params)
+{
+  int i, l;
+
+  if (params->voices_acquired) {
+    for (i = 0; i < MAX_METER; i++)
+      soundbank_release(dsp->bank, params->voices[i]);
+    soundbank_release(dsp->bank, params->subvoice);
+    for (l = 0; l < DSP_MAX_LAYERS; l++) {
+      for (i = 0; i < MAX_METER; i++)
+        soundbank_release(dsp->bank, params->layers[l].voices[i]);
+    }
+    params->voices_acquired = 0;
+  }
+}
 
-  if (dsp->tickpos >= ticklen) {
-    dsp->tickpos = 0;
-    dsp->cyclepos++;
-    if (dsp->cyclepos >= dsp->meter)
-      dsp->cyclepos = 0;
+/*
+ * stops playback of voices which have been freed in the sound bank
+ */
+static void check_slots(dsp_t* dsp)
+{
+  int i;
 
-    reply = (unsigned int*) g_malloc(sizeof(unsigned int));
-    *reply = dsp->cyclepos;
-    comm_server_send_response(dsp->inter_thread_comm,
-			      MESSAGE_TYPE_RESPONSE_SYNC, reply);
+  for (i = 0; i < DSP_SLOTS; i++) {
+    if (!dsp->bank->voices[dsp->slots[i].voice].name)
+      dsp->slots[i].voice = SOUNDBANK_SILENCE;
   }
 }
 
 /*
- * Feed pulseaudio stream with next samples
+ * reports a sound which couldn't be prepared to the client
  */
-gboolean pulse_feed(dsp_t* dsp)
+static void sound_error(dsp_t* dsp)
 {
-  int ticklen = rint(dsp->rate / dsp->frequency) *
-                dsp->channels * dsp->samplesize / 8;
-  unsigned char *the_data; /* pointer to actual buffer */
-  int data_size;           /* size of actual buffer */
+  send_response(dsp, MESSAGE_TYPE_RESPONSE_START_ERROR, NULL);
+}
 
-  int fragments; /* number of fragments yet to write */
-  int error;
-  fragments = 1;
+/*
+ * sets up the voices of <params> again after a change of meter, accents
+ * or sounds, keeping voices used before and after
+ */
+static void update_voices(dsp_t* dsp, dsp_params_t* params)
+{
+  dsp_params_t old; /* only the voices of it are used */
 
-  wrap_position(dsp, ticklen);
+  if (!dsp->bank)
+    return;
 
-  /* write as many fragments as possible */
-  while (fragments > 0) {
-    int i;
+  memcpy(&old, params, sizeof(old));
+  if (acquire_voices(dsp, params) == -1)
+    sound_error(dsp);
+  release_voices(dsp, &old);
+  check_slots(dsp);
+}
 
-    /* generate fragment */
-    for (i = 0; i < dsp->fragmentsize; i++) {
-      int index;
-
-      if (dsp->meter == 1) {                 /* single ticks */
-	the_data = dsp->tickdata0;
-	data_size = dsp->td0_size;
-      } else if (dsp->accents[dsp->cyclepos]) {  /* accentuate 1st tick */
-	the_data = dsp->tickdata1;
-	data_size = dsp->td1_size;
-      } else {                                 /* sound of 2nd tick */
-	the_data = dsp->tickdata2;
-	data_size = dsp->td2_size;
-      }
+/*
+ * destroys parameter block <params> used by audio thread
+ */
+static void discard_params(dsp_t* dsp, dsp_params_t* params)
+{
+  release_voices(dsp, params);
+  if (dsp->bank)
+    check_slots(dsp);
+  dsp_params_delete(params);
+}
 
-      if ((index = dsp->tickpos) < data_size) { /* tick! */
-	dsp->fragment[i] = the_data[index];
-      } else { /* silence (between ticks)  */
-	dsp->fragment[i] =
-	  dsp->silence[i % (dsp->samplesize / 8 * dsp->channels)];
-      }
+/*
+ * starts playback of <voice> in <slot> at relative volume <gain>,
+ * cutting off the voice played there before
+ */
+static void trigger_slot(dsp_t* dsp, int slot, int voice, double gain)
+{
+  dsp->slots[slot].voice = voice;
+  dsp->slots[slot].pos = 0;
+  dsp->slots[slot].gain = gain;
+  dsp->slots[slot].bus = slot == DSP_SLOT_PULSE ? DSP_BUS_PULSE : DSP_BUS_CLICK;
+  dsp->slots[slot].cue = slot == DSP_SLOT_TICK &&
+    dsp->bank->voices[voice].variant == VOICE_VARIANT_ACCENT;
+}
 
-      dsp->tickpos++;
-      wrap_position(dsp, ticklen);
-    }
+/*
+ * starts the sync pulse (if routed to a channel) at the current frame
+ */
+static void trigger_pulse(dsp_t* dsp)
+{
+  trigger_slot(dsp, DSP_SLOT_PULSE, dsp->pulsevoice, 1.0);
+}
 
-    if (pa_simple_write(dsp->pas, dsp->fragment, (size_t) dsp->fragmentsize, &error) < 0) {
-      g_print("pulse_feed: pa_simple_write ERROR: %s\n", pa_strerror(error));
-    }
-    fragments--;
-  }
+/*
+ * points each channel of the device to its bus according to the channel
+ * map and prepares the sync pulse if it is routed to a channel
+ */
+static void setup_routes(dsp_t* dsp)
+{
+  dsp_channel_map_t* map = dsp->channel_map;
+  int pulse;
+  int c;
 
-#if 0
-  if (pa_simple_drain(dsp->pas, &error) < 0) {
-    g_print("pulse_feed: pa_simple_drain ERROR: %s\n", pa_strerror(error));
+  dsp->routed = 0;
+  for (c = 0; c < dsp->channels; c++) {
+    int bus = !map ? DSP_BUS_CLICK :
+              c < map->channels ? map->buses[c] : DSP_BUS_SILENCE;
+
+    dsp->routes[c] = &dsp->buses[bus * dsp->fragmentframes];
+    dsp->routed |= 1 << bus;
   }
-#endif
+  dsp->routed &= ~(1 << DSP_BUS_SILENCE); /* never mixed into */
+  pulse = dsp->routed & 1 << DSP_BUS_PULSE;
+
+  if (pulse && dsp->pulsevoice == SOUNDBANK_SILENCE) {
+    int voice = soundbank_acquire(dsp->bank, PULSE_NAME,
+                                  VOICE_VARIANT_NORMAL);
+
+    if (voice == -1)
+      sound_error(dsp);
+    else
+      dsp->pulsevoice = voice;
+  } else if (!pulse && dsp->pulsevoice != SOUNDBANK_SILENCE) {
+    soundbank_release(dsp->bank, dsp->pulsevoice);
+    dsp->pulsevoice = SOUNDBANK_SILENCE;
+    check_slots(dsp);
+  }
+}
 
-  return 1;
+/*
+ * timeline callback: returns voice for tick <beat> of <section>,
+ * -1 on error
+ */
+static int timeline_voice(dsp_t* dsp, const timeline_section_t* section,
+                          int beat)
+{
+  return acquire_voice(dsp, section->soundname ?
+                            section->soundname : dsp->params->soundname,
+                       section->accents[beat], section->meter);
 }
 
 /*
- * Feed dsp device with next samples
- *
- * used as output start and callback
+ * gives back the sound bank voices of the compiled timeline
  */
-gboolean dsp_feed(dsp_t* dsp)
+static void release_timeline_voices(dsp_t* dsp)
 {
-  audio_buf_info info; /* OSS structure to obtain buffering parameters */
-  int ticklen = rint(dsp->rate / dsp->frequency) *
-                dsp->channels * dsp->samplesize / 8;
-  unsigned char *the_data; /* pointer to actual buffer */
-  int data_size;           /* size of actual buffer */
+  timeline_t* timeline = dsp->timeline;
+  int i, n;
 
-  int fragments; /* number of fragments yet to write */
-  int limit; /* number of fragments we want to have filled */
+  if (timeline && timeline->rate) {
+    for (i = 0; i < timeline->n_sections; i++) {
+      for (n = 0; n < timeline->sections[i].meter; n++)
+        soundbank_release(dsp->bank, timeline->sections[i].voices[n]);
+    }
+    timeline->rate = 0;
+  }
+}
 
-  /* get number of fragments to write to dsp */
-  if (ioctl(dsp->dspfd, SNDCTL_DSP_GETOSPACE, &info) == -1) {
-    perror("SNDCTL_DSP_GETOSPACE");
+/*
+ * compiles the timeline for the opened device, continuing at timepos
+ */
+static void compile_timeline(dsp_t* dsp)
+{
+  release_timeline_voices(dsp);
+  if (timeline_compile(dsp->timeline, dsp->rate,
+                       (timeline_voice_t) timeline_voice, dsp) == -1)
+  {
+    sound_error(dsp);
   }
+  dsp->cursor = timeline_find(dsp->timeline, dsp->timepos);
+}
 
-  limit =
-    dsp->rate * dsp->channels * dsp->samplesize / 8 *
-    WRITE_AHEAD_INTERVAL / (1000 * dsp->fragmentsize);
-  if (limit < 2) /* we want to have filled at least 2 fragments */
-    limit = 2;
-  fragments = limit - (info.fragstotal - info.fragments);
+/*
+ * writes <size> bytes of encoded <data> to the sound device
+ */
+static void write_device(dsp_t* dsp, const unsigned char* data, int size)
+{
+  int error;
 
-  wrap_position(dsp, ticklen);
+  if (dsp->dspfd != -1) {
+    write(dsp->dspfd, data, size);
+  } else if (pa_simple_write(dsp->pas, data, (size_t) size, &error) < 0) {
+    g_print("pulse_feed: pa_simple_write ERROR: %s\n", pa_strerror(error));
+  }
+}
 
-  /* write as many fragments as possible */
-  while (fragments > 0) {
-    int i;
+/*
+ * opens the sinks of dsp->fanout for the output of the device, which is
+ * delayed by the silence given for its latency compensation
+ */
+static void start_fanout(dsp_t* dsp)
+{
+  int framesize = dsp->channels * dsp->samplesize / 8;
+  int frames;
 
-    /* generate fragment */
-    for (i = 0; i < dsp->fragmentsize; i++) {
-      int index;
-
-      if (dsp->meter == 1) {                 /* single ticks */
-	the_data = dsp->tickdata0;
-	data_size = dsp->td0_size;
-      } else if (dsp->accents[dsp->cyclepos]) {  /* accentuate 1st tick */
-	the_data = dsp->tickdata1;
-	data_size = dsp->td1_size;
-      } else {                                 /* sound of 2nd tick */
-	the_data = dsp->tickdata2;
-	data_size = dsp->td2_size;
-      }
+  if (fanout_start(dsp->fanout, dsp->rate, dsp->channels, dsp->format,
+                   framesize, dsp->fragmentsize) == -1)
+  {
+    fprintf(stderr, "Warning: Couldn't open sinks.\n");
+    return;
+  }
 
-      if ((index = dsp->tickpos) < data_size) { /* tick! */
-	dsp->fragment[i] = the_data[index];
-      } else { /* silence (between ticks)  */
-	dsp->fragment[i] =
-	  dsp->silence[i % (dsp->samplesize / 8 * dsp->channels)];
-      }
+  memset(dsp->mix, 0, dsp->fragmentframes * dsp->channels * sizeof(int));
+  encode_fragment(dsp, dsp->fragment, dsp->fragmentframes);
+  for (frames = fanout_delay_frames(dsp->fanout); frames > 0;
+       frames -= dsp->fragmentframes)
+  {
+    write_device(dsp, dsp->fragment,
+                 MIN(frames, dsp->fragmentframes) * framesize);
+  }
+}
 
-      dsp->tickpos++;
-      wrap_position(dsp, ticklen);
-    }
+/*
+ * prefetches dsp->backing for the device, kept filled by its own thread
+ * unless rendering offline
+ */
+static void start_backing(dsp_t* dsp)
+{
+  int latency = MAX(dsp->fragstotal, 2) * dsp->fragmentframes;
 
-    write(dsp->dspfd, dsp->fragment, dsp->fragmentsize);
-    fragments--;
-  }
+  if (backing_start(dsp->backing, dsp->rate, latency,
+                    dsp->ticklen * dsp->params->meter, !dsp->offline) == -1)
+    fprintf(stderr, "Warning: Couldn't start backing track.\n");
+}
 
-  return 1;
+/*
+ * called at the start of each bar of <barlen> frames
+ */
+static void start_bar(dsp_t* dsp, int barlen)
+{
+  if (dsp->backing)
+    backing_bar(dsp->backing, barlen);
 }
 
 /*
- * Gets mixer setting
+ * prepares metronome <dsp> to play on the opened device (or file)
  *
- * returns value from 0.0 to 1.0 on success
+ * returns 0 on success, -1 otherwise
  */
-double dsp_get_volume(dsp_t* dsp)
+static int prepare_playback(dsp_t* dsp)
 {
-  assert(dsp->volume >= 0.0 && dsp->volume <= 1.0);
+  int i;
 
-  return dsp->volume;
+  dsp->frames = NULL;
+  dsp->frames_map = NULL;
+  dsp->frames_name = NULL;
+
+  dsp->fragmentframes =
+    dsp->fragmentsize * 8 / (dsp->channels * dsp->samplesize);
+  dsp->mix = (int*) g_malloc(dsp->fragmentframes * dsp->channels * sizeof(int));
+  dsp->buses =
+    (int*) g_malloc0(DSP_BUSES * dsp->fragmentframes * sizeof(int));
+  dsp->routes = (const int**) g_malloc(dsp->channels * sizeof(int*));
+  dsp->pulsevoice = SOUNDBANK_SILENCE;
+
+  /* prepare voices of every tick */
+  dsp->bank = soundbank_new((voice_prepare_t) prepare_voice, dsp);
+  dsp->bank->debug = dsp->debug;
+  if (acquire_voices(dsp, dsp->params) == -1) {
+    return -1;
+  }
+  setup_routes(dsp);
+
+  dsp->cyclepos = 0; /* init */
+  dsp->tickpos = 0;
+  dsp->subpos = 0;
+  dsp->ramp_ticks = 0;
+  dsp->ramp_frames = 0;
+  dsp->timepos = 0;
+  dsp->cursor = 0;
+  dsp->framepos = 0;
+  dsp->clockpos = -1;
+  if (dsp->timeline)
+    compile_timeline(dsp);
+  if (dsp->clock && !dsp->offline)
+    midiclock_start(dsp->clock, dsp->rate);
+  if (dsp->netsync && !dsp->offline)
+    netsync_start(dsp->netsync, dsp->rate);
+  if (dsp->beatshm && !dsp->offline)
+    beatshm_start(dsp->beatshm, dsp->rate);
+  if (dsp->master && !dsp->offline) {
+    midiclock_start(dsp->master, dsp->rate);
+    pll_reset(dsp->pll);
+    dsp->master_position = 0;
+  }
+  update_ticklen(dsp);
+  for (i = 0; i < DSP_MAX_LAYERS; i++)
+    dsp->pulsepos[i] = -1; /* start with pulse 0 */
+  for (i = 0; i < DSP_SLOTS; i++)
+    trigger_slot(dsp, i, SOUNDBANK_SILENCE, 0.0);
+  if (dsp->backing)
+    start_backing(dsp);
+  if (!dsp->timeline)
+    start_bar(dsp, dsp->ticklen * dsp->params->meter);
+  trigger_slot(dsp, DSP_SLOT_TICK, dsp->params->voices[0], 1.0);
+  trigger_pulse(dsp);
+  if (dsp->fanout && !dsp->offline && !dsp->guest)
+    start_fanout(dsp);
+
+  dsp->running = 1;
+
+  return 0;
 }
 
 /*
- * Sets mixer setting
+ * Opens DSP and prepare metronome <dsp> to play
  *
- * accepts a value from 0.0 to 1.0
+ * returns 0 on success, -1 otherwise
  */
-void dsp_set_volume(dsp_t* dsp, double volume)
+int dsp_init(dsp_t* dsp)
 {
-  assert(volume >= 0.0 && volume <= 1.0);
+  if (dsp_open(dsp) == -1)
+    return -1;
 
-  dsp->volume = volume;
-  if (dsp->running) {
-    free(dsp->tickdata0);
-    free(dsp->tickdata1);
-    free(dsp->tickdata2);
+  return prepare_playback(dsp);
+}
 
-    prepare_buffers(dsp);
+/*
+ * close device and clean up
+ */
+void dsp_deinit(dsp_t* dsp)
+{
+  dsp->running = 0;
+  if (dsp->fanout)
+    fanout_stop(dsp->fanout);
+  if (dsp->backing)
+    backing_stop(dsp->backing);
+  dsp_close(dsp);
+  if (dsp->clock)
+    midiclock_stop(dsp->clock);
+  if (dsp->master)
+    midiclock_stop(dsp->master);
+  if (dsp->beatshm)
+    beatshm_stop(dsp->beatshm);
+
+  if (dsp->bank) {
+    release_timeline_voices(dsp);
+    release_voices(dsp, dsp->params);
+    if (dsp->pending)
+      release_voices(dsp, dsp->pending);
+    soundbank_release(dsp->bank, dsp->pulsevoice);
+    dsp->pulsevoice = SOUNDBANK_SILENCE;
+    soundbank_delete(dsp->bank);
+    dsp->bank = NULL;
+  }
+  free_frames(dsp);
+  if (dsp->mix) {
+    g_free(dsp->mix);
+    dsp->mix = NULL;
+  }
+  if (dsp->buses) {
+    g_free(dsp->buses);
+    dsp->buses = NULL;
+  }
+  if (dsp->routes) {
+    g_free(dsp->routes);
+    dsp->routes = NULL;
   }
 }
 
 /*
- * the main loop of the metronome
+ * makes dsp->pending the current parameter block
  */
-void dsp_main_loop(dsp_t* dsp) {
-  struct timespec requested = { (WRITE_AHEAD_INTERVAL / 2) / 1000,
-                                ((WRITE_AHEAD_INTERVAL / 2) % 1000) * 1000};
-  struct timespec remaining; /* dummy */
-  int repeat_flag = 1;
+static void apply_params(dsp_t* dsp)
+{
+  /* a new ramp starts now, an unchanged one continues */
+  if (!same_ramp(dsp->params, dsp->pending)) {
+    dsp->ramp_ticks = 0;
+    dsp->ramp_frames = 0;
+  }
 
-  while (repeat_flag) {
-    message_type_t message_type;
-    void* message;
-    int get_volume = 0;         /* flag */
-    void* reply = NULL;
+  discard_params(dsp, dsp->params);
+  dsp->params = dsp->pending;
+  dsp->pending = NULL;
+
+  /* never index accents[] beyond the new meter */
+  if (dsp->cyclepos >= dsp->params->meter)
+    dsp->cyclepos = 0;
+
+  if (dsp->running)
+    update_ticklen(dsp);
+}
+
+/*
+ * takes over new parameter block <params> from client, to be applied
+ * immediately or at its quantization point (see wrap_position())
+ *
+ * its voices are prepared right now, so switching is only a pointer swap;
+ * a block still pending is superseded by the new one
+ */
+static void set_params(dsp_t* dsp, dsp_params_t* params)
+{
+  if (!params->soundname)
+    params->soundname = strdup(dsp->params->soundname);
+  params->voices_acquired = 0;
+
+  if (dsp->bank && acquire_voices(dsp, params) == -1)
+    sound_error(dsp);
+
+  if (dsp->pending)
+    discard_params(dsp, dsp->pending);
+  dsp->pending = params;
+
+  if (!dsp->running || params->quantize == DSP_QUANTIZE_NOW)
+    apply_params(dsp);
+}
+
+/*
+ * sets sound <name> as sound of current and pending parameter block
+ */
+static void set_sound(dsp_t* dsp, char* name)
+{
+  if (dsp->pending) {
+    if (dsp->pending->soundname) free(dsp->pending->soundname);
+    dsp->pending->soundname = strdup(name);
+    update_voices(dsp, dsp->pending);
+  }
+  if (dsp->params->soundname) free(dsp->params->soundname);
+  dsp->params->soundname = name;
+  update_voices(dsp, dsp->params);
+}
+
+/*
+ * tells the client about the start of tick cyclepos
+ */
+static void send_sync(dsp_t* dsp) {
+  unsigned int* reply = (unsigned int*) g_malloc(sizeof(unsigned int));
+
+  *reply = dsp->cyclepos;
+  send_response(dsp, MESSAGE_TYPE_RESPONSE_SYNC, reply);
+}
 
-    while ((message_type = comm_server_try_get_query(dsp->inter_thread_comm,
-	                                             &message))
-	   != MESSAGE_TYPE_NO_MESSAGE)
+/*
+ * tells the LAN beat sync followers and readers of the beat position export
+ * about the tick number <beat> in bar of <meter> ticks of note value <unit>
+ * starting now, <ticklen> frames long
+ */
+static void publish_tick(dsp_t* dsp, long long ticklen, int beat, int meter,
+                         int unit)
+{
+  if (dsp->netsync && dsp->netsync->leader && !dsp->offline)
+    netsync_publish(dsp->netsync, dsp->framepos, (double) ticklen / dsp->rate,
+                    meter, beat);
+  if (dsp->beatshm && !dsp->offline)
+    beatshm_publish(dsp->beatshm, dsp->framepos, ticklen, beat, 0, meter,
+                    unit, dsp->timeline ? 1 : dsp->params->subdivision);
+}
+
+/*
+ * tells the client how well the MIDI clock master or LAN beat sync leader
+ * is followed
+ */
+static void send_lock(dsp_t* dsp) {
+  dsp_lock_t* reply;
+  double ms = 1000.0 / dsp->rate; /* milliseconds per frame */
+  double origin;
+  double length;
+  int meter;
+
+  if (dsp->offline || dsp->quiet)
+    return;
+
+  if (dsp->master) {
+    reply = (dsp_lock_t*) g_malloc(sizeof(dsp_lock_t));
+    reply->locked = pll_locked(dsp->pll);
+    reply->bpm = dsp->pll->period > 0.0 ?
+      60.0 * dsp->rate / (dsp->pll->period * MIDICLOCK_PPQN) : 0.0;
+    reply->phase_error = dsp->pll->phase_error * ms;
+    reply->jitter = dsp->pll->jitter * ms;
+    send_response(dsp, MESSAGE_TYPE_RESPONSE_LOCK, reply);
+  } else if (dsp->netsync && !dsp->netsync->leader) {
+    reply = (dsp_lock_t*) g_malloc0(sizeof(dsp_lock_t));
+    reply->locked = netsync_follow(dsp->netsync, &origin, &length, &meter);
+    if (reply->locked) { /* tick just started: deviation from leader's */
+      reply->bpm = 60.0 * dsp->rate / length;
+      reply->phase_error =
+        (dsp->framepos - origin -
+         floor((dsp->framepos - origin) / length + 0.5) * length) * ms;
+      reply->jitter = dsp->netsync->jitter * 1000.0;
+    }
+    send_response(dsp, MESSAGE_TYPE_RESPONSE_LOCK, reply);
+  }
+}
+
+/*
+ * starts counting tickpos / cyclepos limits are exceeded,
+ * starting the voice of the new tick
+ */
+static void wrap_position(dsp_t* dsp) {
+  if (dsp->tickpos >= dsp->ticklen) {
+    dsp->ramp_ticks++;
+    dsp->ramp_frames += dsp->ticklen;
+    dsp->tickpos = 0;
+    dsp->subpos = 0;
+    dsp->cyclepos++;
+    if (dsp->cyclepos >= dsp->params->meter)
+      dsp->cyclepos = 0;
+
+    if (dsp->pending &&
+        (dsp->pending->quantize != DSP_QUANTIZE_BAR || dsp->cyclepos == 0))
     {
+      apply_params(dsp);
+    }
+
+    /* next step of tempo ramp */
+    if (dsp->params->ramp_target > 0.0)
+      update_ticklen(dsp);
+
+    if (dsp->cyclepos == 0) {
+      int l;
+
+      for (l = 0; l < DSP_MAX_LAYERS; l++)
+        dsp->pulsepos[l] = -1; /* start with pulse 0 */
+      start_bar(dsp, dsp->ticklen * dsp->params->meter);
+    }
+
+    trigger_slot(dsp, DSP_SLOT_TICK, dsp->params->voices[dsp->cyclepos], 1.0);
+    trigger_pulse(dsp);
+    dsp->clockpos = -1;
+    send_sync(dsp);
+    send_lock(dsp);
+    publish_tick(dsp, dsp->ticklen, dsp->cyclepos, dsp->params->meter, 4);
+  }
+}
 
-      switch (message_type) {
-        case MESSAGE_TYPE_STOP_SERVER:
-	  repeat_flag = 0;
-	  break;
-	case MESSAGE_TYPE_SET_DEVICE:
-	  if (dsp->devicename) free(dsp->devicename);
-	  dsp->devicename = (char*) message;
-	  break;
-	case MESSAGE_TYPE_SET_SOUND:
-	  if (dsp->soundname) free(dsp->soundname);
-	  dsp->soundname = (char*) message;
-	  break;
-	case MESSAGE_TYPE_SET_SOUNDSYSTEM:
-	  if (dsp->soundsystem) free(dsp->soundsystem);
-	  dsp->soundsystem = (char*) message;
-	  break;
-	case MESSAGE_TYPE_SET_METER:
-	  dsp->meter = *((int*) message);
-	  free(message);
-	  break;
-	case MESSAGE_TYPE_SET_ACCENTS:
-	  if (dsp->accents) free(dsp->accents);
-	  dsp->accents = (int*) message;
-	  break;
-	case MESSAGE_TYPE_SET_FREQUENCY:
-	  dsp->frequency = *((double*) message);
-	  free(message);
-	  break;
-        case MESSAGE_TYPE_START_METRONOME:
-	  if (dsp_init(dsp) == -1) {
-            comm_server_send_response(dsp->inter_thread_comm,
-		                      MESSAGE_TYPE_RESPONSE_START_ERROR, NULL);
-	    dsp_deinit(dsp);
-	  }
-	  break;
-        case MESSAGE_TYPE_STOP_METRONOME:
-	  dsp_deinit(dsp);
-	  break;
-	case MESSAGE_TYPE_START_SYNC:
-	  dsp->sync_flag = 1;
-	  break;
-	case MESSAGE_TYPE_STOP_SYNC:
-	  dsp->sync_flag = 0;
-	  break;
-	case MESSAGE_TYPE_SET_VOLUME:
-	  dsp_set_volume(dsp, *((double*) message));
-	  free(message);
-	  break;
-	case MESSAGE_TYPE_GET_VOLUME:
-	  get_volume = 1;
-	  break;
-	default:
-	  fprintf(stderr, "Warning: Unhandled message type in audio thread.\n");
+/*
+ * sends the MIDI clock events of the current tick (<ticklen> frames long,
+ * number <beat> in bar, <pulses> clock pulses long) reached at frame
+ * <tickpos> of the tick and returns the frame in the tick of the next clock
+ * pulse
+ */
+static long long next_clock(dsp_t* dsp, long long ticklen, long long tickpos,
+                            int beat, int pulses)
+{
+  if (!dsp->clock)
+    return ticklen;
+
+  if (dsp->clockpos == -1) {
+    midiclock_tick(dsp->clock, dsp->framepos, beat);
+    dsp->clockpos = 0;
+  }
+
+  while (dsp->clockpos + 1 < pulses) {
+    long long offset = (dsp->clockpos + 1) * ticklen / pulses;
+
+    if (offset > tickpos)
+      return offset;
+
+    dsp->clockpos++;
+    midiclock_pulse(dsp->clock, dsp->framepos);
+  }
+
+  return ticklen;
+}
+
+/*
+ * returns frame in current tick at which sub beat <n> starts
+ */
+static int subbeat_offset(dsp_t* dsp, int n)
+{
+  return (long long) n * dsp->ticklen / dsp->params->subdivision;
+}
+
+/*
+ * starts the voices of sub beats and layer pulses reached at tickpos and
+ * returns the frame in current tick of the next event (tick, sub beat or
+ * pulse)
+ */
+static int next_event(dsp_t* dsp)
+{
+  int barpos = dsp->cyclepos * dsp->ticklen + dsp->tickpos;
+  int result = next_clock(dsp, dsp->ticklen, dsp->tickpos, dsp->cyclepos,
+                          MIDICLOCK_PPQN);
+  int l;
+
+  while (dsp->subpos + 1 < dsp->params->subdivision) {
+    int offset = subbeat_offset(dsp, dsp->subpos + 1);
+
+    if (offset > dsp->tickpos) {
+      result = MIN(result, offset);
+      break;
+    }
+
+    dsp->subpos++;
+    trigger_slot(dsp, DSP_SLOT_SUB, dsp->params->subvoice,
+                 dsp->params->subgain);
+    trigger_pulse(dsp);
+    if (dsp->beatshm && !dsp->offline)
+      beatshm_publish(dsp->beatshm, dsp->framepos, dsp->ticklen,
+                      dsp->cyclepos, dsp->subpos, dsp->params->meter, 4,
+                      dsp->params->subdivision);
+  }
+
+  for (l = 0; l < dsp->params->n_layers; l++) {
+    dsp_layer_t* layer = &dsp->params->layers[l];
+
+    while (dsp->pulsepos[l] + 1 < layer->pulses) {
+      int offset = pulse_offset(dsp, l, dsp->pulsepos[l] + 1);
+
+      if (offset > barpos) {
+        result = MIN(result, offset - barpos + dsp->tickpos);
+        break;
       }
+
+      dsp->pulsepos[l]++;
+      trigger_slot(dsp, DSP_SLOT_LAYER + l, layer->voices[dsp->pulsepos[l]],
+                   layer->gain);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * starts the voices of timeline events reached at timepos and
+ * returns the number of frames up to the next event (or clock pulse)
+ */
+static long long next_timeline_event(dsp_t* dsp)
+{
+  timeline_t* timeline = dsp->timeline;
+  timeline_event_t* event;
+  long long tickpos;
+
+  while (dsp->cursor < timeline->n_events &&
+         timeline->events[dsp->cursor].frame <= dsp->timepos)
+  {
+    event = &timeline->events[dsp->cursor++];
+
+    trigger_slot(dsp, DSP_SLOT_TICK, event->voice, event->gain);
+    trigger_pulse(dsp);
+    dsp->cyclepos = event->beat;
+    dsp->clockpos = -1;
+    send_sync(dsp);
+    if (dsp->cursor < timeline->n_events) {
+      if (event->beat == 0)
+        start_bar(dsp, (event[1].frame - event->frame) *
+                       timeline->sections[event->section].meter);
+      publish_tick(dsp, event[1].frame - event->frame, event->beat,
+                   timeline->sections[event->section].meter,
+                   timeline->sections[event->section].unit);
+    }
+  }
+
+  if (dsp->cursor >= timeline->n_events)
+    return LLONG_MAX; /* end of timeline: silence */
+
+  event = &timeline->events[dsp->cursor];
+  if (dsp->cursor == 0)
+    return event->frame - dsp->timepos;
+
+  tickpos = dsp->timepos - event[-1].frame;
+  return next_clock(dsp, event->frame - event[-1].frame, tickpos,
+                    event[-1].beat,
+                    MIDICLOCK_PPQN * 4 /
+                    timeline->sections[event[-1].section].unit) - tickpos;
+}
+
+/*
+ * adds the next <span> frames of the voice in <slot> to its bus at frame
+ * <pos>, the sync pulse at full level; buses not played on any channel
+ * are skipped
+ */
+static void mix_slot(dsp_t* dsp, dsp_slot_t* slot, int pos, int span)
+{
+  voice_t* voice = &dsp->bank->voices[slot->voice];
+  int gain = slot->bus == DSP_BUS_PULSE ?
+    MIXER_UNITY : mixer_gain(slot->gain * dsp->volume);
+  int n = MIN(voice->frames - slot->pos, span);
+
+  if (n > 0 && gain > 0) {
+    if (dsp->routed & 1 << slot->bus)
+      mixer_add(&dsp->buses[slot->bus * dsp->fragmentframes + pos],
+                &voice->data[slot->pos], n, gain);
+    if (slot->cue && dsp->routed & 1 << DSP_BUS_CUE)
+      mixer_add(&dsp->buses[DSP_BUS_CUE * dsp->fragmentframes + pos],
+                &voice->data[slot->pos], n, gain);
+  }
+  slot->pos = MIN(slot->pos + span, voice->frames);
+}
+
+/*
+ * adds the next <span> frames of the backing track at frame <pos> to its
+ * bus, or to the click if it isn't played on a channel of its own
+ */
+static void mix_backing(dsp_t* dsp, int pos, int span)
+{
+  int bus = dsp->routed & 1 << DSP_BUS_TRACK ? DSP_BUS_TRACK : DSP_BUS_CLICK;
+
+  backing_mix(dsp->backing, dsp->routed & 1 << bus ?
+              &dsp->buses[bus * dsp->fragmentframes + pos] : NULL, span);
+}
+
+/*
+ * Generates the next <frames> (at most dsp->fragmentframes) of output in
+ * the mono buses dsp->buses
+ *
+ * the fragment is composed of spans between events (ticks and sub beats,
+ * or the ticks of the timeline): each event (re)starts the voice of its slot,
+ * looked up in the parameter block or timeline, and for each span, the voices
+ * still sounding and the backing track are mixed into their buses, so the
+ * track starts with the first frame of its bar
+ */
+static void mix_buses(dsp_t* dsp, int frames)
+{
+  int pos = 0;
+  int bus;
+
+  for (bus = 0; bus < DSP_BUSES; bus++) {
+    if (dsp->routed & 1 << bus)
+      memset(&dsp->buses[bus * dsp->fragmentframes], 0, frames * sizeof(int));
+  }
+
+  while (pos < frames) {
+    int span;
+    int i;
+
+    if (dsp->timeline) {
+      span = MIN(next_timeline_event(dsp), frames - pos);
+      dsp->timepos += span;
+    } else {
+      wrap_position(dsp);
+      span = MIN(next_event(dsp) - dsp->tickpos, frames - pos);
+      dsp->tickpos += span;
+    }
+
+    for (i = 0; i < DSP_SLOTS; i++)
+      mix_slot(dsp, &dsp->slots[i], pos, span);
+    if (dsp->backing)
+      mix_backing(dsp, pos, span);
+
+    pos += span;
+    dsp->framepos += span;
+  }
+
+  if (!dsp->timeline)
+    wrap_position(dsp);
+}
+
+/*
+ * Generates the next <frames> (at most dsp->fragmentframes) of output in
+ * the accumulator dsp->mix: the buses are interleaved to the channels in
+ * one pass
+ */
+static void mix_fragment(dsp_t* dsp, int frames)
+{
+  mix_buses(dsp, frames);
+  mixer_interleave(dsp->mix, dsp->routes, dsp->channels, frames);
+}
+
+/*
+ * Generates the next <frames> (at most dsp->fragmentframes) of output
+ * encoded for the device
+ *
+ * returns the encoded frames: dsp->fragment, or with running sinks a buffer
+ * handed to them by reference (valid until the next call), so the output is
+ * rendered and encoded once for any number of sinks
+ */
+static const unsigned char* render_fragment(dsp_t* dsp, int frames)
+{
+  unsigned char* dest = NULL;
+
+  if (dsp->render)
+    dsp->render(dsp->render_data, dsp, frames);
+  else
+    mix_fragment(dsp, frames);
+
+  if (dsp->fanout)
+    dest = fanout_next(dsp->fanout);
+  encode_fragment(dsp, dest ? dest : dsp->fragment, frames);
+  if (dest) {
+    fanout_write(dsp->fanout,
+                 frames * dsp->channels * dsp->samplesize / 8);
+    return dest;
+  }
+  return dsp->fragment;
+}
+
+/*
+ * makes <timeline> (taken over) the schedule to be played from its
+ * beginning instead of the parameter block, NULL: back to parameter block
+ */
+void dsp_set_timeline(dsp_t* dsp, timeline_t* timeline)
+{
+  if (dsp->timeline) {
+    if (dsp->bank)
+      release_timeline_voices(dsp);
+    timeline_delete(dsp->timeline);
+  }
+  dsp->timeline = timeline;
+  dsp->timepos = 0;
+  dsp->cursor = 0;
+
+  if (dsp->running) {
+    if (timeline)
+      compile_timeline(dsp);
+    dsp->slots[DSP_SLOT_TICK].voice = SOUNDBANK_SILENCE;
+    check_slots(dsp);
+  }
+}
+
+/*
+ * continues timeline at the beginning of <bar> (counted from 0)
+ */
+static void seek_bar(dsp_t* dsp, int bar)
+{
+  long long frame;
+
+  if (dsp->timeline && dsp->running &&
+      (frame = timeline_bar_frame(dsp->timeline, bar)) != -1)
+  {
+    dsp->timepos = frame;
+    dsp->cursor = dsp->timeline->bars[bar];
+    dsp->slots[DSP_SLOT_TICK].voice = SOUNDBANK_SILENCE;
+    if (dsp->clock)
+      midiclock_locate(dsp->clock, dsp->framepos,
+                       timeline_bar_sixteenths(dsp->timeline, bar));
+  }
+}
+
+/*
+ * makes <clock> (taken over) the MIDI clock output, NULL: none
+ */
+void dsp_set_midiclock(dsp_t* dsp, midiclock_t* clock)
+{
+  if (dsp->clock)
+    midiclock_delete(dsp->clock);
+  dsp->clock = clock;
+
+  if (clock && dsp->running && !dsp->offline)
+    midiclock_start(clock, dsp->rate); /* START at next bar */
+}
+
+/*
+ * makes <master> (taken over) the MIDI clock input followed, NULL: none
+ */
+void dsp_set_master(dsp_t* dsp, midiclock_t* master)
+{
+  if (dsp->master)
+    midiclock_delete(dsp->master);
+  dsp->master = master;
+  if (!dsp->pll)
+    dsp->pll = pll_new();
+  pll_reset(dsp->pll);
+  dsp->master_position = 0;
+
+  if (master && dsp->running && !dsp->offline)
+    midiclock_start(master, dsp->rate);
+}
+
+/*
+ * adjusts the current tick to end with the next tick of a master whose
+ * ticks are <length> frames long, with a bar starting at frame <origin>;
+ * if <bar> is set, the ticks also take over the position in the bar
+ * (not in timeline mode)
+ *
+ * the tick length changes by at most FOLLOW_CORRECTION per call, so a
+ * phase difference is caught up over several ticks
+ */
+static void align_ticks(dsp_t* dsp, double origin, double length, int bar)
+{
+  long long start; /* frame at which the current tick started */
+  long beat;       /* number of the master's tick ending the current one */
+  int cyclepos;
+
+  if (dsp->timeline)
+    return;
+
+  start = dsp->framepos - dsp->tickpos;
+  beat = lrint((start + length - origin) / length);
+
+  dsp->frequency = dsp->rate / length;
+  dsp->ticklen = CLAMP(llrint(origin + beat * length) - start,
+                       (int) (length * (1.0 - FOLLOW_CORRECTION)),
+                       (int) (length * (1.0 + FOLLOW_CORRECTION)));
+  dsp->ticklen = MAX(dsp->ticklen, dsp->tickpos + 1);
+
+  if (bar) { /* next tick is beat of master's bar */
+    cyclepos = (beat - 1) % dsp->params->meter;
+    dsp->cyclepos = cyclepos < 0 ? cyclepos + dsp->params->meter : cyclepos;
+  }
+}
+
+/*
+ * takes the messages received from the MIDI clock master and, once locked
+ * to its pulses, aligns the ticks to its quarters
+ */
+static void follow_clock(dsp_t* dsp)
+{
+  midiclock_input_t input;
+  pll_t* pll = dsp->pll;
+
+  while (midiclock_receive(dsp->master, &input)) {
+    switch (input.type) {
+    case MIDICLOCK_START:
+      pll_renumber(pll, 0);
+      dsp->master_position = 2;
+      break;
+    case MIDICLOCK_SONGPOS:
+      pll_renumber(pll, (long) input.value * MIDICLOCK_PPQN / 4);
+      dsp->master_position = 2;
+      break;
+    case MIDICLOCK_CLOCK:
+      pll_input(pll, input.frame);
+      if (dsp->master_position == 2)
+        dsp->master_position = 1;
+      else if (pll->pulses == 1) /* reacquired: pulses lost in between */
+        dsp->master_position = 0;
+      break;
+    default: /* CONTINUE, STOP: clock pulses tell */
+      break;
+    }
+  }
+
+  if (pll_locked(pll)) /* pulse 0: START */
+    align_ticks(dsp, pll_predict(pll, 0), pll->period * MIDICLOCK_PPQN,
+                dsp->master_position == 1);
+}
+
+/*
+ * makes <netsync> (taken over) the LAN beat sync instance, NULL: none
+ */
+void dsp_set_netsync(dsp_t* dsp, netsync_t* netsync)
+{
+  if (dsp->netsync)
+    netsync_delete(dsp->netsync);
+  dsp->netsync = netsync;
+
+  if (netsync && dsp->running && !dsp->offline)
+    netsync_start(netsync, dsp->rate);
+}
+
+/*
+ * makes <beatshm> (taken over) the beat position export, NULL: none
+ */
+void dsp_set_beatshm(dsp_t* dsp, beatshm_t* beatshm)
+{
+  if (dsp->beatshm)
+    beatshm_delete(dsp->beatshm);
+  dsp->beatshm = beatshm;
+
+  if (beatshm && dsp->running && !dsp->offline)
+    beatshm_start(beatshm, dsp->rate);
+}
+
+/*
+ * makes <backing> (taken over) the backing track, NULL: none; a new track
+ * starts with the next start of playback
+ */
+void dsp_set_backing(dsp_t* dsp, backing_t* backing)
+{
+  if (dsp->backing)
+    backing_delete(dsp->backing);
+  dsp->backing = backing;
+}
+
+/*
+ * makes <fanout> (taken over) the further sinks of the output written to
+ * the sound device, NULL: none
+ */
+void dsp_set_fanout(dsp_t* dsp, fanout_t* fanout)
+{
+  if (dsp->fanout)
+    fanout_delete(dsp->fanout);
+  dsp->fanout = fanout;
+
+  if (fanout && dsp->running && !dsp->offline && !dsp->guest)
+    start_fanout(dsp);
+}
+
+/*
+ * takes the beats of the LAN beat sync leader and aligns the ticks to them
+ */
+static void follow_leader(dsp_t* dsp)
+{
+  double origin;
+  double length;
+  int meter;
+
+  if (netsync_follow(dsp->netsync, &origin, &length, &meter))
+    align_ticks(dsp, origin, length, meter == dsp->params->meter);
+}
+
+/*
+ * before rendering the next fragment, whose first frame will be heard after
+ * <delay> seconds (-1.0: unknown): maps frames to the time of MIDI clock
+ * and LAN beat sync and follows their masters
+ */
+static void synchronize(dsp_t* dsp, double delay)
+{
+  if (delay >= 0.0) {
+    if (dsp->clock)
+      midiclock_anchor(dsp->clock, dsp->framepos, delay);
+    if (dsp->master)
+      midiclock_anchor(dsp->master, dsp->framepos, delay);
+    if (dsp->netsync)
+      netsync_anchor(dsp->netsync, dsp->framepos, delay);
+    if (dsp->beatshm)
+      beatshm_anchor(dsp->beatshm, dsp->framepos, delay);
+  }
+
+  if (dsp->netsync)
+    netsync_poll(dsp->netsync);
+  if (dsp->master)
+    follow_clock(dsp);
+  else if (dsp->netsync && !dsp->netsync->leader)
+    follow_leader(dsp);
+}
+
+/*
+ * Feed pulseaudio stream with next samples
+ */
+gboolean pulse_feed(dsp_t* dsp)
+{
+  int fragments; /* number of fragments yet to write */
+  int error;
+  fragments = 1;
+
+  if (dsp->clock || dsp->master || dsp->netsync || dsp->beatshm) {
+    pa_usec_t latency = pa_simple_get_latency(dsp->pas, &error);
+
+    synchronize(dsp, latency != (pa_usec_t) -1 ? latency / 1e6 : -1.0);
+  }
+
+  /* write as many fragments as possible */
+  while (fragments > 0) {
+    write_device(dsp, render_fragment(dsp, dsp->fragmentframes),
+                 dsp->fragmentsize);
+    fragments--;
+  }
+  if (dsp->clock)
+    midiclock_flush(dsp->clock);
+
+#if 0
+  if (pa_simple_drain(dsp->pas, &error) < 0) {
+    g_print("pulse_feed: pa_simple_drain ERROR: %s\n", pa_strerror(error));
+  }
+#endif
+
+  return 1;
+}
+
+/*
+ * Feed dsp device with next samples
+ *
+ * used as output start and callback
+ */
+gboolean dsp_feed(dsp_t* dsp)
+{
+  audio_buf_info info; /* OSS structure to obtain buffering parameters */
+
+  int fragments; /* number of fragments yet to write */
+  int limit; /* number of fragments we want to have filled */
+
+  /* get number of fragments to write to dsp */
+  if (ioctl(dsp->dspfd, SNDCTL_DSP_GETOSPACE, &info) == -1) {
+    perror("SNDCTL_DSP_GETOSPACE");
+  }
+
+  limit =
+    dsp->rate * dsp->channels * dsp->samplesize / 8 *
+    WRITE_AHEAD_INTERVAL / (1000 * dsp->fragmentsize);
+  if (limit < 2) /* we want to have filled at least 2 fragments */
+    limit = 2;
+  fragments = limit - (info.fragstotal - info.fragments);
+
+  if (dsp->clock || dsp->master || dsp->netsync || dsp->beatshm) {
+    int delay; /* bytes written but not yet played */
+
+    synchronize(dsp, ioctl(dsp->dspfd, SNDCTL_DSP_GETODELAY, &delay) != -1 ?
+                (double) delay * 8 /
+                (dsp->rate * dsp->channels * dsp->samplesize) : -1.0);
+  }
+
+  /* write as many fragments as possible */
+  while (fragments > 0) {
+    write_device(dsp, render_fragment(dsp, dsp->fragmentframes),
+                 dsp->fragmentsize);
+    fragments--;
+  }
+  if (dsp->clock)
+    midiclock_flush(dsp->clock);
+
+  return 1;
+}
+
+/*
+ * prepares <dsp> to render without sound device: <rate> and <channels> of
+ * output with sample <format> (see formats, above), generated exactly as in
+ * playback, by dsp_offline_render() until dsp_offline_stop()
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int dsp_offline_start(dsp_t* dsp, int rate, int channels, int format)
+{
+  unsigned int format_index;
+
+  if (dsp->running)
+    return -1;
+
+  for (format_index = 0;
+       formats[format_index].format != 0 &&
+       formats[format_index].format != format;
+       format_index++);
+  if (!formats[format_index].format || rate <= 0 || channels <= 0)
+    return -1;
+
+  dsp->offline = 1;
+  dsp->format = format;
+  dsp->samplesize = formats[format_index].samplesize;
+  dsp->rate = rate;
+  dsp->channels = channels;
+  dsp->fragmentsize = dsp->rate / 10 * dsp->channels * dsp->samplesize / 8;
+  dsp->fragment = g_malloc(dsp->fragmentsize);
+
+  if (prepare_playback(dsp) == -1) {
+    dsp_offline_stop(dsp);
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * renders the next <frames> of output to <buffer>, in the format given to
+ * dsp_offline_start()
+ */
+void dsp_offline_render(dsp_t* dsp, void* buffer, int frames)
+{
+  unsigned char* dest = (unsigned char*) buffer;
+  int framesize = dsp->channels * dsp->samplesize / 8;
+
+  while (frames > 0) {
+    int n = MIN(frames, dsp->fragmentframes);
+
+    memcpy(dest, render_fragment(dsp, n), n * framesize);
+    dest += n * framesize;
+    frames -= n;
+  }
+}
+
+/*
+ * renders the next <frames> of output to <buffer> as floating point samples
+ * (-1.0 ... 1.0), regardless of the format given to dsp_offline_start()
+ *
+ * doesn't allocate memory, e.g. for plugins in a realtime thread
+ */
+void dsp_offline_render_float(dsp_t* dsp, float* buffer, int frames)
+{
+  while (frames > 0) {
+    int n = MIN(frames, dsp->fragmentframes);
+
+    mix_fragment(dsp, n);
+    mixer_encode_float(buffer, dsp->mix, n * dsp->channels);
+    buffer += n * dsp->channels;
+    frames -= n;
+  }
+}
+
+/*
+ * prepares all variants of sound <name> until dsp_deinit(), so changing
+ * rhythm with dsp_set_rhythm() never prepares voices (allocating memory)
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int dsp_pin_voices(dsp_t* dsp, const char* name)
+{
+  if (!dsp->bank ||
+      soundbank_acquire(dsp->bank, name, VOICE_VARIANT_NORMAL) == -1 ||
+      soundbank_acquire(dsp->bank, name, VOICE_VARIANT_ACCENT) == -1 ||
+      soundbank_acquire(dsp->bank, name, VOICE_VARIANT_SECONDARY) == -1)
+    return -1;
+  return 0;
+}
+
+/*
+ * changes <meter> with DSP_BEAT_* <accents> for each tick and <subdivision>
+ * of the current parameter block in place, keeping the position (e.g. of a
+ * plugin following its host)
+ *
+ * doesn't allocate memory if the voices are pinned (see dsp_pin_voices())
+ */
+void dsp_set_rhythm(dsp_t* dsp, int meter, const int* accents,
+                    int subdivision)
+{
+  dsp_params_t* params = dsp->params;
+
+  params->meter = CLAMP(meter, 1, MAX_METER);
+  memset(params->accents, 0, sizeof(params->accents));
+  memcpy(params->accents, accents, params->meter * sizeof(int));
+  params->subdivision = CLAMP(subdivision, 1, DSP_MAX_SUBDIVISION);
+  update_voices(dsp, params);
+
+  if (dsp->cyclepos >= params->meter)
+    dsp->cyclepos = 0;
+  while (dsp->subpos > 0 && subbeat_offset(dsp, dsp->subpos) > dsp->tickpos)
+    dsp->subpos--;
+  if (dsp->running)
+    sync_layers(dsp);
+}
+
+/*
+ * continues playing at <frequency> from <position>, counted in ticks since
+ * the start of the bar, e.g. 2.5: middle of the third tick; a tick or sub
+ * beat starting right at the position is played, a voice in the middle of
+ * a tick is cut off
+ *
+ * a position matching the current one (up to a frame) only changes the
+ * tempo, so hosts may report their position in each cycle
+ *
+ * doesn't allocate memory, see dsp_set_rhythm()
+ */
+void dsp_locate(dsp_t* dsp, double frequency, double position)
+{
+  int meter = dsp->params->meter;
+  int cyclepos;
+  int tickpos;
+
+  dsp->params->frequency = frequency;
+  dsp->params->ramp_target = 0.0;
+  update_ticklen(dsp);
+
+  position = fmod(position, meter);
+  if (position < 0.0)
+    position += meter;
+  cyclepos = (int) position;
+  tickpos = lrint((position - cyclepos) * dsp->ticklen);
+  if (tickpos >= dsp->ticklen) {
+    cyclepos = (cyclepos + 1) % meter;
+    tickpos = 0;
+  }
+
+  if (cyclepos == dsp->cyclepos && abs(tickpos - dsp->tickpos) <= 1)
+    return;
+
+  if (tickpos == 0) { /* the tick starts with the next frame */
+    dsp->cyclepos = (cyclepos + meter - 1) % meter;
+    dsp->tickpos = dsp->ticklen;
+  } else {
+    dsp->cyclepos = cyclepos;
+    dsp->tickpos = tickpos;
+    dsp->subpos = 0;
+    while (dsp->subpos + 1 < dsp->params->subdivision &&
+           subbeat_offset(dsp, dsp->subpos + 1) < tickpos)
+      dsp->subpos++;
+    trigger_slot(dsp, DSP_SLOT_TICK, SOUNDBANK_SILENCE, 0.0);
+    trigger_slot(dsp, DSP_SLOT_SUB, SOUNDBANK_SILENCE, 0.0);
+    trigger_slot(dsp, DSP_SLOT_PULSE, SOUNDBANK_SILENCE, 0.0);
+  }
+  sync_layers(dsp);
+}
+
+/*
+ * ends rendering started by dsp_offline_start()
+ */
+void dsp_offline_stop(dsp_t* dsp)
+{
+  dsp_deinit(dsp);
+  g_free(dsp->fragment);
+  dsp->fragment = NULL;
+  dsp->offline = 0;
+}
+
+/*
+ * makes <dsp> a guest rendered by another dsp object (see dsp_t.render) via
+ * dsp_guest_mix(): mono output at <rate> in fragments of up to <frames>,
+ * started and stopped by its client without opening a sound device
+ *
+ * a running guest restarts at the beginning of the bar if <rate> or
+ * <frames> changed
+ */
+void dsp_set_guest(dsp_t* dsp, int rate, int frames)
+{
+  int running = dsp->running;
+
+  if (dsp->guest && dsp->rate == rate && dsp->fragmentframes == frames)
+    return;
+
+  if (running)
+    dsp_deinit(dsp);
+  dsp->guest = 1;
+  dsp->format = AFMT_S16_NE;
+  dsp->samplesize = 16;
+  dsp->channels = 1;
+  dsp->rate = rate;
+  dsp->fragmentsize = frames * dsp->samplesize / 8;
+  dsp->fragmentframes = frames;
+  if (running && prepare_playback(dsp) == -1) {
+    send_response(dsp, MESSAGE_TYPE_RESPONSE_START_ERROR, NULL);
+    dsp_deinit(dsp);
+  }
+}
+
+/*
+ * generates the next <frames> (at most the fragment size given to
+ * dsp_set_guest()) of guest <dsp>
+ *
+ * returns the accumulator holding the output, NULL if the guest is stopped
+ */
+const int* dsp_guest_mix(dsp_t* dsp, int frames)
+{
+  if (!dsp->running)
+    return NULL;
+
+  mix_buses(dsp, frames); /* mono: the bus of the only channel, no copy */
+  return dsp->routes[0];
+}
+
+/*
+ * renders <seconds> of metronome output with parameter block <params>
+ * (taken over like with MESSAGE_TYPE_SET_PARAMS) to WAV file <filename>,
+ * without sound device
+ *
+ * the output is generated exactly as in playback: tempo ramps, sub beats
+ * and layers included
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int dsp_render(dsp_t* dsp, dsp_params_t* params,
+               const char* filename, double seconds)
+{
+  wavfile_t* wav;
+  unsigned char* buffer;
+  long long frames;
+  int result = 0;
+
+  set_params(dsp, params);
+
+  if (dsp_offline_start(dsp, DEFAULT_RATE, DEFAULT_CHANNELS,
+                        DEFAULT_FORMAT) == -1)
+    return -1;
+
+  if (!(wav = wavfile_open(filename, dsp->rate, dsp->channels))) {
+    result = -1;
+  } else {
+    buffer = (unsigned char*) g_malloc(dsp->fragmentsize);
+    for (frames = seconds * dsp->rate; frames > 0 && result == 0;
+         frames -= dsp->fragmentframes)
+    {
+      int n = MIN(frames, dsp->fragmentframes);
+
+      dsp_offline_render(dsp, buffer, n);
+      result = wavfile_write(wav, buffer, n * dsp->channels * 2);
     }
+    free(buffer);
+    if (wavfile_close(wav) == -1)
+      result = -1;
+  }
+
+  dsp_offline_stop(dsp);
+
+  return result;
+}
+
+/*
+ * Gets mixer setting
+ *
+ * returns value from 0.0 to 1.0 on success
+ */
+double dsp_get_volume(dsp_t* dsp)
+{
+  assert(dsp->volume >= 0.0 && dsp->volume <= 1.0);
+
+  return dsp->volume;
+}
+
+/*
+ * Sets mixer setting
+ *
+ * accepts a value from 0.0 to 1.0
+ */
+void dsp_set_volume(dsp_t* dsp, double volume)
+{
+  assert(volume >= 0.0 && volume <= 1.0);
+
+  dsp->volume = volume;
+}
+
+/*
+ * returns new status report of <dsp>
+ */
+static dsp_status_t* get_status(dsp_t* dsp, unsigned int sequence) {
+  dsp_status_t* result;
+
+  result = (dsp_status_t*) g_malloc0(sizeof(dsp_status_t));
+  result->sequence = sequence;
+  result->running = dsp->running;
+  result->bpm =
+    (dsp->running ? dsp->frequency : dsp->params->frequency) * 60.0;
+  result->meter = dsp->params->meter;
+  memcpy(result->accents, dsp->params->accents, sizeof(result->accents));
+  result->beat = dsp->cyclepos;
+  result->volume = dsp->volume;
+
+  return result;
+}
+
+/*
+ * handles query <message_type> with body <message> from the client,
+ * clearing <repeat_flag> on STOP_SERVER and setting <get_volume> on
+ * GET_VOLUME
+ */
+static void handle_query(dsp_t* dsp, message_type_t message_type,
+                         void* message, int* repeat_flag, int* get_volume)
+{
+  switch (message_type) {
+    case MESSAGE_TYPE_STOP_SERVER:
+      *repeat_flag = 0;
+      break;
+    case MESSAGE_TYPE_SET_DEVICE:
+      if (dsp->devicename) free(dsp->devicename);
+      dsp->devicename = (char*) message;
+      break;
+    case MESSAGE_TYPE_SET_SOUND:
+      set_sound(dsp, (char*) message);
+      break;
+    case MESSAGE_TYPE_SET_SOUNDSYSTEM:
+      if (dsp->soundsystem) free(dsp->soundsystem);
+      dsp->soundsystem = (char*) message;
+      break;
+    case MESSAGE_TYPE_SET_METER:
+      dsp->params->meter = *((int*) message);
+      update_voices(dsp, dsp->params);
+      if (dsp->pending) {
+	dsp->pending->meter = dsp->params->meter;
+	update_voices(dsp, dsp->pending);
+      }
+      if (dsp->cyclepos >= dsp->params->meter)
+	dsp->cyclepos = 0;
+      if (dsp->running)
+	sync_layers(dsp);
+      free(message);
+      break;
+    case MESSAGE_TYPE_SET_ACCENTS:
+      memcpy(dsp->params->accents, message, sizeof(dsp->params->accents));
+      update_voices(dsp, dsp->params);
+      if (dsp->pending) {
+	memcpy(dsp->pending->accents, message,
+	       sizeof(dsp->pending->accents));
+	update_voices(dsp, dsp->pending);
+      }
+      free(message);
+      break;
+    case MESSAGE_TYPE_SET_FREQUENCY: /* stops tempo ramps */
+      dsp->params->frequency = *((double*) message);
+      dsp->params->ramp_target = 0.0;
+      if (dsp->pending) {
+	dsp->pending->frequency = dsp->params->frequency;
+	dsp->pending->ramp_target = 0.0;
+      }
+      if (dsp->running)
+	update_ticklen(dsp);
+      free(message);
+      break;
+    case MESSAGE_TYPE_SET_PARAMS:
+      set_params(dsp, (dsp_params_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_TIMELINE:
+      dsp_set_timeline(dsp, (timeline_t*) message);
+      break;
+    case MESSAGE_TYPE_SEEK_BAR:
+      seek_bar(dsp, *((int*) message));
+      free(message);
+      break;
+    case MESSAGE_TYPE_SET_MIDICLOCK:
+      dsp_set_midiclock(dsp, (midiclock_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_MASTER:
+      dsp_set_master(dsp, (midiclock_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_NETSYNC:
+      dsp_set_netsync(dsp, (netsync_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_BEATSHM:
+      dsp_set_beatshm(dsp, (beatshm_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_FANOUT:
+      dsp_set_fanout(dsp, (fanout_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_BACKING: /* at next start */
+      dsp_set_backing(dsp, (backing_t*) message);
+      break;
+    case MESSAGE_TYPE_SET_CHANNEL_MAP: /* number of channels: at next start */
+      if (dsp->channel_map)
+	dsp_channel_map_delete(dsp->channel_map);
+      dsp->channel_map = (dsp_channel_map_t*) message;
+      dsp->channels_requested =
+	dsp->channel_map ? dsp->channel_map->channels : 0;
+      if (dsp->bank)
+	setup_routes(dsp);
+      break;
+    case MESSAGE_TYPE_START_METRONOME:
+      if (dsp->running)
+	break;
+      if ((dsp->guest ? prepare_playback(dsp) : dsp_init(dsp)) == -1) {
+	send_response(dsp, MESSAGE_TYPE_RESPONSE_START_ERROR, NULL);
+	dsp_deinit(dsp);
+      }
+      break;
+    case MESSAGE_TYPE_STOP_METRONOME:
+      dsp_deinit(dsp);
+      break;
+    case MESSAGE_TYPE_START_SYNC:
+      dsp->sync_flag = 1;
+      break;
+    case MESSAGE_TYPE_STOP_SYNC:
+      dsp->sync_flag = 0;
+      break;
+    case MESSAGE_TYPE_SET_VOLUME:
+      dsp_set_volume(dsp, *((double*) message));
+      free(message);
+      break;
+    case MESSAGE_TYPE_GET_VOLUME:
+      *get_volume = 1;
+      break;
+    case MESSAGE_TYPE_BATCH: /* all queries before the next fragment */
+      {
+	comm_batch_t* batch = (comm_batch_t*) message;
+	int i;
+
+	for (i = 0; i < batch->n; i++)
+	  handle_query(dsp, batch->messages[i].type,
+		       batch->messages[i].body, repeat_flag, get_volume);
+	if (batch->reply)
+	  g_async_queue_push(batch->reply, get_status(dsp, batch->sequence));
+	send_response(dsp, MESSAGE_TYPE_RESPONSE_STATUS,
+		      get_status(dsp, batch->sequence));
+	comm_batch_delete(batch);
+      }
+      break;
+    default:
+      fprintf(stderr, "Warning: Unhandled message type in audio thread.\n");
+  }
+}
+
+/*
+ * handles all queries waiting, e.g. before rendering offline in the client's
+ * thread, see handle_query()
+ */
+void dsp_handle_queries(dsp_t* dsp, int* repeat_flag, int* get_volume)
+{
+  message_type_t message_type;
+  void* message;
+
+  while ((message_type = comm_server_try_get_query(dsp->inter_thread_comm,
+                                                   &message))
+         != MESSAGE_TYPE_NO_MESSAGE)
+  {
+    handle_query(dsp, message_type, message, repeat_flag, get_volume);
+  }
+}
+
+/*
+ * the main loop of the metronome
+ */
+void dsp_main_loop(dsp_t* dsp) {
+  struct timespec requested = { (WRITE_AHEAD_INTERVAL / 2) / 1000,
+                                ((WRITE_AHEAD_INTERVAL / 2) % 1000) * 1000};
+  struct timespec remaining; /* dummy */
+  int repeat_flag = 1;
+
+  while (repeat_flag) {
+    int get_volume = 0;         /* flag */
+    void* reply = NULL;
+
+    dsp_handle_queries(dsp, &repeat_flag, &get_volume);
 
     if (get_volume) {
       double volume = dsp_get_volume(dsp);
@@ -1004,8 +2935,7 @@ void dsp_main_loop(dsp_t* dsp) {
       reply = (double*) g_malloc0 (sizeof(double));
       *((double*)reply) = volume;
       if (*((double*)reply) != -1) {
-	comm_server_send_response(dsp->inter_thread_comm,
-				  MESSAGE_TYPE_RESPONSE_VOLUME, reply);
+	send_response(dsp, MESSAGE_TYPE_RESPONSE_VOLUME, reply);
       } else {
 	free(reply);
       }
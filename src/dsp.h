@@ -25,17 +25,184 @@
 #ifndef DSP_H
 #define DSP_H
 
-/* GTK headers */
-#include <gtk/gtk.h>
+/* GTK+ headers */
+#include <glib.h>
 
 #include <pulse/simple.h>
 
 /* own headers */
+#include "afmt.h"
+#include "globals.h"
+#include "soundbank.h"
 #include "threadtalk.h"
+#include "timeline.h"
+#include "midiclock.h"
+#include "pll.h"
+#include "netsync.h"
+#include "beatshm.h"
+#include "fanout.h"
+#include "wavfile.h"
+#include "backing.h"
 
-typedef struct dsp_t {
+/* values of dsp_params_t.accents[] */
+#define DSP_BEAT_NORMAL 0 /* regular tick */
+#define DSP_BEAT_ACCENT 1 /* accentuated tick */
+#define DSP_BEAT_OFF    2 /* silent tick */
+
+/* maximum number of sub beats per tick (tuplets) */
+#define DSP_MAX_SUBDIVISION 32
+
+/* maximum number of additional pulse layers (polyrhythms) */
+#define DSP_MAX_LAYERS 8
+
+/* playback slots: voices sounding at the same time, mixed into one output */
+#define DSP_SLOT_TICK  0  /* started at the beginning of each tick */
+#define DSP_SLOT_SUB   1  /* started at each sub beat */
+#define DSP_SLOT_LAYER 2  /* started at each pulse of a layer (one per layer) */
+#define DSP_SLOT_PULSE (DSP_SLOT_LAYER + DSP_MAX_LAYERS) /* sync pulse at
+                             each tick and sub beat */
+#define DSP_SLOTS      (DSP_SLOT_PULSE + 1)
+
+/* mono buses the slots are mixed into, routed to the channels of the device */
+#define DSP_BUS_SILENCE 0 /* nothing */
+#define DSP_BUS_CLICK   1 /* all voices besides the sync pulse */
+#define DSP_BUS_CUE     2 /* accentuated ticks only */
+#define DSP_BUS_PULSE   3 /* square sync pulse, independent of volume */
+#define DSP_BUS_TRACK   4 /* backing track, on the click if not played */
+#define DSP_BUSES       5
+
+/* maximum number of channels of a channel map */
+#define DSP_MAX_CHANNELS 32
+
+/* flags of dsp_t.reported: diagnostics printed once per dsp object */
+#define DSP_REPORTED_OPEN   1 /* device parameters (debug) */
+#define DSP_REPORTED_CLOSE  2 /* closing of device (debug) */
+#define DSP_REPORTED_FORMAT 4 /* sample format not supported */
+
+/*
+ * point in time at which a new parameter block takes effect
+ */
+typedef enum dsp_quantize_t {
+  DSP_QUANTIZE_NOW,  /* immediately, even within the current tick */
+  DSP_QUANTIZE_BEAT, /* at the start of the next tick */
+  DSP_QUANTIZE_BAR   /* at the start of the next cycle (first tick of meter) */
+} dsp_quantize_t;
+
+/*
+ * course of a tempo ramp from frequency to ramp_target of a parameter block
+ */
+typedef enum dsp_ramp_shape_t {
+  DSP_RAMP_LINEAR,      /* constant change of BPM per time unit */
+  DSP_RAMP_EXPONENTIAL  /* constant ratio of BPM per time unit */
+} dsp_ramp_shape_t;
+
+typedef enum dsp_ramp_unit_t {
+  DSP_RAMP_BARS,        /* ramp_length counts cycles of the meter */
+  DSP_RAMP_SECONDS      /* ramp_length counts seconds */
+} dsp_ramp_unit_t;
+
+/*
+ * additional pulse stream, dividing the cycle of the meter (bar) evenly,
+ * e.g. 3 pulses against meter 4
+ */
+typedef struct dsp_layer_t {
+  int pulses;              /* number of pulses per bar */
+  int accents[MAX_METER];  /* DSP_BEAT_* for each pulse */
+  char* soundname;         /* sound of pulses, NULL: soundname of ticks */
+  double gain;             /* volume relative to ticks */
+
+  /* set up by audio thread: sound bank voice for each pulse */
+  unsigned char voices[MAX_METER];
+} dsp_layer_t;
+
+/*
+ * complete set of musical parameters, applied by the audio thread as a whole
+ */
+typedef struct dsp_params_t {
+  double frequency;        /* ticking frequency in Hz */
+  int meter;               /* meter mode */
+  int accents[MAX_METER];  /* DSP_BEAT_* for each tick in meter */
+  char* soundname;         /* sound name or filename, NULL: unchanged */
+  char* sounds[MAX_METER]; /* sound for each tick, NULL: soundname */
+
+  int subdivision;         /* number of sub beats per tick, 1: none */
+  char* subsound;          /* sound of sub beats, NULL: soundname */
+  double subgain;          /* volume of sub beats relative to ticks */
+
+  int n_layers;            /* number of pulse layers played with the ticks */
+  dsp_layer_t layers[DSP_MAX_LAYERS];
+
+  /* tempo ramp, starting when the block is applied */
+  double ramp_target;      /* frequency at end of ramp in Hz, 0.0: no ramp */
+  double ramp_length;      /* duration in ramp_unit */
+  dsp_ramp_unit_t ramp_unit;
+  dsp_ramp_shape_t ramp_shape;
+
+  dsp_quantize_t quantize;
+
+  /* set up by audio thread: sound bank voice for each tick and sub beats */
+  unsigned char voices[MAX_METER];
+  unsigned char subvoice;
+  int voices_acquired;
+} dsp_params_t;
+
+/*
+ * DSP_BUS_* played on each channel of the device, e.g. click on channels 1
+ * and 2, accents on a cue channel and the sync pulse on channel 4 for an
+ * analog sequencer
+ */
+typedef struct dsp_channel_map_t {
+  int channels;                 /* number of channels */
+  int buses[DSP_MAX_CHANNELS];  /* for each channel */
+} dsp_channel_map_t;
+
+/*
+ * a voice being played back
+ */
+typedef struct dsp_slot_t {
+  int voice;        /* sound bank index, SOUNDBANK_SILENCE: none */
+  int pos;          /* next frame of voice */
+  double gain;      /* relative to dsp volume */
+  int bus;          /* DSP_BUS_* the voice is mixed into */
+  int cue;          /* accentuated tick: also mixed into DSP_BUS_CUE */
+} dsp_slot_t;
+
+/*
+ * state of following a MIDI clock master or LAN beat sync leader, reported
+ * once per tick
+ */
+typedef struct dsp_lock_t {
+  int locked;         /* ticks follow the master */
+  double bpm;         /* tempo of master */
+  double phase_error; /* deviation of last clock pulse (LAN: of tick) in
+                         milliseconds */
+  double jitter;      /* RMS of deviations (LAN: of clock offset
+                         measurements) in milliseconds */
+} dsp_lock_t;
+
+/*
+ * state of the metronome, reported after each batch of queries
+ */
+typedef struct dsp_status_t {
+  unsigned int sequence;   /* of the batch answered */
+  int running;
+  double bpm;              /* current tempo */
+  int meter;
+  int accents[MAX_METER];  /* DSP_BEAT_* for each tick in meter */
+  int beat;                /* number of current tick in bar */
+  double volume;           /* 0.0 ... 1.0 */
+} dsp_status_t;
+
+typedef struct dsp_t dsp_t;
+
+/*
+ * generates <frames> of output in the accumulator dsp->mix instead of the
+ * ticks of <dsp>, e.g. mixing other dsp objects into its device stream
+ */
+typedef void (*dsp_render_t)(void* data, dsp_t* dsp, int frames);
+
+struct dsp_t {
   char* devicename;
-  char* soundname;
   char* soundsystem;
 
   pa_simple *pas;   /* pa simple playback stream */
@@ -44,6 +211,7 @@ typedef struct dsp_t {
   int fragmentsize; /* fragment size */
   int fragstotal;   /* number of fragments in DSP buffer */
   int channels;     /* number of channels */
+  int channels_requested; /* from device, 0: default (mono) */
   int rate;         /* number of frames per second in Hz */
   int samplesize;   /* number of bits per item (usually 8 or 16) */
   int format;
@@ -52,33 +220,86 @@ typedef struct dsp_t {
   int channels_in;  /* number of channels of input data in Hz */
 
   unsigned char* fragment;
+  int fragmentframes; /* number of frames in fragment */
+  int* mix;           /* accumulator: fragmentframes * channels samples */
+  int* buses;         /* DSP_BUSES mono accumulators of fragmentframes */
+  const int** routes; /* bus played on each channel */
+  int routed;         /* bit mask of buses played on any channel */
+  dsp_channel_map_t* channel_map; /* NULL: click on all channels */
+  int pulsevoice;     /* sound bank voice of sync pulse,
+                         SOUNDBANK_SILENCE: no channel of pulse */
 
-  unsigned char* tickdata0; /* raw dsp sample bytes for single tick */
-  int td0_size;  /* length in bytes */
-  unsigned char* tickdata1; /* raw dsp sample bytes for first tick */
-  int td1_size;
-  unsigned char* tickdata2; /* dsp sample bytes for other ticks */
-  int td2_size;
-
-  unsigned char* silence; /* size = channels * samplesize / 8 */
+  soundbank_t* bank;  /* prepared voices, see dsp_params_t.voices */
+  dsp_slot_t slots[DSP_SLOTS];
 
-  short* frames;         /* the original frames yet to be scaled by volume */
+  char* frames_name;     /* sound name of frames */
+  const short* frames;   /* the original frames yet to be scaled by volume */
+  wavmap_t* frames_map;  /* file mapped for frames, NULL: frames allocated */
   int number_of_frames;
 
-  int meter;        /* meter mode */
-  double frequency; /* ticking frequency in Hz */
+  dsp_params_t* params;  /* parameters currently played */
+  dsp_params_t* pending; /* parameters waiting for their quantization point */
+
+  double frequency; /* current ticking frequency in Hz (see tempo ramps) */
+  int ticklen;      /* length of tick in frames, according to frequency */
   int cyclepos;     /* current number of tick (0, 1, 2 for 3/4) */
   int tickpos;      /* number of frame in tick */
-  int* accents;
+  int subpos;       /* number of last sub beat in tick (0: the tick itself) */
+  int pulsepos[DSP_MAX_LAYERS]; /* number of last pulse in bar of layers */
+
+  int ramp_ticks;        /* number of ticks since start of tempo ramp */
+  long long ramp_frames; /* number of frames since start of tempo ramp */
+
+  timeline_t* timeline;  /* schedule played instead of params, NULL: none */
+  long long timepos;     /* number of frame in timeline */
+  int cursor;            /* number of next event in timeline */
+
+  midiclock_t* clock;    /* MIDI clock output, NULL: none */
+  long long framepos;    /* number of frames rendered since start */
+  int clockpos;          /* number of last clock pulse in tick, -1: tick
+                            not yet sent */
+
+  midiclock_t* master;   /* MIDI clock input followed, NULL: none */
+  pll_t* pll;            /* clock pulses of master, in frames */
+  int master_position;   /* bar position of master known: 1, waiting for
+                            the first pulse after START or song position: 2,
+                            unknown: 0 */
+
+  netsync_t* netsync;    /* LAN beat sync (leader or follower), NULL: none */
+  beatshm_t* beatshm;    /* beat position export, NULL: none */
+  fanout_t* fanout;      /* further sinks of the output, NULL: none */
+  backing_t* backing;    /* backing track, NULL: none */
 
   int running;      /* on/off flag */
+  int offline;      /* rendering to file: no responses to client */
+  int quiet;        /* client doesn't read responses (besides batch
+                       replies): none sent */
+  int guest;        /* rendered by another dsp object (see dsp_set_guest()):
+                       started without sound device */
+
+  dsp_render_t render; /* output generator, NULL: ticks of this object */
+  void* render_data;   /* for render */
+
+  int debug;        /* level of runtime debugging output, 0: none */
+  int fixed_point;  /* sounds prepared in integer arithmetic, see
+                       mixer_resample() */
+  int reported;     /* DSP_REPORTED_* */
 
   double volume;    /* 0.0 ... 1.0 */
 
   int sync_flag;
 
   comm_t* inter_thread_comm;
-} dsp_t;
+};
+
+dsp_params_t* dsp_params_new(void);
+dsp_params_t* dsp_params_copy(const dsp_params_t* params);
+void dsp_params_delete(dsp_params_t* params);
+int dsp_params_set_layers(dsp_params_t* params, const char* layers);
+int dsp_params_set_ramp(dsp_params_t* params, const char* ramp);
+
+dsp_channel_map_t* dsp_channel_map_new(const char* spec);
+void dsp_channel_map_delete(dsp_channel_map_t* map);
 
 dsp_t* dsp_new(comm_t* comm);
 void dsp_delete(dsp_t* dsp);
@@ -88,10 +309,31 @@ void dsp_close(dsp_t* dsp);
 int dsp_init(dsp_t* dsp);
 void dsp_deinit(dsp_t* dsp);
 gboolean dsp_feed(dsp_t* dsp);
+int dsp_offline_start(dsp_t* dsp, int rate, int channels, int format);
+void dsp_offline_render(dsp_t* dsp, void* buffer, int frames);
+void dsp_offline_render_float(dsp_t* dsp, float* buffer, int frames);
+int dsp_pin_voices(dsp_t* dsp, const char* name);
+void dsp_set_rhythm(dsp_t* dsp, int meter, const int* accents,
+                    int subdivision);
+void dsp_locate(dsp_t* dsp, double frequency, double position);
+void dsp_offline_stop(dsp_t* dsp);
+void dsp_set_guest(dsp_t* dsp, int rate, int frames);
+const int* dsp_guest_mix(dsp_t* dsp, int frames);
+int dsp_render(dsp_t* dsp, dsp_params_t* params,
+               const char* filename, double seconds);
+
+void dsp_set_timeline(dsp_t* dsp, timeline_t* timeline);
+void dsp_set_midiclock(dsp_t* dsp, midiclock_t* clock);
+void dsp_set_master(dsp_t* dsp, midiclock_t* master);
+void dsp_set_netsync(dsp_t* dsp, netsync_t* netsync);
+void dsp_set_beatshm(dsp_t* dsp, beatshm_t* beatshm);
+void dsp_set_fanout(dsp_t* dsp, fanout_t* fanout);
+void dsp_set_backing(dsp_t* dsp, backing_t* backing);
 
 double dsp_get_volume(dsp_t* dsp);
 void dsp_set_volume(dsp_t* dsp, double volume);
 
+void dsp_handle_queries(dsp_t* dsp, int* repeat_flag, int* get_volume);
 void dsp_main_loop(dsp_t* dsp);
 
 #endif /* DSP_H */
@@ -0,0 +1,525 @@
+/*
+ * fanout.c: rendered stream written to further sinks
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+#include <pulse/simple.h>
+#include <pulse/error.h>
+
+/* own headers */
+#include "globals.h"
+#include "afmt.h"
+#include "fanout.h"
+
+/* default OSS device of sinks */
+#define FANOUT_OSS_DEVICE "/dev/dsp"
+
+/*
+ * WAV encoding of the sample formats of the sound device: samples in a layout
+ * WAV files don't have are converted by the thread of the sink
+ */
+typedef struct wav_format_t {
+  int format;              /* AFMT_* */
+  int tag;                 /* WAVFILE_* */
+  int bits;                /* per sample in file */
+  int swap;                /* big endian */
+  int shift;               /* bits samples are moved up by */
+} wav_format_t;
+
+static const wav_format_t wav_formats[] = {
+  { AFMT_U8,         WAVFILE_PCM,    8, 0, 0 },
+  { AFMT_S16_LE,     WAVFILE_PCM,   16, 0, 0 },
+  { AFMT_S16_BE,     WAVFILE_PCM,   16, 1, 0 },
+  { AFMT_S24_PACKED, WAVFILE_PCM,   24, 0, 0 },
+  { AFMT_S24_LE,     WAVFILE_PCM,   32, 0, 8 },
+  { AFMT_S24_BE,     WAVFILE_PCM,   32, 1, 8 },
+  { AFMT_S32_LE,     WAVFILE_PCM,   32, 0, 0 },
+  { AFMT_S32_BE,     WAVFILE_PCM,   32, 1, 0 },
+  { AFMT_FLOAT,      WAVFILE_FLOAT, 32, G_BYTE_ORDER == G_BIG_ENDIAN, 0 },
+  { AFMT_MU_LAW,     WAVFILE_MULAW,  8, 0, 0 },
+  { AFMT_A_LAW,      WAVFILE_ALAW,   8, 0, 0 }
+};
+
+/*
+ * returns new fanout for <spec>: sinks "TYPE[:TARGET][@MS]" separated by
+ * ',' with TYPE "oss" (device, default: /dev/dsp), "pulse" (PulseAudio sink,
+ * default: server's default) or "wav" (file), each written MS milliseconds
+ * later for latency compensation; "device@MS" delays the sound device itself,
+ * e.g. "device@12,oss:/dev/dsp1,wav:/tmp/take.wav@3.5"
+ *
+ * returns NULL on error
+ */
+fanout_t* fanout_new(const char* spec)
+{
+  fanout_t* result;
+  char* copy = strdup(spec);
+  char* state;
+  char* entry;
+  int error = 0;
+
+  result = (fanout_t*) g_malloc0(sizeof(fanout_t));
+  for (entry = strtok_r(copy, ",", &state);
+       entry && !error;
+       entry = strtok_r(NULL, ",", &state))
+  {
+    fanout_sink_t* sink = &result->sinks[result->n];
+    char* target = strchr(entry, ':');
+    char* ms = strrchr(target ? target : entry, '@');
+    char* end = NULL;
+    double delay = 0.0;
+
+    if (ms) {
+      *ms++ = '\0';
+      delay = strtod(ms, &end) / 1000.0;
+    }
+    if (target)
+      *target++ = '\0';
+    if (ms && (*end || delay < 0.0 || delay > 10.0)) {
+      error = 1;
+    } else if (!strcmp(entry, "device") && !target) {
+      result->delay = delay;
+    } else if (result->n == FANOUT_MAX_SINKS) {
+      error = 1;
+    } else {
+      if (!strcmp(entry, "oss"))
+	sink->type = FANOUT_SINK_OSS;
+      else if (!strcmp(entry, "pulse"))
+	sink->type = FANOUT_SINK_PULSE;
+      else if (!strcmp(entry, "wav") && target && *target)
+	sink->type = FANOUT_SINK_WAV;
+      else
+	error = 1;
+      sink->target = strdup(target ? target : "");
+      sink->delay = delay;
+      sink->fd = -1;
+      sink->queue = g_async_queue_new();
+      sink->fanout = result;
+      result->n++;
+    }
+  }
+  free(copy);
+
+  result->pool = g_async_queue_new();
+  if (error || (result->n == 0 && result->delay == 0.0)) {
+    fprintf(stderr, "Warning: Bad sink specification \"%s\".\n", spec);
+    fanout_delete(result);
+    return NULL;
+  }
+  return result;
+}
+
+void fanout_delete(fanout_t* fanout)
+{
+  int i;
+
+  fanout_stop(fanout);
+  for (i = 0; i < fanout->n; i++) {
+    free(fanout->sinks[i].target);
+    g_async_queue_unref(fanout->sinks[i].queue);
+  }
+  g_async_queue_unref(fanout->pool);
+  free(fanout);
+}
+
+/*
+ * hands <buffer> back to the pool if nobody writes it anymore
+ */
+static void unref_buffer(fanout_buffer_t* buffer)
+{
+  if (g_atomic_int_dec_and_test(&buffer->refcount))
+    g_async_queue_push(buffer->pool, buffer);
+}
+
+/*
+ * returns new buffer for a fragment of <fanout>
+ */
+static fanout_buffer_t* new_buffer(fanout_t* fanout)
+{
+  fanout_buffer_t* result;
+
+  result = (fanout_buffer_t*) g_malloc0(sizeof(fanout_buffer_t));
+  result->data = (unsigned char*) g_malloc(fanout->fragmentsize);
+  result->pool = fanout->pool;
+  return result;
+}
+
+/*
+ * converts <size> bytes of samples at <data> into sink->converted: to little
+ * endian, moved up by sink->shift bits
+ */
+static void convert_samples(fanout_sink_t* sink, const unsigned char* data,
+                            int size)
+{
+  int bytes = sink->fanout->framesize / sink->fanout->channels;
+  unsigned char* dest = sink->converted;
+  int i, j;
+
+  for (i = 0; i < size; i += bytes) {
+    guint32 sample = 0;
+
+    for (j = 0; j < bytes; j++) {
+      int k = sink->swap ? bytes - 1 - j : j;
+
+      sample |= (guint32) data[i + k] << (8 * j);
+    }
+    sample <<= sink->shift;
+    for (j = 0; j < bytes; j++)
+      dest[i + j] = (unsigned char) (sample >> (8 * j));
+  }
+}
+
+/*
+ * writes <size> bytes of <data> to <sink>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int write_sink(fanout_sink_t* sink, const unsigned char* data, int size)
+{
+  int error;
+
+  switch (sink->type) {
+  case FANOUT_SINK_OSS:
+    while (size > 0) {
+      ssize_t n = write(sink->fd, data, size);
+
+      if (n <= 0)
+	return -1;
+      data += n;
+      size -= n;
+    }
+    return 0;
+  case FANOUT_SINK_PULSE:
+    return pa_simple_write(sink->pas, data, size, &error) < 0 ? -1 : 0;
+  case FANOUT_SINK_WAV:
+    if (sink->converted) {
+      convert_samples(sink, data, size);
+      data = sink->converted;
+    }
+    return wavfile_write(sink->wav, data, size);
+  }
+  return -1;
+}
+
+/*
+ * thread of <sink>: writes the silence of its delay, then the fragments
+ * queued until it is stopped
+ */
+static gpointer sink_loop(fanout_sink_t* sink)
+{
+  fanout_t* fanout = sink->fanout;
+  fanout_buffer_t* buffer;
+  int size = lrint(sink->delay * fanout->rate) * fanout->framesize;
+  unsigned char* silence = (unsigned char*) g_malloc(fanout->fragmentsize);
+  int failed = 0;
+
+  memset(silence, fanout->silence, fanout->fragmentsize);
+  while (size > 0 && !failed) {
+    int n = MIN(size, fanout->fragmentsize);
+
+    failed = write_sink(sink, silence, n) == -1;
+    size -= n;
+  }
+  free(silence);
+
+  while ((buffer = g_async_queue_pop(sink->queue)) != (void*) fanout) {
+    if (!failed && write_sink(sink, buffer->data, buffer->size) == -1) {
+      fprintf(stderr, "Warning: Couldn't write to sink \"%s\".\n",
+              sink->target);
+      failed = 1;
+    }
+    unref_buffer(buffer);
+  }
+  return NULL;
+}
+
+/*
+ * opens <sink> with the parameters of <fanout>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int open_sink(fanout_t* fanout, fanout_sink_t* sink)
+{
+  pa_sample_spec spec;
+  int format = fanout->format;
+  int channels = fanout->channels;
+  int rate = fanout->rate;
+  int n_wav_formats = sizeof(wav_formats) / sizeof(wav_format_t);
+  int error;
+  int i;
+
+  switch (sink->type) {
+  case FANOUT_SINK_OSS:
+    if ((sink->fd = open(*sink->target ? sink->target : FANOUT_OSS_DEVICE,
+                         O_WRONLY)) == -1)
+    {
+      perror(sink->target);
+      return -1;
+    }
+    if (ioctl(sink->fd, SNDCTL_DSP_SETFMT, &format) == -1 ||
+        ioctl(sink->fd, SNDCTL_DSP_CHANNELS, &channels) == -1 ||
+        ioctl(sink->fd, SNDCTL_DSP_SPEED, &rate) == -1 ||
+        format != fanout->format || channels != fanout->channels ||
+        rate != fanout->rate)
+    {
+      fprintf(stderr, "Warning: Sink \"%s\" doesn't take the output format "
+                      "of the sound device.\n", sink->target);
+      return -1;
+    }
+    return 0;
+
+  case FANOUT_SINK_PULSE:
+    spec.channels = channels;
+    spec.rate = rate;
+    switch (format) {
+    case AFMT_S16_LE: spec.format = PA_SAMPLE_S16LE; break;
+    case AFMT_S16_BE: spec.format = PA_SAMPLE_S16BE; break;
+    case AFMT_S32_LE: spec.format = PA_SAMPLE_S32LE; break;
+    case AFMT_S32_BE: spec.format = PA_SAMPLE_S32BE; break;
+    case AFMT_S24_LE: spec.format = PA_SAMPLE_S24_32LE; break;
+    case AFMT_S24_BE: spec.format = PA_SAMPLE_S24_32BE; break;
+    case AFMT_S24_PACKED: spec.format = PA_SAMPLE_S24LE; break;
+    case AFMT_FLOAT:  spec.format = PA_SAMPLE_FLOAT32NE; break;
+    case AFMT_U8:     spec.format = PA_SAMPLE_U8;    break;
+    case AFMT_MU_LAW: spec.format = PA_SAMPLE_ULAW;  break;
+    case AFMT_A_LAW:  spec.format = PA_SAMPLE_ALAW;  break;
+    default:
+      return -1;
+    }
+    if (!(sink->pas = pa_simple_new(NULL, "GTick metronome",
+                                    PA_STREAM_PLAYBACK,
+                                    *sink->target ? sink->target : NULL,
+                                    "gtick sink", &spec, NULL, NULL, &error)))
+    {
+      fprintf(stderr, "Warning: Couldn't open sink \"%s\": %s\n",
+              sink->target, pa_strerror(error));
+      return -1;
+    }
+    return 0;
+
+  case FANOUT_SINK_WAV:
+    for (i = 0; i < n_wav_formats && wav_formats[i].format != format; i++);
+    if (i == n_wav_formats) {
+      fprintf(stderr, "Warning: WAV sink doesn't take the output format "
+                      "of the sound device.\n");
+      return -1;
+    }
+    sink->swap = wav_formats[i].swap;
+    sink->shift = wav_formats[i].shift;
+    if (sink->swap || sink->shift)
+      sink->converted = (unsigned char*) g_malloc(fanout->fragmentsize);
+    return (sink->wav = wavfile_open_encoded(sink->target, rate, channels,
+                                             wav_formats[i].tag,
+                                             wav_formats[i].bits)) ? 0 : -1;
+  }
+  return -1;
+}
+
+static void close_sink(fanout_sink_t* sink)
+{
+  int error;
+
+  if (sink->fd != -1) {
+    close(sink->fd);
+    sink->fd = -1;
+  }
+  if (sink->pas) {
+    pa_simple_drain(sink->pas, &error);
+    pa_simple_free(sink->pas);
+    sink->pas = NULL;
+  }
+  if (sink->wav) {
+    wavfile_close(sink->wav);
+    sink->wav = NULL;
+  }
+  free(sink->converted);
+  sink->converted = NULL;
+  sink->open = 0;
+}
+
+/*
+ * opens the sinks for the output of the sound device: <rate>, <channels>,
+ * <format> (AFMT_*) with <framesize> bytes per frame and <fragmentsize>
+ * bytes per fragment, and starts their threads; sinks failing to open are
+ * left out
+ *
+ * returns 0 on success, -1 otherwise (no sink opened)
+ */
+int fanout_start(fanout_t* fanout, int rate, int channels, int format,
+                 int framesize, int fragmentsize)
+{
+  int opened = 0;
+  int i;
+
+  if (fanout->running)
+    return -1;
+
+  fanout->rate = rate;
+  fanout->channels = channels;
+  fanout->format = format;
+  fanout->framesize = framesize;
+  fanout->fragmentsize = fragmentsize;
+  switch (format) {
+  case AFMT_U8:     fanout->silence = 0x80; break;
+  case AFMT_MU_LAW: fanout->silence = 0xFF; break;
+  case AFMT_A_LAW:  fanout->silence = 0xD5; break;
+  default:          fanout->silence = 0x00;
+  }
+
+  for (i = 0; i < fanout->n; i++) {
+    fanout_sink_t* sink = &fanout->sinks[i];
+
+    if (open_sink(fanout, sink) == -1) {
+      fprintf(stderr, "Warning: Sink \"%s\" left out.\n", sink->target);
+      close_sink(sink);
+    } else {
+      sink->open = 1;
+      opened++;
+    }
+  }
+  if (fanout->n > 0 && opened == 0)
+    return -1;
+
+  /*
+   * enough for the full queue of each sink and the fragment it is writing,
+   * and the one being encoded: no allocation while rendering
+   */
+  for (i = 0; i < FANOUT_POOL(opened); i++)
+    g_async_queue_push(fanout->pool, new_buffer(fanout));
+
+  for (i = 0; i < fanout->n; i++) {
+    fanout->sinks[i].dropped = 0;
+    if (fanout->sinks[i].open)
+      fanout->sinks[i].thread =
+        g_thread_new("sink", (GThreadFunc) sink_loop, &fanout->sinks[i]);
+  }
+  fanout->running = 1;
+  return 0;
+}
+
+/*
+ * writes the fragments queued so far, then closes the sinks
+ */
+void fanout_stop(fanout_t* fanout)
+{
+  fanout_buffer_t* buffer;
+  int i;
+
+  if (!fanout->running)
+    return;
+
+  for (i = 0; i < fanout->n; i++) {
+    fanout_sink_t* sink = &fanout->sinks[i];
+
+    if (!sink->open)
+      continue;
+    g_async_queue_push(sink->queue, fanout);
+    g_thread_join(sink->thread);
+    close_sink(sink);
+    if (sink->dropped)
+      fprintf(stderr, "Warning: %d fragments dropped for sink \"%s\".\n",
+              sink->dropped, sink->target);
+  }
+
+  if (fanout->current) {
+    unref_buffer(fanout->current);
+    fanout->current = NULL;
+  }
+  while ((buffer = g_async_queue_try_pop(fanout->pool))) {
+    free(buffer->data);
+    free(buffer);
+  }
+  fanout->running = 0;
+}
+
+/*
+ * returns number of frames of silence to write to the sound device before
+ * the first fragment
+ */
+int fanout_delay_frames(fanout_t* fanout)
+{
+  return lrint(fanout->delay * fanout->rate);
+}
+
+/*
+ * returns buffer to encode the next fragment of the sound device into
+ * (valid until the next call), NULL if the sinks aren't running
+ */
+unsigned char* fanout_next(fanout_t* fanout)
+{
+  if (!fanout->running)
+    return NULL;
+
+  if (fanout->current)
+    unref_buffer(fanout->current);
+  if (!(fanout->current = g_async_queue_try_pop(fanout->pool)))
+    fanout->current = new_buffer(fanout);
+  fanout->current->refcount = 1; /* sound device */
+
+  return fanout->current->data;
+}
+
+/*
+ * hands the first <size> bytes of the buffer returned by fanout_next() to
+ * all sinks, without copying
+ */
+void fanout_write(fanout_t* fanout, int size)
+{
+  fanout_buffer_t* buffer = fanout->current;
+  int i;
+
+  if (!buffer)
+    return;
+
+  buffer->size = size;
+  for (i = 0; i < fanout->n; i++) {
+    fanout_sink_t* sink = &fanout->sinks[i];
+
+    if (!sink->open) {
+      /* left out */
+    } else if (g_async_queue_length(sink->queue) >= FANOUT_QUEUE) {
+      sink->dropped++;
+    } else {
+      g_atomic_int_inc(&buffer->refcount);
+      g_async_queue_push(sink->queue, buffer);
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/*
+ * fanout.h: rendered stream written to further sinks
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FANOUT_H
+#define FANOUT_H
+
+/* GTK+ headers */
+#include <glib.h>
+
+#include <pulse/simple.h>
+
+/* own headers */
+#include "wavfile.h"
+
+/* maximum number of sinks besides the sound device */
+#define FANOUT_MAX_SINKS 8
+
+/*
+ * maximum number of fragments queued for a sink: further fragments are
+ * dropped for it, so a stalled sink never holds up the sound device
+ */
+#define FANOUT_QUEUE 32
+
+/* number of buffers of a fanout with <n> sinks */
+#define FANOUT_POOL(n) ((n) * (FANOUT_QUEUE + 1) + 1)
+
+/*
+ * fragment encoded once for the sound device and all sinks, returned to the
+ * pool of the fanout when the last one is done with it
+ */
+typedef struct fanout_buffer_t {
+  gint refcount;
+  int size;                /* number of bytes used */
+  unsigned char* data;
+  GAsyncQueue* pool;       /* of unused buffers */
+} fanout_buffer_t;
+
+typedef enum fanout_sink_type_t {
+  FANOUT_SINK_OSS,         /* OSS device */
+  FANOUT_SINK_PULSE,       /* PulseAudio sink */
+  FANOUT_SINK_WAV          /* recording to WAV file */
+} fanout_sink_type_t;
+
+/*
+ * output writing the fragments in its own thread, delayed for latency
+ * compensation
+ */
+typedef struct fanout_sink_t {
+  fanout_sink_type_t type;
+  char* target;            /* device or file name, "": default */
+  double delay;            /* seconds of silence written first */
+
+  int fd;                  /* OSS: device, -1: closed */
+  pa_simple* pas;          /* PulseAudio: stream, NULL: closed */
+  wavfile_t* wav;          /* WAV: file, NULL: closed */
+  unsigned char* converted; /* WAV: fragment in the file's encoding, NULL:
+                              fragments written as they are */
+  int swap;                /* WAV: samples converted from big endian */
+  int shift;               /* WAV: bits samples are moved up by */
+  int open;                /* opened by fanout_start() */
+
+  GAsyncQueue* queue;      /* fanout_buffer_t* to write, the fanout: stop */
+  GThread* thread;
+  int dropped;             /* fragments not written: queue full */
+  struct fanout_t* fanout;
+} fanout_sink_t;
+
+/*
+ * sinks written in parallel to the sound device: each fragment is rendered
+ * and encoded once and handed to all sinks by reference
+ */
+typedef struct fanout_t {
+  fanout_sink_t sinks[FANOUT_MAX_SINKS];
+  int n;                   /* number of sinks */
+  double delay;            /* seconds the sound device is delayed */
+
+  int running;             /* sinks opened */
+  int rate;
+  int channels;
+  int format;              /* AFMT_* of sound device */
+  int framesize;           /* bytes per frame */
+  int fragmentsize;        /* bytes per buffer */
+  unsigned char silence;   /* byte value of silence in format */
+
+  GAsyncQueue* pool;       /* unused buffers */
+  fanout_buffer_t* current; /* encoded last, NULL: none */
+} fanout_t;
+
+fanout_t* fanout_new(const char* spec);
+void fanout_delete(fanout_t* fanout);
+
+int fanout_start(fanout_t* fanout, int rate, int channels, int format,
+                 int framesize, int fragmentsize);
+void fanout_stop(fanout_t* fanout);
+int fanout_delay_frames(fanout_t* fanout);
+unsigned char* fanout_next(fanout_t* fanout);
+void fanout_write(fanout_t* fanout, int size);
+
+#endif /* FANOUT_H */
@@ -49,8 +49,11 @@
 #define DEFAULT_SPEED 75
 #define DEFAULT_VOLUME VOLUME_MAX
 #define DEFAULT_METER 1
+#define DEFAULT_SUBBEATS 1
+#define DEFAULT_SUBBEAT_VOLUME 50
 #define DEFAULT_COMMAND_ON_START ""
 #define DEFAULT_COMMAND_ON_STOP ""
+#define DEFAULT_CONTROL_SOCKET "<default>"
 
 /* How often to update the "Visual Tick" */
 #define VISUAL_DELAY 0.03
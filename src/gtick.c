@@ -53,11 +53,15 @@ int main(int argc, char *argv[])
     {"usage",    no_argument,       0, 'h'},
     {"version",  no_argument,       0, 'v'},
     {"debug",    optional_argument, 0, 'd'},
+    {"render",   required_argument, 0, 'r'},
+    {"length",   required_argument, 0, 'l'},
     {0, 0, 0, 0}
   };
-  char *short_options = "hvd::";
+  char *short_options = "hvd::r:l:";
   int option_index = 0;
   int c;
+  char* render_filename = NULL;
+  double render_length = 60.0;
 
   /* prepare for i18n */
 #ifdef ENABLE_NLS
@@ -85,6 +89,9 @@ Options:\n\
   -h, --help              Show this help message\n\
   -v, --version           Print version information\n\
   -d, --debug[=level]     Print additional runtime debugging data to stdout\n\
+  -r, --render=FILE       Write metronome output (current settings) to WAV\n\
+                          file instead of playing it\n\
+  -l, --length=SECONDS    Length of rendered output (default: 60)\n\
 \n"),
       argv[0]);
       exit(0);
@@ -98,6 +105,12 @@ Options:\n\
 	debug = 1;
       }
       break;
+    case 'r': /* offline rendering */
+      render_filename = optarg;
+      break;
+    case 'l': /* length of offline rendering */
+      render_length = strtod(optarg, NULL);
+      break;
     case '?':
       exit(1);
     }
@@ -112,6 +125,14 @@ Options:\n\
 
   /* Initialise UI */
   metro = metro_new();
+
+  if (render_filename) {
+    int result = metro_render(metro, render_filename, render_length);
+
+    comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_STOP_SERVER, NULL);
+    metro_delete(metro);
+    return result == -1 ? 1 : 0;
+  }
   
   /* GTK+ internal main loop */
   gtk_main();
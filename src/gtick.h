@@ -0,0 +1,115 @@
+/*
+ * libgtick: metronome engine library interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GTICK_H
+#define GTICK_H
+
+/*
+ * The engine of gtick and gtickd for other programs: each engine renders
+ * into buffers of the caller or plays on its own sound device, and several
+ * engines may be used in one process (each one by one thread at a time).
+ *
+ * Only opaque objects are handed out, so programs linked against the shared
+ * library keep working as long as GTICK_API_VERSION stays the same.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* incremented on incompatible changes of this interface */
+#define GTICK_API_VERSION 1
+
+/* accents of ticks, see gtick_params_set_meter() */
+#define GTICK_BEAT_NORMAL 0 /* regular tick */
+#define GTICK_BEAT_ACCENT 1 /* accentuated tick */
+#define GTICK_BEAT_OFF    2 /* silent tick */
+
+/* limits of parameters */
+#define GTICK_MIN_BPM 1
+#define GTICK_MAX_BPM 1000
+#define GTICK_MAX_METER 100
+#define GTICK_MAX_SUBDIVISION 32
+
+/*
+ * point in time at which a new parameter block takes effect while the
+ * engine is playing or rendering
+ */
+typedef enum gtick_quantize_t {
+  GTICK_QUANTIZE_NOW,  /* immediately, even within the current tick */
+  GTICK_QUANTIZE_BEAT, /* at the start of the next tick */
+  GTICK_QUANTIZE_BAR   /* at the start of the next bar */
+} gtick_quantize_t;
+
+/* complete set of musical parameters, applied by the engine as a whole */
+typedef struct gtick_params_t gtick_params_t;
+
+/* metronome engine */
+typedef struct gtick_engine_t gtick_engine_t;
+
+int gtick_api_version(void);
+
+/*
+ * parameter blocks: the setters return 0 on success, -1 on bad arguments
+ * (leaving the block unchanged)
+ */
+gtick_params_t* gtick_params_new(void);
+gtick_params_t* gtick_params_copy(const gtick_params_t* params);
+void gtick_params_delete(gtick_params_t* params);
+int gtick_params_set_bpm(gtick_params_t* params, double bpm);
+int gtick_params_set_meter(gtick_params_t* params,
+                           int meter, const int* accents);
+int gtick_params_set_subdivision(gtick_params_t* params,
+                                 int subdivision, double gain);
+int gtick_params_set_sound(gtick_params_t* params, const char* sound);
+int gtick_params_set_layers(gtick_params_t* params, const char* layers);
+int gtick_params_set_ramp(gtick_params_t* params, const char* ramp);
+int gtick_params_set_quantize(gtick_params_t* params,
+                              gtick_quantize_t quantize);
+
+/* engines */
+gtick_engine_t* gtick_engine_new(void);
+void gtick_engine_delete(gtick_engine_t* engine);
+void gtick_engine_set_debug(gtick_engine_t* engine, int level);
+int gtick_engine_set_params(gtick_engine_t* engine,
+                            const gtick_params_t* params);
+int gtick_engine_set_volume(gtick_engine_t* engine, double volume);
+
+/* rendering into buffers: interleaved signed 16 bit samples, CPU endian */
+int gtick_engine_render_start(gtick_engine_t* engine, int rate, int channels);
+int gtick_engine_render(gtick_engine_t* engine, short* buffer, int frames);
+void gtick_engine_render_stop(gtick_engine_t* engine);
+
+/* playback via sound driver */
+const char* const* gtick_drivers(void);
+int gtick_engine_set_driver(gtick_engine_t* engine,
+                            const char* driver, const char* device);
+int gtick_engine_start(gtick_engine_t* engine);
+void gtick_engine_stop(gtick_engine_t* engine);
+int gtick_engine_running(gtick_engine_t* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GTICK_H */
@@ -0,0 +1,118 @@
+/*
+ * gtickbeat.c: example reader of the beat position export, printing each
+ *              tick when it is heard
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <getopt.h>
+
+/* own headers: only libgtickbeat needed */
+#include "beatshm.h"
+
+/* nanoseconds between samples of the record while waiting for a tick */
+#define POLL_INTERVAL 1000000
+
+/*
+ * sleeps until CLOCK_MONOTONIC <time> in nanoseconds
+ */
+static void sleep_until(int64_t time)
+{
+  struct timespec t;
+
+  t.tv_sec = time / 1000000000;
+  t.tv_nsec = time % 1000000000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL))
+    ;
+}
+
+int main(int argc, char *argv[])
+{
+  struct option long_options[] = {
+    {"help",    no_argument,       0, 'h'},
+    {"version", no_argument,       0, 'v'},
+    {"name",    required_argument, 0, 'n'},
+    {0, 0, 0, 0}
+  };
+  const char* name = BEATSHM_NAME;
+  const beatshm_record_t* record;
+  beatshm_record_t beat;
+  int64_t last = 0; /* time of last tick printed */
+  int c;
+
+  while ((c = getopt_long(argc, argv, "hvn:", long_options, NULL)) != -1) {
+    switch(c) {
+    case 'h': /* help */
+      printf("\
+Usage: %s [OPTION...]\n\
+\n\
+Prints bar, beat and sub beat of each tick of a running gtick or gtickd\n\
+(option BeatExport) at the time it is heard, with the deviation of the\n\
+wake up time.\n\
+\n\
+Options:\n\
+  -h, --help              Show this help message\n\
+  -v, --version           Print version information\n\
+  -n, --name=NAME         Shared memory object (default: %s)\n\
+\n",
+        argv[0], BEATSHM_NAME);
+      exit(0);
+    case 'v': /* version */
+      printf(PACKAGE " " VERSION "\n");
+      exit(0);
+    case 'n':
+      name = optarg;
+      break;
+    case '?':
+      exit(1);
+    }
+  }
+
+  if (!(record = beatshm_attach(name))) {
+    fprintf(stderr, "Error: No beat export \"%s\" found.\n", name);
+    exit(1);
+  }
+
+  for (;;) {
+    int64_t now = beatshm_now();
+
+    beatshm_read(record, &beat);
+    if (!beat.running || beat.tick_time == last || beat.tick_time < now) {
+      sleep_until(now + POLL_INTERVAL);
+      continue;
+    }
+
+    sleep_until(beat.tick_time);
+    printf("%6lld.%d.%d  %7.3f BPM  %d/%d  %+.3f ms\n",
+           (long long) beat.bar + 1, beat.beat + 1, beat.subbeat + 1,
+           beat.bpm, beat.meter, beat.subdivision,
+           (beatshm_now() - beat.tick_time) / 1e6);
+    fflush(stdout);
+    last = beat.tick_time;
+  }
+
+  return 0;
+}
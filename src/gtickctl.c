@@ -0,0 +1,220 @@
+/*
+ * gtickctl.c: command line client of the GTick control socket
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "control.h"
+
+static const char* results[] = {
+  [CONTROL_OK] = "OK",
+  [CONTROL_BAD_REQUEST] = "Bad request",
+  [CONTROL_NO_PROFILE] = "No such profile",
+  [CONTROL_NO_ENGINE] = "Audio thread not responding"
+};
+
+/*
+ * adds command <argv>[0] with its argument to <batch>
+ *
+ * returns number of arguments used, -1 on error
+ */
+static int add_command(control_batch_t* batch, int argc, char* argv[])
+{
+  const char* name = argv[0];
+  const char* arg = argc > 1 ? argv[1] : NULL;
+
+  if (!strcmp(name, "start"))
+    return control_add_command(batch, CONTROL_START) == -1 ? -1 : 1;
+  if (!strcmp(name, "stop"))
+    return control_add_command(batch, CONTROL_STOP) == -1 ? -1 : 1;
+  if (!strcmp(name, "status"))
+    return 1; /* every request is answered with the status */
+
+  if (!arg)
+    return -1;
+  if ((!strcmp(name, "tempo") &&
+       control_add_tempo(batch, g_ascii_strtod(arg, NULL)) == 0) ||
+      (!strcmp(name, "meter") &&
+       control_add_meter(batch, atoi(arg)) == 0) ||
+      (!strcmp(name, "accents") &&
+       control_add_accents(batch, arg) == 0) ||
+      (!strcmp(name, "volume") &&
+       control_add_volume(batch, atoi(arg)) == 0) ||
+      (!strcmp(name, "profile") &&
+       control_add_profile(batch, arg) == 0) ||
+      (!strcmp(name, "sound") &&
+       control_add_sound(batch, arg) == 0))
+    return 2;
+  return -1;
+}
+
+static void print_status(const control_status_t* status)
+{
+  int i;
+
+  printf("%s, %s, %.3f BPM, beat %d of %d, volume %d%%, accents ",
+         results[status->result],
+         status->running ? "running" : "stopped",
+         status->bpm, status->beat + 1, status->meter, status->volume);
+  for (i = 0; i < status->meter; i++)
+    putchar('0' + status->accents[i]);
+  putchar('\n');
+}
+
+static double now(void)
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/*
+ * measures round trip time of <n> status requests
+ *
+ * returns 0 on success, -1 on error
+ */
+static int benchmark(int fd, int n)
+{
+  control_batch_t batch;
+  control_status_t status;
+  double min = 1e9;
+  double max = 0.0;
+  double sum = 0.0;
+  int i;
+
+  control_batch_init(&batch);
+  for (i = 0; i < n; i++) {
+    double start = now();
+    double t;
+
+    if (control_request(fd, &batch, &status) == -1)
+      return -1;
+    t = now() - start;
+    sum += t;
+    min = MIN(min, t);
+    max = MAX(max, t);
+  }
+  printf("%d round trips: min %.1f us, mean %.1f us, max %.1f us\n",
+         n, min * 1e6, sum / n * 1e6, max * 1e6);
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  struct option long_options[] = {
+    {"help",      no_argument,       0, 'h'},
+    {"version",   no_argument,       0, 'v'},
+    {"socket",    required_argument, 0, 's'},
+    {"benchmark", required_argument, 0, 'b'},
+    {0, 0, 0, 0}
+  };
+  char *short_options = "+hvs:b:";
+  control_batch_t batch;
+  control_status_t status;
+  char* path = NULL;
+  int rounds = 0;
+  int fd;
+  int c;
+
+  while ((c = getopt_long(argc, argv, short_options, long_options,
+                          NULL)) != -1) {
+    switch(c) {
+    case 'h': /* help */
+      printf("\
+Usage: %s [OPTION...] [COMMAND...]\n\
+\n\
+Sends all commands at once to a running gtick or gtickd and prints the\n\
+resulting status.\n\
+\n\
+Commands:\n\
+  tempo BPM, meter N, accents LIST (e.g. 1020: 1 accent, 2 off),\n\
+  volume PERCENT, start, stop, profile NAME|NUMBER, sound NAME|FILE,\n\
+  status\n\
+\n\
+Options:\n\
+  -h, --help              Show this help message\n\
+  -v, --version           Print version information\n\
+  -s, --socket=PATH       Control socket (default: $XDG_RUNTIME_DIR/%s)\n\
+  -b, --benchmark=N       Measure round trip time of N status requests\n\
+\n",
+      argv[0], CONTROL_SOCKET_NAME);
+      exit(0);
+    case 'v': /* version */
+      printf(PACKAGE " " VERSION "\n");
+      exit(0);
+    case 's':
+      path = optarg;
+      break;
+    case 'b':
+      rounds = atoi(optarg);
+      break;
+    case '?':
+      exit(1);
+    }
+  }
+
+  control_batch_init(&batch);
+  while (optind < argc) {
+    int n = add_command(&batch, argc - optind, argv + optind);
+
+    if (n == -1) {
+      fprintf(stderr, "Error: Bad command: %s\n", argv[optind]);
+      exit(1);
+    }
+    optind += n;
+  }
+
+  if ((fd = control_connect(path)) == -1) {
+    perror("Error: Couldn't connect to control socket");
+    exit(1);
+  }
+
+  if (rounds > 0)
+    c = benchmark(fd, rounds);
+  else if ((c = control_request(fd, &batch, &status)) == 0)
+    print_status(&status);
+  close(fd);
+
+  if (c == -1) {
+    fprintf(stderr, "Error: Connection lost.\n");
+    return 1;
+  }
+  return rounds == 0 && status.result != CONTROL_OK ? 1 : 0;
+}
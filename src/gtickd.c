@@ -0,0 +1,1382 @@
+/*
+ * gtickd.c: headless metronome (GTick engine without GTK+)
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <getopt.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "dsp.h"
+#include "option.h"
+#include "options.h"
+#include "threadtalk.h"
+#include "timeline.h"
+#include "netsync.h"
+#include "beatshm.h"
+#include "fanout.h"
+#include "backing.h"
+#include "mixer.h"
+#include "control.h"
+#include "httpd.h"
+#include "sessions.h"
+#include "util.h"
+
+/* milliseconds between checks for messages from the audio thread */
+#define POLL_INTERVAL 30
+
+/*
+ * the headless metronome: current setting, taking the same rc options as
+ * the GTK+ front end (as far as they concern the sound)
+ */
+typedef struct gtickd_t {
+  options_t* options;
+  comm_t* inter_thread_comm;
+  GThread* audio_thread;
+  GMainLoop* main_loop;
+
+  double speed;                 /* BPM */
+  int meter;
+  char accents[MAX_METER + 1];  /* '1': accentuated tick */
+  double volume;                /* VOLUME_MIN ... VOLUME_MAX */
+  int subbeats;
+  double subbeat_volume;        /* relative to ticks, in percent */
+  char* layers;                 /* see dsp_params_set_layers() */
+  char* ramp;                   /* see dsp_params_set_ramp() */
+  char* setlist;                /* timeline file, "": none */
+  char* netsync;                /* see netsync_new(), "": none */
+  char* beat_export;            /* shared memory object, "": none */
+  char* http_server;            /* "[ADDRESS:]PORT", "": none */
+  char* channel_map;            /* see dsp_channel_map_new(), "": none */
+  char* sinks;                  /* see fanout_new(), "": none */
+  char* backing_track;          /* see backing_new(), "": none */
+  char* control_socket;         /* path, DEFAULT_CONTROL_SOCKET, "": none */
+  control_profile_t* profiles;  /* loadable via control socket */
+  int n_profiles;
+
+  int n_sessions;               /* metronomes sharing the device stream,
+                                   0: one metronome without sessions */
+  int mixed;                    /* sessions on all channels: 1, each on its
+                                   own channel: 0 */
+  int workers;                  /* rendering threads besides audio thread */
+  int fixed_point;              /* sounds prepared in integer arithmetic */
+  char* render_filename;        /* WAV file instead of playback, NULL: play */
+  double render_length;         /* of offline rendering, in seconds */
+  sessions_t* sessions;         /* NULL: no sessions */
+
+  /* queries of the setting: the audio thread or each session */
+  comm_t* metronomes[SESSIONS_MAX];
+  int n_metronomes;
+
+  control_t* controls[SESSIONS_MAX]; /* control socket server of each
+                                        metronome, NULL: none */
+  httpd_t* httpd;               /* HTTP server, NULL: none */
+
+  int running;                  /* audio thread playing */
+  int result;                   /* exit status */
+} gtickd_t;
+
+static volatile int interrupted = 0; /* caught signal */
+
+/* handler for SIGTERM and SIGINT */
+static void terminate_signal_callback(int sig) {
+  interrupted = sig;
+}
+
+/*
+ * returns new parameter block with the complete current setting
+ */
+static dsp_params_t* get_params(gtickd_t* gtickd) {
+  dsp_params_t* params;
+  int i;
+
+  params = dsp_params_new();
+  params->frequency = gtickd->speed / 60.0;
+  params->meter = gtickd->meter;
+  for (i = 0; i < MAX_METER && gtickd->accents[i]; i++)
+    params->accents[i] = gtickd->accents[i] == '1';
+  if (gtickd->options->sample_name)
+    params->soundname = strdup(gtickd->options->sample_name);
+  params->subdivision = gtickd->subbeats;
+  params->subgain = gtickd->subbeat_volume / 100.0;
+  if (*gtickd->layers)
+    dsp_params_set_layers(params, gtickd->layers);
+  if (*gtickd->ramp)
+    dsp_params_set_ramp(params, gtickd->ramp);
+
+  return params;
+}
+
+/*
+ * sends the complete current setting to the audio thread, taking effect at
+ * the next tick (while running)
+ */
+static void send_params(gtickd_t* gtickd) {
+  int i;
+
+  if (!gtickd->running)
+    return;
+
+  for (i = 0; i < gtickd->n_metronomes; i++) {
+    dsp_params_t* params = get_params(gtickd);
+
+    params->quantize = DSP_QUANTIZE_BEAT;
+    comm_client_query(gtickd->metronomes[i], MESSAGE_TYPE_SET_PARAMS,
+                      params);
+  }
+}
+
+static void send_volume(gtickd_t* gtickd) {
+  int i;
+
+  if (!gtickd->running)
+    return;
+
+  for (i = 0; i < gtickd->n_metronomes; i++) {
+    double* volume = (double*) g_malloc(sizeof(double));
+
+    *volume = gtickd->volume / 100.0;
+    comm_client_query(gtickd->metronomes[i], MESSAGE_TYPE_SET_VOLUME,
+                      volume);
+  }
+}
+
+/*
+ * sends setlist and beat sync to the audio thread
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int send_setlist(gtickd_t* gtickd) {
+  int i;
+
+  if (!gtickd->running)
+    return 0;
+
+  for (i = 0; i < gtickd->n_metronomes; i++) {
+    timeline_t* timeline = NULL;
+
+    if (*gtickd->setlist && !(timeline = timeline_load(gtickd->setlist))) {
+      fprintf(stderr, "Error: Bad setlist: %s\n", gtickd->setlist);
+      return -1;
+    }
+    comm_client_query(gtickd->metronomes[i],
+                      MESSAGE_TYPE_SET_TIMELINE, timeline);
+  }
+  return 0;
+}
+
+/* LAN beat sync and beat export follow the device: not with sessions */
+static int send_netsync(gtickd_t* gtickd) {
+  netsync_t* sync = NULL;
+
+  if (!gtickd->running || gtickd->sessions)
+    return 0;
+
+  if (*gtickd->netsync && !(sync = netsync_new(gtickd->netsync)))
+    return -1;
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_SET_NETSYNC, sync);
+  return 0;
+}
+
+static int send_beat_export(gtickd_t* gtickd) {
+  beatshm_t* shm = NULL;
+
+  if (!gtickd->running || gtickd->sessions)
+    return 0;
+
+  if (*gtickd->beat_export && !(shm = beatshm_new(gtickd->beat_export)))
+    return -1;
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_SET_BEATSHM, shm);
+  return 0;
+}
+
+/*
+ * sends the channel map, taking effect at the next start of the device
+ */
+static int send_channel_map(gtickd_t* gtickd) {
+  dsp_channel_map_t* map = NULL;
+
+  if (!gtickd->running || gtickd->sessions)
+    return 0;
+
+  if (*gtickd->channel_map &&
+      !(map = dsp_channel_map_new(gtickd->channel_map)))
+    return -1;
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_SET_CHANNEL_MAP, map);
+  return 0;
+}
+
+static int send_sinks(gtickd_t* gtickd) {
+  fanout_t* fanout = NULL;
+
+  if (!gtickd->running)
+    return 0;
+
+  if (*gtickd->sinks && !(fanout = fanout_new(gtickd->sinks)))
+    return -1;
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_SET_FANOUT, fanout);
+  return 0;
+}
+
+/*
+ * sends the backing track to the first metronome: with sessions, the
+ * device stream mixes their output only
+ */
+static int send_backing_track(gtickd_t* gtickd) {
+  backing_t* backing = NULL;
+
+  if (!gtickd->running)
+    return 0;
+
+  if (*gtickd->backing_track &&
+      !(backing = backing_new(gtickd->backing_track)))
+    return -1;
+  comm_client_query(gtickd->metronomes[0], MESSAGE_TYPE_SET_BACKING, backing);
+  return 0;
+}
+
+/*
+ * option system callbacks: the values are kept in gtickd and sent to the
+ * audio thread when it is running
+ */
+
+static int set_sample(gtickd_t* gtickd, const char* option_name _U_,
+                      const char* sample_name)
+{
+  free(gtickd->options->sample_name);
+  gtickd->options->sample_name = strdup(sample_name);
+  if (gtickd->running) {
+    int i;
+
+    for (i = 0; i < gtickd->n_metronomes; i++)
+      comm_client_query(gtickd->metronomes[i],
+                        MESSAGE_TYPE_SET_SOUND, strdup(sample_name));
+    send_params(gtickd);
+  }
+  return 0;
+}
+
+static const char* get_sample(gtickd_t* gtickd,
+                              int n _U_, char** option_name _U_)
+{
+  return gtickd->options->sample_name;
+}
+
+static int new_sample(gtickd_t* gtickd) {
+  gtickd->options->sample_name = strdup(DEFAULT_SAMPLE_FILENAME);
+  return 0;
+}
+
+static void delete_sample(gtickd_t* gtickd) {
+  free(gtickd->options->sample_name);
+}
+
+static int set_sound_system(gtickd_t* gtickd, const char* option_name _U_,
+                            const char* sound_system)
+{
+  free(gtickd->options->soundsystem);
+  gtickd->options->soundsystem = strdup(sound_system);
+  return 0;
+}
+
+static const char* get_sound_system(gtickd_t* gtickd,
+                                    int n _U_, char** option_name _U_)
+{
+  return gtickd->options->soundsystem;
+}
+
+static int new_sound_system(gtickd_t* gtickd) {
+  gtickd->options->soundsystem = strdup(DEFAULT_SOUND_SYSTEM);
+  return 0;
+}
+
+static void delete_sound_system(gtickd_t* gtickd) {
+  free(gtickd->options->soundsystem);
+}
+
+static int set_sound_device_name(gtickd_t* gtickd,
+                                 const char* option_name _U_,
+                                 const char* sound_device_name)
+{
+  free(gtickd->options->sound_device_name);
+  gtickd->options->sound_device_name = strdup(sound_device_name);
+  return 0;
+}
+
+static const char* get_sound_device_name(gtickd_t* gtickd,
+                                         int n _U_, char** option_name _U_)
+{
+  return gtickd->options->sound_device_name;
+}
+
+static int new_sound_device_name(gtickd_t* gtickd) {
+  gtickd->options->sound_device_name = strdup(DEFAULT_SOUND_DEVICE_FILENAME);
+  return 0;
+}
+
+static void delete_sound_device_name(gtickd_t* gtickd) {
+  free(gtickd->options->sound_device_name);
+}
+
+static int set_speed(gtickd_t* gtickd, const char* option_name _U_,
+                     const char* speed)
+{
+  double bpm = g_ascii_strtod(speed, NULL);
+
+  if (bpm < MIN_BPM || bpm > MAX_BPM)
+    return -1;
+  gtickd->speed = bpm;
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_speed(gtickd_t* gtickd,
+                             int n _U_, char** option_name _U_)
+{
+  static char result[G_ASCII_DTOSTR_BUF_SIZE];
+
+  return g_ascii_dtostr(result, sizeof(result), gtickd->speed);
+}
+
+static int new_speed(gtickd_t* gtickd) {
+  gtickd->speed = DEFAULT_SPEED;
+  return 0;
+}
+
+static int set_meter(gtickd_t* gtickd, const char* option_name _U_,
+                     const char* meter)
+{
+  int n = (int) strtol(meter, NULL, 0);
+
+  if (n < 1 || n > MAX_METER)
+    return -1;
+  gtickd->meter = n;
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_meter(gtickd_t* gtickd,
+                             int n _U_, char** option_name _U_)
+{
+  static char result[16];
+
+  snprintf(result, sizeof(result), "%d", gtickd->meter);
+  return result;
+}
+
+static int new_meter(gtickd_t* gtickd) {
+  gtickd->meter = DEFAULT_METER;
+  return 0;
+}
+
+/* accents: string of '0' and '1', e.g. "1000" */
+static int set_accents(gtickd_t* gtickd, const char* option_name _U_,
+                       const char* accents)
+{
+  strncpy(gtickd->accents, accents, MAX_METER);
+  gtickd->accents[MAX_METER] = '\0';
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_accents(gtickd_t* gtickd,
+                               int n _U_, char** option_name _U_)
+{
+  return gtickd->accents;
+}
+
+static int new_accents(gtickd_t* gtickd) {
+  gtickd->accents[0] = '1';
+  return 0;
+}
+
+static int set_volume(gtickd_t* gtickd, const char* option_name _U_,
+                      const char* volume)
+{
+  double value = g_ascii_strtod(volume, NULL);
+
+  if (value < VOLUME_MIN || value > VOLUME_MAX)
+    return -1;
+  gtickd->volume = value;
+  send_volume(gtickd);
+  return 0;
+}
+
+static const char* get_volume(gtickd_t* gtickd,
+                              int n _U_, char** option_name _U_)
+{
+  static char result[G_ASCII_DTOSTR_BUF_SIZE];
+
+  return g_ascii_dtostr(result, sizeof(result), gtickd->volume);
+}
+
+static int new_volume(gtickd_t* gtickd) {
+  gtickd->volume = DEFAULT_VOLUME;
+  return 0;
+}
+
+static int set_subbeats(gtickd_t* gtickd, const char* option_name _U_,
+                        const char* subbeats)
+{
+  int n = (int) strtol(subbeats, NULL, 0);
+
+  if (n < 1 || n > DSP_MAX_SUBDIVISION)
+    return -1;
+  gtickd->subbeats = n;
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_subbeats(gtickd_t* gtickd,
+                                int n _U_, char** option_name _U_)
+{
+  static char result[16];
+
+  snprintf(result, sizeof(result), "%d", gtickd->subbeats);
+  return result;
+}
+
+static int new_subbeats(gtickd_t* gtickd) {
+  gtickd->subbeats = DEFAULT_SUBBEATS;
+  return 0;
+}
+
+static int set_subbeat_volume(gtickd_t* gtickd, const char* option_name _U_,
+                              const char* volume)
+{
+  gtickd->subbeat_volume = CLAMP(g_ascii_strtod(volume, NULL), 0.0, 100.0);
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_subbeat_volume(gtickd_t* gtickd,
+                                      int n _U_, char** option_name _U_)
+{
+  static char result[G_ASCII_DTOSTR_BUF_SIZE];
+
+  return g_ascii_dtostr(result, sizeof(result), gtickd->subbeat_volume);
+}
+
+static int new_subbeat_volume(gtickd_t* gtickd) {
+  gtickd->subbeat_volume = DEFAULT_SUBBEAT_VOLUME;
+  return 0;
+}
+
+/* checks <layers> with a scratch parameter block */
+static int set_layers(gtickd_t* gtickd, const char* option_name _U_,
+                      const char* layers)
+{
+  dsp_params_t* params = dsp_params_new();
+  int result = dsp_params_set_layers(params, layers);
+
+  dsp_params_delete(params);
+  if (result == -1)
+    return -1;
+  free(gtickd->layers);
+  gtickd->layers = strdup(layers);
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_layers(gtickd_t* gtickd,
+                              int n _U_, char** option_name _U_)
+{
+  return gtickd->layers;
+}
+
+static int new_layers(gtickd_t* gtickd) {
+  gtickd->layers = strdup("");
+  return 0;
+}
+
+static void delete_layers(gtickd_t* gtickd) {
+  free(gtickd->layers);
+}
+
+static int set_ramp(gtickd_t* gtickd, const char* option_name _U_,
+                    const char* ramp)
+{
+  dsp_params_t* params = dsp_params_new();
+  int result = dsp_params_set_ramp(params, ramp);
+
+  dsp_params_delete(params);
+  if (result == -1)
+    return -1;
+  free(gtickd->ramp);
+  gtickd->ramp = strdup(ramp);
+  send_params(gtickd);
+  return 0;
+}
+
+static const char* get_ramp(gtickd_t* gtickd,
+                            int n _U_, char** option_name _U_)
+{
+  return gtickd->ramp;
+}
+
+static int new_ramp(gtickd_t* gtickd) {
+  gtickd->ramp = strdup("");
+  return 0;
+}
+
+static void delete_ramp(gtickd_t* gtickd) {
+  free(gtickd->ramp);
+}
+
+static int set_setlist(gtickd_t* gtickd, const char* option_name _U_,
+                       const char* setlist)
+{
+  char* old = gtickd->setlist;
+
+  gtickd->setlist = strdup(setlist);
+  if (send_setlist(gtickd) == -1) {
+    free(gtickd->setlist);
+    gtickd->setlist = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_setlist(gtickd_t* gtickd,
+                               int n _U_, char** option_name _U_)
+{
+  return gtickd->setlist;
+}
+
+static int new_setlist(gtickd_t* gtickd) {
+  gtickd->setlist = strdup("");
+  return 0;
+}
+
+static void delete_setlist(gtickd_t* gtickd) {
+  free(gtickd->setlist);
+}
+
+static int set_netsync(gtickd_t* gtickd, const char* option_name _U_,
+                       const char* spec)
+{
+  char* old = gtickd->netsync;
+
+  gtickd->netsync = strdup(spec);
+  if (send_netsync(gtickd) == -1) {
+    free(gtickd->netsync);
+    gtickd->netsync = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_netsync(gtickd_t* gtickd,
+                               int n _U_, char** option_name _U_)
+{
+  return gtickd->netsync;
+}
+
+static int new_netsync(gtickd_t* gtickd) {
+  gtickd->netsync = strdup("");
+  return 0;
+}
+
+static void delete_netsync(gtickd_t* gtickd) {
+  free(gtickd->netsync);
+}
+
+static int set_beat_export(gtickd_t* gtickd, const char* option_name _U_,
+                           const char* name)
+{
+  char* old = gtickd->beat_export;
+
+  gtickd->beat_export = strdup(name);
+  if (send_beat_export(gtickd) == -1) {
+    free(gtickd->beat_export);
+    gtickd->beat_export = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_beat_export(gtickd_t* gtickd,
+                                   int n _U_, char** option_name _U_)
+{
+  return gtickd->beat_export;
+}
+
+static int new_beat_export(gtickd_t* gtickd) {
+  gtickd->beat_export = strdup("");
+  return 0;
+}
+
+static void delete_beat_export(gtickd_t* gtickd) {
+  free(gtickd->beat_export);
+}
+
+static int set_channel_map(gtickd_t* gtickd, const char* option_name _U_,
+                           const char* spec)
+{
+  char* old = gtickd->channel_map;
+
+  gtickd->channel_map = strdup(spec);
+  if (send_channel_map(gtickd) == -1) {
+    free(gtickd->channel_map);
+    gtickd->channel_map = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_channel_map(gtickd_t* gtickd,
+                                   int n _U_, char** option_name _U_)
+{
+  return gtickd->channel_map;
+}
+
+static int new_channel_map(gtickd_t* gtickd) {
+  gtickd->channel_map = strdup("");
+  return 0;
+}
+
+static void delete_channel_map(gtickd_t* gtickd) {
+  free(gtickd->channel_map);
+}
+
+static int set_sinks(gtickd_t* gtickd, const char* option_name _U_,
+                     const char* spec)
+{
+  char* old = gtickd->sinks;
+
+  gtickd->sinks = strdup(spec);
+  if (send_sinks(gtickd) == -1) {
+    free(gtickd->sinks);
+    gtickd->sinks = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_sinks(gtickd_t* gtickd,
+                             int n _U_, char** option_name _U_)
+{
+  return gtickd->sinks;
+}
+
+static int new_sinks(gtickd_t* gtickd) {
+  gtickd->sinks = strdup("");
+  return 0;
+}
+
+static void delete_sinks(gtickd_t* gtickd) {
+  free(gtickd->sinks);
+}
+
+static int set_backing_track(gtickd_t* gtickd, const char* option_name _U_,
+                             const char* spec)
+{
+  char* old = gtickd->backing_track;
+
+  gtickd->backing_track = strdup(spec);
+  if (send_backing_track(gtickd) == -1) {
+    free(gtickd->backing_track);
+    gtickd->backing_track = old;
+    return -1;
+  }
+  free(old);
+  return 0;
+}
+
+static const char* get_backing_track(gtickd_t* gtickd,
+                                     int n _U_, char** option_name _U_)
+{
+  return gtickd->backing_track;
+}
+
+static int new_backing_track(gtickd_t* gtickd) {
+  gtickd->backing_track = strdup("");
+  return 0;
+}
+
+static void delete_backing_track(gtickd_t* gtickd) {
+  free(gtickd->backing_track);
+}
+
+static int set_http_server(gtickd_t* gtickd, const char* option_name _U_,
+                           const char* spec)
+{
+  free(gtickd->http_server);
+  gtickd->http_server = strdup(spec);
+  return 0;
+}
+
+static const char* get_http_server(gtickd_t* gtickd,
+                                   int n _U_, char** option_name _U_)
+{
+  return gtickd->http_server;
+}
+
+static int new_http_server(gtickd_t* gtickd) {
+  gtickd->http_server = strdup("");
+  return 0;
+}
+
+static void delete_http_server(gtickd_t* gtickd) {
+  free(gtickd->http_server);
+}
+
+static int set_control_socket(gtickd_t* gtickd, const char* option_name _U_,
+                              const char* path)
+{
+  free(gtickd->control_socket);
+  gtickd->control_socket = strdup(path);
+  return 0;
+}
+
+static const char* get_control_socket(gtickd_t* gtickd,
+                                      int n _U_, char** option_name _U_)
+{
+  return gtickd->control_socket;
+}
+
+static int new_control_socket(gtickd_t* gtickd) {
+  gtickd->control_socket = strdup(DEFAULT_CONTROL_SOCKET);
+  return 0;
+}
+
+static void delete_control_socket(gtickd_t* gtickd) {
+  free(gtickd->control_socket);
+}
+
+/*
+ * profiles of the rc file ("Profile_N_Name", "Profile_N_Speed", ...), for
+ * the control socket
+ */
+static int set_profile(gtickd_t* gtickd, const char* option_name,
+                       const char* value)
+{
+  control_profile_t* profile;
+  char field[16];
+  char** target;
+  int n;
+
+  if (sscanf(option_name, "Profile_%d_%15s", &n, field) != 2 ||
+      n < 1 || n > 1000)
+    return -1;
+
+  if (n > gtickd->n_profiles) {
+    gtickd->profiles = (control_profile_t*)
+      g_realloc(gtickd->profiles, n * sizeof(control_profile_t));
+    memset(gtickd->profiles + gtickd->n_profiles, 0,
+           (n - gtickd->n_profiles) * sizeof(control_profile_t));
+    gtickd->n_profiles = n;
+  }
+  profile = &gtickd->profiles[n - 1];
+
+  if (!strcmp(field, "Name"))
+    target = &profile->name;
+  else if (!strcmp(field, "Speed"))
+    target = &profile->speed;
+  else if (!strcmp(field, "Meter"))
+    target = &profile->meter;
+  else if (!strcmp(field, "Accents"))
+    target = &profile->accents;
+  else
+    return -1;
+
+  free(*target);
+  *target = strdup(value);
+  return 0;
+}
+
+static void delete_profile(gtickd_t* gtickd) {
+  int i;
+
+  for (i = 0; i < gtickd->n_profiles; i++) {
+    free(gtickd->profiles[i].name);
+    free(gtickd->profiles[i].speed);
+    free(gtickd->profiles[i].meter);
+    free(gtickd->profiles[i].accents);
+  }
+  free(gtickd->profiles);
+}
+
+/*
+ * registers option <name> of gtickd
+ */
+static void add_option(gtickd_t* gtickd, const char* name,
+                       option_new_t constructor, option_delete_t destructor,
+                       option_set_t setter, option_get_t getter)
+{
+  option_register(&gtickd->options->option_list, name, constructor,
+                  destructor, setter, (option_get_n_t) option_return_one,
+                  getter, (void*) gtickd);
+}
+
+/*
+ * The audio thread
+ */
+static gpointer audio_loop(gtickd_t* gtickd) {
+  dsp_t* dsp;
+
+  if (gtickd->sessions) {
+    sessions_main_loop(gtickd->sessions);
+    return NULL;
+  }
+
+  dsp = dsp_new(gtickd->inter_thread_comm);
+  dsp->debug = debug;
+  dsp->fixed_point = gtickd->fixed_point;
+  dsp_main_loop(dsp);
+  dsp_delete(dsp);
+
+  return NULL;
+}
+
+/*
+ * sets up gtickd->n_sessions metronomes on the device stream, or the single
+ * one of the audio thread
+ */
+static void new_metronomes(gtickd_t* gtickd) {
+  int i;
+
+  if (!gtickd->n_sessions) {
+    gtickd->metronomes[0] = gtickd->inter_thread_comm;
+    gtickd->n_metronomes = 1;
+    return;
+  }
+
+  gtickd->sessions = sessions_new(gtickd->inter_thread_comm,
+                                  gtickd->mixed ? 0 : gtickd->n_sessions,
+                                  gtickd->workers);
+  gtickd->sessions->device->debug = debug;
+  gtickd->sessions->device->fixed_point = gtickd->fixed_point;
+  for (i = 0; i < gtickd->n_sessions; i++)
+    gtickd->metronomes[i] =
+      sessions_add(gtickd->sessions, gtickd->mixed ? SESSIONS_MIXED : i);
+  gtickd->n_metronomes = gtickd->n_sessions;
+  if (*gtickd->netsync || *gtickd->beat_export || *gtickd->channel_map)
+    fprintf(stderr, "Warning: NetSync, BeatExport and ChannelMap not "
+                    "available with sessions.\n");
+}
+
+/*
+ * starts the control socket servers: at the configured path, or with
+ * sessions at PATH.1 ... PATH.N
+ */
+static void new_controls(gtickd_t* gtickd) {
+  char* path;
+  int i;
+
+  if (!*gtickd->control_socket)
+    return;
+
+  path = strcmp(gtickd->control_socket, DEFAULT_CONTROL_SOCKET) ?
+    strdup(gtickd->control_socket) : control_default_path();
+  for (i = 0; i < gtickd->n_metronomes; i++) {
+    char* name = gtickd->sessions ?
+      g_strdup_printf("%s.%d", path, i + 1) : strdup(path);
+
+    gtickd->controls[i] = control_new(name, gtickd->metronomes[i]);
+    if (gtickd->controls[i])
+      control_set_profiles(gtickd->controls[i],
+                           gtickd->profiles, gtickd->n_profiles);
+    free(name);
+  }
+  free(path);
+}
+
+/*
+ * returns new headless metronome with the default setting
+ */
+static gtickd_t* gtickd_new(void) {
+  gtickd_t* result;
+
+  result = (gtickd_t*) g_malloc0(sizeof(gtickd_t));
+  result->options = options_new();
+  result->inter_thread_comm = comm_new();
+
+  add_option(result, "SampleFilename",
+             (option_new_t) new_sample, (option_delete_t) delete_sample,
+             (option_set_t) set_sample, (option_get_t) get_sample);
+  add_option(result, "SoundSystem",
+             (option_new_t) new_sound_system,
+             (option_delete_t) delete_sound_system,
+             (option_set_t) set_sound_system, (option_get_t) get_sound_system);
+  add_option(result, "SoundDevice",
+             (option_new_t) new_sound_device_name,
+             (option_delete_t) delete_sound_device_name,
+             (option_set_t) set_sound_device_name,
+             (option_get_t) get_sound_device_name);
+  add_option(result, "Speed", (option_new_t) new_speed, NULL,
+             (option_set_t) set_speed, (option_get_t) get_speed);
+  add_option(result, "Volume", (option_new_t) new_volume, NULL,
+             (option_set_t) set_volume, (option_get_t) get_volume);
+  add_option(result, "Meter", (option_new_t) new_meter, NULL,
+             (option_set_t) set_meter, (option_get_t) get_meter);
+  add_option(result, "Accents", (option_new_t) new_accents, NULL,
+             (option_set_t) set_accents, (option_get_t) get_accents);
+  add_option(result, "SubBeats", (option_new_t) new_subbeats, NULL,
+             (option_set_t) set_subbeats, (option_get_t) get_subbeats);
+  add_option(result, "SubBeatVolume", (option_new_t) new_subbeat_volume, NULL,
+             (option_set_t) set_subbeat_volume,
+             (option_get_t) get_subbeat_volume);
+  add_option(result, "Layers",
+             (option_new_t) new_layers, (option_delete_t) delete_layers,
+             (option_set_t) set_layers, (option_get_t) get_layers);
+  add_option(result, "Ramp",
+             (option_new_t) new_ramp, (option_delete_t) delete_ramp,
+             (option_set_t) set_ramp, (option_get_t) get_ramp);
+  add_option(result, "Setlist",
+             (option_new_t) new_setlist, (option_delete_t) delete_setlist,
+             (option_set_t) set_setlist, (option_get_t) get_setlist);
+  add_option(result, "NetSync",
+             (option_new_t) new_netsync, (option_delete_t) delete_netsync,
+             (option_set_t) set_netsync, (option_get_t) get_netsync);
+  add_option(result, "BeatExport",
+             (option_new_t) new_beat_export,
+             (option_delete_t) delete_beat_export,
+             (option_set_t) set_beat_export, (option_get_t) get_beat_export);
+  add_option(result, "ChannelMap",
+             (option_new_t) new_channel_map,
+             (option_delete_t) delete_channel_map,
+             (option_set_t) set_channel_map, (option_get_t) get_channel_map);
+  add_option(result, "Sinks",
+             (option_new_t) new_sinks, (option_delete_t) delete_sinks,
+             (option_set_t) set_sinks, (option_get_t) get_sinks);
+  add_option(result, "BackingTrack",
+             (option_new_t) new_backing_track,
+             (option_delete_t) delete_backing_track,
+             (option_set_t) set_backing_track,
+             (option_get_t) get_backing_track);
+  add_option(result, "HttpServer",
+             (option_new_t) new_http_server,
+             (option_delete_t) delete_http_server,
+             (option_set_t) set_http_server, (option_get_t) get_http_server);
+  add_option(result, "ControlSocket",
+             (option_new_t) new_control_socket,
+             (option_delete_t) delete_control_socket,
+             (option_set_t) set_control_socket,
+             (option_get_t) get_control_socket);
+  /* read only: gtickd doesn't save the rc file */
+  option_register(&result->options->option_list, "Profile_",
+                  NULL, (option_delete_t) delete_profile,
+                  (option_set_t) set_profile, NULL, NULL, (void*) result);
+
+  return result;
+}
+
+static void gtickd_delete(gtickd_t* gtickd) {
+  options_delete(gtickd->options);
+  comm_delete(gtickd->inter_thread_comm);
+  g_free(gtickd);
+}
+
+/*
+ * starts the audio thread and playback of the current setting
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int gtickd_start(gtickd_t* gtickd) {
+  comm_t* comm = gtickd->inter_thread_comm;
+  int i;
+
+  new_metronomes(gtickd);
+  gtickd->audio_thread =
+    g_thread_new("metro", (GThreadFunc) audio_loop, gtickd);
+  gtickd->running = 1;
+
+  comm_client_query(comm, MESSAGE_TYPE_SET_SOUNDSYSTEM,
+                    strdup(gtickd->options->soundsystem));
+  comm_client_query(comm, MESSAGE_TYPE_SET_DEVICE,
+                    strdup(gtickd->options->sound_device_name));
+  for (i = 0; i < gtickd->n_metronomes; i++)
+    comm_client_query(gtickd->metronomes[i], MESSAGE_TYPE_SET_SOUND,
+                      strdup(gtickd->options->sample_name));
+  send_volume(gtickd);
+  send_params(gtickd);
+  if (send_setlist(gtickd) == -1 || send_netsync(gtickd) == -1 ||
+      send_beat_export(gtickd) == -1 || send_channel_map(gtickd) == -1 ||
+      send_sinks(gtickd) == -1 || send_backing_track(gtickd) == -1)
+    return -1;
+  if (gtickd->sessions) /* the device stream */
+    comm_client_query(comm, MESSAGE_TYPE_START_METRONOME, NULL);
+  for (i = 0; i < gtickd->n_metronomes; i++)
+    comm_client_query(gtickd->metronomes[i],
+                      MESSAGE_TYPE_START_METRONOME, NULL);
+
+  new_controls(gtickd);
+
+  if (*gtickd->http_server) {
+    if (*gtickd->beat_export)
+      gtickd->httpd = httpd_new(gtickd->http_server, gtickd->beat_export);
+    else
+      fprintf(stderr, "Warning: HTTP server needs option BeatExport.\n");
+  }
+
+  return 0;
+}
+
+/*
+ * stops playback and the audio thread
+ */
+static void gtickd_stop(gtickd_t* gtickd) {
+  int i;
+
+  if (!gtickd->running)
+    return;
+
+  for (i = 0; i < gtickd->n_metronomes; i++) {
+    if (gtickd->controls[i]) {
+      control_delete(gtickd->controls[i]);
+      gtickd->controls[i] = NULL;
+    }
+  }
+  if (gtickd->httpd) {
+    httpd_delete(gtickd->httpd);
+    gtickd->httpd = NULL;
+  }
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_STOP_METRONOME, NULL);
+  comm_client_query(gtickd->inter_thread_comm,
+                    MESSAGE_TYPE_STOP_SERVER, NULL);
+  g_thread_join(gtickd->audio_thread);
+  if (gtickd->sessions) {
+    sessions_delete(gtickd->sessions);
+    gtickd->sessions = NULL;
+  }
+  gtickd->n_metronomes = 0;
+  gtickd->running = 0;
+}
+
+/*
+ * handles messages from the audio thread (or a session) to <comm>
+ */
+static void handle_replies(gtickd_t* gtickd, comm_t* comm) {
+  message_type_t message_type;
+  void* body = NULL;
+
+  while ((message_type = comm_client_try_get_reply(comm, &body)) !=
+         MESSAGE_TYPE_NO_MESSAGE)
+  {
+    switch (message_type) {
+      case MESSAGE_TYPE_RESPONSE_SYNC:
+        if (debug > 1)
+          printf("Tick %u\n", *((unsigned int*) body));
+        free(body);
+        break;
+      case MESSAGE_TYPE_RESPONSE_LOCK:
+        if (debug) {
+          dsp_lock_t* lock = (dsp_lock_t*) body;
+
+          printf("Lock: %d, %.1f BPM, phase error %.2f ms, jitter %.2f ms\n",
+                 lock->locked, lock->bpm, lock->phase_error, lock->jitter);
+        }
+        free(body);
+        break;
+      case MESSAGE_TYPE_RESPONSE_STATUS: /* changed via control socket */
+        if (!gtickd->sessions) { /* sessions keep the common setting */
+          dsp_status_t* status = (dsp_status_t*) body;
+          int i;
+
+          gtickd->speed = status->bpm;
+          gtickd->meter = status->meter;
+          for (i = 0; i < MAX_METER; i++)
+            gtickd->accents[i] =
+              status->accents[i] == DSP_BEAT_ACCENT ? '1' : '0';
+          gtickd->volume = status->volume * 100.0;
+        }
+        free(body);
+        break;
+      case MESSAGE_TYPE_RESPONSE_START_ERROR:
+        fprintf(stderr, _("Couldn't start metronome.\n"
+                          "Please check if specified sound device\n"
+                          "and sample file are accessible.\n"));
+        gtickd->result = 1;
+        g_main_loop_quit(gtickd->main_loop);
+        break;
+      default:
+        free(body);
+    }
+  }
+}
+
+/*
+ * periodically called from main loop: handles messages from the audio
+ * thread and signals
+ */
+static gboolean timeout_callback(gtickd_t* gtickd) {
+  int i;
+
+  handle_replies(gtickd, gtickd->inter_thread_comm);
+  if (gtickd->sessions) {
+    for (i = 0; i < gtickd->n_metronomes; i++)
+      handle_replies(gtickd, gtickd->metronomes[i]);
+  }
+
+  if (interrupted) {
+    if (debug)
+      fprintf(stderr, "Signal %d caught.\n", interrupted);
+    g_main_loop_quit(gtickd->main_loop);
+  }
+
+  return TRUE; /* call it again */
+}
+
+/*
+ * sets rc option from "NAME=VALUE" in <assignment>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_option(gtickd_t* gtickd, const char* assignment) {
+  char* name = strdup(assignment);
+  char* value = strchr(name, '=');
+  int result;
+
+  if (value)
+    *value++ = '\0';
+  result = value ? option_set(gtickd->options->option_list, name, value) : -1;
+  if (result == -1)
+    fprintf(stderr, "Error: Bad option: %s\n", assignment);
+  free(name);
+
+  return result;
+}
+
+/*
+ * sets up <gtickd> from the rc file and the command line in <argc>/<argv>,
+ * options of the command line overriding the rc file
+ *
+ * returns 0 on success, -1 on a bad command line
+ */
+static int gtickd_parse(gtickd_t* gtickd, int argc, char* argv[]) {
+  struct option long_options[] = {
+    {"help",     no_argument,       0, 'h'},
+    {"version",  no_argument,       0, 'v'},
+    {"debug",    optional_argument, 0, 'd'},
+    {"bpm",      required_argument, 0, 'b'},
+    {"meter",    required_argument, 0, 'm'},
+    {"accents",  required_argument, 0, 'a'},
+    {"sound",    required_argument, 0, 's'},
+    {"volume",   required_argument, 0, 'V'},
+    {"option",   required_argument, 0, 'o'},
+    {"no-rc",    no_argument,       0, 'n'},
+    {"render",   required_argument, 0, 'r'},
+    {"length",   required_argument, 0, 'l'},
+    {"sessions", required_argument, 0, 'S'},
+    {"mix",      no_argument,       0, 'M'},
+    {"workers",  required_argument, 0, 'w'},
+    {"fixed-point", no_argument,    0, 'F'},
+    {0, 0, 0, 0}
+  };
+  char *short_options = "hvd::b:m:a:s:V:o:nr:l:S:Mw:F";
+  static const char* names[] = { /* of rc options set by short options */
+    ['b'] = "Speed", ['m'] = "Meter", ['a'] = "Accents",
+    ['s'] = "SampleFilename", ['V'] = "Volume"
+  };
+  GPtrArray* assignments = g_ptr_array_new();
+  int use_rc = 1;
+  int result = 0;
+  unsigned int i;
+  int c;
+
+  gtickd->render_length = 60.0;
+  gtickd->workers = g_get_num_processors() - 1;
+  gtickd->fixed_point = MIXER_FIXED_POINT;
+  while (!result && (c = getopt_long(argc, argv, short_options,
+                                     long_options, NULL)) != -1) {
+    switch(c) {
+    case 'h': /* help */
+      printf(_("\
+Usage: %s [OPTION...]\n\
+\n\
+Headless metronome, taking its setting from the GTick rc file and the\n\
+command line.\n\
+\n\
+Options:\n\
+  -h, --help              Show this help message\n\
+  -v, --version           Print version information\n\
+  -d, --debug[=level]     Print additional runtime debugging data to stdout\n\
+  -b, --bpm=BPM           Speed in beats per minute\n\
+  -m, --meter=N           Number of ticks per bar\n\
+  -a, --accents=LIST      Accentuated ticks, e.g. 1001\n\
+  -s, --sound=NAME        Sound name or file\n\
+  -V, --volume=PERCENT    Volume\n\
+  -o, --option=NAME=VALUE Set any rc file option (e.g. Layers, Setlist)\n\
+  -n, --no-rc             Don't read the rc file\n\
+  -r, --render=FILE       Write metronome output to WAV file instead of\n\
+                          playing it\n\
+  -l, --length=SECONDS    Length of rendered output (default: 60)\n\
+  -S, --sessions=N        Play N independent metronomes on one sound device,\n\
+                          each on its own channel and control socket\n\
+                          (PATH.1 ... PATH.N)\n\
+  -M, --mix               Play the sessions on all channels\n\
+  -w, --workers=N         Threads rendering the sessions besides the audio\n\
+                          thread (default: number of CPUs - 1)\n\
+  -F, --fixed-point       Prepare sounds in integer arithmetic, e.g. on\n\
+                          processors without FPU\n\
+\n"),
+      argv[0]);
+      exit(0);
+    case 'v': /* version */
+      printf(PACKAGE " " VERSION "\n");
+      exit(0);
+    case 'd': /* debug mode */
+      debug = optarg ? strtol(optarg, NULL, 0) : 1;
+      break;
+    case 'b':
+    case 'm':
+    case 'a':
+    case 's':
+    case 'V':
+      g_ptr_array_add(assignments,
+                      g_strdup_printf("%s=%s", names[c], optarg));
+      break;
+    case 'o':
+      g_ptr_array_add(assignments, g_strdup(optarg));
+      break;
+    case 'n':
+      use_rc = 0;
+      break;
+    case 'r': /* offline rendering */
+      gtickd->render_filename = optarg;
+      break;
+    case 'l': /* length of offline rendering */
+      gtickd->render_length = strtod(optarg, NULL);
+      break;
+    case 'S': /* sessions */
+      gtickd->n_sessions = strtol(optarg, NULL, 0);
+      if (gtickd->n_sessions < 1 || gtickd->n_sessions > SESSIONS_MAX) {
+        fprintf(stderr, "Error: Number of sessions must be 1 ... %d.\n",
+                SESSIONS_MAX);
+        result = -1;
+      }
+      break;
+    case 'M':
+      gtickd->mixed = 1;
+      break;
+    case 'w':
+      gtickd->workers = strtol(optarg, NULL, 0);
+      break;
+    case 'F':
+      gtickd->fixed_point = 1;
+      break;
+    case '?':
+      result = -1;
+      break;
+    }
+  }
+
+  gtickd->workers = MAX(gtickd->workers, 0);
+  if (!result && use_rc)
+    option_restore_all(gtickd->options->option_list);
+  for (i = 0; i < assignments->len; i++) {
+    if (!result &&
+        set_option(gtickd, g_ptr_array_index(assignments, i)) == -1)
+      result = -1;
+    g_free(g_ptr_array_index(assignments, i));
+  }
+  g_ptr_array_free(assignments, TRUE);
+
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  gtickd_t* gtickd;
+  int result;
+
+  /* prepare for i18n */
+#ifdef ENABLE_NLS
+  setlocale(LC_ALL, "");
+  if (!bindtextdomain(PACKAGE, LOCALEDIR)) {
+    fprintf(stderr, "Error setting directory for textdomain (i18n).\n");
+  }
+  if (!textdomain(PACKAGE)) {
+    fprintf(stderr, "Error setting domainname for gettext() "
+                    "(internationalization).\n");
+  }
+#endif
+
+  gtickd = gtickd_new();
+  if (gtickd_parse(gtickd, argc, argv) == -1)
+    gtickd->result = 1;
+
+  if (gtickd->result) {
+    /* bad command line */
+  } else if (gtickd->render_filename) {
+    comm_t* comm = comm_new();
+    dsp_t* dsp = dsp_new(comm);
+
+    dsp->debug = debug;
+    dsp->fixed_point = gtickd->fixed_point;
+    dsp->volume = gtickd->volume / 100.0;
+    if (*gtickd->setlist) {
+      timeline_t* timeline = timeline_load(gtickd->setlist);
+
+      if (timeline)
+        dsp_set_timeline(dsp, timeline);
+      else
+        gtickd->result = 1;
+    }
+    if (!gtickd->result &&
+        dsp_render(dsp, get_params(gtickd), gtickd->render_filename,
+                   gtickd->render_length) == -1)
+      gtickd->result = 1;
+    dsp_delete(dsp);
+    comm_delete(comm);
+  } else if (gtickd_start(gtickd) == -1) {
+    gtickd->result = 1;
+    gtickd_stop(gtickd);
+  } else {
+    signal(SIGINT, &terminate_signal_callback);
+    signal(SIGTERM, &terminate_signal_callback);
+
+    gtickd->main_loop = g_main_loop_new(NULL, FALSE);
+    g_timeout_add(POLL_INTERVAL, (GSourceFunc) timeout_callback, gtickd);
+    g_main_loop_run(gtickd->main_loop);
+    g_main_loop_unref(gtickd->main_loop);
+    gtickd_stop(gtickd);
+  }
+
+  result = gtickd->result;
+  gtickd_delete(gtickd);
+  return result;
+}
@@ -0,0 +1,335 @@
+/*
+ * gticklv2.c: LV2 plugin playing the metronome in time with the transport
+ *             of the host
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+/* LV2 headers */
+#include <lv2/core/lv2.h>
+#include <lv2/urid/urid.h>
+#include <lv2/atom/atom.h>
+#include <lv2/atom/util.h>
+#include <lv2/time/time.h>
+
+/* own headers */
+#include "globals.h"
+#include "dsp.h"
+#include "threadtalk.h"
+
+#define GTICK_LV2_URI "http://gtick.sourceforge.net/lv2/gtick"
+
+/* ports, see gtick.ttl */
+typedef enum gticklv2_port_t {
+  PORT_CONTROL,     /* atom sequence with time:Position of host */
+  PORT_OUT,         /* mono output */
+  PORT_VOLUME,      /* 0.0 ... 1.0 */
+  PORT_BPM,         /* tempo without transport of host */
+  PORT_METER,       /* beats per bar without transport of host */
+  PORT_SUBDIVISION, /* sub beats per tick, 1: none */
+  PORT_ACCENT,      /* first tick of bar accentuated: 1, else 0 */
+  PORTS
+} gticklv2_port_t;
+
+typedef struct gticklv2_uris_t {
+  LV2_URID atom_Blank;
+  LV2_URID atom_Object;
+  LV2_URID atom_Float;
+  LV2_URID atom_Double;
+  LV2_URID atom_Int;
+  LV2_URID atom_Long;
+  LV2_URID time_Position;
+  LV2_URID time_barBeat;
+  LV2_URID time_beatsPerBar;
+  LV2_URID time_beatsPerMinute;
+  LV2_URID time_speed;
+} gticklv2_uris_t;
+
+/*
+ * plugin instance: the dsp object renders offline into the output buffer,
+ * with all voices prepared in instantiate(), so run() doesn't allocate
+ */
+typedef struct gticklv2_t {
+  gticklv2_uris_t uris;
+  comm_t* comm;
+  dsp_t* dsp;
+
+  const LV2_Atom_Sequence* control;
+  float* out;
+  const float* ports[PORTS];   /* control ports, by gticklv2_port_t */
+
+  int host;                    /* transport of host reported: 1, else 0 */
+  double speed;                /* of host transport, 0.0: stopped */
+  double bpm;                  /* current tempo */
+  int meter;                   /* current beats per bar */
+  int subdivision;
+  int accent;
+  int accents[MAX_METER];      /* DSP_BEAT_* for dsp_set_rhythm() */
+} gticklv2_t;
+
+static LV2_Handle instantiate(const LV2_Descriptor* descriptor _U_,
+                              double rate,
+                              const char* bundle_path _U_,
+                              const LV2_Feature* const* features)
+{
+  LV2_URID_Map* map = NULL;
+  gticklv2_t* plugin;
+  gticklv2_uris_t* uris;
+  int i;
+
+  for (i = 0; features[i]; i++) {
+    if (!strcmp(features[i]->URI, LV2_URID__map))
+      map = (LV2_URID_Map*) features[i]->data;
+  }
+  if (!map)
+    return NULL;
+
+  plugin = (gticklv2_t*) calloc(1, sizeof(gticklv2_t));
+  uris = &plugin->uris;
+  uris->atom_Blank = map->map(map->handle, LV2_ATOM__Blank);
+  uris->atom_Object = map->map(map->handle, LV2_ATOM__Object);
+  uris->atom_Float = map->map(map->handle, LV2_ATOM__Float);
+  uris->atom_Double = map->map(map->handle, LV2_ATOM__Double);
+  uris->atom_Int = map->map(map->handle, LV2_ATOM__Int);
+  uris->atom_Long = map->map(map->handle, LV2_ATOM__Long);
+  uris->time_Position = map->map(map->handle, LV2_TIME__Position);
+  uris->time_barBeat = map->map(map->handle, LV2_TIME__barBeat);
+  uris->time_beatsPerBar = map->map(map->handle, LV2_TIME__beatsPerBar);
+  uris->time_beatsPerMinute =
+    map->map(map->handle, LV2_TIME__beatsPerMinute);
+  uris->time_speed = map->map(map->handle, LV2_TIME__speed);
+
+  plugin->comm = comm_new();
+  plugin->dsp = dsp_new(plugin->comm);
+  plugin->dsp->quiet = 1;
+  plugin->dsp->volume = 1.0;
+  plugin->bpm = DEFAULT_BPM;
+  plugin->meter = 4;
+  plugin->subdivision = 1;
+  plugin->accent = 1;
+
+  if (dsp_offline_start(plugin->dsp, lrint(rate), 1, AFMT_S16_NE) == -1) {
+    dsp_delete(plugin->dsp);
+    comm_delete(plugin->comm);
+    free(plugin);
+    return NULL;
+  }
+  if (dsp_pin_voices(plugin->dsp, DEFAULT_SAMPLE_FILENAME) == -1) {
+    dsp_offline_stop(plugin->dsp);
+    dsp_delete(plugin->dsp);
+    comm_delete(plugin->comm);
+    free(plugin);
+    return NULL;
+  }
+
+  return (LV2_Handle) plugin;
+}
+
+static void connect_port(LV2_Handle instance, uint32_t port, void* data)
+{
+  gticklv2_t* plugin = (gticklv2_t*) instance;
+
+  switch (port) {
+  case PORT_CONTROL:
+    plugin->control = (const LV2_Atom_Sequence*) data;
+    break;
+  case PORT_OUT:
+    plugin->out = (float*) data;
+    break;
+  default:
+    if (port < PORTS)
+      plugin->ports[port] = (const float*) data;
+  }
+}
+
+/*
+ * applies meter, accent and sub beats to the dsp object if changed
+ */
+static void update_rhythm(gticklv2_t* plugin, int meter)
+{
+  int subdivision = lrintf(*plugin->ports[PORT_SUBDIVISION]);
+  int accent = *plugin->ports[PORT_ACCENT] > 0.5f;
+  int i;
+
+  meter = CLAMP(meter, 1, MAX_METER);
+  subdivision = CLAMP(subdivision, 1, DSP_MAX_SUBDIVISION);
+  if (meter == plugin->meter && subdivision == plugin->subdivision &&
+      accent == plugin->accent)
+    return;
+
+  plugin->meter = meter;
+  plugin->subdivision = subdivision;
+  plugin->accent = accent;
+  for (i = 0; i < meter; i++)
+    plugin->accents[i] = i == 0 && accent ? DSP_BEAT_ACCENT : DSP_BEAT_NORMAL;
+  dsp_set_rhythm(plugin->dsp, meter, plugin->accents, subdivision);
+}
+
+static void activate(LV2_Handle instance)
+{
+  gticklv2_t* plugin = (gticklv2_t*) instance;
+
+  plugin->host = 0;
+  plugin->speed = 1.0; /* free running until the host reports */
+  plugin->meter = 0;   /* set up at first run */
+  dsp_locate(plugin->dsp, plugin->bpm / 60.0, 0.0);
+}
+
+/*
+ * returns the numeric value of <atom>, <fallback> if it isn't a number
+ */
+static double get_number(const gticklv2_uris_t* uris, const LV2_Atom* atom,
+                         double fallback)
+{
+  if (!atom)
+    return fallback;
+  if (atom->type == uris->atom_Float)
+    return ((const LV2_Atom_Float*) atom)->body;
+  if (atom->type == uris->atom_Double)
+    return ((const LV2_Atom_Double*) atom)->body;
+  if (atom->type == uris->atom_Int)
+    return ((const LV2_Atom_Int*) atom)->body;
+  if (atom->type == uris->atom_Long)
+    return ((const LV2_Atom_Long*) atom)->body;
+  return fallback;
+}
+
+/*
+ * takes over the position of the host transport reported in <object>
+ */
+static void follow_host(gticklv2_t* plugin, const LV2_Atom_Object* object)
+{
+  const gticklv2_uris_t* uris = &plugin->uris;
+  const LV2_Atom* bar_beat = NULL;
+  const LV2_Atom* beats_per_bar = NULL;
+  const LV2_Atom* bpm = NULL;
+  const LV2_Atom* speed = NULL;
+
+  lv2_atom_object_get(object,
+                      uris->time_barBeat, &bar_beat,
+                      uris->time_beatsPerBar, &beats_per_bar,
+                      uris->time_beatsPerMinute, &bpm,
+                      uris->time_speed, &speed,
+                      0);
+
+  plugin->host = 1;
+  plugin->speed = get_number(uris, speed, plugin->speed);
+  plugin->bpm = CLAMP(get_number(uris, bpm, plugin->bpm), MIN_BPM, MAX_BPM);
+  update_rhythm(plugin, lrint(get_number(uris, beats_per_bar,
+                                         plugin->meter)));
+  if (bar_beat)
+    dsp_locate(plugin->dsp, plugin->bpm / 60.0,
+               get_number(uris, bar_beat, 0.0));
+  else
+    dsp_locate(plugin->dsp, plugin->bpm / 60.0,
+               plugin->dsp->cyclepos +
+               (double) plugin->dsp->tickpos / plugin->dsp->ticklen);
+}
+
+/*
+ * renders output frames <from> ... <to>, silence while the host transport
+ * is stopped
+ */
+static void render(gticklv2_t* plugin, uint32_t from, uint32_t to)
+{
+  if (to <= from)
+    return;
+
+  if (plugin->speed > 0.0)
+    dsp_offline_render_float(plugin->dsp, plugin->out + from, to - from);
+  else
+    memset(plugin->out + from, 0, (to - from) * sizeof(float));
+}
+
+static void run(LV2_Handle instance, uint32_t frames)
+{
+  gticklv2_t* plugin = (gticklv2_t*) instance;
+  const gticklv2_uris_t* uris = &plugin->uris;
+  uint32_t pos = 0;
+
+  plugin->dsp->volume = CLAMP(*plugin->ports[PORT_VOLUME], 0.0f, 1.0f);
+  if (!plugin->host) { /* free running at tempo and meter of ports */
+    double bpm = CLAMP(*plugin->ports[PORT_BPM], MIN_BPM, MAX_BPM);
+
+    update_rhythm(plugin, lrintf(*plugin->ports[PORT_METER]));
+    if (bpm != plugin->bpm) {
+      plugin->bpm = bpm;
+      dsp_locate(plugin->dsp, bpm / 60.0,
+                 plugin->dsp->cyclepos +
+                 (double) plugin->dsp->tickpos / plugin->dsp->ticklen);
+    }
+  } else {
+    update_rhythm(plugin, plugin->meter);
+  }
+
+  /* sample accurate: render up to each position change of the host */
+  LV2_ATOM_SEQUENCE_FOREACH(plugin->control, event) {
+    const LV2_Atom_Object* object = (const LV2_Atom_Object*) &event->body;
+
+    if ((object->atom.type == uris->atom_Blank ||
+         object->atom.type == uris->atom_Object) &&
+        object->body.otype == uris->time_Position)
+    {
+      uint32_t frame = CLAMP(event->time.frames, (int64_t) pos,
+                             (int64_t) frames);
+
+      render(plugin, pos, frame);
+      pos = frame;
+      follow_host(plugin, object);
+    }
+  }
+  render(plugin, pos, frames);
+}
+
+static void cleanup(LV2_Handle instance)
+{
+  gticklv2_t* plugin = (gticklv2_t*) instance;
+
+  dsp_offline_stop(plugin->dsp);
+  dsp_delete(plugin->dsp);
+  comm_delete(plugin->comm);
+  free(plugin);
+}
+
+static const LV2_Descriptor descriptor = {
+  GTICK_LV2_URI,
+  instantiate,
+  connect_port,
+  activate,
+  run,
+  NULL,
+  cleanup,
+  NULL
+};
+
+LV2_SYMBOL_EXPORT const LV2_Descriptor* lv2_descriptor(uint32_t index)
+{
+  return index == 0 ? &descriptor : NULL;
+}
@@ -0,0 +1,661 @@
+/*
+ * httpd.c: embedded HTTP server pushing beats to browsers via WebSocket
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "httpd.h"
+#include "beatshm.h"
+
+/* appended to Sec-WebSocket-Key for Sec-WebSocket-Accept (RFC 6455) */
+#define WEBSOCKET_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/* WebSocket opcodes */
+#define OPCODE_TEXT  0x1
+#define OPCODE_CLOSE 0x8
+#define OPCODE_PING  0x9
+#define OPCODE_PONG  0xA
+
+/* size of a beat event in JSON */
+#define MAX_EVENT 512
+
+/*
+ * the visual tick page: connects to /beat and schedules the flashes of the
+ * announced ticks with the browser's clock, so network jitter is absorbed
+ * as long as an event arrives before its first tick
+ */
+static const char page[] =
+"<!DOCTYPE html>\n"
+"<html><head><meta charset=\"utf-8\">\n"
+"<meta name=\"viewport\" content=\"width=device-width\">\n"
+"<title>GTick</title>\n"
+"<style>\n"
+"body{margin:0;background:#000;color:#ccc;font-family:sans-serif;"
+"text-align:center}\n"
+"#tick{margin:5vh auto;width:60vmin;height:60vmin;border-radius:50%;"
+"background:#222}\n"
+"#tick.on{background:#4c4}#tick.accent{background:#e33}\n"
+"#position{font-size:15vmin}#bpm{font-size:6vmin}\n"
+"</style></head><body>\n"
+"<div id=\"tick\"></div><div id=\"position\">-</div><div id=\"bpm\"></div>\n"
+"<script>\n"
+"var tick = document.getElementById('tick');\n"
+"var position = document.getElementById('position');\n"
+"var bpm = document.getElementById('bpm');\n"
+"var timers = [];\n"
+"function show(t) {\n"
+"  position.textContent = (t.bar + 1) + '.' + (t.beat + 1);\n"
+"  tick.className = t.beat == 0 ? 'accent' : 'on';\n"
+"  setTimeout(function() { tick.className = ''; }, 100);\n"
+"}\n"
+"function connect() {\n"
+"  var ws = new WebSocket('ws://' + location.host + '/beat');\n"
+"  ws.onmessage = function(e) {\n"
+"    var m = JSON.parse(e.data);\n"
+"    timers.forEach(clearTimeout);\n"
+"    timers = [];\n"
+"    if (!m.running) {\n"
+"      position.textContent = '-';\n"
+"      bpm.textContent = '';\n"
+"      return;\n"
+"    }\n"
+"    bpm.textContent = m.bpm.toFixed(1) + ' BPM, ' + m.meter + '/' + m.unit;\n"
+"    m.ticks.forEach(function(t) {\n"
+"      timers.push(setTimeout(function() { show(t); }, Math.max(0, t.in)));\n"
+"    });\n"
+"  };\n"
+"  ws.onclose = function() { setTimeout(connect, 1000); };\n"
+"}\n"
+"connect();\n"
+"</script></body></html>\n";
+
+static void close_client(httpd_client_t* client)
+{
+  close(client->fd);
+  client->fd = -1;
+  client->state = HTTPD_CLOSED;
+}
+
+/*
+ * sends as much of the output of <client> as possible without blocking,
+ * closing it after a complete HTTP response
+ */
+static void flush_client(httpd_client_t* client)
+{
+  while (client->n_output > 0) {
+    ssize_t n = send(client->fd, client->output, client->n_output,
+                     MSG_NOSIGNAL);
+
+    if (n == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        close_client(client);
+      return;
+    }
+    client->n_output -= n;
+    memmove(client->output, client->output + n, client->n_output);
+  }
+
+  if (client->state == HTTPD_RESPONSE)
+    close_client(client);
+}
+
+/*
+ * appends <size> bytes of <data> to output of <client>, dropping it if it
+ * doesn't keep up
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int queue(httpd_client_t* client, const void* data, int size)
+{
+  if (client->n_output + size > HTTPD_OUTPUT_SIZE) {
+    if (debug)
+      fprintf(stderr, "Warning: HTTP client too slow, dropped.\n");
+    close_client(client);
+    return -1;
+  }
+  memcpy(client->output + client->n_output, data, size);
+  client->n_output += size;
+  return 0;
+}
+
+/*
+ * queues WebSocket frame of <opcode> with <size> bytes of <payload>
+ * (unmasked, as sent by servers)
+ */
+static void queue_frame(httpd_client_t* client, int opcode,
+                        const void* payload, int size)
+{
+  unsigned char header[4];
+  int n = 2;
+
+  header[0] = 0x80 | opcode; /* FIN */
+  if (size < 126) {
+    header[1] = size;
+  } else {
+    header[1] = 126;
+    header[2] = size >> 8;
+    header[3] = size;
+    n = 4;
+  }
+  if (queue(client, header, n) == 0)
+    queue(client, payload, size);
+}
+
+/*
+ * queues a complete HTTP response; the connection is closed when it is sent
+ */
+static void respond(httpd_client_t* client, const char* status,
+                    const char* type, const char* body)
+{
+  char header[256];
+
+  snprintf(header, sizeof(header),
+           "HTTP/1.1 %s\r\n"
+           "Content-Type: %s\r\n"
+           "Content-Length: %d\r\n"
+           "Cache-Control: no-cache\r\n"
+           "Connection: close\r\n\r\n",
+           status, type, (int) strlen(body));
+  client->state = HTTPD_RESPONSE;
+  if (queue(client, header, strlen(header)) == 0)
+    queue(client, body, strlen(body));
+}
+
+/*
+ * returns value of header field <name> in <request> (copied, to be freed),
+ * NULL if missing
+ */
+static char* find_header(const char* request, const char* name)
+{
+  const char* line = strstr(request, "\r\n");
+  int length = strlen(name);
+
+  while (line && line[2] != '\r') {
+    line += 2;
+    if (!strncasecmp(line, name, length) && line[length] == ':') {
+      const char* value = line + length + 1;
+      const char* end = strstr(value, "\r\n");
+
+      while (*value == ' ' || *value == '\t')
+        value++;
+      return g_strndup(value, end - value);
+    }
+    line = strstr(line, "\r\n");
+  }
+  return NULL;
+}
+
+/*
+ * returns 1 if comma separated header field <value> contains <token>
+ */
+static int has_token(const char* value, const char* token)
+{
+  char** tokens = g_strsplit(value ? value : "", ",", 0);
+  int result = 0;
+  int i;
+
+  for (i = 0; tokens[i]; i++)
+    result |= !g_ascii_strcasecmp(g_strstrip(tokens[i]), token);
+  g_strfreev(tokens);
+  return result;
+}
+
+/*
+ * formats the beat event for <beat> at monotonic time <now> to <event>:
+ * {"running":true,"bar":B,"beat":N,"meter":M,"unit":U,"bpm":X,
+ *  "ticks":[{"in":MS,"bar":B,"beat":N},...]}
+ * with the milliseconds until each of the current and the next ticks is heard
+ *
+ * returns length
+ */
+static int format_event(char* event, const beatshm_record_t* beat,
+                        int64_t now)
+{
+  char number[G_ASCII_DTOSTR_BUF_SIZE];
+  long long bar = beat->bar;
+  int n = 0;
+  int b = beat->beat;
+  int i;
+
+  if (!beat->running)
+    return snprintf(event, MAX_EVENT, "{\"running\":false}");
+
+  n += snprintf(event + n, MAX_EVENT - n,
+                "{\"running\":true,\"bar\":%lld,\"beat\":%d,\"meter\":%d,"
+                "\"unit\":%d,\"bpm\":%s,\"ticks\":[", bar, b, beat->meter,
+                beat->unit,
+                g_ascii_formatd(number, sizeof(number), "%.3f", beat->bpm));
+  for (i = 0; i < HTTPD_UPCOMING; i++) {
+    double in = (beat->tick_time + i * beat->tick_length - now) / 1e6;
+
+    n += snprintf(event + n, MAX_EVENT - n,
+                  "%s{\"in\":%s,\"bar\":%lld,\"beat\":%d}", i ? "," : "",
+                  g_ascii_formatd(number, sizeof(number), "%.3f", in),
+                  bar, b);
+    if (++b >= beat->meter) {
+      b = 0;
+      bar++;
+    }
+  }
+  n += snprintf(event + n, MAX_EVENT - n, "]}");
+  return n;
+}
+
+/*
+ * queues the state of the last tick to WebSocket <client>
+ */
+static void push_state(httpd_t* httpd, httpd_client_t* client)
+{
+  char event[MAX_EVENT];
+  int n = format_event(event, &httpd->beat, beatshm_now());
+
+  queue_frame(client, OPCODE_TEXT, event, n);
+}
+
+/*
+ * answers complete HTTP request of <client>: the page, the WebSocket
+ * handshake or an error
+ */
+static void handle_request(httpd_t* httpd, httpd_client_t* client)
+{
+  char* upgrade = find_header(client->input, "Upgrade");
+  char* connection = find_header(client->input, "Connection");
+  char* key = find_header(client->input, "Sec-WebSocket-Key");
+  char path[64];
+
+  if (sscanf(client->input, "GET %63s HTTP/1.", path) != 1) {
+    respond(client, "405 Method Not Allowed", "text/plain",
+            "Method not allowed\n");
+  } else if (!strcmp(path, "/") || !strcmp(path, "/index.html")) {
+    respond(client, "200 OK", "text/html; charset=utf-8", page);
+  } else if (strcmp(path, "/beat")) {
+    respond(client, "404 Not Found", "text/plain", "Not found\n");
+  } else if (!key || !has_token(upgrade, "websocket") ||
+             !has_token(connection, "upgrade")) {
+    respond(client, "400 Bad Request", "text/plain",
+            "WebSocket expected\n");
+  } else {
+    char* accept_key = g_strconcat(key, WEBSOCKET_GUID, NULL);
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA1);
+    guint8 digest[20];
+    gsize length = sizeof(digest);
+    char* accept;
+    char* response;
+
+    g_checksum_update(checksum, (guchar*) accept_key, strlen(accept_key));
+    g_checksum_get_digest(checksum, digest, &length);
+    accept = g_base64_encode(digest, length);
+    response = g_strdup_printf("HTTP/1.1 101 Switching Protocols\r\n"
+                               "Upgrade: websocket\r\n"
+                               "Connection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+
+    client->state = HTTPD_WEBSOCKET;
+    if (queue(client, response, strlen(response)) == 0 &&
+        httpd->beat.running)
+      push_state(httpd, client);
+
+    g_free(response);
+    g_free(accept);
+    g_checksum_free(checksum);
+    g_free(accept_key);
+  }
+
+  g_free(upgrade);
+  g_free(connection);
+  g_free(key);
+}
+
+/*
+ * handles the complete WebSocket frames received from <client>: answers
+ * pings and close requests, other messages are ignored
+ */
+static void handle_frames(httpd_client_t* client)
+{
+  unsigned char* data = (unsigned char*) client->input;
+
+  while (client->state == HTTPD_WEBSOCKET && client->n_input >= 2) {
+    int opcode = data[0] & 0x0F;
+    int length = data[1] & 0x7F;
+    int header = 6; /* including mask */
+    int i;
+
+    if (!(data[1] & 0x80) || length == 127) { /* unmasked or huge */
+      close_client(client);
+      return;
+    }
+    if (length == 126) {
+      if (client->n_input < 4)
+        return;
+      length = data[2] << 8 | data[3];
+      header = 8;
+    }
+    if (header + length > HTTPD_MAX_REQUEST) {
+      close_client(client);
+      return;
+    }
+    if (client->n_input < header + length)
+      return;
+
+    for (i = 0; i < length; i++)
+      data[header + i] ^= data[header - 4 + (i & 3)];
+
+    if (opcode == OPCODE_PING) {
+      queue_frame(client, OPCODE_PONG, data + header, length);
+    } else if (opcode == OPCODE_CLOSE) {
+      queue_frame(client, OPCODE_CLOSE, data + header, MIN(length, 2));
+      client->state = HTTPD_RESPONSE; /* close when sent */
+      return;
+    }
+
+    client->n_input -= header + length;
+    memmove(data, data + header + length, client->n_input);
+  }
+}
+
+/*
+ * reads from <client> and handles its complete request or frames
+ */
+static void receive(httpd_t* httpd, httpd_client_t* client)
+{
+  ssize_t n;
+
+  n = read(client->fd, client->input + client->n_input,
+           sizeof(client->input) - 1 - client->n_input);
+  if (n <= 0) {
+    if (n == 0 || (errno != EAGAIN && errno != EINTR))
+      close_client(client);
+    return;
+  }
+  client->n_input += n;
+  client->input[client->n_input] = '\0';
+
+  if (client->state == HTTPD_REQUEST) {
+    char* end = strstr(client->input, "\r\n\r\n");
+
+    if (end) {
+      int length = end + 4 - client->input;
+
+      handle_request(httpd, client);
+      /* frames sent right after the handshake */
+      client->n_input -= length;
+      memmove(client->input, client->input + length, client->n_input);
+      if (client->state == HTTPD_WEBSOCKET)
+        handle_frames(client);
+    } else if (client->n_input >= (int) sizeof(client->input) - 1) {
+      respond(client, "413 Request Entity Too Large", "text/plain",
+              "Request too large\n");
+    }
+  } else if (client->state == HTTPD_WEBSOCKET) {
+    handle_frames(client);
+  } else { /* response pending: input ignored */
+    client->n_input = 0;
+  }
+}
+
+/*
+ * samples the beat export and pushes new ticks and stops to all WebSocket
+ * clients
+ */
+static void check_beat(httpd_t* httpd)
+{
+  int64_t now = beatshm_now();
+  beatshm_record_t beat;
+  char event[MAX_EVENT];
+  int n;
+  int i;
+
+  /* the object is recreated when the export is switched: reattach */
+  if (!httpd->beat.running &&
+      now - httpd->last_attach >= HTTPD_ATTACH_INTERVAL * 1000000LL)
+  {
+    if (httpd->record)
+      beatshm_detach(httpd->record);
+    httpd->record = beatshm_attach(httpd->export);
+    httpd->last_attach = now;
+  }
+  if (!httpd->record)
+    return;
+
+  beatshm_read(httpd->record, &beat);
+  if (beat.running ?
+      beat.subbeat != 0 || (httpd->beat.running &&
+                            beat.tick_time == httpd->beat.tick_time) :
+      !httpd->beat.running)
+    return;
+
+  httpd->beat = beat;
+  n = format_event(event, &beat, now);
+  for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+    if (httpd->clients[i].state == HTTPD_WEBSOCKET)
+      queue_frame(&httpd->clients[i], OPCODE_TEXT, event, n);
+  }
+}
+
+static void accept_client(httpd_t* httpd)
+{
+  int fd = accept4(httpd->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  int i;
+
+  for (i = 0; fd != -1 && i < HTTPD_MAX_CLIENTS; i++) {
+    httpd_client_t* client = &httpd->clients[i];
+
+    if (client->state == HTTPD_CLOSED) {
+      client->fd = fd;
+      client->state = HTTPD_REQUEST;
+      client->n_input = 0;
+      client->n_output = 0;
+      fd = -1;
+    }
+  }
+  if (fd != -1) { /* too many clients */
+    if (debug)
+      fprintf(stderr, "Warning: HTTP connection refused.\n");
+    close(fd);
+  }
+}
+
+/*
+ * server thread: serves connections and pushes beats until woken up by
+ * httpd_delete()
+ */
+static gpointer serve(httpd_t* httpd)
+{
+  struct pollfd fds[2 + HTTPD_MAX_CLIENTS];
+  int i;
+
+  for (;;) {
+    int n = 2;
+
+    fds[0].fd = httpd->wakeup[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = httpd->fd;
+    fds[1].events = POLLIN;
+    for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+      fds[n].fd = httpd->clients[i].fd; /* -1: ignored by poll() */
+      fds[n].events = POLLIN | (httpd->clients[i].n_output ? POLLOUT : 0);
+      n++;
+    }
+
+    if (poll(fds, n, HTTPD_POLL_INTERVAL) == -1) {
+      if (errno == EINTR)
+        continue;
+      perror("poll");
+      break;
+    }
+
+    if (fds[0].revents)
+      break;
+
+    if (fds[1].revents & POLLIN)
+      accept_client(httpd);
+
+    for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+      if (fds[2 + i].revents & (POLLIN | POLLERR | POLLHUP) &&
+          httpd->clients[i].fd == fds[2 + i].fd)
+        receive(httpd, &httpd->clients[i]);
+    }
+
+    check_beat(httpd);
+
+    for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+      if (httpd->clients[i].fd != -1)
+        flush_client(&httpd->clients[i]);
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * returns listening socket for <spec>: "[ADDRESS:]PORT" or "ADDRESS",
+ * the bound port in <port>
+ *
+ * returns -1 on error
+ */
+static int open_socket(const char* spec, int* port)
+{
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  const char* colon = strchr(spec, ':');
+  char* host = colon ? g_strndup(spec, colon - spec) : NULL;
+  const char* number = colon ? colon + 1 : spec;
+  int on = 1;
+  int fd;
+
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(HTTPD_PORT);
+  if (*number >= '0' && *number <= '9') {
+    address.sin_port = htons(atoi(number));
+  } else if (!colon) {
+    host = g_strdup(spec);
+  }
+
+  if (host && !inet_aton(host, &address.sin_addr)) {
+    fprintf(stderr, "Warning: Bad HTTP server specification \"%s\".\n",
+            spec);
+    g_free(host);
+    return -1;
+  }
+  g_free(host);
+
+  if ((fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                   0)) == -1 ||
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) ||
+      bind(fd, (struct sockaddr*) &address, sizeof(address)) ||
+      listen(fd, HTTPD_MAX_CLIENTS) ||
+      getsockname(fd, (struct sockaddr*) &address, &length))
+  {
+    perror("Warning: Couldn't set up HTTP server");
+    if (fd != -1)
+      close(fd);
+    return -1;
+  }
+
+  *port = ntohs(address.sin_port);
+  return fd;
+}
+
+/*
+ * returns new HTTP server for <spec> (see open_socket(), port 0: any free
+ * port) showing the ticks of beat export <export> (see beatshm_new())
+ *
+ * returns NULL on error
+ */
+httpd_t* httpd_new(const char* spec, const char* export)
+{
+  httpd_t* result;
+  int i;
+
+  result = (httpd_t*) g_malloc0(sizeof(httpd_t));
+
+  if ((result->fd = open_socket(spec, &result->port)) == -1 ||
+      pipe(result->wakeup) == -1)
+  {
+    if (result->fd != -1) {
+      perror("pipe");
+      close(result->fd);
+    }
+    free(result);
+    return NULL;
+  }
+
+  for (i = 0; i < HTTPD_MAX_CLIENTS; i++)
+    result->clients[i].fd = -1;
+  result->export = strdup(export);
+  result->last_attach = beatshm_now() - HTTPD_ATTACH_INTERVAL * 1000000LL;
+  result->thread = g_thread_new("httpd", (GThreadFunc) serve, result);
+
+  if (debug)
+    fprintf(stderr, "HTTP server: port %d\n", result->port);
+
+  return result;
+}
+
+/*
+ * stops and destroys HTTP server, closing all connections
+ */
+void httpd_delete(httpd_t* httpd)
+{
+  int i;
+
+  if (write(httpd->wakeup[1], "", 1) != 1)
+    perror("write");
+  g_thread_join(httpd->thread);
+
+  for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+    if (httpd->clients[i].fd != -1)
+      close_client(&httpd->clients[i]);
+  }
+  close(httpd->wakeup[0]);
+  close(httpd->wakeup[1]);
+  close(httpd->fd);
+  if (httpd->record)
+    beatshm_detach(httpd->record);
+
+  free(httpd->export);
+  free(httpd);
+}
@@ -0,0 +1,92 @@
+/*
+ * embedded HTTP / WebSocket beat server interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HTTPD_H
+#define HTTPD_H
+
+/* GTK+ headers */
+#include <glib.h>
+
+/* own headers */
+#include "beatshm.h"
+
+/* default TCP port */
+#define HTTPD_PORT 7180
+
+/* maximum number of connections (HTTP and WebSocket) */
+#define HTTPD_MAX_CLIENTS 64
+
+/* maximum size of HTTP request header and of WebSocket frame received */
+#define HTTPD_MAX_REQUEST 4096
+
+/* size of output buffer of a connection: slower clients are dropped */
+#define HTTPD_OUTPUT_SIZE 16384
+
+/* milliseconds between samples of the beat export */
+#define HTTPD_POLL_INTERVAL 2
+
+/* milliseconds between attempts to (re)attach the beat export */
+#define HTTPD_ATTACH_INTERVAL 1000
+
+/* number of upcoming ticks announced in each event */
+#define HTTPD_UPCOMING 4
+
+typedef enum httpd_state_t {
+  HTTPD_CLOSED,     /* slot unused */
+  HTTPD_REQUEST,    /* reading HTTP request */
+  HTTPD_RESPONSE,   /* sending HTTP response, then closing */
+  HTTPD_WEBSOCKET   /* receiving beat events */
+} httpd_state_t;
+
+typedef struct httpd_client_t {
+  int fd;
+  httpd_state_t state;
+  char input[HTTPD_MAX_REQUEST];  /* incomplete request or frame */
+  int n_input;
+  char output[HTTPD_OUTPUT_SIZE]; /* not yet sent */
+  int n_output;
+} httpd_client_t;
+
+/*
+ * server: in its own thread, serves the visual tick page and pushes each
+ * tick of the beat export (see beatshm.h) to WebSocket clients, so the
+ * audio thread isn't involved at all
+ */
+typedef struct httpd_t {
+  int fd;                   /* listening socket */
+  int port;                 /* bound TCP port */
+  int wakeup[2];            /* pipe to terminate thread */
+  GThread* thread;
+
+  char* export;             /* name of beat export followed */
+  const beatshm_record_t* record; /* attached beat export, NULL: none */
+  int64_t last_attach;      /* monotonic time of last attempt in ns */
+  beatshm_record_t beat;    /* last tick pushed (running 0: stopped) */
+
+  httpd_client_t clients[HTTPD_MAX_CLIENTS];
+} httpd_t;
+
+httpd_t* httpd_new(const char* spec, const char* export);
+void httpd_delete(httpd_t* httpd);
+
+#endif /* HTTPD_H */
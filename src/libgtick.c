@@ -0,0 +1,470 @@
+/*
+ * libgtick.c: metronome engine library, wrapping the dsp object of gtick
+ *             and gtickd behind a stable interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "dsp.h"
+#include "threadtalk.h"
+#include "gtick.h"
+
+/* milliseconds to wait for the audio thread to answer */
+#define GTICK_TIMEOUT 2000
+
+struct gtick_params_t {
+  dsp_params_t* block;
+};
+
+/*
+ * the dsp object is used by the calling thread while idle or rendering, and
+ * only via queries while the audio thread plays it: all changes take the
+ * same path, see submit()
+ */
+struct gtick_engine_t {
+  comm_t* comm;
+  dsp_t* dsp;
+  GThread* thread;        /* audio thread while playing, NULL: none */
+  GAsyncQueue* reply;     /* status after each batch of queries */
+  unsigned int sequence;  /* of last batch */
+  int rendering;          /* between render_start and render_stop */
+  int debug;              /* handed to dsp before use */
+};
+
+/* names given to gtick_engine_set_driver() and their dsp sound systems */
+static const char* const drivers[] = { "pulseaudio", "oss", NULL };
+static const char* const soundsystems[] = { "<pulseaudio>", "<oss>", NULL };
+
+int gtick_api_version(void)
+{
+  return GTICK_API_VERSION;
+}
+
+/*
+ * returns new parameter block: DEFAULT_SPEED BPM in 1/4 with the sound of
+ * the engine
+ */
+gtick_params_t* gtick_params_new(void)
+{
+  gtick_params_t* result;
+
+  result = (gtick_params_t*) g_malloc(sizeof(gtick_params_t));
+  result->block = dsp_params_new();
+
+  return result;
+}
+
+gtick_params_t* gtick_params_copy(const gtick_params_t* params)
+{
+  gtick_params_t* result;
+
+  result = (gtick_params_t*) g_malloc(sizeof(gtick_params_t));
+  result->block = dsp_params_copy(params->block);
+
+  return result;
+}
+
+void gtick_params_delete(gtick_params_t* params)
+{
+  dsp_params_delete(params->block);
+  free(params);
+}
+
+int gtick_params_set_bpm(gtick_params_t* params, double bpm)
+{
+  if (bpm < GTICK_MIN_BPM || bpm > GTICK_MAX_BPM)
+    return -1;
+
+  params->block->frequency = bpm / 60.0;
+  return 0;
+}
+
+/*
+ * sets <meter> ticks per bar with GTICK_BEAT_* for each tick in <accents>,
+ * NULL: first tick accentuated
+ */
+int gtick_params_set_meter(gtick_params_t* params,
+                           int meter, const int* accents)
+{
+  int i;
+
+  if (meter < 1 || meter > GTICK_MAX_METER)
+    return -1;
+  for (i = 0; accents && i < meter; i++) {
+    if (accents[i] < GTICK_BEAT_NORMAL || accents[i] > GTICK_BEAT_OFF)
+      return -1;
+  }
+
+  params->block->meter = meter;
+  memset(params->block->accents, 0, sizeof(params->block->accents));
+  for (i = 0; i < meter; i++)
+    params->block->accents[i] = accents ? accents[i] :
+                                i == 0 ? GTICK_BEAT_ACCENT : GTICK_BEAT_NORMAL;
+  return 0;
+}
+
+/*
+ * sets <subdivision> sub beats per tick (1: none) with <gain> relative to
+ * the ticks (0.0 ... 1.0)
+ */
+int gtick_params_set_subdivision(gtick_params_t* params,
+                                 int subdivision, double gain)
+{
+  if (subdivision < 1 || subdivision > GTICK_MAX_SUBDIVISION ||
+      gain < 0.0 || gain > 1.0)
+    return -1;
+
+  params->block->subdivision = subdivision;
+  params->block->subgain = gain;
+  return 0;
+}
+
+/*
+ * sets sound of ticks: "<default>", a synthesized sound (e.g. "<sine>" or
+ * "<wood freq=1500>", see synth.c) or a sound file, NULL: sound of the
+ * engine left unchanged
+ */
+int gtick_params_set_sound(gtick_params_t* params, const char* sound)
+{
+  if (params->block->soundname)
+    free(params->block->soundname);
+  params->block->soundname = sound ? strdup(sound) : NULL;
+  return 0;
+}
+
+/*
+ * sets pulse layers, e.g. "100;10000,<sine>" (see option Layers of gtickd)
+ */
+int gtick_params_set_layers(gtick_params_t* params, const char* layers)
+{
+  return dsp_params_set_layers(params->block, layers);
+}
+
+/*
+ * sets tempo ramp from the BPM of the block, e.g. "linear 160 16 bars"
+ * (see option Ramp of gtickd), "": none
+ */
+int gtick_params_set_ramp(gtick_params_t* params, const char* ramp)
+{
+  return dsp_params_set_ramp(params->block, ramp);
+}
+
+int gtick_params_set_quantize(gtick_params_t* params,
+                              gtick_quantize_t quantize)
+{
+  switch (quantize) {
+  case GTICK_QUANTIZE_NOW:
+    params->block->quantize = DSP_QUANTIZE_NOW;
+    break;
+  case GTICK_QUANTIZE_BEAT:
+    params->block->quantize = DSP_QUANTIZE_BEAT;
+    break;
+  case GTICK_QUANTIZE_BAR:
+    params->block->quantize = DSP_QUANTIZE_BAR;
+    break;
+  default:
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * returns new engine, not playing: default sound, full volume, driver
+ * "pulseaudio"
+ */
+gtick_engine_t* gtick_engine_new(void)
+{
+  gtick_engine_t* result;
+
+  result = (gtick_engine_t*) g_malloc0(sizeof(gtick_engine_t));
+  result->comm = comm_new();
+  result->dsp = dsp_new(result->comm);
+  result->dsp->quiet = 1; /* status comes with the batch replies */
+  result->dsp->volume = 1.0;
+  result->dsp->soundsystem = strdup(soundsystems[0]);
+  result->dsp->devicename = strdup(DEFAULT_SOUND_DEVICE_FILENAME);
+  result->reply = g_async_queue_new();
+
+  return result;
+}
+
+void gtick_engine_delete(gtick_engine_t* engine)
+{
+  void* status;
+
+  gtick_engine_stop(engine);
+  gtick_engine_render_stop(engine);
+  dsp_delete(engine->dsp);
+  comm_delete(engine->comm);
+  while ((status = g_async_queue_try_pop(engine->reply)))
+    free(status);
+  g_async_queue_unref(engine->reply);
+  free(engine);
+}
+
+/*
+ * sets level of debugging output on stdout, 0: none; taking effect at the
+ * next start of playback or rendering
+ */
+void gtick_engine_set_debug(gtick_engine_t* engine, int level)
+{
+  engine->debug = level;
+}
+
+/*
+ * lets the engine handle <batch> (taken over): by the audio thread between
+ * two fragments while playing, else right away in the calling thread
+ *
+ * returns status after the batch, NULL if the audio thread didn't answer
+ */
+static dsp_status_t* submit(gtick_engine_t* engine, comm_batch_t* batch)
+{
+  dsp_status_t* status;
+
+  comm_client_query(engine->comm, MESSAGE_TYPE_BATCH, batch);
+  if (!engine->thread) {
+    int repeat_flag = 1;
+    int get_volume = 0;
+
+    dsp_handle_queries(engine->dsp, &repeat_flag, &get_volume);
+  }
+
+  /* skip late status of earlier batches */
+  while ((status = g_async_queue_timeout_pop(engine->reply,
+                                             GTICK_TIMEOUT * 1000)) &&
+         status->sequence != engine->sequence)
+    free(status);
+
+  return status;
+}
+
+/*
+ * lets the engine handle query <type> with <body> (taken over)
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int query(gtick_engine_t* engine, message_type_t type, void* body)
+{
+  comm_batch_t* batch = comm_batch_new(++engine->sequence, engine->reply);
+  dsp_status_t* status;
+
+  comm_batch_add(batch, type, body);
+  if (!(status = submit(engine, batch)))
+    return -1;
+  free(status);
+  return 0;
+}
+
+/*
+ * makes (a copy of) <params> the parameters of the engine, taking effect
+ * according to their quantization
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_set_params(gtick_engine_t* engine,
+                            const gtick_params_t* params)
+{
+  return query(engine, MESSAGE_TYPE_SET_PARAMS,
+               dsp_params_copy(params->block));
+}
+
+/*
+ * sets <volume> 0.0 ... 1.0
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_set_volume(gtick_engine_t* engine, double volume)
+{
+  double* body;
+
+  if (volume < 0.0 || volume > 1.0)
+    return -1;
+
+  body = (double*) g_malloc(sizeof(double));
+  *body = volume;
+  return query(engine, MESSAGE_TYPE_SET_VOLUME, body);
+}
+
+/*
+ * prepares rendering at <rate> Hz with <channels> by gtick_engine_render(),
+ * starting with the first tick, while not playing
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_render_start(gtick_engine_t* engine, int rate, int channels)
+{
+  if (engine->thread || engine->rendering)
+    return -1;
+
+  engine->dsp->debug = engine->debug;
+  if (dsp_offline_start(engine->dsp, rate, channels, AFMT_S16_NE) == -1)
+    return -1;
+  engine->rendering = 1;
+  return 0;
+}
+
+/*
+ * renders the next <frames> to <buffer> (frames * channels samples)
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_render(gtick_engine_t* engine, short* buffer, int frames)
+{
+  if (!engine->rendering || frames < 0)
+    return -1;
+
+  dsp_offline_render(engine->dsp, buffer, frames);
+  return 0;
+}
+
+void gtick_engine_render_stop(gtick_engine_t* engine)
+{
+  if (!engine->rendering)
+    return;
+
+  dsp_offline_stop(engine->dsp);
+  engine->rendering = 0;
+}
+
+/*
+ * returns NULL terminated list of drivers for gtick_engine_set_driver()
+ */
+const char* const* gtick_drivers(void)
+{
+  return drivers;
+}
+
+/*
+ * selects <driver> (see gtick_drivers()) with <device> (file name of OSS
+ * device, NULL: default) for the next start
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_set_driver(gtick_engine_t* engine,
+                            const char* driver, const char* device)
+{
+  comm_batch_t* batch;
+  dsp_status_t* status;
+  int i;
+
+  for (i = 0; drivers[i] && strcmp(drivers[i], driver); i++);
+  if (!drivers[i])
+    return -1;
+
+  batch = comm_batch_new(++engine->sequence, engine->reply);
+  comm_batch_add(batch, MESSAGE_TYPE_SET_SOUNDSYSTEM, strdup(soundsystems[i]));
+  comm_batch_add(batch, MESSAGE_TYPE_SET_DEVICE,
+                 strdup(device ? device : DEFAULT_SOUND_DEVICE_FILENAME));
+  if (!(status = submit(engine, batch)))
+    return -1;
+  free(status);
+  return 0;
+}
+
+/*
+ * The audio thread
+ */
+static gpointer audio_loop(dsp_t* dsp)
+{
+  dsp_main_loop(dsp);
+
+  return NULL;
+}
+
+/*
+ * starts playback on the sound driver in an audio thread of its own
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int gtick_engine_start(gtick_engine_t* engine)
+{
+  comm_batch_t* batch;
+  dsp_status_t* status;
+  int result;
+
+  if (engine->thread || engine->rendering)
+    return -1;
+
+  engine->dsp->debug = engine->debug;
+  engine->thread = g_thread_new("gtick", (GThreadFunc) audio_loop,
+                                engine->dsp);
+
+  batch = comm_batch_new(++engine->sequence, engine->reply);
+  comm_batch_add(batch, MESSAGE_TYPE_START_METRONOME, NULL);
+  status = submit(engine, batch);
+  result = status && status->running ? 0 : -1;
+  if (status)
+    free(status);
+
+  if (result == -1)
+    gtick_engine_stop(engine);
+  return result;
+}
+
+/*
+ * stops playback and the audio thread
+ */
+void gtick_engine_stop(gtick_engine_t* engine)
+{
+  if (!engine->thread)
+    return;
+
+  comm_client_query(engine->comm, MESSAGE_TYPE_STOP_METRONOME, NULL);
+  comm_client_query(engine->comm, MESSAGE_TYPE_STOP_SERVER, NULL);
+  g_thread_join(engine->thread);
+  engine->thread = NULL;
+}
+
+/*
+ * returns 1 if playing on the sound driver, 0 otherwise
+ */
+int gtick_engine_running(gtick_engine_t* engine)
+{
+  dsp_status_t* status;
+  int result;
+
+  if (!engine->thread)
+    return 0;
+
+  status = submit(engine, comm_batch_new(++engine->sequence, engine->reply));
+  result = status && status->running;
+  if (status)
+    free(status);
+  return result;
+}
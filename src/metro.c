@@ -66,6 +66,7 @@ static void preferences_cb(GtkAction *action, metro_t *metro);
 static void quit_cb(GtkAction *action, metro_t *metro);
 static void toggle_accenttable_cb(GtkToggleAction *action, metro_t *metro);
 static void toggle_visualtick_cb(GtkToggleAction *action, metro_t *metro);
+static void set_meter_int(metro_t* metro, int meter);
 
 #define TIMER_DELAY 300
 volatile int interrupted = 0; /* the caught signal will be stored here */
@@ -243,13 +244,117 @@ int gui_get_meter(metro_t* metro) {
   return meter;
 }
 
+/*
+ * starts collecting speed, meter and accents changes from GUI (widgets)
+ * instead of sending them to the audio thread one by one
+ *
+ * calls may be nested, see metro_params_end()
+ */
+void metro_params_begin(metro_t* metro) {
+  metro->params_batch++;
+}
+
+/*
+ * returns new parameter block with the complete current setting
+ * (speed, meter, accents, sound, sub beats, layers, tempo ramp)
+ */
+static dsp_params_t* get_params(metro_t* metro) {
+  dsp_params_t* params;
+  int i;
+
+  params = dsp_params_new();
+  params->frequency =
+    gtk_adjustment_get_value(GTK_ADJUSTMENT(metro->speed_adjustment)) / 60.0;
+  params->meter = gui_get_meter(metro);
+  for (i = 0; i < MAX_METER; i++) {
+    params->accents[i] = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+	                                                metro->accentbuttons[i]));
+  }
+  if (metro->options->sample_name)
+    params->soundname = strdup(metro->options->sample_name);
+  params->subdivision = gtk_spin_button_get_value_as_int(
+                          GTK_SPIN_BUTTON(metro->subbeats_spin_button));
+  params->subgain = metro->subbeat_volume / 100.0;
+  if (metro->layers)
+    dsp_params_set_layers(params, metro->layers);
+  if (metro->ramp)
+    dsp_params_set_ramp(params, metro->ramp);
+
+  return params;
+}
+
+/*
+ * finishes collecting changes: when leaving the outermost batch, the complete
+ * current setting is sent to the audio thread as one parameter block, to be
+ * applied at the specified quantization point
+ */
+void metro_params_end(metro_t* metro, dsp_quantize_t quantize) {
+  dsp_params_t* params;
+
+  assert(metro->params_batch > 0);
+
+  if (--metro->params_batch > 0)
+    return;
+
+  params = get_params(metro);
+  params->quantize = quantize;
+
+  comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_SET_PARAMS, params);
+}
+
+/*
+ * finishes collecting changes without sending them, e.g. for a setting the
+ * audio thread already has (an enclosing batch still sends its changes)
+ */
+void metro_params_abort(metro_t* metro) {
+  assert(metro->params_batch > 0);
+
+  metro->params_batch--;
+}
+
+/*
+ * renders <seconds> of the current setting to WAV file <filename>,
+ * independent of the audio thread and sound device
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int metro_render(metro_t* metro, const char* filename, double seconds) {
+  comm_t* comm = comm_new();
+  dsp_t* dsp = dsp_new(comm);
+  int result;
+
+  dsp->debug = debug;
+  dsp->volume =
+    gtk_adjustment_get_value(GTK_ADJUSTMENT(metro->volume_adjustment)) / 100.0;
+  if (metro->setlist && *metro->setlist) {
+    timeline_t* timeline = timeline_load(metro->setlist);
+
+    if (!timeline) {
+      dsp_delete(dsp);
+      comm_delete(comm);
+      return -1;
+    }
+    dsp_set_timeline(dsp, timeline);
+  }
+  result = dsp_render(dsp, get_params(metro), filename, seconds);
+
+  dsp_delete(dsp);
+  comm_delete(comm);
+
+  return result;
+}
+
 /*
  * GUI volume change callback
  */
 static void set_volume_cb(metro_t* metro)
 {
-  double* volume = (double*) g_malloc(sizeof(double));
+  double* volume;
+
+  if (metro->params_batch)
+    return;
 
+  volume = (double*) g_malloc(sizeof(double));
   *volume = GTK_ADJUSTMENT(metro->volume_adjustment)->value / 100.0;
   comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_SET_VOLUME,
       volume);
@@ -278,9 +383,13 @@ static void set_speed_cb(metro_t *metro)
     g_print("set_speed_cb(): New speed name = \"%s\"\n",
             speed_names[new_index].name);
 
-  comm_client_query(metro->inter_thread_comm,
-                    MESSAGE_TYPE_SET_FREQUENCY,
-		    frequency);
+  if (metro->params_batch) {
+    free(frequency);
+  } else {
+    comm_client_query(metro->inter_thread_comm,
+                      MESSAGE_TYPE_SET_FREQUENCY,
+		      frequency);
+  }
 }
 
 /*
@@ -303,9 +412,14 @@ static void set_speed_name_cb(metro_t *metro)
  * At least one accent check button has been toggled
  */
 static void accents_changed_cb(metro_t* metro) {
-  int* message = (int*) g_malloc (sizeof(int) * MAX_METER);
+  int* message;
   int i;
 
+  if (metro->params_batch)
+    return;
+
+  message = (int*) g_malloc (sizeof(int) * MAX_METER);
+
   for (i = 0; i < MAX_METER; i++) {
     message[i] = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
 	                                          metro->accentbuttons[i]));
@@ -315,6 +429,24 @@ static void accents_changed_cb(metro_t* metro) {
                     message);
 }
 
+/*
+ * shows <state> in status bar and start / stop controls
+ */
+static void show_state(metro_t* metro, int state) {
+  gtk_statusbar_pop(GTK_STATUSBAR(metro->statusbar),
+		    metro->status_context);
+  gtk_statusbar_push(GTK_STATUSBAR(metro->statusbar),
+		     metro->status_context,
+		     _(state_data[state].state));
+  gtk_label_set_text(GTK_LABEL(metro->togglebutton_label),
+		     _(state_data[state].toggle_label));
+  /* Set Start/Stop label */
+  g_object_set(metro->start_action, "label",
+               _(state_data[state].toggle_label), NULL);
+
+  metro->state = state;
+}
+
 /*
  * Change state
  */
@@ -335,21 +467,62 @@ static void set_state(metro_t* metro, int state) {
       fprintf(stderr, "Warning: Unhandled state change.\n");
     }
 
-    gtk_statusbar_pop(GTK_STATUSBAR(metro->statusbar),
-		      metro->status_context);
-    gtk_statusbar_push(GTK_STATUSBAR(metro->statusbar),
-		       metro->status_context,
-		       _(state_data[state].state));
-    gtk_label_set_text(GTK_LABEL(metro->togglebutton_label),
-		       _(state_data[state].toggle_label));
-    /* Set Start/Stop label */
-    g_object_set(metro->start_action, "label",
-                 _(state_data[state].toggle_label), NULL);
+    show_state(metro, state);
+  }
+}
+
+/*
+ * shows setting changed via control socket, without sending it back to the
+ * audio thread
+ */
+static void show_status(metro_t* metro, dsp_status_t* status) {
+  int i;
 
-    metro->state = state;
+  metro_params_begin(metro);
+  gtk_adjustment_set_value(GTK_ADJUSTMENT(metro->speed_adjustment),
+                           status->bpm);
+  set_meter_int(metro, status->meter);
+  for (i = 0; i < MAX_METER; i++) {
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(metro->accentbuttons[i]),
+                                 status->accents[i] == DSP_BEAT_ACCENT);
+  }
+  gtk_adjustment_set_value(GTK_ADJUSTMENT(metro->volume_adjustment),
+                           status->volume * 100.0);
+  metro_params_abort(metro);
+
+  if (status->running != (metro->state == STATE_RUNNING)) {
+    if (status->running)
+      visualtick_sync(metro, 0);
+    show_state(metro, status->running ? STATE_RUNNING : STATE_IDLE);
   }
 }
 
+/*
+ * shows state of following the MIDI clock master in the status bar
+ */
+static void show_lock(metro_t* metro, dsp_lock_t* lock) {
+  char* text;
+
+  if (metro->state != STATE_RUNNING)
+    return;
+
+  if (lock->locked)
+    text = g_strdup_printf(_("Following %s: %.1f BPM, "
+                             "phase error %.2f ms, jitter %.2f ms"),
+                           *metro->midiclockin ? _("MIDI clock") :
+                                                 _("leader"),
+                           lock->bpm, lock->phase_error, lock->jitter);
+  else
+    text = g_strdup_printf(_("Waiting for %s"),
+                           *metro->midiclockin ? _("MIDI clock") :
+                                                 _("leader"));
+
+  gtk_statusbar_pop(GTK_STATUSBAR(metro->statusbar), metro->status_context);
+  gtk_statusbar_push(GTK_STATUSBAR(metro->statusbar), metro->status_context,
+                     text);
+  g_free(text);
+}
+
 /*
  * handle messages from server (i.e., from metronome backend)
  */
@@ -371,6 +544,14 @@ static gint handle_comm(metro_t* metro) {
 
 	set_state(metro, STATE_IDLE);
         break;
+      case MESSAGE_TYPE_RESPONSE_LOCK:
+	show_lock(metro, (dsp_lock_t*) body);
+	free(body);
+	break;
+      case MESSAGE_TYPE_RESPONSE_STATUS:
+	show_status(metro, (dsp_status_t*) body);
+	free(body);
+	break;
       default:
         printf("Warning: Unhandled message type: %d.\n", message_type);
     }
@@ -424,6 +605,14 @@ static void quit_cb(GtkAction *action _U_, metro_t *metro)
 {
   set_state(metro, STATE_IDLE);
   option_save_all(metro->options->option_list);
+  if (metro->control) {
+    control_delete(metro->control);
+    metro->control = NULL;
+  }
+  if (metro->httpd) {
+    httpd_delete(metro->httpd);
+    metro->httpd = NULL;
+  }
   comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_STOP_SERVER, NULL);
   gtk_main_quit();
 }
@@ -912,7 +1101,10 @@ static void set_meter_int(metro_t* metro, int meter)
 
   visualtick_new_meter(metro, meter);
 
-  comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_SET_METER, message);
+  if (metro->params_batch)
+    free(message);
+  else
+    comm_client_query(metro->inter_thread_comm, MESSAGE_TYPE_SET_METER, message);
 }
 
 /*
@@ -990,6 +1182,740 @@ static void delete_meter(metro_t* metro _U_) {
   get_meter(NULL, 0, NULL);
 }
 
+/*
+ * Callback for number of sub beats: takes effect with the next tick
+ */
+static void set_subbeats_cb(metro_t* metro) {
+  metro_params_begin(metro);
+  metro_params_end(metro, DSP_QUANTIZE_BEAT);
+}
+
+/*
+ * option system callback for choosing the number of sub beats
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_subbeats(metro_t* metro,
+                        const char* option_name _U_, const char* subbeats)
+{
+  if (!metro || !subbeats)
+    return -1;
+
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(metro->subbeats_spin_button),
+                            (int) strtol(subbeats, NULL, 0));
+
+  return 0;
+}
+
+/*
+ * option system callback for spotting the number of sub beats
+ *
+ * if called with metro == NULL, deinitializes state and return NULL
+ */
+static const char* get_subbeats(metro_t* metro,
+                                int n _U_, char** option_name _U_)
+{
+  static char* result = NULL;
+
+  if (result)
+    free(result);
+
+  if (metro == NULL)
+    return NULL;
+
+  result = g_strdup_printf("%d", gtk_spin_button_get_value_as_int(
+                                   GTK_SPIN_BUTTON(metro->subbeats_spin_button)));
+
+  return result;
+}
+
+/*
+ * option system callback for initializing sub beats option
+ */
+static int new_subbeats(metro_t* metro) {
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(metro->subbeats_spin_button),
+                            DEFAULT_SUBBEATS);
+  return 0;
+}
+
+/*
+ * option system callback for destroying sub beats option
+ */
+static void delete_subbeats(metro_t* metro _U_) {
+  get_subbeats(NULL, 0, NULL);
+}
+
+/*
+ * option system callback for choosing the volume of sub beats
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_subbeat_volume(metro_t* metro,
+                              const char* option_name _U_, const char* volume)
+{
+  if (!metro || !volume)
+    return -1;
+
+  metro->subbeat_volume = CLAMP(g_ascii_strtod(volume, NULL),
+                                VOLUME_MIN, VOLUME_MAX);
+  metro_params_begin(metro);
+  metro_params_end(metro, DSP_QUANTIZE_NOW);
+
+  return 0;
+}
+
+/*
+ * option system callback for spotting the volume of sub beats
+ *
+ * if called with metro == NULL, deinitializes state and return NULL
+ */
+static const char* get_subbeat_volume(metro_t* metro,
+                                      int n _U_, char** option_name _U_)
+{
+  static gchar* result = NULL;
+
+  if (result)
+    free(result);
+
+  if (metro == NULL)
+    return NULL;
+
+  result = g_malloc(G_ASCII_DTOSTR_BUF_SIZE);
+  return g_ascii_dtostr(result, G_ASCII_DTOSTR_BUF_SIZE, metro->subbeat_volume);
+}
+
+/*
+ * option system callback for initializing sub beat volume option
+ */
+static int new_subbeat_volume(metro_t* metro) {
+  metro->subbeat_volume = DEFAULT_SUBBEAT_VOLUME;
+  return 0;
+}
+
+/*
+ * option system callback for destroying sub beat volume option
+ */
+static void delete_subbeat_volume(metro_t* metro _U_) {
+  get_subbeat_volume(NULL, 0, NULL);
+}
+
+/*
+ * option system callback for choosing the pulse layers (polyrhythms),
+ * switched to at the beginning of the next bar
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_layers(metro_t* metro,
+                      const char* option_name _U_, const char* layers)
+{
+  dsp_params_t* params;
+
+  if (!metro || !layers)
+    return -1;
+
+  /* validate */
+  params = dsp_params_new();
+  if (dsp_params_set_layers(params, layers) == -1) {
+    g_print("set_layers(): Bad value: %s\n", layers);
+    dsp_params_delete(params);
+    return -1;
+  }
+  dsp_params_delete(params);
+
+  if (metro->layers)
+    free(metro->layers);
+  metro->layers = strdup(layers);
+  metro_params_begin(metro);
+  metro_params_end(metro, DSP_QUANTIZE_BAR);
+
+  return 0;
+}
+
+/* option system callback for getting pulse layers option */
+static const char* get_layers(metro_t* metro,
+                              int n _U_, char** option_name _U_)
+{
+  return metro->layers;
+}
+
+/* option system callback for initializing pulse layers option */
+static int new_layers(metro_t* metro) {
+  metro->layers = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying pulse layers option */
+static void delete_layers(metro_t* metro) {
+  if (metro->layers) {
+    free(metro->layers);
+    metro->layers = NULL;
+  }
+}
+
+/*
+ * option system callback for choosing the tempo ramp, started at the
+ * beginning of the next bar
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_ramp(metro_t* metro, const char* option_name _U_,
+                    const char* ramp)
+{
+  dsp_params_t* params;
+
+  if (!metro || !ramp)
+    return -1;
+
+  /* validate */
+  params = dsp_params_new();
+  if (dsp_params_set_ramp(params, ramp) == -1) {
+    g_print("set_ramp(): Bad value: %s\n", ramp);
+    dsp_params_delete(params);
+    return -1;
+  }
+  dsp_params_delete(params);
+
+  if (metro->ramp)
+    free(metro->ramp);
+  metro->ramp = strdup(ramp);
+  metro_params_begin(metro);
+  metro_params_end(metro, DSP_QUANTIZE_BAR);
+
+  return 0;
+}
+
+/* option system callback for getting tempo ramp option */
+static const char* get_ramp(metro_t* metro,
+                            int n _U_, char** option_name _U_)
+{
+  return metro->ramp;
+}
+
+/* option system callback for initializing tempo ramp option */
+static int new_ramp(metro_t* metro) {
+  metro->ramp = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying tempo ramp option */
+static void delete_ramp(metro_t* metro) {
+  if (metro->ramp) {
+    free(metro->ramp);
+    metro->ramp = NULL;
+  }
+}
+
+/*
+ * option system callback for choosing the setlist (timeline file) to be
+ * played instead of the current setting, "": none
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_setlist(metro_t* metro, const char* option_name _U_,
+                       const char* setlist)
+{
+  timeline_t* timeline = NULL;
+
+  if (!metro || !setlist)
+    return -1;
+
+  if (*setlist && !(timeline = timeline_load(setlist))) {
+    g_print("set_setlist(): Bad setlist: %s\n", setlist);
+    return -1;
+  }
+
+  if (metro->setlist)
+    free(metro->setlist);
+  metro->setlist = strdup(setlist);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_TIMELINE, timeline);
+
+  return 0;
+}
+
+/* option system callback for getting setlist option */
+static const char* get_setlist(metro_t* metro,
+                               int n _U_, char** option_name _U_)
+{
+  return metro->setlist;
+}
+
+/* option system callback for initializing setlist option */
+static int new_setlist(metro_t* metro) {
+  metro->setlist = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying setlist option */
+static void delete_setlist(metro_t* metro) {
+  if (metro->setlist) {
+    free(metro->setlist);
+    metro->setlist = NULL;
+  }
+}
+
+/*
+ * option system callback for choosing the MIDI clock output:
+ * "DESTINATION[,NOTE]", e.g. "20:0" or "Midi Through,37" with NOTE
+ * triggered on each tick, DESTINATION "-" for a port only subscribable
+ * by others, "": off
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_midiclock(metro_t* metro, const char* option_name _U_,
+                         const char* midiclock)
+{
+  midiclock_t* clock = NULL;
+  char* destination;
+  char* note;
+  char* end;
+  int n = -1;
+
+  if (!metro || !midiclock)
+    return -1;
+
+  if (*midiclock) {
+    destination = strdup(midiclock);
+    if ((note = strrchr(destination, ','))) {
+      *note++ = '\0';
+      n = strtol(note, &end, 10);
+      if (*end || n < 0 || n > 127) {
+        g_print("set_midiclock(): Bad note: %s\n", note);
+        free(destination);
+        return -1;
+      }
+    }
+    clock = midiclock_new(strcmp(destination, "-") ? destination : NULL, n);
+    free(destination);
+    if (!clock)
+      return -1;
+  }
+
+  if (metro->midiclock)
+    free(metro->midiclock);
+  metro->midiclock = strdup(midiclock);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_MIDICLOCK, clock);
+
+  return 0;
+}
+
+/* option system callback for getting MIDI clock option */
+static const char* get_midiclock(metro_t* metro,
+                                 int n _U_, char** option_name _U_)
+{
+  return metro->midiclock;
+}
+
+/* option system callback for initializing MIDI clock option */
+static int new_midiclock(metro_t* metro) {
+  metro->midiclock = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying MIDI clock option */
+static void delete_midiclock(metro_t* metro) {
+  if (metro->midiclock) {
+    free(metro->midiclock);
+    metro->midiclock = NULL;
+  }
+}
+
+/*
+ * option system callback for choosing the MIDI clock master to follow:
+ * "SOURCE", e.g. "20:0" or "Midi Through", "-" for a port only connectable
+ * by others, "": off
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_midiclockin(metro_t* metro, const char* option_name _U_,
+                           const char* midiclockin)
+{
+  midiclock_t* master = NULL;
+
+  if (!metro || !midiclockin)
+    return -1;
+
+  if (*midiclockin) {
+    master = midiclock_new_input(strcmp(midiclockin, "-") ?
+                                 midiclockin : NULL);
+    if (!master)
+      return -1;
+  }
+
+  if (metro->midiclockin)
+    free(metro->midiclockin);
+  metro->midiclockin = strdup(midiclockin);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_MASTER, master);
+
+  return 0;
+}
+
+/* option system callback for getting MIDI clock master option */
+static const char* get_midiclockin(metro_t* metro,
+                                   int n _U_, char** option_name _U_)
+{
+  return metro->midiclockin;
+}
+
+/* option system callback for initializing MIDI clock master option */
+static int new_midiclockin(metro_t* metro) {
+  metro->midiclockin = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying MIDI clock master option */
+static void delete_midiclockin(metro_t* metro) {
+  if (metro->midiclockin) {
+    free(metro->midiclockin);
+    metro->midiclockin = NULL;
+  }
+}
+
+/*
+ * option system callback for LAN beat sync with other instances:
+ * "ROLE[,GROUP[:PORT][,INTERFACE]]", e.g. "leader" or
+ * "follower,239.255.71.84:7171,192.168.0.2", "": off
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_netsync(metro_t* metro, const char* option_name _U_,
+                       const char* spec)
+{
+  netsync_t* sync = NULL;
+
+  if (!metro || !spec)
+    return -1;
+
+  if (*spec && !(sync = netsync_new(spec)))
+    return -1;
+
+  if (metro->netsync)
+    free(metro->netsync);
+  metro->netsync = strdup(spec);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_NETSYNC, sync);
+
+  return 0;
+}
+
+/* option system callback for getting LAN beat sync option */
+static const char* get_netsync(metro_t* metro,
+                               int n _U_, char** option_name _U_)
+{
+  return metro->netsync;
+}
+
+/* option system callback for initializing LAN beat sync option */
+static int new_netsync(metro_t* metro) {
+  metro->netsync = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying LAN beat sync option */
+static void delete_netsync(metro_t* metro) {
+  if (metro->netsync) {
+    free(metro->netsync);
+    metro->netsync = NULL;
+  }
+}
+
+/*
+ * option system callback for the HTTP server showing the ticks of the beat
+ * position export in browsers: "[ADDRESS:]PORT", "": off
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_http_server(metro_t* metro, const char* option_name _U_,
+                           const char* spec)
+{
+  if (!metro || !spec)
+    return -1;
+
+  if (*spec && !*metro->beat_export) {
+    fprintf(stderr, "Warning: HTTP server needs option BeatExport.\n");
+    return -1;
+  }
+
+  if (metro->httpd) {
+    httpd_delete(metro->httpd);
+    metro->httpd = NULL;
+  }
+  if (*spec && !(metro->httpd = httpd_new(spec, metro->beat_export)))
+    return -1;
+
+  if (metro->http_server)
+    free(metro->http_server);
+  metro->http_server = strdup(spec);
+
+  return 0;
+}
+
+/* option system callback for getting HTTP server option */
+static const char* get_http_server(metro_t* metro,
+                                   int n _U_, char** option_name _U_)
+{
+  return metro->http_server;
+}
+
+/* option system callback for initializing HTTP server option */
+static int new_http_server(metro_t* metro) {
+  metro->http_server = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying HTTP server option */
+static void delete_http_server(metro_t* metro) {
+  if (metro->http_server) {
+    free(metro->http_server);
+    metro->http_server = NULL;
+  }
+}
+
+/*
+ * option system callback for the beat position export: name of shared
+ * memory object, e.g. "/gtick", "": off
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_beat_export(metro_t* metro, const char* option_name _U_,
+                           const char* name)
+{
+  beatshm_t* shm = NULL;
+
+  if (!metro || !name)
+    return -1;
+
+  if (*name && !(shm = beatshm_new(name)))
+    return -1;
+
+  if (metro->beat_export)
+    free(metro->beat_export);
+  metro->beat_export = strdup(name);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_BEATSHM, shm);
+
+  if (metro->httpd) { /* follow the new export */
+    char* spec = strdup(metro->http_server);
+
+    set_http_server(metro, NULL, spec);
+    free(spec);
+  }
+
+  return 0;
+}
+
+/* option system callback for getting beat position export option */
+static const char* get_beat_export(metro_t* metro,
+                                   int n _U_, char** option_name _U_)
+{
+  return metro->beat_export;
+}
+
+/* option system callback for initializing beat position export option */
+static int new_beat_export(metro_t* metro) {
+  metro->beat_export = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying beat position export option */
+static void delete_beat_export(metro_t* metro) {
+  if (metro->beat_export) {
+    free(metro->beat_export);
+    metro->beat_export = NULL;
+  }
+}
+
+/*
+ * option system callback for the channel map, e.g. "click,click,cue,pulse",
+ * "": click on all channels; taking effect at the next start
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_channel_map(metro_t* metro, const char* option_name _U_,
+                           const char* spec)
+{
+  dsp_channel_map_t* map = NULL;
+
+  if (!metro || !spec)
+    return -1;
+
+  if (*spec && !(map = dsp_channel_map_new(spec)))
+    return -1;
+
+  if (metro->channel_map)
+    free(metro->channel_map);
+  metro->channel_map = strdup(spec);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_CHANNEL_MAP, map);
+
+  return 0;
+}
+
+/* option system callback for getting channel map option */
+static const char* get_channel_map(metro_t* metro,
+                                   int n _U_, char** option_name _U_)
+{
+  return metro->channel_map;
+}
+
+/* option system callback for initializing channel map option */
+static int new_channel_map(metro_t* metro) {
+  metro->channel_map = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying channel map option */
+static void delete_channel_map(metro_t* metro) {
+  if (metro->channel_map) {
+    free(metro->channel_map);
+    metro->channel_map = NULL;
+  }
+}
+
+/*
+ * option system callback for the further outputs of the rendered stream,
+ * e.g. "oss:/dev/dsp1@10,wav:/tmp/take.wav", "": none
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_sinks(metro_t* metro, const char* option_name _U_,
+                     const char* spec)
+{
+  fanout_t* fanout = NULL;
+
+  if (!metro || !spec)
+    return -1;
+
+  if (*spec && !(fanout = fanout_new(spec)))
+    return -1;
+
+  if (metro->sinks)
+    free(metro->sinks);
+  metro->sinks = strdup(spec);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_FANOUT, fanout);
+
+  return 0;
+}
+
+/* option system callback for getting sinks option */
+static const char* get_sinks(metro_t* metro,
+                             int n _U_, char** option_name _U_)
+{
+  return metro->sinks;
+}
+
+/* option system callback for initializing sinks option */
+static int new_sinks(metro_t* metro) {
+  metro->sinks = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying sinks option */
+static void delete_sinks(metro_t* metro) {
+  if (metro->sinks) {
+    free(metro->sinks);
+    metro->sinks = NULL;
+  }
+}
+
+/*
+ * option system callback for the recording played along with the click,
+ * e.g. "/music/blues.wav@3:5-12", "": none; played from the next start
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_backing_track(metro_t* metro, const char* option_name _U_,
+                             const char* spec)
+{
+  backing_t* backing = NULL;
+
+  if (!metro || !spec)
+    return -1;
+
+  if (*spec && !(backing = backing_new(spec)))
+    return -1;
+
+  if (metro->backing_track)
+    free(metro->backing_track);
+  metro->backing_track = strdup(spec);
+  comm_client_query(metro->inter_thread_comm,
+                    MESSAGE_TYPE_SET_BACKING, backing);
+
+  return 0;
+}
+
+/* option system callback for getting backing track option */
+static const char* get_backing_track(metro_t* metro,
+                                     int n _U_, char** option_name _U_)
+{
+  return metro->backing_track;
+}
+
+/* option system callback for initializing backing track option */
+static int new_backing_track(metro_t* metro) {
+  metro->backing_track = strdup("");
+  return 0;
+}
+
+/* option system callback for destroying backing track option */
+static void delete_backing_track(metro_t* metro) {
+  if (metro->backing_track) {
+    free(metro->backing_track);
+    metro->backing_track = NULL;
+  }
+}
+
+/*
+ * option system callback for the control socket: path, "<default>":
+ * $XDG_RUNTIME_DIR/gtick.sock, "": none
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_control_socket(metro_t* metro, const char* option_name _U_,
+                              const char* path)
+{
+  if (!metro || !path)
+    return -1;
+
+  if (metro->control) {
+    control_delete(metro->control);
+    metro->control = NULL;
+  }
+  if (*path)
+    metro->control = control_new(strcmp(path, DEFAULT_CONTROL_SOCKET) ?
+                                 path : NULL, metro->inter_thread_comm);
+
+  if (metro->control_socket)
+    free(metro->control_socket);
+  metro->control_socket = strdup(path);
+  profiles_export(metro);
+
+  return 0;
+}
+
+/* option system callback for getting control socket option */
+static const char* get_control_socket(metro_t* metro,
+                                      int n _U_, char** option_name _U_)
+{
+  return metro->control_socket;
+}
+
+/* option system callback for initializing control socket option */
+static int new_control_socket(metro_t* metro) {
+  return set_control_socket(metro, NULL, DEFAULT_CONTROL_SOCKET);
+}
+
+/* option system callback for destroying control socket option */
+static void delete_control_socket(metro_t* metro) {
+  if (metro->control_socket) {
+    free(metro->control_socket);
+    metro->control_socket = NULL;
+  }
+}
+
 /* option system callback for initializing command for metronome start */
 static int new_command_on_start(options_t* options) {
   if ((options->command_on_start = strdup(DEFAULT_COMMAND_ON_START)))
@@ -1272,6 +2198,7 @@ static gpointer audio_loop(metro_t* metro) {
   dsp_t* dsp;
 
   dsp = dsp_new(metro->inter_thread_comm);
+  dsp->debug = debug;
   dsp_main_loop(dsp);
   dsp_delete(dsp);
 
@@ -1809,6 +2736,26 @@ metro_t* metro_new(void) {
                    G_CALLBACK(set_meter_cb),
 		   metro);
 
+  hbox = gtk_hbox_new (FALSE, 12);
+  gtk_box_pack_start(GTK_BOX (beatvbox), hbox, FALSE, TRUE, 0);
+  gtk_widget_show (hbox);
+
+  label = gtk_label_new(_("Sub beats per tick:"));
+  gtk_box_pack_start(GTK_BOX(hbox), label, FALSE, TRUE, 0);
+  gtk_widget_show(label);
+
+  adjustment = gtk_adjustment_new(DEFAULT_SUBBEATS, 1, DSP_MAX_SUBDIVISION,
+                                  1, 4, 0);
+  metro->subbeats_spin_button =
+    gtk_spin_button_new(GTK_ADJUSTMENT(adjustment), 1, 0);
+  gtk_widget_show(metro->subbeats_spin_button);
+  gtk_box_pack_start(GTK_BOX(hbox), metro->subbeats_spin_button,
+      FALSE, TRUE, 0);
+  g_signal_connect_swapped(G_OBJECT(metro->subbeats_spin_button),
+                           "value-changed",
+                           G_CALLBACK(set_subbeats_cb),
+                           metro);
+
   /* Accent table */
   metro->accentframe = gtk_frame_new(_("Beat Accent"));
   gtk_frame_set_shadow_type(GTK_FRAME(metro->accentframe), GTK_SHADOW_NONE);
@@ -1874,6 +2821,119 @@ metro_t* metro_new(void) {
 		  (option_get_t) get_accents,
 		  (void*) metro);
 
+  option_register(&metro->options->option_list,
+                  "SubBeats",
+		  (option_new_t) new_subbeats,
+		  (option_delete_t) delete_subbeats,
+		  (option_set_t) set_subbeats,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_subbeats,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "SubBeatVolume",
+		  (option_new_t) new_subbeat_volume,
+		  (option_delete_t) delete_subbeat_volume,
+		  (option_set_t) set_subbeat_volume,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_subbeat_volume,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "Layers",
+		  (option_new_t) new_layers,
+		  (option_delete_t) delete_layers,
+		  (option_set_t) set_layers,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_layers,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "Ramp",
+		  (option_new_t) new_ramp,
+		  (option_delete_t) delete_ramp,
+		  (option_set_t) set_ramp,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_ramp,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "Setlist",
+		  (option_new_t) new_setlist,
+		  (option_delete_t) delete_setlist,
+		  (option_set_t) set_setlist,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_setlist,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "MidiClock",
+		  (option_new_t) new_midiclock,
+		  (option_delete_t) delete_midiclock,
+		  (option_set_t) set_midiclock,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_midiclock,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "MidiClockIn",
+		  (option_new_t) new_midiclockin,
+		  (option_delete_t) delete_midiclockin,
+		  (option_set_t) set_midiclockin,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_midiclockin,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "NetSync",
+		  (option_new_t) new_netsync,
+		  (option_delete_t) delete_netsync,
+		  (option_set_t) set_netsync,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_netsync,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "BeatExport",
+		  (option_new_t) new_beat_export,
+		  (option_delete_t) delete_beat_export,
+		  (option_set_t) set_beat_export,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_beat_export,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "ChannelMap",
+		  (option_new_t) new_channel_map,
+		  (option_delete_t) delete_channel_map,
+		  (option_set_t) set_channel_map,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_channel_map,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "Sinks",
+		  (option_new_t) new_sinks,
+		  (option_delete_t) delete_sinks,
+		  (option_set_t) set_sinks,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_sinks,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "BackingTrack",
+		  (option_new_t) new_backing_track,
+		  (option_delete_t) delete_backing_track,
+		  (option_set_t) set_backing_track,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_backing_track,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "HttpServer",
+		  (option_new_t) new_http_server,
+		  (option_delete_t) delete_http_server,
+		  (option_set_t) set_http_server,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_http_server,
+		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "ControlSocket",
+		  (option_new_t) new_control_socket,
+		  (option_delete_t) delete_control_socket,
+		  (option_set_t) set_control_socket,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_control_socket,
+		  (void*) metro);
+
   /* Profiles */
   metro->profileframe = profiles_new(metro);
   gtk_box_pack_start(GTK_BOX(vbox), metro->profileframe, FALSE, TRUE, 0);
@@ -1993,6 +3053,10 @@ metro_t* metro_new(void) {
 }
 
 void metro_delete(metro_t* metro) {
+  if (metro->control)
+    control_delete(metro->control);
+  if (metro->httpd)
+    httpd_delete(metro->httpd);
   g_thread_join(metro->audio_thread);
   comm_delete(metro->inter_thread_comm);
   metro->inter_thread_comm = NULL;
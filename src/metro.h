@@ -37,8 +37,11 @@
 #include <glib.h>
 
 /* own headers */
+#include "dsp.h"
 #include "options.h"
 #include "threadtalk.h"
+#include "control.h"
+#include "httpd.h"
 
 typedef enum state_t {
   STATE_IDLE,     /* Metronome off */
@@ -80,6 +83,22 @@ typedef struct metro_t {
   GtkWidget* meter_button_4;
   GtkWidget* meter_button_more;
   GtkWidget* meter_spin_button;
+  GtkWidget* subbeats_spin_button;
+  double subbeat_volume;               /* relative to ticks, in percent */
+  char* layers;            /* pulse layers, see dsp_params_set_layers() */
+  char* ramp;              /* tempo ramp, see dsp_params_set_ramp() */
+  char* setlist;           /* timeline file, "": none */
+  char* midiclock;         /* MIDI clock output, see set_midiclock() */
+  char* midiclockin;       /* MIDI clock master followed, "": none */
+  char* netsync;           /* LAN beat sync, see netsync_new(), "": none */
+  char* beat_export;       /* shared memory object of beat position, "": none*/
+  char* http_server;       /* "[ADDRESS:]PORT" of HTTP server, "": none */
+  char* channel_map;       /* see dsp_channel_map_new(), "": none */
+  char* sinks;             /* further outputs, see fanout_new(), "": none */
+  char* backing_track;     /* see backing_new(), "": none */
+  httpd_t* httpd;          /* HTTP server, NULL: none */
+  char* control_socket;    /* path of control socket, "": none */
+  control_t* control;      /* control socket server, NULL: none */
 
   GtkWidget* togglebutton_label;
   GtkWidget* speed_name;               /* ComboBox */
@@ -97,6 +116,9 @@ typedef struct metro_t {
   GtkWidget* profileframe;             /* show / hide */
   GtkToggleAction* profiles_action;
   GtkTreeView* profiles_tree;
+  dsp_quantize_t profile_quantize;     /* when to switch to selected profile */
+
+  int params_batch; /* > 0: collect changes for one parameter block */
 
   GtkWidget* statusbar;
   guint status_context;
@@ -115,6 +137,10 @@ typedef struct metro_t {
 metro_t* metro_new(void);
 void metro_delete(metro_t* metro);
 int gui_get_meter(metro_t* metro);
+void metro_params_begin(metro_t* metro);
+void metro_params_end(metro_t* metro, dsp_quantize_t quantize);
+void metro_params_abort(metro_t* metro);
+int metro_render(metro_t* metro, const char* filename, double seconds);
 
 int set_meter(metro_t* metro, const char* option_name _U_, const char* meter);
 const char* get_meter(metro_t* metro, int n _U_, char** option_name _U_);
@@ -0,0 +1,397 @@
+/*
+ * midiclock.c: MIDI clock output and input via ALSA sequencer
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "midiclock.h"
+
+#ifdef WITH_ALSA
+
+/*
+ * returns new sequencer client with a port for sending (<input> == 0) or
+ * receiving MIDI clock, connected to <address> (e.g. "20:0" or
+ * "Midi Through", NULL or "": only subscribable by others)
+ *
+ * returns NULL on error
+ */
+static midiclock_t* open_port(const char* address, int input)
+{
+  midiclock_t* result;
+  snd_seq_addr_t peer;
+
+  result = (midiclock_t*) g_malloc0(sizeof(midiclock_t));
+  result->input = input;
+  result->note = -1;
+  result->queue = -1;
+
+  /* never block the audio thread */
+  if (snd_seq_open(&result->seq, "default", SND_SEQ_OPEN_DUPLEX,
+                   SND_SEQ_NONBLOCK) < 0)
+  {
+    fprintf(stderr, "Warning: Couldn't open ALSA sequencer.\n");
+    free(result);
+    return NULL;
+  }
+  snd_seq_set_client_name(result->seq, "GTick");
+
+  if (input)
+    result->port = snd_seq_create_simple_port(result->seq, "MIDI clock in",
+        SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE,
+        SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+  else
+    result->port = snd_seq_create_simple_port(result->seq, "MIDI clock",
+        SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ,
+        SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+
+  if (result->port < 0 ||
+      (address && *address &&
+       (snd_seq_parse_address(result->seq, &peer, address) < 0 ||
+        (input ? snd_seq_connect_from(result->seq, result->port,
+                                      peer.client, peer.port) :
+                 snd_seq_connect_to(result->seq, result->port,
+                                    peer.client, peer.port)) < 0)))
+  {
+    fprintf(stderr, "Warning: Couldn't connect MIDI clock %s \"%s\".\n",
+            input ? "from" : "to", address);
+    snd_seq_close(result->seq);
+    free(result);
+    return NULL;
+  }
+
+  return result;
+}
+
+/*
+ * returns new MIDI clock sender connected to <destination> (see
+ * open_port()), triggering <note> on each tick (-1: none)
+ *
+ * returns NULL on error
+ */
+midiclock_t* midiclock_new(const char* destination, int note)
+{
+  midiclock_t* result = open_port(destination, 0);
+
+  if (result)
+    result->note = note;
+  return result;
+}
+
+/*
+ * returns new MIDI clock receiver connected to <source> (see open_port()),
+ * NULL on error
+ */
+midiclock_t* midiclock_new_input(const char* source)
+{
+  return open_port(source, 1);
+}
+
+/*
+ * destroys MIDI clock sender or receiver, stopping it if necessary
+ */
+void midiclock_delete(midiclock_t* clock)
+{
+  midiclock_stop(clock);
+  snd_seq_close(clock->seq);
+  free(clock);
+}
+
+/*
+ * queues <event> for the time <frame> is heard
+ */
+static void schedule(midiclock_t* clock, snd_seq_event_t* event,
+                     long long frame)
+{
+  double time = clock->offset + (double) frame / clock->rate;
+  snd_seq_real_time_t real_time;
+
+  if (time < 0.0)
+    time = 0.0;
+  real_time.tv_sec = (unsigned int) time;
+  real_time.tv_nsec = (unsigned int) ((time - real_time.tv_sec) * 1e9);
+
+  snd_seq_ev_set_source(event, clock->port);
+  snd_seq_ev_set_subs(event);
+  snd_seq_ev_schedule_real(event, clock->queue, 0, &real_time);
+  snd_seq_event_output(clock->seq, event);
+}
+
+/*
+ * queues system realtime or common message <type> at <frame>
+ */
+static void send(midiclock_t* clock, snd_seq_event_type_t type,
+                 long long frame, int value)
+{
+  snd_seq_event_t event;
+
+  snd_seq_ev_clear(&event);
+  event.type = type;
+  event.data.control.value = value;
+  schedule(clock, &event, frame);
+}
+
+/*
+ * starts sequencer queue for playback at <rate> frames per second,
+ * START is sent with the first tick of a bar
+ */
+void midiclock_start(midiclock_t* clock, int rate)
+{
+  midiclock_stop(clock);
+
+  clock->rate = rate;
+  if ((clock->queue = snd_seq_alloc_named_queue(clock->seq, "GTick")) < 0) {
+    fprintf(stderr, "Warning: Couldn't allocate sequencer queue.\n");
+    clock->queue = -1;
+    return;
+  }
+  snd_seq_start_queue(clock->seq, clock->queue, NULL);
+  snd_seq_drain_output(clock->seq);
+
+  if (clock->input) { /* stamp arriving events with queue time */
+    snd_seq_port_info_t* info;
+
+    snd_seq_port_info_alloca(&info);
+    if (snd_seq_get_port_info(clock->seq, clock->port, info) == 0) {
+      snd_seq_port_info_set_timestamping(info, 1);
+      snd_seq_port_info_set_timestamp_real(info, 1);
+      snd_seq_port_info_set_timestamp_queue(info, clock->queue);
+      snd_seq_set_port_info(clock->seq, clock->port, info);
+    }
+  }
+}
+
+/*
+ * sends STOP immediately, dropping events not yet delivered
+ */
+void midiclock_stop(midiclock_t* clock)
+{
+  snd_seq_event_t event;
+
+  if (clock->queue == -1)
+    return;
+
+  snd_seq_drop_output(clock->seq);
+  snd_seq_free_queue(clock->seq, clock->queue); /* drops scheduled events */
+  clock->queue = -1;
+
+  if (clock->started) {
+    snd_seq_ev_clear(&event);
+    snd_seq_ev_set_source(&event, clock->port);
+    snd_seq_ev_set_subs(&event);
+    snd_seq_ev_set_direct(&event);
+    event.type = SND_SEQ_EVENT_STOP;
+    snd_seq_event_output(clock->seq, &event);
+    if (clock->note != -1) {
+      snd_seq_ev_set_noteoff(&event, MIDICLOCK_CHANNEL, clock->note, 0);
+      snd_seq_event_output(clock->seq, &event);
+    }
+    snd_seq_drain_output(clock->seq);
+  }
+  clock->started = 0;
+  clock->anchored = 0;
+}
+
+/*
+ * updates the mapping of frames to sequencer time: <frame> will be heard
+ * after <delay> seconds
+ *
+ * the first call sets the mapping, later ones only correct it slowly,
+ * so jitter of the measured delay doesn't show in the clock
+ */
+void midiclock_anchor(midiclock_t* clock, long long frame, double delay)
+{
+  snd_seq_queue_status_t* status;
+  const snd_seq_real_time_t* now;
+  double offset;
+
+  if (clock->queue == -1)
+    return;
+
+  snd_seq_queue_status_alloca(&status);
+  if (snd_seq_get_queue_status(clock->seq, clock->queue, status) < 0)
+    return;
+  now = snd_seq_queue_status_get_real_time(status);
+  offset = now->tv_sec + now->tv_nsec / 1e9 + delay -
+           (double) frame / clock->rate;
+
+  if (clock->anchored) {
+    clock->offset += (offset - clock->offset) / MIDICLOCK_SMOOTHING;
+  } else {
+    clock->offset = offset;
+    clock->anchored = 1;
+  }
+}
+
+/*
+ * queues tick number <beat> of bar (first clock pulse of the tick and
+ * beat note) at <frame>
+ */
+void midiclock_tick(midiclock_t* clock, long long frame, int beat)
+{
+  snd_seq_event_t event;
+
+  if (clock->queue == -1 || !clock->anchored)
+    return;
+
+  if (!clock->started) {
+    if (beat != 0)
+      return;
+    send(clock, SND_SEQ_EVENT_START, frame, 0);
+    clock->started = 1;
+  }
+  send(clock, SND_SEQ_EVENT_CLOCK, frame, 0);
+
+  if (clock->note != -1) {
+    snd_seq_ev_clear(&event);
+    snd_seq_ev_set_noteon(&event, MIDICLOCK_CHANNEL, clock->note,
+                          beat == 0 ? 127 : 100);
+    schedule(clock, &event, frame);
+    snd_seq_ev_clear(&event);
+    snd_seq_ev_set_noteoff(&event, MIDICLOCK_CHANNEL, clock->note, 0);
+    schedule(clock, &event,
+             frame + clock->rate * MIDICLOCK_NOTE_LENGTH / 1000);
+  }
+}
+
+/*
+ * queues clock pulse within a tick at <frame>
+ */
+void midiclock_pulse(midiclock_t* clock, long long frame)
+{
+  if (clock->queue != -1 && clock->started)
+    send(clock, SND_SEQ_EVENT_CLOCK, frame, 0);
+}
+
+/*
+ * queues jump to song position <sixteenths> at <frame> (STOP, Song Position
+ * Pointer, CONTINUE), e.g. on seeking in a timeline
+ */
+void midiclock_locate(midiclock_t* clock, long long frame, int sixteenths)
+{
+  if (clock->queue == -1 || !clock->anchored)
+    return;
+
+  if (clock->started)
+    send(clock, SND_SEQ_EVENT_STOP, frame, 0);
+  send(clock, SND_SEQ_EVENT_SONGPOS, frame, MIN(sixteenths, 0x3FFF));
+  send(clock, SND_SEQ_EVENT_CONTINUE, frame, 0);
+  clock->started = 1;
+}
+
+/*
+ * hands over the queued events to the sequencer
+ */
+void midiclock_flush(midiclock_t* clock)
+{
+  if (clock->queue != -1)
+    snd_seq_drain_output(clock->seq);
+}
+
+/*
+ * reads next message received by MIDI clock receiver into <input>
+ *
+ * returns 1 if a message was received, 0 otherwise (never blocks)
+ */
+int midiclock_receive(midiclock_t* clock, midiclock_input_t* input)
+{
+  snd_seq_event_t* event;
+
+  if (clock->queue == -1 || !clock->anchored)
+    return 0;
+
+  while (snd_seq_event_input(clock->seq, &event) >= 0) {
+    switch (event->type) {
+    case SND_SEQ_EVENT_CLOCK:
+      input->type = MIDICLOCK_CLOCK;
+      break;
+    case SND_SEQ_EVENT_START:
+      input->type = MIDICLOCK_START;
+      break;
+    case SND_SEQ_EVENT_CONTINUE:
+      input->type = MIDICLOCK_CONTINUE;
+      break;
+    case SND_SEQ_EVENT_STOP:
+      input->type = MIDICLOCK_STOP;
+      break;
+    case SND_SEQ_EVENT_SONGPOS:
+      input->type = MIDICLOCK_SONGPOS;
+      input->value = event->data.control.value;
+      break;
+    default:
+      continue;
+    }
+    input->frame = (event->time.time.tv_sec + event->time.time.tv_nsec / 1e9
+                    - clock->offset) * clock->rate;
+    return 1;
+  }
+
+  return 0;
+}
+
+#else /* WITH_ALSA */
+
+midiclock_t* midiclock_new(const char* destination _U_, int note _U_)
+{
+  fprintf(stderr, "Warning: MIDI clock not available (built without ALSA).\n");
+  return NULL;
+}
+
+midiclock_t* midiclock_new_input(const char* source _U_)
+{
+  return midiclock_new(NULL, -1);
+}
+
+void midiclock_delete(midiclock_t* clock)
+{
+  free(clock);
+}
+
+void midiclock_start(midiclock_t* clock _U_, int rate _U_) {}
+void midiclock_stop(midiclock_t* clock _U_) {}
+void midiclock_anchor(midiclock_t* clock _U_,
+                      long long frame _U_, double delay _U_) {}
+void midiclock_tick(midiclock_t* clock _U_, long long frame _U_, int beat _U_)
+{}
+void midiclock_pulse(midiclock_t* clock _U_, long long frame _U_) {}
+void midiclock_locate(midiclock_t* clock _U_,
+                      long long frame _U_, int sixteenths _U_) {}
+void midiclock_flush(midiclock_t* clock _U_) {}
+int midiclock_receive(midiclock_t* clock _U_, midiclock_input_t* input _U_)
+{
+  return 0;
+}
+
+#endif /* WITH_ALSA */
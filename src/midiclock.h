@@ -0,0 +1,96 @@
+/*
+ * MIDI clock output and input interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MIDICLOCK_H
+#define MIDICLOCK_H
+
+#ifdef WITH_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+/* MIDI clock pulses per quarter note (a tick, see timeline_section_t.unit) */
+#define MIDICLOCK_PPQN 24
+
+/* MIDI channel of beat notes (counted from 0: drums) */
+#define MIDICLOCK_CHANNEL 9
+
+/* length of beat notes in milliseconds */
+#define MIDICLOCK_NOTE_LENGTH 10
+
+/*
+ * number of fragments over which the mapping of frames to sequencer time
+ * follows changes of the output delay (e.g. clock drift of sound card)
+ */
+#define MIDICLOCK_SMOOTHING 32
+
+/*
+ * MIDI clock sender or receiver: events are given with the number of the
+ * audio frame they belong to, sent events are scheduled on a sequencer queue
+ * for the time that frame is heard
+ */
+typedef struct midiclock_t {
+#ifdef WITH_ALSA
+  snd_seq_t* seq;
+  int port;
+  int queue;         /* -1: stopped */
+#endif
+  int input;         /* 1: receiving, 0: sending */
+  int note;          /* note triggered on each tick, -1: none */
+  int rate;          /* frames per second */
+  double offset;     /* sequencer time of frame 0 in seconds */
+  int anchored;      /* offset known */
+  int started;       /* START sent */
+} midiclock_t;
+
+/*
+ * received MIDI clock message
+ */
+typedef enum midiclock_message_t {
+  MIDICLOCK_NONE,
+  MIDICLOCK_CLOCK,
+  MIDICLOCK_START,
+  MIDICLOCK_CONTINUE,
+  MIDICLOCK_STOP,
+  MIDICLOCK_SONGPOS    /* value: song position in sixteenths */
+} midiclock_message_t;
+
+typedef struct midiclock_input_t {
+  midiclock_message_t type;
+  double frame;      /* audio frame heard at time of arrival */
+  int value;
+} midiclock_input_t;
+
+midiclock_t* midiclock_new(const char* destination, int note);
+midiclock_t* midiclock_new_input(const char* source);
+void midiclock_delete(midiclock_t* clock);
+
+void midiclock_start(midiclock_t* clock, int rate);
+void midiclock_stop(midiclock_t* clock);
+void midiclock_anchor(midiclock_t* clock, long long frame, double delay);
+void midiclock_tick(midiclock_t* clock, long long frame, int beat);
+void midiclock_pulse(midiclock_t* clock, long long frame);
+void midiclock_locate(midiclock_t* clock, long long frame, int sixteenths);
+void midiclock_flush(midiclock_t* clock);
+int midiclock_receive(midiclock_t* clock, midiclock_input_t* input);
+
+#endif /* MIDICLOCK_H */
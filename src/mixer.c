@@ -0,0 +1,341 @@
+/*
+ * mixer.c: accumulation of voices and conversion to 16 bit output
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <limits.h>
+#include <math.h>
+
+/* SIMD intrinsics, scalar code is used for the rest of the buffers and
+ * on other platforms */
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "mixer.h"
+
+/*
+ * returns <x> saturated to the range of a 16 bit signed sample
+ */
+short mixer_saturate(int x)
+{
+  return CLAMP(x, SHRT_MIN, SHRT_MAX);
+}
+
+/*
+ * returns x if x < limit, else (limit - 1); thus it returns an exclusively
+ * limited value
+ */
+static int limit_int(int x, int limit) {
+  if (x < limit)
+    return x;
+  else
+    return limit - 1;
+}
+
+/*
+ * resamples with floating point arithmetic, see mixer_resample()
+ */
+static int resample_float(const short* from, int from_size, int from_rate,
+                          int from_channels, int rate, short** to)
+{
+  double speed_factor = (double) from_rate / rate; /* output to input */
+  int result_size = (long long)from_size * rate / from_rate; /* number of frames */
+  short* result;
+  int i, j;
+
+  result = (short*) g_malloc(result_size * sizeof(short));
+
+  for (i = 0; i < result_size; i++) { /* for each output frame */
+    double mixdown = 0.0;
+    double leftbound = i * speed_factor;
+    double rightbound = (i + 1) * speed_factor;
+
+    while (leftbound < rightbound) {
+      int index = (int)leftbound;
+      double dummy;
+      double frac = modf(leftbound, &dummy);
+      double weight;
+
+      if (rightbound - leftbound < 1)
+	weight = rightbound - leftbound;
+      else
+	weight = 1.0;
+
+      for (j = 0; j < from_channels; j++) {
+	mixdown += weight * (
+	    (1.0 - frac) * from[from_channels * index + j] +
+	    frac * from[from_channels * limit_int(index + 1, from_size) + j]);
+      }
+
+      leftbound += 1.0;
+    }
+    mixdown /= (speed_factor * from_channels);
+
+    result[i] = mixer_saturate((int) mixdown);
+  }
+
+  *to = result;
+  return result_size;
+}
+
+/*
+ * resamples as resample_float(), in integer arithmetic only: positions are
+ * counted in units of 1 / <rate> of an input frame, so weights and
+ * interpolation factors are exact and the result is the same on every
+ * architecture
+ */
+static int resample_fixed(const short* from, int from_size, int from_rate,
+                          int from_channels, int rate, short** to)
+{
+  gint64 divisor = (gint64) rate * from_rate * from_channels;
+  int result_size = (long long)from_size * rate / from_rate; /* number of frames */
+  short* result;
+  int i, j;
+
+  result = (short*) g_malloc(result_size * sizeof(short));
+
+  for (i = 0; i < result_size; i++) { /* for each output frame */
+    gint64 mixdown = 0;
+    gint64 leftbound = (gint64) i * from_rate;
+    gint64 rightbound = leftbound + from_rate;
+
+    while (leftbound < rightbound) {
+      int index = leftbound / rate;
+      gint64 frac = leftbound % rate;
+      gint64 weight = MIN(rightbound - leftbound, rate);
+
+      for (j = 0; j < from_channels; j++) {
+	mixdown += weight * (
+	    (rate - frac) * from[from_channels * index + j] +
+	    frac * from[from_channels * limit_int(index + 1, from_size) + j]);
+      }
+
+      leftbound += rate;
+    }
+
+    result[i] = mixer_saturate(mixdown / divisor);
+  }
+
+  *to = result;
+  return result_size;
+}
+
+/*
+ * resamples sound data to a rate for playback
+ *
+ * input:
+ *     from:          the sample data source in signed 16 bit format
+ *     from_size:     number of frames in <from>
+ *     from_rate:     the rate of <from>
+ *     from_channels: number of channels in <from>
+ *     rate:          the rate of the output (e.g. of the device)
+ *     fixed_point:   integer only arithmetic (e.g. for processors without
+ *                    FPU) if != 0, floating point otherwise
+ *
+ * output:
+ *     to:            the pointer to the allocated mono frames (signed
+ *                    16 bit) at <rate>
+ *     return value:  number of frames generated, -1 on error
+ *
+ * NOTES:
+ *  - The input is mixed down to 1 channel
+ *  - <to> will be allocated by mixer_resample, but has to be free()d by
+ *    caller
+ */
+int mixer_resample(const short* from, int from_size, int from_rate,
+                   int from_channels, int rate, short** to, int fixed_point)
+{
+  if (fixed_point)
+    return resample_fixed(from, from_size, from_rate, from_channels, rate, to);
+  return resample_float(from, from_size, from_rate, from_channels, rate, to);
+}
+
+/*
+ * returns fixed point gain for <factor> (0.0 ... 1.0)
+ */
+int mixer_gain(double factor)
+{
+  return CLAMP((int) (factor * MIXER_UNITY), 0, MIXER_UNITY);
+}
+
+/*
+ * adds <n> samples of <src>, scaled by fixed point <gain> (see mixer_gain()),
+ * to accumulator <dest>
+ */
+void mixer_add(int* dest, const short* src, int n, int gain)
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  /* src * gain as sum of two 16 bit products: src * gain_lo + src * gain_hi */
+  __m128i gains = _mm_set1_epi32((gain - gain / 2) << 16 | gain / 2);
+
+  for (; i + 8 <= n; i += 8) {
+    __m128i s = _mm_loadu_si128((const __m128i*) &src[i]);
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(s, s), gains);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(s, s), gains);
+    __m128i* d = (__m128i*) &dest[i];
+
+    _mm_storeu_si128(d, _mm_add_epi32(_mm_loadu_si128(d),
+                                      _mm_srai_epi32(lo, MIXER_GAIN_SHIFT)));
+    _mm_storeu_si128(d + 1, _mm_add_epi32(_mm_loadu_si128(d + 1),
+                                          _mm_srai_epi32(hi, MIXER_GAIN_SHIFT)));
+  }
+#endif /* __SSE2__ */
+
+  for (; i < n; i++)
+    dest[i] += (src[i] * gain) >> MIXER_GAIN_SHIFT;
+}
+
+/*
+ * writes <n> accumulated samples of <src> as 16 bit signed little endian
+ * samples to <dest>, clipping overloaded samples
+ */
+void mixer_encode_s16_le(unsigned char* dest, const int* src, int n)
+{
+  int i = 0;
+
+#ifdef __SSE2__
+  /* SSE2 is little endian: saturating pack yields the final samples */
+  for (; i + 8 <= n; i += 8) {
+    __m128i lo = _mm_loadu_si128((const __m128i*) &src[i]);
+    __m128i hi = _mm_loadu_si128((const __m128i*) &src[i + 4]);
+
+    _mm_storeu_si128((__m128i*) &dest[i * 2], _mm_packs_epi32(lo, hi));
+  }
+#endif /* __SSE2__ */
+
+  for (; i < n; i++) {
+    short sample = mixer_saturate(src[i]);
+
+    dest[i * 2] = (unsigned char) (sample & 0xff);
+    dest[i * 2 + 1] = (unsigned char) (sample >> 8 & 0xff);
+  }
+}
+
+/*
+ * writes <n> accumulated samples of <src> as 16 bit signed big endian
+ * samples to <dest>, clipping overloaded samples
+ */
+void mixer_encode_s16_be(unsigned char* dest, const int* src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    short sample = mixer_saturate(src[i]);
+
+    dest[i * 2] = (unsigned char) (sample >> 8 & 0xff);
+    dest[i * 2 + 1] = (unsigned char) (sample & 0xff);
+  }
+}
+
+/*
+ * writes <n> accumulated samples of <src> as signed little endian samples of
+ * <bits> (32, or 24 in the lower bits) in 32 bit words to <dest>, clipping
+ * overloaded samples as in 16 bit
+ */
+void mixer_encode_s32_le(unsigned char* dest, const int* src, int n, int bits)
+{
+  int shift = bits - 16;
+  int i;
+
+  for (i = 0; i < n; i++) {
+    unsigned int sample = (unsigned int) mixer_saturate(src[i]) << shift;
+
+    dest[i * 4] = (unsigned char) (sample & 0xff);
+    dest[i * 4 + 1] = (unsigned char) (sample >> 8 & 0xff);
+    dest[i * 4 + 2] = (unsigned char) (sample >> 16 & 0xff);
+    dest[i * 4 + 3] = (unsigned char) (sample >> 24 & 0xff);
+  }
+}
+
+/*
+ * writes <n> accumulated samples of <src> as signed big endian samples of
+ * <bits> (32, or 24 in the lower bits) in 32 bit words to <dest>, clipping
+ * overloaded samples as in 16 bit
+ */
+void mixer_encode_s32_be(unsigned char* dest, const int* src, int n, int bits)
+{
+  int shift = bits - 16;
+  int i;
+
+  for (i = 0; i < n; i++) {
+    unsigned int sample = (unsigned int) mixer_saturate(src[i]) << shift;
+
+    dest[i * 4] = (unsigned char) (sample >> 24 & 0xff);
+    dest[i * 4 + 1] = (unsigned char) (sample >> 16 & 0xff);
+    dest[i * 4 + 2] = (unsigned char) (sample >> 8 & 0xff);
+    dest[i * 4 + 3] = (unsigned char) (sample & 0xff);
+  }
+}
+
+/*
+ * writes <n> accumulated samples of <src> as floating point samples
+ * (-1.0 ... 1.0) to <dest>, clipping overloaded samples
+ */
+void mixer_encode_float(float* dest, const int* src, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    dest[i] = mixer_saturate(src[i]) * (1.0f / 32768.0f);
+}
+
+/*
+ * adds <frames> mono samples of accumulator <src> to <channel> of
+ * accumulator <dest> with <channels> interleaved channels
+ */
+void mixer_route(int* dest, int channels, int channel, const int* src,
+                 int frames)
+{
+  int i;
+
+  dest += channel;
+  for (i = 0; i < frames; i++)
+    dest[i * channels] += src[i];
+}
+
+/*
+ * writes <frames> of mono accumulators <src> (one for each of <channels>)
+ * interleaved to <dest>
+ */
+void mixer_interleave(int* dest, const int* const* src, int channels,
+                      int frames)
+{
+  int i, c;
+
+  for (i = 0; i < frames; i++) {
+    for (c = 0; c < channels; c++)
+      *dest++ = src[c][i];
+  }
+}
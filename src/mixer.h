@@ -0,0 +1,57 @@
+/*
+ * Mixer interface: accumulation of voices and conversion to 16 bit output
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MIXER_H
+#define MIXER_H
+
+/* fixed point gain: MIXER_UNITY is a factor of 1.0, also the maximum */
+#define MIXER_GAIN_SHIFT 15
+#define MIXER_UNITY (1 << MIXER_GAIN_SHIFT)
+
+/*
+ * default arithmetic of sound preparation (mixer_resample(), synth_render()):
+ * integer only if configured with --enable-fixed-point
+ */
+#ifdef FIXED_POINT
+#define MIXER_FIXED_POINT 1
+#else
+#define MIXER_FIXED_POINT 0
+#endif
+
+short mixer_saturate(int x);
+int mixer_gain(double factor);
+int mixer_resample(const short* from, int from_size, int from_rate,
+                   int from_channels, int rate, short** to, int fixed_point);
+
+void mixer_add(int* dest, const short* src, int n, int gain);
+void mixer_encode_s16_le(unsigned char* dest, const int* src, int n);
+void mixer_encode_s16_be(unsigned char* dest, const int* src, int n);
+void mixer_encode_s32_le(unsigned char* dest, const int* src, int n, int bits);
+void mixer_encode_s32_be(unsigned char* dest, const int* src, int n, int bits);
+void mixer_encode_float(float* dest, const int* src, int n);
+void mixer_route(int* dest, int channels, int channel, const int* src,
+                 int frames);
+void mixer_interleave(int* dest, const int* const* src, int channels,
+                      int frames);
+
+#endif /* MIXER_H */
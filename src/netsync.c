@@ -0,0 +1,434 @@
+/*
+ * netsync.c: LAN beat synchronization via UDP multicast
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "netsync.h"
+
+/*
+ * packets: magic, type, version, 2 reserved bytes, sender id, then
+ *
+ *   BEAT:  sequence, time, length, meter (16 bit), beat (16 bit)
+ *   PING:  t1
+ *   REPLY: id of pinging follower, t1, t2, t3
+ *
+ * in network byte order, times in nanoseconds of the sender's clock
+ * (REPLY: t1 of follower, t2 / t3 of leader)
+ */
+#define MAGIC "GTik"
+#define PROTOCOL_VERSION 1
+#define TYPE_BEAT  'B'
+#define TYPE_PING  'P'
+#define TYPE_REPLY 'R'
+#define HEADER_SIZE 12
+#define MAX_PACKET_SIZE 64
+
+static void put32(unsigned char* p, unsigned int x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+static unsigned int get32(const unsigned char* p)
+{
+  return (unsigned int) p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+/* writes <seconds> as 64 bit nanoseconds */
+static void put_time(unsigned char* p, double seconds)
+{
+  long long ns = llrint(seconds * 1e9);
+
+  put32(p, (unsigned long long) ns >> 32);
+  put32(p + 4, ns);
+}
+
+static double get_time(const unsigned char* p)
+{
+  return (long long) ((unsigned long long) get32(p) << 32 | get32(p + 4))
+         / 1e9;
+}
+
+/*
+ * returns local time of CLOCK_REALTIME <stamp> (kernel time stamp of
+ * received packet)
+ */
+static double from_realtime(netsync_t* sync, const struct timespec* stamp)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  return netsync_time(sync) -
+         (now.tv_sec - stamp->tv_sec) - (now.tv_nsec - stamp->tv_nsec) / 1e9;
+}
+
+/*
+ * returns monotonic local time in seconds
+ */
+double netsync_time(netsync_t* sync)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9 + sync->skew;
+}
+
+/*
+ * returns new beat sync instance for <spec>:
+ * "ROLE[,GROUP[:PORT][,INTERFACE]]" with ROLE "leader" or "follower",
+ * e.g. "follower,239.255.71.84:7171,192.168.0.2"
+ *
+ * returns NULL on error
+ */
+netsync_t* netsync_new(const char* spec)
+{
+  netsync_t* result;
+  struct ip_mreq request;
+  struct in_addr interface;
+  char* role = strdup(spec);
+  char* group;
+  char* port = NULL;
+  char* address = NULL;
+  unsigned char loop = 1;
+  int on = 1;
+
+  interface.s_addr = htonl(INADDR_ANY);
+  group = strchr(role, ',');
+  if (group) {
+    *group++ = '\0';
+    if ((address = strchr(group, ',')))
+      *address++ = '\0';
+    if ((port = strchr(group, ':')))
+      *port++ = '\0';
+  }
+
+  result = (netsync_t*) g_malloc0(sizeof(netsync_t));
+  result->fd = -1;
+  result->leader = !strcmp(role, "leader");
+  result->id = ((unsigned int) getpid() << 16 ^ (unsigned int) time(NULL) ^
+                (unsigned int) lrint(fmod(netsync_time(result), 1.0) * 1e9))
+               | 1;
+  result->group.sin_family = AF_INET;
+  result->group.sin_port =
+    htons(group && port ? atoi(port) : NETSYNC_PORT);
+
+  if ((!result->leader && strcmp(role, "follower")) ||
+      !inet_aton(group && *group ? group : NETSYNC_GROUP,
+                 &result->group.sin_addr) ||
+      !IN_MULTICAST(ntohl(result->group.sin_addr.s_addr)) ||
+      (address && !inet_aton(address, &interface)))
+  {
+    fprintf(stderr, "Warning: Bad beat sync specification \"%s\".\n", spec);
+    free(role);
+    free(result);
+    return NULL;
+  }
+  free(role);
+
+  request.imr_multiaddr = result->group.sin_addr;
+  request.imr_interface = interface;
+  if ((result->fd = socket(AF_INET, SOCK_DGRAM, 0)) == -1 ||
+      setsockopt(result->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) ||
+      setsockopt(result->fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) ||
+      bind(result->fd, (struct sockaddr*) &result->group,
+           sizeof(result->group)) ||
+      setsockopt(result->fd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                 &request, sizeof(request)) ||
+      setsockopt(result->fd, IPPROTO_IP, IP_MULTICAST_IF,
+                 &interface, sizeof(interface)) ||
+      setsockopt(result->fd, IPPROTO_IP, IP_MULTICAST_LOOP,
+                 &loop, sizeof(loop)) ||
+      fcntl(result->fd, F_SETFL, O_NONBLOCK) == -1)
+  {
+    perror("Warning: Couldn't set up beat sync socket");
+    if (result->fd != -1)
+      close(result->fd);
+    free(result);
+    return NULL;
+  }
+
+  return result;
+}
+
+/*
+ * destroys beat sync instance
+ */
+void netsync_delete(netsync_t* sync)
+{
+  close(sync->fd);
+  free(sync);
+}
+
+/*
+ * prepares mapping of frames to local time for playback at <rate> frames
+ * per second
+ */
+void netsync_start(netsync_t* sync, int rate)
+{
+  sync->rate = rate;
+  sync->anchored = 0;
+}
+
+/*
+ * updates the mapping of frames to local time: <frame> will be heard
+ * after <delay> seconds (smoothed like midiclock_anchor())
+ */
+void netsync_anchor(netsync_t* sync, long long frame, double delay)
+{
+  double offset = netsync_time(sync) + delay - (double) frame / sync->rate;
+
+  if (sync->anchored) {
+    sync->offset += (offset - sync->offset) / NETSYNC_SMOOTHING;
+  } else {
+    sync->offset = offset;
+    sync->anchored = 1;
+  }
+}
+
+/*
+ * writes packet header of <type> to <packet>
+ */
+static void put_header(netsync_t* sync, unsigned char* packet, int type)
+{
+  memcpy(packet, MAGIC, 4);
+  packet[4] = type;
+  packet[5] = PROTOCOL_VERSION;
+  packet[6] = packet[7] = 0;
+  put32(packet + 8, sync->id);
+}
+
+static void send_packet(netsync_t* sync, unsigned char* packet, int size)
+{
+  sendto(sync->fd, packet, size, 0, (struct sockaddr*) &sync->group,
+         sizeof(sync->group));
+}
+
+/*
+ * leader: announces tick number <beat> of bar with <meter> ticks, starting
+ * at <frame> and lasting <length> seconds
+ */
+void netsync_publish(netsync_t* sync, long long frame, double length,
+                     int meter, int beat)
+{
+  unsigned char packet[MAX_PACKET_SIZE];
+
+  if (!sync->leader || !sync->anchored)
+    return;
+
+  put_header(sync, packet, TYPE_BEAT);
+  put32(packet + 12, ++sync->sequence);
+  put_time(packet + 16, sync->offset + (double) frame / sync->rate);
+  put_time(packet + 24, length);
+  packet[32] = meter >> 8;
+  packet[33] = meter;
+  packet[34] = beat >> 8;
+  packet[35] = beat;
+  send_packet(sync, packet, 36);
+}
+
+/*
+ * follower: takes offset measurement, keeping the one with the shortest
+ * round trip of the last NETSYNC_FILTER (least disturbed by queueing)
+ */
+static void add_sample(netsync_t* sync, double offset, double delay)
+{
+  double sum = 0.0;
+  int best = 0;
+  int i;
+
+  if (delay < 0.0)
+    return;
+
+  if (sync->n_samples == NETSYNC_FILTER) {
+    memmove(sync->samples[0], sync->samples[1],
+            (NETSYNC_FILTER - 1) * sizeof(sync->samples[0]));
+    sync->n_samples--;
+  }
+  sync->samples[sync->n_samples][0] = offset;
+  sync->samples[sync->n_samples][1] = delay;
+  sync->n_samples++;
+
+  for (i = 1; i < sync->n_samples; i++)
+    if (sync->samples[i][1] < sync->samples[best][1])
+      best = i;
+  sync->clock_offset = sync->samples[best][0];
+  sync->delay = sync->samples[best][1];
+
+  for (i = 0; i < sync->n_samples; i++)
+    sum += (sync->samples[i][0] - sync->clock_offset) *
+           (sync->samples[i][0] - sync->clock_offset);
+  sync->jitter = sqrt(sum / sync->n_samples);
+}
+
+/*
+ * handles received <packet> of <size> bytes, arrived at local time <arrival>
+ */
+static void receive(netsync_t* sync, const unsigned char* packet, int size,
+                    double arrival)
+{
+  unsigned char reply[MAX_PACKET_SIZE];
+  unsigned int sender;
+
+  if (size < HEADER_SIZE || memcmp(packet, MAGIC, 4) ||
+      packet[5] != PROTOCOL_VERSION || (sender = get32(packet + 8)) == sync->id)
+    return;
+
+  switch (packet[4]) {
+  case TYPE_PING: /* t1, answered with t2 = arrival, t3 = now */
+    if (sync->leader && size >= 20) {
+      put_header(sync, reply, TYPE_REPLY);
+      put32(reply + 12, sender);
+      memcpy(reply + 16, packet + 12, 8);
+      put_time(reply + 24, arrival);
+      put_time(reply + 32, netsync_time(sync));
+      send_packet(sync, reply, 40);
+    }
+    break;
+  case TYPE_BEAT:
+    if (sync->leader || size < 36)
+      break;
+    if (sync->master != sender) { /* new leader */
+      if (sync->master && arrival - sync->arrival < NETSYNC_TIMEOUT)
+        break; /* keep the current one */
+      sync->master = sender;
+      sync->n_samples = 0;
+      sync->last_ping = 0.0;
+    }
+    sync->sequence = get32(packet + 12);
+    sync->beat_time = get_time(packet + 16);
+    sync->length = get_time(packet + 24);
+    sync->meter = packet[32] << 8 | packet[33];
+    sync->beat = packet[34] << 8 | packet[35];
+    sync->arrival = arrival;
+    break;
+  case TYPE_REPLY: /* offset = ((t2 - t1) + (t3 - t4)) / 2 */
+    if (!sync->leader && size >= 40 && sender == sync->master &&
+        get32(packet + 12) == sync->id)
+    {
+      double t1 = get_time(packet + 16);
+      double t2 = get_time(packet + 24);
+      double t3 = get_time(packet + 32);
+
+      add_sample(sync, ((t2 - t1) + (t3 - arrival)) / 2,
+                 (arrival - t1) - (t3 - t2));
+    }
+    break;
+  }
+}
+
+/*
+ * handles all packets received so far and sends offset measurements when
+ * due (never blocks)
+ */
+void netsync_poll(netsync_t* sync)
+{
+  unsigned char packet[MAX_PACKET_SIZE];
+  char control[CMSG_SPACE(sizeof(struct timespec))];
+  struct iovec iov;
+  struct msghdr message;
+  struct cmsghdr* cmsg;
+  double arrival;
+  double now;
+  int size;
+
+  for (;;) {
+    iov.iov_base = packet;
+    iov.iov_len = sizeof(packet);
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    if ((size = recvmsg(sync->fd, &message, 0)) < 0)
+      break;
+
+    arrival = netsync_time(sync);
+    for (cmsg = CMSG_FIRSTHDR(&message); cmsg;
+         cmsg = CMSG_NXTHDR(&message, cmsg))
+    {
+      if (cmsg->cmsg_level == SOL_SOCKET &&
+          cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        arrival = from_realtime(sync, (struct timespec*) CMSG_DATA(cmsg));
+    }
+    receive(sync, packet, size, arrival);
+  }
+
+  now = netsync_time(sync);
+  if (!sync->leader && sync->master &&
+      now - sync->last_ping >= NETSYNC_PING_INTERVAL)
+  {
+    put_header(sync, packet, TYPE_PING);
+    put_time(packet + 12, netsync_time(sync));
+    send_packet(sync, packet, 20);
+    sync->last_ping = now;
+  }
+}
+
+/*
+ * follower: returns the frame at which a bar of the leader starts in
+ * <origin>, the length of its ticks in frames in <length> and its <meter>
+ *
+ * returns 1 if the leader is followed, 0 otherwise
+ */
+int netsync_follow(netsync_t* sync, double* origin, double* length,
+                   int* meter)
+{
+  if (sync->leader || !sync->master || !sync->n_samples || !sync->anchored ||
+      netsync_time(sync) - sync->arrival > NETSYNC_TIMEOUT ||
+      sync->length <= 0.0)
+  {
+    return 0;
+  }
+
+  *origin = (sync->beat_time - sync->clock_offset - sync->beat * sync->length
+             - sync->offset) * sync->rate;
+  *length = sync->length * sync->rate;
+  *meter = sync->meter;
+
+  return 1;
+}
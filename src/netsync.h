@@ -0,0 +1,97 @@
+/*
+ * LAN beat synchronization interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NETSYNC_H
+#define NETSYNC_H
+
+#include <netinet/in.h>
+
+/* default multicast group and UDP port */
+#define NETSYNC_GROUP "239.255.71.84"
+#define NETSYNC_PORT 7171
+
+/* seconds between clock offset measurements of a follower */
+#define NETSYNC_PING_INTERVAL 0.2
+
+/* number of offset measurements from which the best one is taken */
+#define NETSYNC_FILTER 8
+
+/* seconds without beat after which the leader is considered gone */
+#define NETSYNC_TIMEOUT 2.0
+
+/*
+ * number of fragments over which the mapping of frames to local time
+ * follows changes of the output delay
+ */
+#define NETSYNC_SMOOTHING 32
+
+/*
+ * instance of the beat sync protocol: the leader publishes each tick with
+ * the (monotonic) time it is heard, followers measure the offset of the
+ * leader's clock NTP-style and convert the ticks to their own frames
+ *
+ * all packets are multicast, so any number of instances can share one host
+ */
+typedef struct netsync_t {
+  int fd;
+  int leader;              /* 1: publishing beats, 0: following */
+  unsigned int id;         /* sender id of this instance in packets */
+  struct sockaddr_in group;
+
+  int rate;                /* frames per second */
+  double offset;           /* local time of frame 0 in seconds */
+  int anchored;            /* offset known */
+  double skew;             /* added to local clock (tests on one host) */
+
+  unsigned int sequence;   /* number of last beat sent or received */
+
+  /* follower: clock of leader */
+  unsigned int master;     /* sender id of leader followed, 0: none */
+  double last_ping;        /* local time of last offset measurement */
+  double samples[NETSYNC_FILTER][2]; /* offset and round trip delay */
+  int n_samples;
+  double clock_offset;     /* leader time minus local time in seconds */
+  double delay;            /* round trip delay of best measurement */
+  double jitter;           /* RMS of measured offsets around clock_offset */
+
+  /* follower: last beat of leader */
+  double beat_time;        /* leader time at which beat is heard */
+  double length;           /* length of tick in seconds */
+  int meter;
+  int beat;                /* number of tick in bar */
+  double arrival;          /* local time of arrival */
+} netsync_t;
+
+netsync_t* netsync_new(const char* spec);
+void netsync_delete(netsync_t* sync);
+
+double netsync_time(netsync_t* sync);
+void netsync_start(netsync_t* sync, int rate);
+void netsync_anchor(netsync_t* sync, long long frame, double delay);
+void netsync_publish(netsync_t* sync, long long frame, double length,
+                     int meter, int beat);
+void netsync_poll(netsync_t* sync);
+int netsync_follow(netsync_t* sync, double* origin, double* length,
+                   int* meter);
+
+#endif /* NETSYNC_H */
@@ -0,0 +1,154 @@
+/*
+ * pll.c: phase-locked loop following an external pulse stream
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdlib.h>
+#include <math.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "pll.h"
+
+/*
+ * returns new phase-locked loop, waiting for its first pulse
+ */
+pll_t* pll_new(void)
+{
+  pll_t* result;
+
+  result = (pll_t*) g_malloc0(sizeof(pll_t));
+  result->count = -1;
+
+  return result;
+}
+
+/*
+ * destroys phase-locked loop
+ */
+void pll_delete(pll_t* pll)
+{
+  free(pll);
+}
+
+/*
+ * loses lock: the next pulse starts a new acquisition
+ */
+void pll_reset(pll_t* pll)
+{
+  pll->pulses = 0;
+  pll->period = 0.0;
+  pll->phase_error = 0.0;
+  pll->jitter = 0.0;
+}
+
+/*
+ * makes <next> the number of the next pulse (e.g. on MIDI START), keeping
+ * the lock
+ */
+void pll_renumber(pll_t* pll, long next)
+{
+  pll->count = next - 1;
+}
+
+/*
+ * takes pulse received at <time>
+ *
+ * the first pulses are fitted exactly (least squares), later ones only
+ * correct phase and period by PLL_ALPHA and PLL_BETA of their deviation
+ * from the prediction (alpha-beta filter); missing pulses are skipped
+ */
+void pll_input(pll_t* pll, double time)
+{
+  double error;
+  double alpha, beta;
+  long k;
+
+  pll->count++;
+
+  if (pll->pulses > 0 && pll->period == 0.0) {
+    if (time > pll->last) {
+      pll->period = time - pll->last;
+      pll->last = time;
+      pll->pulses++;
+    }
+    return;
+  }
+
+  error = time - (pll->last + pll->period);
+  if (pll->pulses == 0 || error > PLL_DROPOUT * pll->period ||
+      error < -pll->period / 2)
+  { /* (re)acquisition */
+    pll_reset(pll);
+    pll->last = time;
+    pll->pulses = 1;
+    return;
+  }
+
+  if (error > pll->period / 2) { /* missing pulses */
+    k = lrint(error / pll->period);
+    pll->count += k;
+    pll->last += k * pll->period;
+    error -= k * pll->period;
+  }
+
+  pll->pulses++;
+  k = pll->pulses;
+  alpha = MAX(PLL_ALPHA, 2.0 * (2 * k - 1) / (k * (k + 1.0)));
+  beta = MAX(PLL_BETA, 6.0 / (k * (k + 1.0)));
+
+  pll->last += pll->period + alpha * error;
+  pll->period += beta * error;
+
+  pll->phase_error = error;
+  if (pll->pulses == 3)
+    pll->jitter = fabs(error);
+  else
+    pll->jitter = sqrt((1.0 - PLL_JITTER_WEIGHT) * pll->jitter * pll->jitter +
+                       PLL_JITTER_WEIGHT * error * error);
+}
+
+/*
+ * returns the expected time of pulse number <pulse>
+ */
+double pll_predict(pll_t* pll, long pulse)
+{
+  return pll->last + (pulse - pll->count) * pll->period;
+}
+
+/*
+ * returns 1 if the pulses are followed reliably, 0 otherwise
+ */
+int pll_locked(pll_t* pll)
+{
+  return pll->pulses >= PLL_LOCK_PULSES &&
+         pll->jitter < pll->period * PLL_LOCK_JITTER;
+}
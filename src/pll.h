@@ -0,0 +1,68 @@
+/*
+ * Phase-locked loop interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLL_H
+#define PLL_H
+
+/* share of the phase error corrected on each pulse (in steady state) */
+#define PLL_ALPHA 0.05
+
+/* share of the phase error applied to the period (critically damped) */
+#define PLL_BETA (PLL_ALPHA * PLL_ALPHA / (2.0 - PLL_ALPHA))
+
+/* weight of each phase error in the jitter average */
+#define PLL_JITTER_WEIGHT (1.0 / 64)
+
+/* number of periods without pulse after which the lock is lost */
+#define PLL_DROPOUT 4
+
+/* locked: after this number of pulses, with jitter below this share of
+   the period */
+#define PLL_LOCK_PULSES 48
+#define PLL_LOCK_JITTER 0.1
+
+/*
+ * follower of a pulse stream (e.g. MIDI clock): estimates period and phase
+ * of the pulses, filtering out their jitter
+ *
+ * times are counted in frames
+ */
+typedef struct pll_t {
+  long count;          /* number of last pulse */
+  int pulses;          /* number of pulses since acquisition */
+  double last;         /* filtered time of last pulse */
+  double period;       /* filtered time between pulses, 0.0: unknown */
+
+  double phase_error;  /* deviation of last pulse from prediction */
+  double jitter;       /* RMS of phase errors */
+} pll_t;
+
+pll_t* pll_new(void);
+void pll_delete(pll_t* pll);
+void pll_reset(pll_t* pll);
+void pll_renumber(pll_t* pll, long next);
+void pll_input(pll_t* pll, double time);
+double pll_predict(pll_t* pll, long pulse);
+int pll_locked(pll_t* pll);
+
+#endif /* PLL_H */
@@ -123,6 +123,43 @@ static gchar* profile_get_accents(profile_t* profile) {
   }
 }
 
+/*
+ * makes the profiles loadable via control socket
+ */
+void profiles_export(metro_t* metro)
+{
+  GtkTreeModel* model;
+  GtkTreeIter iter;
+  control_profile_t* profiles;
+  int n = 0;
+
+  if (!metro->control || !metro->profiles_tree)
+    return;
+
+  model = gtk_tree_view_get_model(metro->profiles_tree);
+  profiles = g_malloc0(gtk_tree_model_iter_n_children(model, NULL) *
+                       sizeof(control_profile_t));
+  if (gtk_tree_model_get_iter_first(model, &iter)) {
+    do {
+      profile_t* profile;
+
+      gtk_tree_model_get(model, &iter,
+                         COLUMN_NAME, &profiles[n].name,
+                         COLUMN_PROFILE, &profile,
+                         -1);
+      profiles[n].speed = profile_get_speed(profile);
+      profiles[n].meter = profile_get_meter(profile);
+      profiles[n].accents = profile_get_accents(profile);
+      n++;
+    } while (gtk_tree_model_iter_next(model, &iter));
+  }
+  control_set_profiles(metro->control, profiles, n);
+
+  while (n--)
+    g_free(profiles[n].name);
+  g_free(profiles);
+}
+
 /* Callback for changed selection -> setting to respective profile values */
 static void selection_changed_cb(metro_t* metro)
 {
@@ -139,9 +176,12 @@ static void selection_changed_cb(metro_t* metro)
     profile_t* profile;
     gtk_tree_model_get(GTK_TREE_MODEL(store), &iter,
                        COLUMN_PROFILE, &profile, -1);
+    /* switch the audio thread over in one step, not setting by setting */
+    metro_params_begin(metro);
     set_meter(metro, NULL, profile_get_meter(profile));
     set_speed(metro, NULL, profile_get_speed(profile));
     set_accents(metro, NULL, profile_get_accents(profile));
+    metro_params_end(metro, metro->profile_quantize);
   } else if (debug)
     g_print("selection_changed_cb(): No Profile list selection available.\n");
 }
@@ -198,6 +238,49 @@ static const char* get_show_profiles(metro_t* metro,
   }
 }
 
+/* names of quantization points for profile changes, see dsp_quantize_t */
+static const char* quantize_names[] = { "now", "beat", "bar" };
+
+/* option system callback for initializing profile quantization option */
+static int new_profile_quantize(metro_t* metro) {
+  if (metro) {
+    metro->profile_quantize = DSP_QUANTIZE_BAR;
+    return 0;
+  } else {
+    return -1;
+  }
+}
+
+/* option system callback for destroying profile quantization option */
+static void delete_profile_quantize(metro_t* metro _U_) {
+}
+
+/* option system callback for setting profile quantization option */
+static int set_profile_quantize(metro_t* metro,
+                                const char* option_name _U_,
+			        const char* profile_quantize)
+{
+  unsigned int i;
+
+  if (metro) {
+    for (i = 0; i < G_N_ELEMENTS(quantize_names); i++) {
+      if (!strcmp(profile_quantize, quantize_names[i])) {
+        metro->profile_quantize = (dsp_quantize_t) i;
+        return 0;
+      }
+    }
+    g_print("set_profile_quantize(): Bad value: %s\n", profile_quantize);
+  }
+  return -1;
+}
+
+/* option system callback for getting profile quantization option */
+static const char* get_profile_quantize(metro_t* metro,
+                                        int n _U_, char** option_name _U_)
+{
+  return quantize_names[metro->profile_quantize];
+}
+
 /* option system callback for initializing selected profile option */
 static int new_profile_selected(metro_t* metro) {
   if (metro) {
@@ -348,6 +431,7 @@ static int set_profile(metro_t* metro,
 		return -1;
 	      }
               g_free(name_copy);
+	      profiles_export(metro);
 	      return 0;
 	    } else g_print("set_profile(): No Tree Model available.\n");
 	  } else g_print("set_profile(): No option suffix.\n");
@@ -484,6 +568,7 @@ static void save_profile(metro_t* metro, GtkTreeIter* iter)
   profile_set_meter(profile, get_meter(metro, 1, NULL));
   profile_set_speed(profile, get_speed(metro, 1, NULL));
   profile_set_accents(profile, get_accents(metro, 1, NULL));
+  profiles_export(metro);
 }
 
 /*
@@ -723,6 +808,13 @@ GtkWidget* profiles_new(metro_t* metro)
   g_signal_connect_swapped(G_OBJECT(tree), "button-press-event",
                            G_CALLBACK(selection_changed_cb), metro);
   metro->profiles_tree = GTK_TREE_VIEW(tree);
+  /* name changes, deletion and reordering */
+  g_signal_connect_swapped(G_OBJECT(store), "row-changed",
+                           G_CALLBACK(profiles_export), metro);
+  g_signal_connect_swapped(G_OBJECT(store), "row-deleted",
+                           G_CALLBACK(profiles_export), metro);
+  g_signal_connect_swapped(G_OBJECT(store), "rows-reordered",
+                           G_CALLBACK(profiles_export), metro);
   gtk_container_add(GTK_CONTAINER(scrolled_window), tree);
   gtk_widget_show(tree);
 
@@ -773,6 +865,14 @@ GtkWidget* profiles_new(metro_t* metro)
 		  (option_get_n_t) get_n_profile,
 		  (option_get_t) get_profile,
 		  (void*) metro);
+  option_register(&metro->options->option_list,
+                  "ProfileQuantize",
+		  (option_new_t) new_profile_quantize,
+		  (option_delete_t) delete_profile_quantize,
+		  (option_set_t) set_profile_quantize,
+		  (option_get_n_t) option_return_one,
+		  (option_get_t) get_profile_quantize,
+		  (void*) metro);
   option_register(&metro->options->option_list,
                   "ProfileSelected",
 		  (option_new_t) new_profile_selected,
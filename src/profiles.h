@@ -39,5 +39,6 @@
 
 void toggle_profiles_cb(GtkToggleAction *action, metro_t *metro);
 GtkWidget* profiles_new(metro_t* metro);
+void profiles_export(metro_t* metro);
 
 #endif /* PROFILES_H */
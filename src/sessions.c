@@ -0,0 +1,230 @@
+/*
+ * sessions.c: independent metronomes sharing one sound device stream
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdlib.h>
+#include <string.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "sessions.h"
+#include "dsp.h"
+#include "mixer.h"
+#include "threadtalk.h"
+
+/*
+ * renders the current fragment of sessions->chunk sessions from <first> on
+ */
+static void render_chunk(session_t* first, sessions_t* sessions)
+{
+  session_t* end = MIN(first + sessions->chunk,
+                       sessions->sessions + sessions->n);
+
+  for (; first < end; first++)
+    first->mix = dsp_guest_mix(first->dsp, sessions->frames);
+}
+
+/*
+ * renders a chunk of sessions in a worker of the pool, see render_chunk()
+ */
+static void render_worker(session_t* first, sessions_t* sessions)
+{
+  render_chunk(first, sessions);
+
+  g_mutex_lock(&sessions->lock);
+  if (--sessions->pending == 0)
+    g_cond_signal(&sessions->done);
+  g_mutex_unlock(&sessions->lock);
+}
+
+/*
+ * handles the queries of the client of <session> at the start of a fragment
+ * of <device>
+ */
+static void handle_queries(session_t* session, dsp_t* device)
+{
+  int repeat_flag = 1; /* sessions end with the device stream only */
+  int get_volume = 0;
+
+  dsp_set_guest(session->dsp, device->rate, device->fragmentframes);
+  dsp_handle_queries(session->dsp, &repeat_flag, &get_volume);
+
+  if (get_volume && !session->dsp->quiet) {
+    double* volume = (double*) g_malloc(sizeof(double));
+
+    *volume = dsp_get_volume(session->dsp);
+    comm_server_send_response(session->comm, MESSAGE_TYPE_RESPONSE_VOLUME,
+                              volume);
+  }
+}
+
+/*
+ * generates <frames> of <device> (see dsp_render_t): the output of all
+ * sessions, each routed to its channel
+ *
+ * the sessions are split into one chunk per thread, rendered by the workers
+ * of the pool and the audio thread at the same time, so each worker is woken
+ * up once per fragment
+ */
+static void render(sessions_t* sessions, dsp_t* device, int frames)
+{
+  int channels = device->channels;
+  int i;
+
+  memset(device->mix, 0, frames * channels * sizeof(int));
+  for (i = 0; i < sessions->n; i++)
+    handle_queries(&sessions->sessions[i], device);
+
+  sessions->frames = frames;
+  if (sessions->pool && sessions->n > 1) {
+    int chunk = (sessions->n + sessions->workers) / (sessions->workers + 1);
+
+    sessions->chunk = chunk;
+    sessions->pending = (sessions->n - 1) / chunk;
+    for (i = chunk; i < sessions->n; i += chunk)
+      g_thread_pool_push(sessions->pool, &sessions->sessions[i], NULL);
+
+    render_chunk(sessions->sessions, sessions);
+
+    g_mutex_lock(&sessions->lock);
+    while (sessions->pending > 0)
+      g_cond_wait(&sessions->done, &sessions->lock);
+    g_mutex_unlock(&sessions->lock);
+  } else {
+    sessions->chunk = sessions->n;
+    render_chunk(sessions->sessions, sessions);
+  }
+
+  for (i = 0; i < sessions->n; i++) {
+    session_t* session = &sessions->sessions[i];
+    int c;
+
+    if (!session->mix)
+      continue;
+    if (session->channel == SESSIONS_MIXED) {
+      for (c = 0; c < channels; c++)
+        mixer_route(device->mix, channels, c, session->mix, frames);
+    } else { /* devices with less channels than requested: wrapped */
+      mixer_route(device->mix, channels, session->channel % channels,
+                  session->mix, frames);
+    }
+  }
+}
+
+/*
+ * returns new device stream of up to SESSIONS_MAX sessions, taking the
+ * queries of <comm> (e.g. sound system, device, start, stop), requesting
+ * <channels> from the device and rendering with <workers> threads besides
+ * the audio thread
+ */
+sessions_t* sessions_new(comm_t* comm, int channels, int workers)
+{
+  sessions_t* result;
+
+  result = (sessions_t*) g_malloc0(sizeof(sessions_t));
+  result->device = dsp_new(comm);
+  result->device->channels_requested = channels;
+  result->device->render = (dsp_render_t) render;
+  result->device->render_data = result;
+
+  g_mutex_init(&result->lock);
+  g_cond_init(&result->done);
+  if (workers > 0) {
+    result->workers = workers;
+    result->pool = g_thread_pool_new((GFunc) render_worker, result,
+                                     workers, TRUE, NULL);
+  }
+
+  return result;
+}
+
+/*
+ * stops and destroys all sessions and the device stream
+ */
+void sessions_delete(sessions_t* sessions)
+{
+  int i;
+
+  if (sessions->pool)
+    g_thread_pool_free(sessions->pool, FALSE, TRUE);
+
+  for (i = 0; i < sessions->n; i++) {
+    session_t* session = &sessions->sessions[i];
+
+    dsp_deinit(session->dsp);
+    dsp_delete(session->dsp);
+    comm_delete(session->comm);
+  }
+  dsp_deinit(sessions->device);
+  dsp_delete(sessions->device);
+
+  g_cond_clear(&sessions->done);
+  g_mutex_clear(&sessions->lock);
+  free(sessions);
+}
+
+/*
+ * adds a session played on <channel> of the device (from 0),
+ * SESSIONS_MIXED: all channels; only before sessions_main_loop()
+ *
+ * the session starts stopped: its client sets it up and starts it with
+ * queries to the returned communication object (owned by <sessions>),
+ * handled while the device stream runs
+ *
+ * returns NULL if there are SESSIONS_MAX sessions already
+ */
+comm_t* sessions_add(sessions_t* sessions, int channel)
+{
+  session_t* session;
+
+  if (sessions->n == SESSIONS_MAX)
+    return NULL;
+
+  session = &sessions->sessions[sessions->n++];
+  session->comm = comm_new();
+  session->dsp = dsp_new(session->comm);
+  session->dsp->debug = sessions->device->debug;
+  session->dsp->fixed_point = sessions->device->fixed_point;
+  session->channel = channel;
+  session->mix = NULL;
+
+  return session->comm;
+}
+
+/*
+ * the main loop of the audio thread: plays the device stream as started
+ * and stopped by the queries of the host, see dsp_main_loop()
+ */
+void sessions_main_loop(sessions_t* sessions)
+{
+  dsp_main_loop(sessions->device);
+}
@@ -0,0 +1,75 @@
+/*
+ * sessions interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef SESSIONS_H
+#define SESSIONS_H
+
+/* GTK+ headers */
+#include <glib.h>
+
+/* own headers */
+#include "dsp.h"
+#include "threadtalk.h"
+
+/* maximum number of sessions sharing one device stream */
+#define SESSIONS_MAX 64
+
+/* channel of a session heard on all channels of the device */
+#define SESSIONS_MIXED -1
+
+/*
+ * one metronome: its client talks to it like to an own audio thread
+ * (threadtalk.h), with its own tempo, meter and sound
+ */
+typedef struct session_t {
+  comm_t* comm;      /* queries of the client, responses to it */
+  dsp_t* dsp;        /* guest of the device stream, see dsp_set_guest() */
+  int channel;       /* of the device, SESSIONS_MIXED: all */
+  const int* mix;    /* output of current fragment, NULL: stopped */
+} session_t;
+
+/*
+ * sound device stream rendering all sessions: its ticks aren't played, the
+ * output of the sessions is routed to it instead
+ */
+typedef struct sessions_t {
+  dsp_t* device;     /* takes the queries of the host (start, stop, device) */
+  session_t sessions[SESSIONS_MAX];
+  int n;             /* number of sessions */
+
+  GThreadPool* pool; /* workers rendering sessions, NULL: audio thread only */
+  int workers;       /* number of threads of pool */
+  GMutex lock;
+  GCond done;
+  int pending;       /* chunks of current fragment not yet rendered */
+  int chunk;         /* number of sessions rendered by one thread */
+  int frames;        /* length of current fragment */
+} sessions_t;
+
+sessions_t* sessions_new(comm_t* comm, int channels, int workers);
+void sessions_delete(sessions_t* sessions);
+comm_t* sessions_add(sessions_t* sessions, int channel);
+void sessions_main_loop(sessions_t* sessions);
+
+#endif /* SESSIONS_H */
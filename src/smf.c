@@ -0,0 +1,359 @@
+/*
+ * smf.c: import of tempo maps from Standard MIDI Files
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "dsp.h"
+#include "timeline.h"
+#include "smf.h"
+
+/*
+ * tempo and time signature maps collected from all tracks
+ */
+typedef struct smf_t {
+  FILE* fp;
+  long pos;                 /* bytes read and skipped within chunks */
+  int ppq;                  /* MIDI ticks per quarter note */
+  long end;                 /* end of song in MIDI ticks */
+
+  smf_change_t* tempos;     /* ordered by tick */
+  int n_tempos;
+  smf_change_t* signatures; /* ordered by tick */
+  int n_signatures;
+
+  double* starts;           /* time in seconds of each tempo change */
+  int cursor;               /* tempo change of last time calculation */
+} smf_t;
+
+/*
+ * returns next byte of the file, -1 on EOF
+ */
+static int read_byte(smf_t* smf)
+{
+  int c = getc(smf->fp);
+
+  if (c != EOF)
+    smf->pos++;
+  return c;
+}
+
+/*
+ * skips <bytes> bytes of the file
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int skip(smf_t* smf, long bytes)
+{
+  if (fseek(smf->fp, bytes, SEEK_CUR))
+    return -1;
+  smf->pos += bytes;
+  return 0;
+}
+
+/*
+ * returns big endian number of <bytes> bytes, -1 on EOF
+ */
+static long read_number(smf_t* smf, int bytes)
+{
+  long result = 0;
+  int c;
+
+  while (bytes--) {
+    if ((c = read_byte(smf)) == EOF)
+      return -1;
+    result = (result << 8) | c;
+  }
+  return result;
+}
+
+/*
+ * returns variable length quantity, -1 on error
+ */
+static long read_varlen(smf_t* smf)
+{
+  long result = 0;
+  int i;
+  int c;
+
+  for (i = 0; i < 4; i++) {
+    if ((c = read_byte(smf)) == EOF)
+      return -1;
+    result = (result << 7) | (c & 0x7F);
+    if (!(c & 0x80))
+      return result;
+  }
+  return -1;
+}
+
+/*
+ * inserts change at <tick> into map <changes> of <n> entries, after
+ * changes at the same tick (later events win)
+ */
+static void add_change(smf_change_t** changes, int* n,
+                       long tick, long value, int denominator)
+{
+  int i = *n;
+
+  if (*n % 64 == 0)
+    *changes = (smf_change_t*) g_realloc(*changes,
+                                         (*n + 64) * sizeof(smf_change_t));
+  while (i > 0 && (*changes)[i - 1].tick > tick)
+    i--;
+  memmove(&(*changes)[i + 1], &(*changes)[i], (*n - i) * sizeof(smf_change_t));
+  (*changes)[i].tick = tick;
+  (*changes)[i].value = value;
+  (*changes)[i].denominator = denominator;
+  (*n)++;
+}
+
+/*
+ * scans track chunk of <length> bytes for tempo and time signature events,
+ * skipping over everything else (notes, controllers, SysEx, other meta
+ * events) without storing it
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int read_track(smf_t* smf, long length)
+{
+  long end = smf->pos + length;
+  long tick = 0;
+  int status = 0;
+
+  while (smf->pos < end) {
+    long delta = read_varlen(smf);
+    long len;
+    int c;
+
+    if (delta == -1 || (c = read_byte(smf)) == EOF)
+      return -1;
+    tick += delta;
+
+    if (c < 0x80) {        /* running status: c is first data byte */
+      if (!status)
+        return -1;
+      if ((status & 0xE0) != 0xC0)
+        read_byte(smf);
+    } else if (c < 0xF0) { /* channel message */
+      status = c;
+      read_byte(smf);
+      if ((status & 0xE0) != 0xC0)
+        read_byte(smf);
+    } else if (c == 0xF0 || c == 0xF7) { /* SysEx */
+      status = 0;
+      if ((len = read_varlen(smf)) == -1 || skip(smf, len))
+        return -1;
+    } else if (c == 0xFF) { /* meta event */
+      int type = read_byte(smf);
+
+      status = 0;
+      if (type == EOF || (len = read_varlen(smf)) == -1)
+        return -1;
+      if (type == 0x51 && len == 3) {
+        long tempo = read_number(smf, 3);
+
+        if (tempo <= 0)
+          return -1;
+        add_change(&smf->tempos, &smf->n_tempos, tick, tempo, 0);
+      } else if (type == 0x58 && len >= 2) {
+        int numerator = read_byte(smf);
+        int power = read_byte(smf);
+
+        if (numerator < 1 || numerator > MAX_METER || power < 0 ||
+            power > TIMELINE_MAX_UNIT_POWER || skip(smf, len - 2))
+          return -1;
+        add_change(&smf->signatures, &smf->n_signatures,
+                   tick, numerator, 1 << power);
+      } else if (type == 0x2F) { /* end of track */
+        break;
+      } else if (skip(smf, len)) {
+        return -1;
+      }
+    } else {
+      return -1;
+    }
+  }
+
+  smf->end = MAX(smf->end, tick);
+  return skip(smf, end - smf->pos);
+}
+
+/*
+ * returns time in seconds of song position <tick>, advancing through the
+ * tempo map (positions must be requested in ascending order)
+ */
+static double tick_seconds(smf_t* smf, double tick)
+{
+  int i = smf->cursor;
+
+  while (i + 1 < smf->n_tempos && smf->tempos[i + 1].tick <= tick)
+    i++;
+  smf->cursor = i;
+
+  return smf->starts[i] +
+         (tick - smf->tempos[i].tick) * smf->tempos[i].value / 1e6 / smf->ppq;
+}
+
+/*
+ * appends section of <bars> bars of <meter> ticks of <beat> MIDI ticks
+ * each (note value <unit> of the time signature), starting at MIDI tick
+ * <start>, with the durations of its ticks taken from the tempo map
+ */
+static void add_section(timeline_t* timeline, smf_t* smf,
+                        double start, double beat, int meter, int unit,
+                        int bars)
+{
+  timeline_section_t* section;
+  double time = tick_seconds(smf, start);
+  int n;
+
+  timeline->sections = (timeline_section_t*) g_realloc(timeline->sections,
+      (timeline->n_sections + 1) * sizeof(timeline_section_t));
+  section = &timeline->sections[timeline->n_sections++];
+  memset(section, 0, sizeof(timeline_section_t));
+  section->bars = bars;
+  section->meter = meter;
+  section->unit = unit;
+  section->accents[0] = DSP_BEAT_ACCENT;
+  section->gain = 1.0;
+  section->durations = (double*) g_malloc(bars * meter * sizeof(double));
+
+  for (n = 0; n < bars * meter; n++) {
+    double next = tick_seconds(smf, start + (n + 1) * beat);
+
+    section->durations[n] = next - time;
+    time = next;
+  }
+  section->bpm = 60.0 / section->durations[0];
+}
+
+/*
+ * converts the collected maps to sections of <timeline>: one for each time
+ * signature, plus one for an incomplete last bar; a tick is the beat of
+ * the time signature (e.g. an eighth note in 6/8)
+ */
+static void convert(smf_t* smf, timeline_t* timeline)
+{
+  int i;
+
+  /* defaults of the MIDI standard */
+  if (smf->n_tempos == 0 || smf->tempos[0].tick > 0)
+    add_change(&smf->tempos, &smf->n_tempos, 0, SMF_DEFAULT_TEMPO, 0);
+  if (smf->n_signatures == 0 || smf->signatures[0].tick > 0)
+    add_change(&smf->signatures, &smf->n_signatures, 0, 4, 4);
+
+  smf->starts = (double*) g_malloc(smf->n_tempos * sizeof(double));
+  smf->starts[0] = 0.0;
+  for (i = 1; i < smf->n_tempos; i++)
+    smf->starts[i] = smf->starts[i - 1] +
+      (double) (smf->tempos[i].tick - smf->tempos[i - 1].tick) *
+      smf->tempos[i - 1].value / 1e6 / smf->ppq;
+  smf->cursor = 0;
+
+  for (i = 0; i < smf->n_signatures; i++) {
+    smf_change_t* signature = &smf->signatures[i];
+    int meter = signature->value;
+    double beat = smf->ppq * 4.0 / signature->denominator;
+    long stop = i + 1 < smf->n_signatures ?
+                smf->signatures[i + 1].tick : smf->end;
+    long beats = (long) ceil((stop - signature->tick) / beat - 1e-9);
+    double start = signature->tick;
+
+    if (beats <= 0)
+      continue;
+    if (beats >= meter) {
+      add_section(timeline, smf, start, beat, meter, signature->denominator,
+                  beats / meter);
+      start += beats / meter * meter * beat;
+    }
+    if (beats % meter)
+      add_section(timeline, smf, start, beat, beats % meter,
+                  signature->denominator, 1);
+  }
+}
+
+/*
+ * appends the tempo map of the Standard MIDI File read from <fp> to
+ * <timeline>, as sections with exact tick durations
+ *
+ * only tempo (FF 51), time signature (FF 58) and end of track (FF 2F) meta
+ * events are evaluated, the file is read as a stream
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int smf_read(FILE* fp, timeline_t* timeline)
+{
+  smf_t smf;
+  char id[4];
+  long length;
+  int division;
+  int result = 0;
+
+  memset(&smf, 0, sizeof(smf));
+  smf.fp = fp;
+
+  if (fread(id, 1, 4, fp) != 4 || memcmp(id, "MThd", 4) ||
+      (length = read_number(&smf, 4)) < 6 ||
+      read_number(&smf, 2) == -1 || read_number(&smf, 2) == -1 ||
+      (division = read_number(&smf, 2)) <= 0 ||
+      skip(&smf, length - 6))
+    return -1;
+
+  if (division & 0x8000) {
+    fprintf(stderr, "Warning: SMPTE time division not supported.\n");
+    return -1;
+  }
+  smf.ppq = division;
+
+  while (result == 0 && fread(id, 1, 4, fp) == 4) {
+    if ((length = read_number(&smf, 4)) == -1)
+      result = -1;
+    else if (!memcmp(id, "MTrk", 4))
+      result = read_track(&smf, length);
+    else if (skip(&smf, length))
+      result = -1;
+  }
+
+  if (result == 0)
+    convert(&smf, timeline);
+
+  if (smf.tempos) free(smf.tempos);
+  if (smf.signatures) free(smf.signatures);
+  if (smf.starts) free(smf.starts);
+
+  return result;
+}
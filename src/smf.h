@@ -0,0 +1,46 @@
+/*
+ * Standard MIDI File tempo map import interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SMF_H
+#define SMF_H
+
+#include <stdio.h>
+
+#include "timeline.h"
+
+/* tempo of a MIDI file without tempo event, in microseconds per quarter */
+#define SMF_DEFAULT_TEMPO 500000
+
+/*
+ * change of tempo or time signature at a position of the song
+ */
+typedef struct smf_change_t {
+  long tick;                /* position in MIDI ticks */
+  long value;               /* tempo: microseconds per quarter note,
+                               time signature: numerator */
+  int denominator;          /* time signature only: e.g. 4 for x/4 */
+} smf_change_t;
+
+int smf_read(FILE* fp, timeline_t* timeline);
+
+#endif /* SMF_H */
@@ -0,0 +1,221 @@
+/*
+ * soundbank.c: shared, reference counted tick sounds
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "mixer.h"
+#include "soundbank.h"
+
+/*
+ * returns new sound bank, voices of which will be generated by <prepare>
+ * (called with <object>)
+ */
+soundbank_t* soundbank_new(voice_prepare_t prepare, void* object) {
+  soundbank_t* result;
+
+  result = (soundbank_t*) g_malloc0(sizeof(soundbank_t));
+  result->prepare = prepare;
+  result->object = object;
+  result->n_voices = 1; /* SOUNDBANK_SILENCE: no name, no data */
+
+  return result;
+}
+
+/*
+ * destroys sound bank, including all voices still referenced
+ */
+void soundbank_delete(soundbank_t* bank) {
+  int i;
+
+  for (i = 0; i < bank->n_voices; i++) {
+    if (bank->voices[i].name) free(bank->voices[i].name);
+    if (bank->voices[i].data && !bank->voices[i].shared)
+      g_free((short*) bank->voices[i].data);
+  }
+  free(bank);
+}
+
+/*
+ * returns index of the voice for <variant> of sound <name>
+ *
+ * an already prepared voice is shared by increasing its reference count,
+ * otherwise it is prepared now
+ *
+ * returns -1 on error (sound not available or bank full)
+ */
+int soundbank_acquire(soundbank_t* bank,
+                      const char* name, voice_variant_t variant)
+{
+  int free_slot = -1;
+  int i;
+  voice_t* voice;
+
+  for (i = 1; i < bank->n_voices; i++) {
+    voice = &bank->voices[i];
+    if (!voice->name) {
+      if (free_slot == -1)
+        free_slot = i;
+    } else if (voice->variant == variant && !strcmp(voice->name, name)) {
+      voice->refcount++;
+      return i;
+    }
+  }
+
+  if (free_slot == -1) {
+    if (bank->n_voices == SOUNDBANK_MAX_VOICES) {
+      fprintf(stderr, "Warning: No free voice for \"%s\".\n", name);
+      return -1;
+    }
+    free_slot = bank->n_voices;
+  }
+
+  voice = &bank->voices[free_slot];
+  if ((voice->frames =
+         bank->prepare(bank->object, name, variant, &voice->data,
+                       &voice->shared)) == -1)
+  {
+    voice->data = NULL;
+    voice->frames = 0;
+    return -1;
+  }
+  voice->name = strdup(name);
+  voice->variant = variant;
+  voice->refcount = 1;
+
+  if (free_slot == bank->n_voices)
+    bank->n_voices++;
+
+  if (bank->debug)
+    g_print("soundbank_acquire: Voice %d: \"%s\" (variant %d), %d frames\n",
+            free_slot, name, variant, voice->frames);
+
+  return free_slot;
+}
+
+/*
+ * gives back a reference to voice <index>, freeing it when unused
+ */
+void soundbank_release(soundbank_t* bank, int index) {
+  voice_t* voice = &bank->voices[index];
+
+  if (index == SOUNDBANK_SILENCE)
+    return;
+
+  if (--voice->refcount == 0) {
+    free(voice->name);
+    voice->name = NULL;
+    if (!voice->shared)
+      g_free((short*) voice->data);
+    voice->data = NULL;
+    voice->frames = 0;
+
+    while (bank->n_voices > 1 && !bank->voices[bank->n_voices - 1].name)
+      bank->n_voices--;
+  }
+}
+
+/*
+ * renders <variant> of the sound of <n> frames (<channels_in> channels at
+ * <rate_in>) to mono frames at <rate>, as prepared for voices of the
+ * device (or at build time for the default tick, see converter.c), in
+ * integer only arithmetic if <fixed_point> != 0 (see mixer_resample())
+ *
+ * returns number of frames allocated in *data, -1 on error
+ */
+int soundbank_render_variant(const short* frames, int n, int rate_in,
+                             int channels_in, voice_variant_t variant,
+                             int rate, short** data, int fixed_point,
+                             int debug)
+{
+  short *tmp_buf; /* temporary buffer for generation of different sounds */
+  int samples;
+  int size = -1;
+  int i;
+
+  int attack = 0;
+
+  switch (variant) {
+  case VOICE_VARIANT_NORMAL: /* single ticks */
+    size = mixer_resample(frames, n, rate_in, channels_in, rate, data,
+                          fixed_point);
+    break;
+
+  case VOICE_VARIANT_ACCENT: /* first tick */
+    if ((size = mixer_resample(frames, n, rate_in * 2, channels_in, rate,
+                               data, fixed_point)) == -1)
+    {
+      return -1;
+    }
+
+    /* attack padding for accents */
+    while (attack < n && abs(frames[attack]) < SHRT_MAX / 20)
+    {
+      attack++;
+    }
+
+    if (attack < n / 3) {
+      int offset = attack / 2; /* in frames */
+
+      *data = (short*) g_realloc(*data, (size + offset) * sizeof(short));
+      memmove(*data + offset, *data, size * sizeof(short));
+      memset(*data, 0, offset * sizeof(short));
+      size += attack / 2;
+
+      if (debug)
+	fprintf(stderr, "Attack padding for accents: %d frames.\n",
+	        attack / 2);
+    }
+    break;
+
+  case VOICE_VARIANT_SECONDARY: /* secondary ticks */
+    samples = n * channels_in;
+    tmp_buf = (short*) g_malloc(samples * sizeof(short));
+    for (i = 0; i < samples; i++) {
+      tmp_buf[i] = frames[i] / 2;
+    }
+    size = mixer_resample(tmp_buf, n, rate_in, channels_in, rate, data,
+                          fixed_point);
+    free(tmp_buf);
+    break;
+
+  default:
+    fprintf(stderr, "Warning: Unhandled voice variant: %d.\n", variant);
+  }
+
+  return size;
+}
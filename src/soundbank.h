@@ -0,0 +1,88 @@
+/*
+ * Sound bank interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SOUNDBANK_H
+#define SOUNDBANK_H
+
+/* maximum number of voices, indices must fit into an unsigned char */
+#define SOUNDBANK_MAX_VOICES 256
+
+/* index of the (always available) silent voice */
+#define SOUNDBANK_SILENCE 0
+
+/* maximum duration of a prepared voice in seconds, longer sounds are cut */
+#define VOICE_MAX_DURATION 2
+
+/*
+ * variants of a sound, prepared from the same source frames
+ */
+typedef enum voice_variant_t {
+  VOICE_VARIANT_NORMAL,    /* unchanged (single ticks) */
+  VOICE_VARIANT_ACCENT,    /* pitched up, for accentuated ticks */
+  VOICE_VARIANT_SECONDARY, /* half amplitude, for other ticks */
+
+  VOICE_VARIANT_NUMBER
+} voice_variant_t;
+
+typedef struct voice_t {
+  char* name;              /* sound name or filename, NULL: unused slot */
+  voice_variant_t variant;
+  int refcount;
+
+  const short* data;       /* linear mono frames at device rate */
+  int frames;              /* number of frames */
+  int shared;              /* data in read-only tables, not freed */
+} voice_t;
+
+/*
+ * prepares <variant> of sound <name> for the device
+ * returns number of frames in *data, -1 on error; *shared set if *data
+ * points into read-only tables, otherwise it is allocated
+ */
+typedef int (*voice_prepare_t) (void* object, const char* name,
+                                voice_variant_t variant, const short** data,
+                                int* shared);
+
+typedef struct soundbank_t {
+  voice_t voices[SOUNDBANK_MAX_VOICES];
+  int n_voices;            /* number of slots in use (including free ones) */
+
+  voice_prepare_t prepare;
+  void* object;            /* argument to deliver to prepare */
+
+  int debug;               /* level of runtime debugging output, 0: none */
+} soundbank_t;
+
+soundbank_t* soundbank_new(voice_prepare_t prepare, void* object);
+void soundbank_delete(soundbank_t* bank);
+
+int soundbank_acquire(soundbank_t* bank,
+                      const char* name, voice_variant_t variant);
+void soundbank_release(soundbank_t* bank, int index);
+
+int soundbank_render_variant(const short* frames, int n, int rate_in,
+                             int channels_in, voice_variant_t variant,
+                             int rate, short** data, int fixed_point,
+                             int debug);
+
+#endif /* SOUNDBANK_H */
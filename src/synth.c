@@ -0,0 +1,707 @@
+/*
+ * synth.c: procedural click sounds
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <limits.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "synth.h"
+#include "mixer.h"
+
+/* wood block: frequencies, levels and decay times of the modes relative to
+   the first one */
+#define WOOD_MODES 3
+static const double wood_ratios[WOOD_MODES] = { 1.0, 2.57, 4.21 };
+static const double wood_levels[WOOD_MODES] = { 1.0, 0.45, 0.2 };
+static const double wood_decays[WOOD_MODES] = { 1.0, 0.5, 0.3 };
+/* the same in Q16, for the fixed point path */
+static const int wood_ratios_q16[WOOD_MODES] = { 65536, 168428, 275907 };
+static const int wood_levels_q16[WOOD_MODES] = { 65536, 29491, 13107 };
+static const int wood_decays_q16[WOOD_MODES] = { 65536, 32768, 19661 };
+
+/* parameters of the fixed point path, converted once by convert_params() */
+typedef struct {
+  synth_model_t model;
+  int size;          /* frames */
+  gint64 gain;       /* peak level, of SHRT_MAX */
+  gint64 freq_q16;   /* Hz, Q16 */
+  int attack;        /* frames */
+  int release;       /* frames */
+  gint64 decay_us;   /* microseconds */
+  gint64 ratio_q16;  /* Q16 */
+  gint64 index_q16;  /* Q16 */
+  gint64 q_q16;      /* Q16 */
+} fixed_params_t;
+
+/* highest frequency rendered, relative to the rate */
+#define NYQUIST_LIMIT 0.45
+
+/* fixed point: Q30 coefficients and envelopes (1.0 == 1 << 30), Q28
+   signals, phases in 1 / 2^32 periods */
+#define Q30 (1 << 30)
+#define Q28_SHIFT 28
+#define NYQUIST_PHASE ((guint32) (NYQUIST_LIMIT * 4294967296.0))
+/* sine table generation: sin(2 pi / SYNTH_TABLE_SIZE) and
+   4 sin^2(pi / SYNTH_TABLE_SIZE), both in Q40 */
+#define TABLE_SIN_Q40 G_GINT64_CONSTANT(1686629052)
+#define TABLE_EPS_Q40 G_GINT64_CONSTANT(2587257)
+/* ln(1000) in Q30: decay to -60 dB */
+#define LN_1000_Q30 G_GINT64_CONSTANT(7417145753)
+
+static const char* models[SYNTH_MODELS] = {
+  [SYNTH_SINE] = "sine", [SYNTH_FM] = "fm",
+  [SYNTH_NOISE] = "noise", [SYNTH_WOOD] = "wood"
+};
+
+/*
+ * sounds of the models without parameters, "<sine>": the classic GTick sine
+ *
+ * model, freq, ratio, index, q, attack, decay, release, length, gain
+ */
+static const synth_params_t defaults[SYNTH_MODELS] = {
+  { SYNTH_SINE,   880.0, 0.0, 0.0, 0.0, 0.002,  0.0,   0.002, 0.010, 1.0 },
+  { SYNTH_FM,    1000.0, 1.4, 3.0, 0.0, 0.0005, 0.060, 0.002, 0.080, 1.0 },
+  { SYNTH_NOISE, 3000.0, 0.0, 0.0, 4.0, 0.0002, 0.025, 0.002, 0.040, 1.0 },
+  { SYNTH_WOOD,  1100.0, 0.0, 0.0, 0.0, 0.0001, 0.040, 0.002, 0.060, 1.0 }
+};
+
+/* parameters in sound names: field, range and unit (times in ms) */
+typedef struct synth_key_t {
+  const char* name;
+  size_t offset;
+  double min;
+  double max;
+  double scale;
+} synth_key_t;
+
+static const synth_key_t keys[] = {
+  { "freq",    offsetof(synth_params_t, freq),    20.0, 20000.0, 1.0   },
+  { "ratio",   offsetof(synth_params_t, ratio),   0.1,  20.0,    1.0   },
+  { "index",   offsetof(synth_params_t, index),   0.0,  50.0,    1.0   },
+  { "q",       offsetof(synth_params_t, q),       0.5,  100.0,   1.0   },
+  { "attack",  offsetof(synth_params_t, attack),  0.0,  2000.0,  0.001 },
+  { "decay",   offsetof(synth_params_t, decay),   0.0,  2000.0,  0.001 },
+  { "release", offsetof(synth_params_t, release), 0.0,  2000.0,  0.001 },
+  { "length",  offsetof(synth_params_t, length),  1.0,  2000.0,  0.001 },
+  { "gain",    offsetof(synth_params_t, gain),    0.0,  1.0,     1.0   },
+  { NULL, 0, 0.0, 0.0, 0.0 }
+};
+
+static float sine_table[SYNTH_TABLE_SIZE + 1]; /* guard entry: wrap around */
+static gint32 fixed_table[SYNTH_TABLE_SIZE + 1]; /* the same in Q30 */
+
+/*
+ * parses sound <name>: "<MODEL[ PARAMETER=VALUE]...>" with MODEL "sine",
+ * "fm", "noise" or "wood", PARAMETER "freq" (Hz), "ratio", "index", "q",
+ * "attack", "decay", "release", "length" (ms) or "gain" (0.0 ... 1.0),
+ * e.g. "<wood freq=1500 decay=25>"
+ *
+ * returns 0 on success (params set), -1 if <name> isn't a valid synthesized
+ * sound
+ */
+int synth_parse(synth_params_t* params, const char* name)
+{
+  synth_params_t result;
+  int len = strlen(name);
+  char* copy;
+  char* state;
+  char* token;
+  int m;
+
+  if (len < 3 || name[0] != '<' || name[len - 1] != '>')
+    return -1;
+
+  copy = g_strndup(name + 1, len - 2);
+  token = strtok_r(copy, " \t", &state);
+  for (m = 0; token && m < SYNTH_MODELS && strcmp(token, models[m]); m++);
+  if (!token || m == SYNTH_MODELS) {
+    free(copy);
+    return -1;
+  }
+
+  result = defaults[m];
+  while ((token = strtok_r(NULL, " \t", &state))) {
+    char* value = strchr(token, '=');
+    char* end;
+    double v;
+    int k;
+
+    if (!value)
+      break;
+    *value++ = '\0';
+    for (k = 0; keys[k].name && strcmp(token, keys[k].name); k++);
+    v = strtod(value, &end);
+    if (!keys[k].name || end == value || *end ||
+        v < keys[k].min || v > keys[k].max)
+      break;
+    *(double*) ((char*) &result + keys[k].offset) = v * keys[k].scale;
+  }
+  free(copy);
+
+  if (token) { /* stopped on error */
+    fprintf(stderr, "Warning: Bad synthesizer parameters in \"%s\".\n", name);
+    return -1;
+  }
+  *params = result;
+  return 0;
+}
+
+/*
+ * fills the sine table once for all threads
+ */
+static void init_table(void)
+{
+  static gsize initialized = 0;
+  int i;
+
+  if (g_once_init_enter(&initialized)) {
+    for (i = 0; i <= SYNTH_TABLE_SIZE; i++)
+      sine_table[i] = sin(2.0 * M_PI * i / SYNTH_TABLE_SIZE);
+    g_once_init_leave(&initialized, 1);
+  }
+}
+
+/*
+ * returns sine of <phase> (in periods) from the table, interpolated
+ */
+static double table_sin(double phase)
+{
+  double x = (phase - floor(phase)) * SYNTH_TABLE_SIZE;
+  int i = (int) x;
+
+  return sine_table[i] + (x - i) * (sine_table[i + 1] - sine_table[i]);
+}
+
+/*
+ * writes the envelope of <params> to <env>: linear attack, exponential
+ * <decay> (0.0: none) and linear release
+ */
+static void render_envelope(const synth_params_t* params, int rate,
+                            double decay, float* env, int size)
+{
+  int attack = MIN(lrint(params->attack * rate), size);
+  int release = MIN(lrint(params->release * rate), size);
+  double factor = decay > 0.0 ? pow(0.001, 1.0 / (decay * rate)) : 1.0;
+  double level = 1.0;
+  int i;
+
+  for (i = 0; i < attack; i++)
+    env[i] = (double) i / attack;
+  for (; i < size; i++) {
+    env[i] = level;
+    level *= factor;
+  }
+  for (i = 0; i < release; i++)
+    env[size - 1 - i] *= (double) i / release;
+}
+
+/*
+ * sine by recursive oscillator: y[n] = 2 cos(w) y[n-1] - y[n-2]
+ */
+static void render_sine(double freq, int rate, const float* env,
+                        float* out, int size)
+{
+  double w = 2.0 * M_PI * MIN(freq, rate * NYQUIST_LIMIT) / rate;
+  double c = 2.0 * cos(w);
+  double y1 = 0.0;
+  double y2 = -sin(w);
+  int i;
+
+  for (i = 0; i < size; i++) {
+    double y = c * y1 - y2;
+
+    out[i] = y1 * env[i];
+    y2 = y1;
+    y1 = y;
+  }
+}
+
+/*
+ * carrier phase modulated by sine of <ratio> times its frequency, with the
+ * modulation index following the envelope: bright attack, mellow decay
+ */
+static void render_fm(const synth_params_t* params, int rate,
+                      const float* env, float* out, int size)
+{
+  double carrier = MIN(params->freq, rate * NYQUIST_LIMIT) / rate;
+  double modulator = carrier * params->ratio;
+  double cphase = 0.0;
+  double mphase = 0.0;
+  int i;
+
+  init_table();
+  for (i = 0; i < size; i++) {
+    out[i] = env[i] *
+      table_sin(cphase + params->index * env[i] * table_sin(mphase));
+    cphase += carrier;
+    mphase += modulator;
+    if (cphase >= 1.0) cphase -= 1.0;
+    if (mphase >= 1.0) mphase -= 1.0;
+  }
+}
+
+/*
+ * white noise (xorshift) through resonant band pass (biquad, 0 dB peak)
+ */
+static void render_noise(const synth_params_t* params, int rate,
+                         const float* env, float* out, int size)
+{
+  double w = 2.0 * M_PI * MIN(params->freq, rate * NYQUIST_LIMIT) / rate;
+  double alpha = sin(w) / (2.0 * params->q);
+  double a0 = 1.0 + alpha;
+  double b0 = alpha / a0;
+  double a1 = -2.0 * cos(w) / a0;
+  double a2 = (1.0 - alpha) / a0;
+  double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+  guint32 state = 0x2545F491; /* same noise for each voice */
+  int i;
+
+  for (i = 0; i < size; i++) {
+    double x;
+    double y;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    x = (gint32) state / 2147483648.0;
+    y = b0 * (x - x2) - a1 * y1 - a2 * y2;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    out[i] = y * env[i];
+  }
+}
+
+/*
+ * wood block: modes struck at once, each a damped recursive resonator
+ * y[n] = 2 r cos(w) y[n-1] - r^2 y[n-2] with its own decay
+ */
+static void render_wood(const synth_params_t* params, int rate,
+                        const float* env, float* out, int size)
+{
+  int m, i;
+
+  memset(out, 0, size * sizeof(float));
+  for (m = 0; m < WOOD_MODES; m++) {
+    double w = 2.0 * M_PI * params->freq * wood_ratios[m] / rate;
+    double decay = MAX(params->decay, 0.001) * wood_decays[m];
+    double r = pow(0.001, 1.0 / (decay * rate));
+    double c = 2.0 * r * cos(w);
+    double r2 = r * r;
+    double y1 = 0.0;
+    double y2 = 0.0;
+    double y = wood_levels[m] * sin(w); /* response to impulse */
+
+    if (w >= 2.0 * M_PI * NYQUIST_LIMIT)
+      continue;
+    for (i = 0; i < size; i++) {
+      y2 = y1;
+      y1 = y;
+      out[i] += y1 * env[i];
+      y = c * y1 - r2 * y2;
+    }
+  }
+}
+
+/*
+ * fills the Q30 sine table once for all threads, by the recursion
+ * sin((k + 1) d) = 2 sin(k d) - sin((k - 1) d) - 4 sin^2(d / 2) sin(k d)
+ * over the first quarter in Q40 and symmetry, without floating point, so
+ * the table is the same on every architecture
+ */
+static void init_fixed_table(void)
+{
+  static gsize initialized = 0;
+  int quarter = SYNTH_TABLE_SIZE / 4;
+  int i;
+
+  if (g_once_init_enter(&initialized)) {
+    gint64 s1 = 0;
+    gint64 s = TABLE_SIN_Q40;
+
+    fixed_table[0] = 0;
+    for (i = 1; i <= quarter; i++) {
+      gint64 next = 2 * s - s1 -
+        ((TABLE_EPS_Q40 * s + (G_GINT64_CONSTANT(1) << 39)) >> 40);
+
+      fixed_table[i] = MIN((s + (1 << 9)) >> 10, Q30);
+      s1 = s;
+      s = next;
+    }
+    for (i = 1; i < quarter; i++)
+      fixed_table[quarter + i] = fixed_table[quarter - i];
+    for (i = 1; i <= 2 * quarter; i++)
+      fixed_table[2 * quarter + i] = -fixed_table[i];
+    g_once_init_leave(&initialized, 1);
+  }
+}
+
+/*
+ * returns sine of <phase> (in 1 / 2^32 periods) from the table, interpolated,
+ * in Q30
+ */
+static gint32 fixed_sin(guint32 phase)
+{
+  int i = phase >> 20;
+  gint64 frac = (phase >> 4) & 0xffff;
+
+  return fixed_table[i] +
+    (((fixed_table[i + 1] - fixed_table[i]) * frac) >> 16);
+}
+
+/*
+ * returns cosine of <phase> (in 1 / 2^32 periods) in Q30
+ */
+static gint32 fixed_cos(guint32 phase)
+{
+  return fixed_sin(phase + (1U << 30));
+}
+
+/*
+ * returns <x> rounded to the nearest integer (x >= 0), without libm
+ */
+static gint64 fixed_round(double x)
+{
+  return (gint64) (x + 0.5);
+}
+
+/*
+ * converts <params> for the fixed point path at <rate>: the only place
+ * where the parsed doubles are used
+ */
+static void convert_params(const synth_params_t* params, int rate,
+                           fixed_params_t* fixed)
+{
+  fixed->model = params->model;
+  fixed->size = fixed_round(params->length * rate);
+  fixed->gain = fixed_round(params->gain * SHRT_MAX);
+  fixed->freq_q16 = fixed_round(params->freq * 65536.0);
+  fixed->attack = fixed_round(params->attack * rate);
+  fixed->release = fixed_round(params->release * rate);
+  fixed->decay_us = fixed_round(params->decay * 1000000.0);
+  fixed->ratio_q16 = fixed_round(params->ratio * 65536.0);
+  fixed->index_q16 = fixed_round(params->index * 65536.0);
+  fixed->q_q16 = fixed_round(params->q * 65536.0);
+}
+
+/*
+ * returns phase increment per frame of <freq_q16> (in Hz, Q16) at <rate>,
+ * limited to NYQUIST_PHASE
+ */
+static guint32 fixed_phase(gint64 freq_q16, int rate)
+{
+  return MIN((freq_q16 << 16) / rate, NYQUIST_PHASE);
+}
+
+/*
+ * returns factor per frame of a decay to -60 dB within <decay_us> (in
+ * microseconds) at <rate>, in Q30: exp(-x) by Taylor series after halving x
+ * below 1/8, squared back
+ */
+static gint32 fixed_decay(gint64 decay_us, int rate)
+{
+  gint64 x = LN_1000_Q30 * 1000000 / MAX(decay_us * rate, 1);
+  gint64 result;
+  int halvings = 0;
+
+  while (x > Q30 / 8) {
+    x >>= 1;
+    halvings++;
+  }
+  result = Q30 - x + (((x * x) >> 30) >> 1);
+  result -= ((((x * x) >> 30) * x) >> 30) / 6;
+  result += ((((((x * x) >> 30) * x) >> 30) * x) >> 30) / 24;
+  while (halvings--)
+    result = (result * result) >> 30;
+
+  return result;
+}
+
+/*
+ * writes the envelope of <params> to <env> in Q30, as render_envelope() with
+ * <decay_us> in microseconds (0: none)
+ */
+static void render_envelope_fixed(const fixed_params_t* params, int rate,
+                                  gint64 decay_us, gint32* env, int size)
+{
+  int attack = MIN(params->attack, size);
+  int release = MIN(params->release, size);
+  gint64 factor = decay_us > 0 ? fixed_decay(decay_us, rate) : Q30;
+  gint64 level = Q30;
+  int i;
+
+  for (i = 0; i < attack; i++)
+    env[i] = (gint64) i * Q30 / attack;
+  for (; i < size; i++) {
+    env[i] = level;
+    level = (level * factor) >> 30;
+  }
+  for (i = 0; i < release; i++)
+    env[size - 1 - i] = (gint64) env[size - 1 - i] * i / release;
+}
+
+/*
+ * sine by recursive oscillator as render_sine(), in Q28
+ */
+static void render_sine_fixed(gint64 freq_q16, int rate, const gint32* env,
+                              gint32* out, int size)
+{
+  guint32 w = fixed_phase(freq_q16, rate);
+  gint64 c = 2 * (gint64) fixed_cos(w);
+  gint64 y1 = 0;
+  gint64 y2 = -(fixed_sin(w) >> 2);
+  int i;
+
+  for (i = 0; i < size; i++) {
+    gint64 y = ((c * y1) >> 30) - y2;
+
+    out[i] = (y1 * env[i]) >> 30;
+    y2 = y1;
+    y1 = y;
+  }
+}
+
+/*
+ * FM as render_fm(), with phase accumulators wrapping around each period
+ */
+static void render_fm_fixed(const fixed_params_t* params, int rate,
+                            const gint32* env, gint32* out, int size)
+{
+  guint32 carrier = fixed_phase(params->freq_q16, rate);
+  guint32 modulator = ((gint64) carrier * params->ratio_q16) >> 16;
+  gint64 index = params->index_q16;
+  guint32 cphase = 0;
+  guint32 mphase = 0;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    /* index * env * sin(mphase) in 1 / 2^32 periods */
+    guint32 offset =
+      (index * (((gint64) env[i] * fixed_sin(mphase)) >> 30)) >> 14;
+
+    out[i] = ((gint64) env[i] * fixed_sin(cphase + offset)) >> 32;
+    cphase += carrier;
+    mphase += modulator;
+  }
+}
+
+/*
+ * noise through band pass as render_noise(), in Q28 with Q30 coefficients
+ */
+static void render_noise_fixed(const fixed_params_t* params, int rate,
+                               const gint32* env, gint32* out, int size)
+{
+  guint32 w = fixed_phase(params->freq_q16, rate);
+  gint64 q = params->q_q16;
+  gint64 alpha = (gint64) fixed_sin(w) * 65536 / (2 * q);
+  gint64 a0 = Q30 + alpha;
+  gint64 b0 = (alpha << 30) / a0;
+  gint64 a1 = -(((gint64) fixed_cos(w) * 2) << 30) / a0;
+  gint64 a2 = ((Q30 - alpha) << 30) / a0;
+  gint64 x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+  guint32 state = 0x2545F491; /* same noise as render_noise() */
+  int i;
+
+  for (i = 0; i < size; i++) {
+    gint64 x;
+    gint64 y;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    x = (gint32) state >> (31 - Q28_SHIFT);
+    y = (b0 * (x - x2) - a1 * y1 - a2 * y2) >> 30;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    out[i] = (y * env[i]) >> 30;
+  }
+}
+
+/*
+ * wood block as render_wood(), each mode a damped resonator in Q28 with Q30
+ * coefficients
+ */
+static void render_wood_fixed(const fixed_params_t* params, int rate,
+                              const gint32* env, gint32* out, int size)
+{
+  gint64 freq_q16 = params->freq_q16;
+  gint64 decay_us = MAX(params->decay_us, 1000);
+  int m, i;
+
+  memset(out, 0, size * sizeof(gint32));
+  for (m = 0; m < WOOD_MODES; m++) {
+    gint64 w = ((freq_q16 * wood_ratios_q16[m]) >> 16 << 16) / rate;
+    gint64 r = fixed_decay((decay_us * wood_decays_q16[m]) >> 16, rate);
+    gint64 c = (2 * r * fixed_cos(w)) >> 30;
+    gint64 r2 = (r * r) >> 30;
+    gint64 y1 = 0;
+    gint64 y2 = 0;
+    /* response to impulse */
+    gint64 y = (((wood_levels_q16[m] * (gint64) fixed_sin(w)) >> 16) >>
+                (30 - Q28_SHIFT));
+
+    if (w >= NYQUIST_PHASE)
+      continue;
+    for (i = 0; i < size; i++) {
+      y2 = y1;
+      y1 = y;
+      out[i] += (y1 * env[i]) >> 30;
+      y = ((c * y1) >> 30) - ((r2 * y2) >> 30);
+    }
+  }
+}
+
+/*
+ * renders as synth_render(), in integer arithmetic: apart from converting
+ * the parameters once (convert_params()), the same on every architecture
+ */
+static int render_fixed(const synth_params_t* synth_params, int rate,
+                        short** samples)
+{
+  fixed_params_t fixed;
+  const fixed_params_t* params = &fixed;
+  int size;
+  gint64 gain;
+  gint32* env;
+  gint32* out;
+  short* s;
+  gint64 peak = 0;
+  gint64 scale;
+  int i;
+
+  convert_params(synth_params, rate, &fixed);
+  size = params->size;
+  gain = params->gain;
+  if (size <= 0 || params->model >= SYNTH_MODELS)
+    return -1;
+
+  init_fixed_table();
+  env = (gint32*) g_malloc(size * sizeof(gint32));
+  out = (gint32*) g_malloc(size * sizeof(gint32));
+  render_envelope_fixed(params, rate,
+                        params->model == SYNTH_WOOD ? 0 : params->decay_us,
+                        env, size);
+  switch (params->model) {
+  case SYNTH_SINE:
+    render_sine_fixed(params->freq_q16, rate, env, out, size);
+    break;
+  case SYNTH_FM:
+    render_fm_fixed(params, rate, env, out, size);
+    break;
+  case SYNTH_NOISE:
+    render_noise_fixed(params, rate, env, out, size);
+    break;
+  default:
+    render_wood_fixed(params, rate, env, out, size);
+  }
+
+  for (i = 0; i < size; i++)
+    peak = MAX(peak, ABS((gint64) out[i]));
+  scale = peak > 0 ? (gain << 32) / peak : 0; /* Q32 */
+  s = (short*) g_malloc(size * sizeof(short));
+  for (i = 0; i < size; i++)
+    s[i] = (out[i] * scale + (G_GINT64_CONSTANT(1) << 31)) >> 32;
+
+  free(env);
+  free(out);
+  *samples = s;
+  return size;
+}
+
+/*
+ * renders the sound of <params> at <rate> (e.g. 48000) in Hz, normalized
+ * to the peak level params->gain
+ *
+ * returns number of (mono) frames returned in <samples>, -1 on error
+ *
+ * NOTES:
+ *  - caller has to free *samples himself
+ *  - <fixed_point> != 0 selects integer only arithmetic, see
+ *    mixer_resample()
+ */
+int synth_render(const synth_params_t* params, int rate, short** samples,
+                 int fixed_point)
+{
+  int size;
+  float* env;
+  float* out;
+  short* s;
+  double peak = 0.0;
+  double scale;
+  int i;
+
+  if (fixed_point)
+    return render_fixed(params, rate, samples);
+  size = lrint(params->length * rate);
+  if (size <= 0 || params->model >= SYNTH_MODELS)
+    return -1;
+
+  env = (float*) g_malloc(size * sizeof(float));
+  out = (float*) g_malloc(size * sizeof(float));
+  render_envelope(params, rate,
+                  params->model == SYNTH_WOOD ? 0.0 : params->decay,
+                  env, size);
+  switch (params->model) {
+  case SYNTH_SINE:
+    render_sine(params->freq, rate, env, out, size);
+    break;
+  case SYNTH_FM:
+    render_fm(params, rate, env, out, size);
+    break;
+  case SYNTH_NOISE:
+    render_noise(params, rate, env, out, size);
+    break;
+  default:
+    render_wood(params, rate, env, out, size);
+  }
+
+  for (i = 0; i < size; i++)
+    peak = MAX(peak, fabs(out[i]));
+  scale = peak > 0.0 ? params->gain * SHRT_MAX / peak : 0.0;
+  s = (short*) g_malloc(size * sizeof(short));
+  for (i = 0; i < size; i++)
+    s[i] = lrint(out[i] * scale);
+
+  free(env);
+  free(out);
+  *samples = s;
+  return size;
+}
@@ -0,0 +1,58 @@
+/*
+ * synth.h: procedural click sounds
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SYNTH_H
+#define SYNTH_H
+
+/* entries of the sine table of the FM model (one period) */
+#define SYNTH_TABLE_SIZE 4096
+
+typedef enum synth_model_t {
+  SYNTH_SINE,   /* sine, by recursive oscillator */
+  SYNTH_FM,     /* carrier modulated by sine, index following envelope */
+  SYNTH_NOISE,  /* white noise through resonant band pass */
+  SYNTH_WOOD,   /* wood block: damped resonators at inharmonic modes */
+  SYNTH_MODELS
+} synth_model_t;
+
+/*
+ * sound of a synthesized voice, times in seconds
+ */
+typedef struct synth_params_t {
+  synth_model_t model;
+  double freq;      /* Hz: sine, carrier, band pass center or first mode */
+  double ratio;     /* FM: modulator frequency relative to carrier */
+  double index;     /* FM: modulation index at full envelope */
+  double q;         /* noise: quality of band pass */
+  double attack;    /* linear rise */
+  double decay;     /* exponential fall to -60 dB after attack, 0: none */
+  double release;   /* linear fade at the end */
+  double length;
+  double gain;      /* peak level, 0.0 ... 1.0 of full scale */
+} synth_params_t;
+
+int synth_parse(synth_params_t* params, const char* name);
+int synth_render(const synth_params_t* params, int rate, short** samples,
+                 int fixed_point);
+
+#endif /* SYNTH_H */
@@ -91,6 +91,43 @@ message_type_t comm_client_try_get_reply(comm_t* comm, void** body) {
   }
 }
 
+/*
+ * returns new empty batch of queries, the response to be pushed to <reply>
+ * (referenced until the batch is destroyed)
+ */
+comm_batch_t* comm_batch_new(unsigned int sequence, GAsyncQueue* reply) {
+  comm_batch_t* result;
+
+  result = (comm_batch_t*) g_malloc0(sizeof(comm_batch_t));
+  result->sequence = sequence;
+  result->reply = reply;
+  if (reply)
+    g_async_queue_ref(reply);
+
+  return result;
+}
+
+/*
+ * destructor for batches: the message bodies are destroyed by the server
+ */
+void comm_batch_delete(comm_batch_t* batch) {
+  if (batch->reply)
+    g_async_queue_unref(batch->reply);
+  free(batch->messages);
+  free(batch);
+}
+
+/*
+ * appends query to <batch> with separately allocated body
+ */
+void comm_batch_add(comm_batch_t* batch, message_type_t type, void* body) {
+  batch->messages = (message_t*) g_realloc(batch->messages,
+                                           (batch->n + 1) * sizeof(message_t));
+  batch->messages[batch->n].type = type;
+  batch->messages[batch->n].body = body;
+  batch->n++;
+}
+
 /*
  * register server at comm object (by increasing reference count)
  */
@@ -52,10 +52,29 @@ enum message_type_t {
   MESSAGE_TYPE_STOP_SYNC,
   MESSAGE_TYPE_SET_VOLUME,      /* param: double*: volume 0.0 ... 1.0 */
   MESSAGE_TYPE_GET_VOLUME,      /* response needed: double*: volume 0.0...1.0 */
+  MESSAGE_TYPE_SET_PARAMS,      /* param: dsp_params_t*: complete parameters */
+  MESSAGE_TYPE_SET_TIMELINE,    /* param: timeline_t*: setlist, NULL: none */
+  MESSAGE_TYPE_SEEK_BAR,        /* param: int*: bar of timeline (from 0) */
+  MESSAGE_TYPE_SET_MIDICLOCK,   /* param: midiclock_t*: MIDI clock, NULL: none*/
+  MESSAGE_TYPE_SET_MASTER,      /* param: midiclock_t*: clock input followed,
+                                   NULL: none */
+  MESSAGE_TYPE_SET_NETSYNC,     /* param: netsync_t*: LAN beat sync,
+                                   NULL: none */
+  MESSAGE_TYPE_SET_BEATSHM,     /* param: beatshm_t*: beat position export,
+                                   NULL: none */
+  MESSAGE_TYPE_BATCH,           /* param: comm_batch_t*: queries applied at
+                                   once, response to batch->reply */
+  MESSAGE_TYPE_SET_CHANNEL_MAP, /* param: dsp_channel_map_t*: NULL: none */
+  MESSAGE_TYPE_SET_FANOUT,      /* param: fanout_t*: further sinks of the
+                                   output, NULL: none */
+  MESSAGE_TYPE_SET_BACKING,     /* param: backing_t*: backing track,
+                                   NULL: none */
 
   MESSAGE_TYPE_RESPONSE_VOLUME, /* param: int*: volume 0 ... 100 */
   MESSAGE_TYPE_RESPONSE_SYNC,   /* param: unsigned int*: position in meter*/
-  MESSAGE_TYPE_RESPONSE_START_ERROR
+  MESSAGE_TYPE_RESPONSE_START_ERROR,
+  MESSAGE_TYPE_RESPONSE_LOCK,   /* param: dsp_lock_t*: following master */
+  MESSAGE_TYPE_RESPONSE_STATUS  /* param: dsp_status_t*: after batch */
 };
 typedef enum message_type_t message_type_t;
 
@@ -64,12 +83,27 @@ typedef struct message_t {
   void* body;
 } message_t;
 
+/*
+ * queries handled by the server in one go, e.g. between two fragments of
+ * the audio thread
+ */
+typedef struct comm_batch_t {
+  int n;                 /* number of messages */
+  message_t* messages;
+  unsigned int sequence; /* returned with the response */
+  GAsyncQueue* reply;    /* receives the response (e.g. status) */
+} comm_batch_t;
+
 comm_t* comm_new(void);
 void comm_delete(comm_t* comm);
 
 void comm_client_query(comm_t* comm, message_type_t type, void* body);
 message_type_t comm_client_try_get_reply(comm_t* comm, void** body);
 
+comm_batch_t* comm_batch_new(unsigned int sequence, GAsyncQueue* reply);
+void comm_batch_delete(comm_batch_t* batch);
+void comm_batch_add(comm_batch_t* batch, message_type_t type, void* body);
+
 void comm_server_register(comm_t* comm);
 void comm_server_unregister(comm_t* comm);
 message_type_t comm_server_try_get_query(comm_t* comm, void** body);
@@ -3,7 +3,9 @@
 /* It contains samples in signed 16 bit format.             */
 /*                                                          */
 
-static short tickdata[] = {
+#define TICKDATA_RATE 44100
+
+static const short tickdata[] = {
   -797,   -639,   -557,   -529,   -482,   -460,   -425,   -315,
   -132,    -81,     -4,   -120,    -25,   -155,    150,   -276,
    475,   -561,    416,  -2478,   8908,  18230,  17342,  -2167,
@@ -125,3 +127,1939 @@ static short tickdata[] = {
    228,  -1892,  -4203,  -3861,   -543,   3158,   4323,   3841,
   3103,   1712,   1386,   2309
 };
+
+static const short tickdata_44100_normal[] = {
+  -797,   -639,   -557,   -529,   -482,   -460,   -425,   -315,
+  -132,    -81,     -4,   -120,    -25,   -155,    150,   -276,
+   475,   -561,    416,  -2478,   8908,  18230,  17342,  -2167,
+-29424, -13059,  14064,  12602,   6970,   6932, -24796, -26810,
+-21127, -15492,  -9666, -14682, -14039,  -7338,  15007,  29094,
+ 16561,  -4309,   9753,  20109,  13018,  11624, -16900, -27585,
+-18805,  -3348,  24024,  17656,   2714, -21286, -17125,  16446,
+ 20472,  10483, -16321, -30005, -17898,  -3527,  19914,   4675,
+-22829, -21715,   -785,  27069,  15929,  16302,  -2337, -30194,
+-21854, -12154, -11071, -14719, -13200,  -9215, -11669,  -1756,
+ 12320,  14969,  27587,  24769,  17421,  19490,  -3607, -27850,
+-14892,   5455,  27474,   2405, -23848, -13375, -12188,    344,
+ 27071,  21639, -10367, -15136,  16242,  29537,  20748,  17401,
+ 15634,  -1315,   -795,  19343,  -9089, -26785, -19274, -15246,
+-13906,  -2567,  10527,   -529,  10856,  29070,  18026,  18268,
+  8219, -20183, -24116,  -8604,  16538,  13528, -11722,  -2146,
+ 20296,  19711,  14071,  13919,   6505, -10486, -22309, -24611,
+-18950, -15703, -14666, -11046, -12765,  -4207,   9649,  14080,
+ 27260,  22691,  18391,  16327,   5434, -14055, -23111, -16528,
+-11830, -10525,    354,  14298,   6210,   4998,  17145,  18222,
+  4902,   1170,  -6127,  -6226,  -3748,  -8025,   1738,  13523,
+ 25258,  19044,  16460,  20732,    507, -13914, -15061,    699,
+ 15568,  13859,  22501,  18926,  15934,   5472,  -3044,  -9665,
+-21021, -18376, -15022, -12717,  -8347,  14142,  29615,  23005,
+ 18123,  17061,  12800,   1075,  -2778,  -7691, -11425,   4204,
+ 16185,  15801,  11825,   9502,   7710,   4852, -12899, -31714,
+-27476, -22530, -19284, -17237,  -9321,   3519,   9761,  17026,
+ 18594,  13512,  12203,   7109,  -7382, -21524, -25841, -21746,
+-14354,   5711,  21421,   7995,   4620,  11546,  10886,   5297,
+-22378, -30571, -14880, -17277,  -9215,   3423,   3986,   3679,
+ -8697,   6414,  14569,  -2887, -15842, -13024,  -1163,  -2471,
+ -4203, -13635, -21955,  -1176,  25496,   7001, -16123, -25731,
+-14452,   8305,  19602,   1231, -29050, -15845,  10417,  23236,
+ 12545,  -5446, -17571, -26365,  -6906,  10486,  -7594, -20301,
+-17864,  -5814,  17299,  23865,  17790,  11336,  -2990,  -7286,
+-11665, -22040, -20367, -16423,  -7857,   5291,  13640,   6275,
+  6463,  14906,  11494,  15199,  -6194, -32201, -21265, -19886,
+ -9451,  20525,  21074,   8406,   3156,    673,   1443,   9382,
+ -1216, -25426, -27239, -19246, -19706,  -1388,  24578,  18675,
+ 13229,  10714,   8521,   6925,   4701,  -7354, -19748, -26365,
+-15524,   3118,  -1796,  -8439,  -8508,  -1499,   6937,   7188,
+-10132, -30616, -24760, -15722, -19267, -26276, -21439, -20733,
+-13101,  14976,  20590,  12637,   7038,   -901,   -957,  -4741,
+-22585, -31115, -23863, -20928, -18895, -17028, -15365,  -5212,
+ 13459,  18988,  16864,  12695,    535,  -3016,  -5280, -10625,
+   811,  13943,  11199,   8051,   3361,  -3959, -15820, -29601,
+-29381, -25897, -22763, -20808, -17045,  -3418,   3017,   9944,
+ 18206,  11967,   9446,  -4918, -20001, -15722, -15433, -18025,
+ -7452,   7679,  10424,  11477,   5382,  -9855, -24436, -22466,
+ -3183,   3935,  -2102, -14359, -24045, -10054,  11877,  10086,
+  5768, -12011, -32767, -30502, -20690, -18481, -19841, -13674,
+   633,  10184,   8615,   4989,    771,  -4988, -14042, -23609,
+-27009, -23069, -19998, -17608,  -8453,   -937,   1763,      0,
+  3568,  16884,  16031,  10374,  -1450, -11782,  -9028,  -9531,
+-10833,  -5478,   1139,  -1295, -12480, -16475,  -8164,   2814,
+   917, -12454, -22043, -24332, -15040,    667,   9901,   3257,
+ -7804,  -4319,   8831,  12883,   1919, -18604, -25661, -14796,
+   881,   5345,  -1836,  -3816,  -2975,  -1595,  -7848, -13762,
+-14042, -10977,  -3254,   6882,  12287,  12019,  13258,  11638,
+  8532,   7161,   3784, -16270, -32452, -28372, -23881, -20479,
+-19467, -15751,  -8337,   6426,  21644,  18111,  12433,   1174,
+-14201, -19581, -21332, -18972, -14804, -12883,  -8053,   1602,
+ 15534,  18559,  12480,   9796,  10228,   6332,    199,  -2706,
+ -5262,  -5496,  -5784,  -9730, -10337,  -4319,  -1578,  -4860,
+ -6942,  -7144,  -6187,   -327,   3905,   4421,   1686,  -6731,
+-15271, -15754,  -8512,   -851,     71,  -3706,  -3790,   1368,
+  9652,  13018,   8510,    851,  -3583,  -4957,  -7247,  -9405,
+-11600, -11669,  -4469,   3887,   3957,    543,    763,   4603,
+  3894,   -159,  -4191,  -6778,  -4180,  -2351,  -7998, -13560,
+-15807, -13301,  -6639,  -2456,   4255,  10216,  13831,  14439,
+ 13891,  10883,    987,  -7275,  -6940,  -4351,  -3596,  -1260,
+ -1156,  -1099,   3679,   9158,  11184,   9867,   6172,   3184,
+  2936,  -1339,  -9927, -12893,  -4143,   7006,   9046,   4929,
+  1514,   1708,   3023,   2098,   -941,  -2834,  -5807, -11158,
+-13557, -11005,  -4716,   -839,  -4956,  -7554,  -6816,  -6430,
+ -3191,  -1507,  -2388,  -4376,  -4042,    492,   7386,  12808,
+ 15995,  14248,   8523,   5048,   3674,   -108,  -4071,  -2740,
+  -797,  -1447,  -5055,  -8862,  -6751,  -1086,   2301,    779,
+ -3354,  -4283,    -76,   4025,   4820,   4065,   4164,   5618,
+  9511,  15008,  14748,   8747,    182,  -6270,  -6515,  -4614,
+ -3583,  -2388,   -893,  -2450,  -2881,   2384,   9124,  12636,
+  8320,   -108,  -5541,  -4978,  -2239,  -1875,  -2085,   -436,
+  4223,   9582,  12789,  10239,   3502,  -2584,  -3879,  -2288,
+ -4044,  -8260,  -9620,  -5704,  -1826,    767,   1130,   -467,
+ -3450,  -5869,  -5114,  -3999,  -1991,    -46,   3071,  12288,
+ 18972,  17770,  17545,  13247,   8561,   6489,   2220,  -1843,
+-10168, -16995, -14812, -11779,  -5509,   1059,   1011,    -81,
+  2221,   8074,  11137,   9451,   6251,   4564,   4175,   1899,
+    76,   2578,   5468,   6720,   6184,   2948,   1487,   3551,
+  4270,   3510,   3726,    803,  -4198,  -5952,  -3849,  -1470,
+   607,   2471,    657,  -1095,   1819,   4095,   4039,   5065,
+  4692,   3493,   4031,   4853,   2444,  -1767,  -2998,  -3318,
+ -2742,    406,   2868,    849,  -1776,    447,   3937,   4709,
+  3077,   -897,  -3250,    329,   4261,   3487,   1778,   2301,
+  3162,   3428,   2866,    553,  -1055,   -312,   -236,  -1712,
+ -3879,  -4564,  -1406,   1879,   2967,   2772,   1796,   1950,
+  3720,   7492,   9449,   8556,   7539,   6207,   5999,   6989,
+  6844,   3265,   -863,  -2444,   -681,   1051,    192,   -673,
+ -1631,  -2173,  -1924,  -2384,  -3615,  -3775,  -3190,  -2416,
+   351,   3943,   6547,   7141,   5309,   4457,   4929,   4230,
+  2343,   1088,   -484,  -2924,  -4116,  -3824,  -2463,  -1618,
+   351,   2879,   2317,    -51,   -504,   1366,   2913,   4257,
+  4641,   3375,   1724,   1591,   2834,   5176,   7307,   5957,
+  3319,   2574,   2847,   1275,  -2497,  -7368,  -9997,  -8713,
+ -6522,  -4014,  -1223,   1954,   4888,   7219,   9163,  10185,
+ 11606,  12284,  10324,   6089,   1351,  -1950,  -2377,     19,
+  1571,    829,  -1628,  -3769,  -4040,  -1871,   -367,  -1595,
+ -3478,  -4159,  -2119,    450,   1936,   1963,   2223,   2847,
+  3359,   4611,   6479,   5997,   1740,  -1499,  -2450,  -1956,
+  -741,  -1708,  -4873,  -5146,  -2565,   -577,   1986,   4050,
+  4012,   3446,   2256,   1191,   1964,   3252,   4238,   5978,
+  7691,   5914,   2106,    -44,    901,   2981,   2672,   -349,
+ -3927,  -4539,  -2384,    807,   2760,   2711,   1227,    135,
+   268,    -32,   -229,   -450,   -573,    484,   2369,   2855,
+  2839,   3897,   4095,   2546,   1110,    300,  -1051,  -2142,
+ -1668,   -635,   -238,   -285,   -233,   1287,   3335,   4238,
+  4057,   3741,   3694,   2482,   -404,  -2087,  -1483,     25,
+  1499,     63,  -3191,  -5104,  -5468,  -4899,  -3049,   -324,
+   228,  -1892,  -4203,  -3861,   -543,   3158,   4323,   3841,
+  3103,   1712,   1386,   2309
+};
+
+static const short tickdata_44100_accent[] = {
+     0,      0,      0,      0,      0,      0,      0,      0,
+     0,   -718,   -543,   -471,   -370,   -106,    -62,    -90,
+   -63,    -43,  -1031,  13569,   7587, -21241,  13333,   6951,
+-25803, -18309, -12174, -10688,  22050,   6126,  14931,  12321,
+-22242, -11076,  20840,  -9286,   -339,  15477, -23163, -10712,
+ 12294, -22272,  13142,  16115, -16265, -17004, -12895, -11207,
+ -6712,  13644,  26178,  18455, -15728,  -4718,  14939, -18611,
+ -5922,  24355, -12751,  22889,  19074,   7159,   9274, -17937,
+-17260,  -8236,   4999,  19963,  18147,  -5982, -16360,  15033,
+ -6934,  20003,  13995,  -1990, -23460, -17326, -12856,  -8486,
+ 11864,  24975,  17359,  -4310, -19819, -11177,   7326,   5604,
+ 17683,   3036,  -6176,  -5886,   7630,  22151,  18596,  -6703,
+ -7181,  14713,  20713,  10703,  -6354, -19698, -13869,   2897,
+ 26310,  17592,   6937,  -5234,  -3610,  15993,  10663,   6281,
+-22306, -25003, -18260,  -2901,  13393,  16053,   9656, -14453,
+-23793,  -4321,  14708,   8083,   8091, -26474, -16078,  -2896,
+  3832,  -1141,   5841, -14433,  -1817,  -8919, -11565,  16248,
+-20927,  -3073,  10416, -22447,  16826,   3549, -21968,   1790,
+-13947, -11839,  20582,  14563,  -5138, -16852, -18395,  -1283,
+  9957,  10684,  13346, -19197, -20575,   5537,  14740,   1914,
+  5412, -13321, -23242, -10547,  21626,  11971,   7723,  -1326,
+-23056,  -6203,  -5117,  -5003,   7062, -20374, -20241, -22771,
+-21086,    937,  16613,   3068,  -2849, -26850, -22395, -17961,
+-10288,  16223,  14779,  -1240,  -7952,   7377,   9625,   -299,
+-22710, -27639, -21785, -10231,   6480,  15086,   2264, -17861,
+-16729,    113,  10950,  -2236, -23451,    376,  -8230, -17049,
+ 10981,  -3121, -31634, -19585, -16757,   5408,   6802,  -2108,
+-18825, -25039, -18803,  -4695,    881,  10226,  13202,  -6616,
+ -9279,  -8155,    -78, -14477,  -2675,  -5768, -23187,  -7186,
+  6579,  -6061,  10857,  -8342, -20228,   3113,  -2826,  -2285,
+-10805, -12509,   1814,  12153,  12448,   7846,  -6243, -30412,
+-22180, -17609,   -955,  19877,   6803, -16891, -20152, -13843,
+ -3225,  17046,  11138,   8280,  -1253,  -5379,  -7757,  -7328,
+ -3219,  -7043,  -3257,   4163,  -2522, -15512,  -4681,  -1817,
+ -1211,  11335,   4680,  -4270,  -8326, -11634,   -291,   2250,
+  2683,   1867,  -5484,  -3265, -10779, -14554,  -4547,   7235,
+ 14135,  12387,  -3144,  -5645,  -2428,  -1127,   6418,  10525,
+  4678,    798, -11410,   1431,   6987,   1611,   2560,  -1887,
+ -8482, -12281,  -2777,  -6255,  -6623,  -2349,  -3382,  -1775,
+ 10097,  15121,   6785,   1783,  -3405,  -1122,  -6958,  -3918,
+  1540,  -3818,   1974,   4442,   4891,  12259,  11747,  -3044,
+ -5564,  -2985,  -1671,   -248,  10880,   4106,  -5259,  -2057,
+ -1260,   6902,  11514,    459,  -3083,  -6152,  -7662,   -529,
+   331,  -4659,  -4556,  -1018,   7679,  18371,  15396,   7525,
+   188, -13581, -13295,  -2225,    465,   5147,  10294,   5407,
+  3037,   1327,   6094,   4566,   2519,   3890,   2264,  -5075,
+ -2659,   1539,   -219,   2957,   4552,   4092,   4442,    338,
+ -3158,  -1168,   1858,   -664,   4323,   1090,  -1460,   3874,
+  2039,   3295,   1709,   -683,   -974,  -4221,    236,   2869,
+  1873,   5606,   9002,   6873,   6494,   5054,  -1653,    185,
+  -240,  -1902,  -2154,  -3695,  -2803,   2147,   6844,   4883,
+  4579,   1715,  -1704,  -3970,  -2040,   1615,   1133,    431,
+  3585,   4008,   1657,   4005,   6632,   2946,   2061,  -4932,
+ -9355,  -5268,    365,   6053,   9674,  11945,   8206,   -299,
+ -1179,   1200,  -2698,  -2955,   -981,  -3818,   -834,   1949,
+  2535,   3985,   6238,    120,  -2203,  -1224,  -5009,  -1571,
+  3018,   3729,   1723,   2608,   5108,   6802,   1031,   1941,
+  1161,  -4233,   -788,   2735,    681,    118,   -339,    -44,
+  2612,   3368,   3320,    705,  -1596,  -1151,   -261,    527,
+  3786,   3899,   3088,  -1245,   -729,    781,  -4147,  -5183,
+ -1686,   -832,  -4032,   1307,   4082,   2407,   1847
+};
+
+static const short tickdata_44100_secondary[] = {
+  -398,   -319,   -278,   -264,   -241,   -230,   -212,   -157,
+   -66,    -40,     -2,    -60,    -12,    -77,     75,   -138,
+   237,   -280,    208,  -1239,   4454,   9115,   8671,  -1083,
+-14712,  -6529,   7032,   6301,   3485,   3466, -12398, -13405,
+-10563,  -7746,  -4833,  -7341,  -7019,  -3669,   7503,  14547,
+  8280,  -2154,   4876,  10054,   6509,   5812,  -8450, -13792,
+ -9402,  -1674,  12012,   8828,   1357, -10643,  -8562,   8223,
+ 10236,   5241,  -8160, -15002,  -8949,  -1763,   9957,   2337,
+-11414, -10857,   -392,  13534,   7964,   8151,  -1168, -15097,
+-10927,  -6077,  -5535,  -7359,  -6600,  -4607,  -5834,   -878,
+  6160,   7484,  13793,  12384,   8710,   9745,  -1803, -13925,
+ -7446,   2727,  13737,   1202, -11924,  -6687,  -6094,    172,
+ 13535,  10819,  -5183,  -7568,   8121,  14768,  10374,   8700,
+  7817,   -657,   -397,   9671,  -4544, -13392,  -9637,  -7623,
+ -6953,  -1283,   5263,   -264,   5428,  14535,   9013,   9134,
+  4109, -10091, -12058,  -4302,   8269,   6764,  -5861,  -1073,
+ 10148,   9855,   7035,   6959,   3252,  -5243, -11154, -12305,
+ -9475,  -7851,  -7333,  -5523,  -6382,  -2103,   4824,   7040,
+ 13630,  11345,   9195,   8163,   2717,  -7027, -11555,  -8264,
+ -5915,  -5262,    177,   7149,   3105,   2499,   8572,   9111,
+  2451,    585,  -3063,  -3113,  -1874,  -4012,    869,   6761,
+ 12629,   9522,   8230,  10366,    253,  -6957,  -7530,    349,
+  7784,   6929,  11250,   9463,   7967,   2736,  -1522,  -4832,
+-10510,  -9188,  -7511,  -6358,  -4173,   7071,  14807,  11502,
+  9061,   8530,   6400,    537,  -1389,  -3845,  -5712,   2102,
+  8092,   7900,   5912,   4751,   3855,   2426,  -6449, -15857,
+-13738, -11265,  -9642,  -8618,  -4660,   1759,   4880,   8513,
+  9297,   6756,   6101,   3554,  -3691, -10762, -12920, -10873,
+ -7177,   2855,  10710,   3997,   2310,   5773,   5443,   2648,
+-11189, -15285,  -7440,  -8638,  -4607,   1711,   1993,   1839,
+ -4348,   3207,   7284,  -1443,  -7921,  -6512,   -581,  -1235,
+ -2101,  -6817, -10977,   -588,  12748,   3500,  -8061, -12865,
+ -7226,   4152,   9801,    615, -14525,  -7922,   5208,  11618,
+  6272,  -2723,  -8785, -13182,  -3453,   5243,  -3797, -10150,
+ -8932,  -2907,   8649,  11932,   8895,   5668,  -1495,  -3643,
+ -5832, -11020, -10183,  -8211,  -3928,   2645,   6820,   3137,
+  3231,   7453,   5747,   7599,  -3097, -16100, -10632,  -9943,
+ -4725,  10262,  10537,   4203,   1578,    336,    721,   4691,
+  -608, -12713, -13619,  -9623,  -9853,   -694,  12289,   9337,
+  6614,   5357,   4260,   3462,   2350,  -3677,  -9874, -13182,
+ -7762,   1559,   -898,  -4219,  -4254,   -749,   3468,   3594,
+ -5066, -15308, -12380,  -7861,  -9633, -13138, -10719, -10366,
+ -6550,   7488,  10295,   6318,   3519,   -450,   -478,  -2370,
+-11292, -15557, -11931, -10464,  -9447,  -8514,  -7682,  -2606,
+  6729,   9494,   8432,   6347,    267,  -1508,  -2640,  -5312,
+   405,   6971,   5599,   4025,   1680,  -1979,  -7910, -14800,
+-14690, -12948, -11381, -10404,  -8522,  -1709,   1508,   4972,
+  9103,   5983,   4723,  -2459, -10000,  -7861,  -7716,  -9012,
+ -3726,   3839,   5212,   5738,   2691,  -4927, -12218, -11233,
+ -1591,   1967,  -1051,  -7179, -12022,  -5027,   5938,   5043,
+  2884,  -6005, -16383, -15251, -10345,  -9240,  -9920,  -6837,
+   316,   5092,   4307,   2494,    385,  -2494,  -7021, -11804,
+-13504, -11534,  -9999,  -8804,  -4226,   -468,    881,      0,
+  1784,   8442,   8015,   5187,   -725,  -5891,  -4514,  -4765,
+ -5416,  -2739,    569,   -647,  -6240,  -8237,  -4082,   1407,
+   458,  -6227, -11021, -12166,  -7520,    333,   4950,   1628,
+ -3902,  -2159,   4415,   6441,    959,  -9302, -12830,  -7398,
+   440,   2672,   -918,  -1908,  -1487,   -797,  -3924,  -6881,
+ -7021,  -5488,  -1627,   3441,   6143,   6009,   6629,   5819,
+  4266,   3580,   1892,  -8135, -16226, -14186, -11940, -10239,
+ -9733,  -7875,  -4168,   3213,  10822,   9055,   6216,    587,
+ -7100,  -9790, -10666,  -9486,  -7402,  -6441,  -4026,    801,
+  7767,   9279,   6240,   4898,   5114,   3166,     99,  -1353,
+ -2631,  -2748,  -2892,  -4865,  -5168,  -2159,   -789,  -2430,
+ -3471,  -3572,  -3093,   -163,   1952,   2210,    843,  -3365,
+ -7635,  -7877,  -4256,   -425,     35,  -1853,  -1895,    684,
+  4826,   6509,   4255,    425,  -1791,  -2478,  -3623,  -4702,
+ -5800,  -5834,  -2234,   1943,   1978,    271,    381,   2301,
+  1947,    -79,  -2095,  -3389,  -2090,  -1175,  -3999,  -6780,
+ -7903,  -6650,  -3319,  -1228,   2127,   5108,   6915,   7219,
+  6945,   5441,    493,  -3637,  -3470,  -2175,  -1798,   -630,
+  -578,   -549,   1839,   4579,   5592,   4933,   3086,   1592,
+  1468,   -669,  -4963,  -6446,  -2071,   3503,   4523,   2464,
+   757,    854,   1511,   1049,   -470,  -1417,  -2903,  -5579,
+ -6778,  -5502,  -2358,   -419,  -2478,  -3777,  -3408,  -3215,
+ -1595,   -753,  -1194,  -2188,  -2021,    246,   3693,   6404,
+  7997,   7124,   4261,   2524,   1837,    -54,  -2035,  -1370,
+  -398,   -723,  -2527,  -4431,  -3375,   -543,   1150,    389,
+ -1677,  -2141,    -38,   2012,   2410,   2032,   2082,   2809,
+  4755,   7504,   7374,   4373,     91,  -3135,  -3257,  -2307,
+ -1791,  -1194,   -446,  -1225,  -1440,   1192,   4562,   6318,
+  4160,    -54,  -2770,  -2489,  -1119,   -937,  -1042,   -218,
+  2111,   4791,   6394,   5119,   1751,  -1292,  -1939,  -1144,
+ -2022,  -4130,  -4810,  -2852,   -913,    383,    565,   -233,
+ -1725,  -2934,  -2557,  -1999,   -995,    -23,   1535,   6144,
+  9486,   8885,   8772,   6623,   4280,   3244,   1110,   -921,
+ -5084,  -8497,  -7406,  -5889,  -2754,    529,    505,    -40,
+  1110,   4037,   5568,   4725,   3125,   2282,   2087,    949,
+    38,   1289,   2734,   3360,   3092,   1474,    743,   1775,
+  2135,   1755,   1863,    401,  -2099,  -2976,  -1924,   -735,
+   303,   1235,    328,   -547,    909,   2047,   2019,   2532,
+  2346,   1746,   2015,   2426,   1222,   -883,  -1499,  -1659,
+ -1371,    203,   1434,    424,   -888,    223,   1968,   2354,
+  1538,   -448,  -1625,    164,   2130,   1743,    889,   1150,
+  1581,   1714,   1433,    276,   -527,   -156,   -118,   -856,
+ -1939,  -2282,   -703,    939,   1483,   1386,    898,    975,
+  1860,   3746,   4724,   4278,   3769,   3103,   2999,   3494,
+  3422,   1632,   -431,  -1222,   -340,    525,     96,   -336,
+  -815,  -1086,   -962,  -1192,  -1807,  -1887,  -1595,  -1208,
+   175,   1971,   3273,   3570,   2654,   2228,   2464,   2115,
+  1171,    544,   -242,  -1462,  -2058,  -1912,  -1231,   -809,
+   175,   1439,   1158,    -25,   -252,    683,   1456,   2128,
+  2320,   1687,    862,    795,   1417,   2588,   3653,   2978,
+  1659,   1287,   1423,    637,  -1248,  -3684,  -4998,  -4356,
+ -3261,  -2007,   -611,    977,   2444,   3609,   4581,   5092,
+  5803,   6142,   5162,   3044,    675,   -975,  -1188,      9,
+   785,    414,   -814,  -1884,  -2020,   -935,   -183,   -797,
+ -1739,  -2079,  -1059,    225,    968,    981,   1111,   1423,
+  1679,   2305,   3239,   2998,    870,   -749,  -1225,   -978,
+  -370,   -854,  -2436,  -2573,  -1282,   -288,    993,   2025,
+  2006,   1723,   1128,    595,    982,   1626,   2119,   2989,
+  3845,   2957,   1053,    -22,    450,   1490,   1336,   -174,
+ -1963,  -2269,  -1192,    403,   1380,   1355,    613,     67,
+   134,    -16,   -114,   -225,   -286,    242,   1184,   1427,
+  1419,   1948,   2047,   1273,    555,    150,   -525,  -1071,
+  -834,   -317,   -119,   -142,   -116,    643,   1667,   2119,
+  2028,   1870,   1847,   1241,   -202,  -1043,   -741,     12,
+   749,     31,  -1595,  -2552,  -2734,  -2449,  -1524,   -162,
+   114,   -946,  -2101,  -1930,   -271,   1579,   2161,   1920,
+  1551,    856,    693,   1154
+};
+
+static const short tickdata_48000_normal[] = {
+  -797,   -651,   -570,   -535,   -497,   -468,   -442,   -377,
+  -250,   -118,    -66,    -16,   -117,    -30,   -137,     83,
+  -148,    188,    -81,   -115,   -669,    866,  10888,  18113,
+ 16366,  -1557, -26357, -16229,   6605,  13122,   9433,   6951,
+ -5759, -25437, -25460, -20246, -15055,  -9702, -14243, -14147,
+ -9013,   7605,  23283,  22749,   7691,    524,  12471,  18823,
+ 12878,  11089, -15117, -26049, -20780,  -8081,  13417,  20640,
+ 10932,  -6135, -20089, -10200,  16949,  20034,  10857, -13138,
+-27268, -21303,  -8736,   9512,  12675,  -6154, -22480, -16874,
+  3393,  26303,  16068,  16267,    924, -23055, -24668, -16215,
+-11612, -12598, -14206, -12178,  -9644, -10739,  -1580,  11352,
+ 14571,  24669,  25649,  20314,  18507,   9240, -12395, -24205,
+-10822,   8069,  26533,   3501, -20566, -15535, -12529,  -4277,
+ 15043,  24524,   9236, -11827,  -8075,  18153,  28987,  20912,
+ 17735,  15954,   3134,   -973,  10784,   5304, -16388, -24296,
+-18266, -15019, -12913,  -2485,   9544,   1198,   8152,  23264,
+ 22443,  18151,  13871,  -1899, -21264, -21110,  -5775,  16443,
+ 13678,  -8407,  -4180,  13703,  19930,  16644,  14000,  11092,
+  1407, -13072, -22625, -24292, -19091, -16047, -14860, -12018,
+-12163,  -7897,   2547,  11449,  18363,  26146,  21992,  18223,
+ 16326,   6319, -10888, -20903, -18667, -13738, -11161,  -5833,
+  5234,  12124,   5982,   6288,  17171,  18161,   6733,   1986,
+ -3937,  -6188,  -4894,  -5699,  -4363,   5199,  16016,  24442,
+ 18914,  16540,  20251,   4425,  -9948, -14652,  -6195,   7854,
+ 14884,  16613,  21651,  18458,  15149,   5537,  -2298,  -8547,
+-18181, -19252, -16405, -13855, -10859,   -616,  18203,  28416,
+ 22516,  18103,  17127,  13412,   3713,  -1598,  -5787,  -9674,
+ -4391,   8621,  16074,  14980,  11534,   9423,   7777,   5191,
+ -9348, -26422, -29012, -24724, -20988, -18477, -14763,  -6351,
+  4455,  10260,  16935,  18446,  14401,  12538,   8828,  -1313,
+-14452, -23331, -24458, -19851, -10842,   7183,  21253,   8918,
+  5126,   9944,  11092,   7497,  -9232, -26013, -24883, -15554,
+-15664,  -7714,   3444,   3961,   3717,  -6144,   2069,  11561,
+  4968,  -8959, -14750,  -9391,  -1457,  -2719,  -4792, -13458,
+-21123,  -4942,  18494,  13358,  -6295, -20866, -21078,  -6913,
+ 11129,  16501,  -1418, -28967, -16835,   6313,  20191,  15952,
+  1750, -11735, -21418, -19432,  -2123,   6983,  -9023, -20224,
+-17985,  -7395,  12387,  21936,  20068,  14280,   4710,  -4627,
+ -8599, -13934, -21809, -20145, -16521,  -8767,   2825,  11396,
+  8852,   6381,  10578,  13519,  12698,   9984, -10420, -31312,
+-21264, -19998, -11146,  13218,  20895,  13552,   5715,   2085,
+   942,   3576,   7394,  -3788, -25471, -27137, -20345, -19605,
+ -6883,  14678,  21405,  16190,  12285,  10069,   8181,   6633,
+  4098,  -6977, -18353, -25082, -18505,  -3523,    353,  -4992,
+ -8466,  -6273,    504,   6976,   5889, -10023, -28823, -25748,
+-17981, -18092, -23384, -23827, -21138, -18109,  -5730,  15993,
+ 19794,  12532,   7387,    240,   -944,  -3582, -15670, -27116,
+-27851, -22780, -20343, -18509, -16820, -14920,  -5592,  11241,
+ 17882,  17461,  14206,   5931,  -1151,  -3907,  -6950,  -7980,
+  2780,  13754,  11233,   8346,   4181,  -2083, -11816, -23830,
+-29490, -27922, -24839, -22262, -20149, -15767,  -3337,   2574,
+  8904,  16295,  13916,  10438,   1904, -11611, -18449, -15640,
+-15951, -16769,  -6884,   7017,  10080,  11259,   7134,  -4236,
+-17874, -23512, -14993,  -1003,   2576,  -3863, -14964, -23863,
+-11453,   7902,  10556,   7252,  -4454, -22259, -31832, -27251,
+-20137, -18710, -19301, -13584,   -440,   8691,   8987,   6144,
+  2458,  -2216,  -8949, -17450, -24543, -26245, -22723, -19923,
+-17727,  -9654,  -2534,    969,    661,   1940,   9726,  16558,
+ 14333,   7787,  -2870, -11627,  -9096,  -9477, -10588,  -6917,
+ -1176,   -245,  -6747, -14102, -13773,  -5488,   2505,   -169,
+-12453, -21263, -23960, -17304,  -4437,   6149,   6495,  -1513,
+ -6584,   -784,   9590,  11718,   1405, -17449, -24690, -17172,
+ -3822,   3643,   1485,  -2739,  -3500,  -2569,  -2923,  -8624,
+-13776, -14033, -11321,  -4750,   4094,  10361,  12136,  12615,
+ 12609,  10647,   8206,   6633,   2279, -16144, -31036, -29060,
+-25003, -21605, -19884, -17585, -12600,  -3262,  10420,  21003,
+ 17543,  12221,   1877, -11990, -18370, -20795, -19886, -16757,
+-13939, -11101,  -5277,   4475,  15912,  18293,  12707,  10114,
+ 10141,   7427,   2422,  -1416,  -3920,  -5354,  -5585,  -6696,
+ -9821,  -9923,  -4394,  -1834,  -4285,  -6408,  -7075,  -6587,
+ -3256,   1445,   4079,   3720,    213,  -7531, -15277, -15720,
+ -9598,  -2622,   -217,  -2218,  -3750,  -1501,   4370,  10598,
+ 12116,   7600,    684,  -3389,  -4785,  -6774,  -8784, -10790,
+-11637,  -8293,  -1231,   3908,   3188,    574,   1002,   4530,
+  3964,    575,  -3132,  -5888,  -5284,  -3276,  -4680,  -9840,
+-14121, -15384, -12718,  -6612,  -2769,   3206,   8800,  12678,
+ 14195,  14154,  12574,   7357,  -1285,  -7210,  -6648,  -4327,
+ -3633,  -1566,  -1178,  -1115,   1887,   6658,  10095,  10681,
+  8758,   5518,   3149,   2695,  -1232,  -9014, -12336,  -6494,
+  3103,   8166,   7038,   3541,   1577,   2028,   2872,   1851,
+  -940,  -2680,  -5323,  -9853, -12777, -12041,  -7781,  -3044,
+ -2279,  -5654,  -7415,  -6774,  -6349,  -3373,  -1738,  -2195,
+ -3779,  -4169,  -1604,   3637,   9419,  13744,  15623,  13496,
+  8349,   5156,   3828,    624,  -2981,  -3214,  -1647,  -1109,
+ -2890,  -6268,  -8360,  -5865,   -831,   2279,    912,  -2656,
+ -4050,  -1469,   2333,   4427,   4499,   4099,   4545,   6323,
+ 10060,  15003,  14764,   9609,   2109,  -4294,  -6420,  -5505,
+ -4150,  -3142,  -1958,  -1214,  -2503,  -2650,   2186,   8323,
+ 11933,   9533,   2947,  -3130,  -5273,  -3899,  -2125,  -1923,
+ -1837,   -115,   4164,   9079,  12227,  10892,   5775,    -35,
+ -3231,  -3212,  -2880,  -5124,  -8498,  -9252,  -5655,  -2092,
+   378,   1046,     32,  -2275,  -4719,  -5533,  -4709,  -3434,
+ -1602,    324,   3416,  11884,  18136,  18017,  17609,  14831,
+ 10669,   7589,   4834,    975,  -3716, -11149, -16858, -14852,
+-12082,  -6645,   -665,   1027,    383,   1055,   4635,   9088,
+ 10715,   8911,   6103,   4561,   4204,   2254,    508,   1780,
+  4311,   6117,   6485,   5031,   2546,   1886,   3631,   4246,
+  3548,   3697,   1424,  -2728,  -5294,  -4808,  -2748,   -678,
+  1166,   2074,    416,   -931,   1746,   3853,   4049,   4789,
+  4822,   4010,   3755,   4364,   4070,   1417,  -1967,  -3024,
+ -3317,  -2788,   -105,   2267,   1505,   -709,   -636,   1952,
+  4207,   4270,   2331,  -1147,  -3160,    127,   3720,   3656,
+  2290,   2101,   2763,   3283,   3217,   2186,    211,   -957,
+  -308,   -238,  -1545,  -3459,  -4375,  -2531,    441,   2402,
+  2888,   2460,   1832,   2226,   4002,   7468,   9277,   8706,
+  7793,   6648,   6084,   6500,   6927,   5613,   2181,  -1149,
+ -2267,   -648,    942,    315,   -478,  -1337,  -1962,  -2040,
+ -2131,  -2837,  -3661,  -3654,  -3093,  -2294,    247,   3516,
+  6026,   6973,   5973,   4835,   4681,   4653,   3640,   2052,
+   852,   -651,  -2893,  -4004,  -3875,  -2811,  -1903,   -473,
+  1614,   2643,   1517,   -167,   -176,   1511,   2929,   4164,
+  4583,   3667,   2239,   1643,   2243,   3873,   5948,   6927,
+  5429,   3230,   2584,   2835,   1471,  -1719,  -5967,  -9027,
+ -9290,  -7685,  -5550,  -3159,   -508,   2375,   5033,   7175,
+  8968,   9999,  11232,  12050,  11157,   8232,   4134,    257,
+ -2056,  -1972,    154,   1566,    884,  -1244,  -3260,  -3953,
+ -2738,  -1090,   -904,  -2265,  -3665,  -3763,  -1829,    496,
+  1861,   1959,   2167,   2663,   3166,   4039,   5474,   6295,
+  4719,   1031,  -1629,  -2422,  -1968,   -870,  -1526,  -4022,
+ -5050,  -3678,  -1595,    464,   2656,   4040,   3920,   3349,
+  2255,   1277,   1838,   2938,   3917,   5271,   6855,   6924,
+  4581,   1528,    133,   1121,   2973,   2689,     66,  -3144,
+ -4355,  -3205,   -668,   1698,   2741,   2275,    994,    152,
+   253,    -22,   -206,   -407,   -539,    107,   1544,   2602,
+  2848,   3176,   3944,   3852,   2438,   1118,    370,   -823,
+ -1869,  -1825,  -1061,   -434,   -257,   -267,    165,   1658,
+  3425,   4234,   4068,   3786,   3704,   2853,    714,  -1298,
+ -1815,   -926,    448,   1202,   -343,  -3274,  -5032,  -5424,
+ -5012,  -3569,  -1311,    -16,   -778,  -2801,  -4096,  -3093,
+    12,   3238,   4308,   3886,   3232,   2068,   1496,   1922
+};
+
+static const short tickdata_48000_accent[] = {
+     0,      0,      0,      0,      0,      0,      0,      0,
+     0,   -724,   -553,   -483,   -408,   -188,    -47,    -76,
+   -25,     33,    -60,    452,  14148,   7298, -21135,   9521,
+  8301, -14803, -22875, -12770, -14175,   -611,  22575,   4945,
+ 15104,  11006, -20495, -14420,  16473,   2263, -14339,  17985,
+ -1071, -24101,    448,   3074, -19150,  13422,  16172, -11036,
+-20456, -12197, -13134,  -9776,   4770,  19641,  22945,  13428,
+-17298,  -1396,  15087, -17885,  -8304,  19163,   -540,   4371,
+ 25136,  16858,   1281,   7233, -19714, -16737,  -7675,   5331,
+ 15714,  20496,   5631, -20619,   4240,   2676,   4801,  18223,
+ 12400,  -5629, -23175, -17584, -13431,  -9902,   6768,  21741,
+ 20197,  11362, -15788, -16246,  -8330,   8075,   6571,  17498,
+  4431,  -4967,  -5419,    431,  19626,  17893,  12289, -12134,
+   758,  15992,  20085,  10447,  -5392, -18571, -15157,  -5358,
+ 22613,  20465,  15276,   1149,  -7697,   1983,  15428,  10506,
+  6492, -17827, -26874, -19768, -10453,   7370,  17682,  13503,
+  3668, -18659, -22085,  -2044,  15191,   7578,   9246, -17184,
+-20719, -11572,   3685,  -1235,   6697,  -1859, -11868,  -2096,
+ -9059, -12978,  15468, -13292, -13779,  12897, -13485,  -5311,
+ 17863,  -4845, -19792,   1357, -14038, -12712,  16982,  17191,
+   295, -11415, -20905, -12670,   7041,   7733,  11793,  10669,
+-19537, -20636,   1068,  17079,   3968,   2437,   1401, -26185,
+-20024,   3905,  18826,  11194,   7393,  -1403, -21665, -10986,
+ -2329,  -7207,   3463,  -2113, -27205, -18163, -23407, -19475,
+  4378,  16277,   3836,  -2286, -21203, -25431, -19438, -15578,
+  2771,  17611,   9984,  -2491,  -6996,   7680,   9800,   1055,
+-17802, -28646, -23592, -17647,   -401,  12579,  12238,  -4814,
+-17158, -15932,   -199,  10657,   1387, -20371,  -8353,   -812,
+-18704,  -1819,   8890, -13338, -29381, -19537, -16165,   4075,
+  7557,    114, -13178, -25173, -21358, -13708,   -837,   1376,
+ 12809,  10912,  -6759,  -9288,  -8717,   -842, -10248,  -9590,
+   791, -16824, -20582,    729,   2435,  -3454,  10154,  -7794,
+-20861,   -254,   -513,  -3025,  -5740, -13827,  -8040,   7151,
+ 12400,  11600,   7364,  -6727, -29984, -23329, -18699,  -7797,
+ 15113,  14700,  -5012, -19540, -18306, -12467,   -316,  16772,
+ 11426,   8760,    564,  -4582,  -6238,  -9644,  -3126,  -5330,
+ -6817,   -957,   3814,  -3633, -15453,  -6135,  -1269,  -2534,
+  7334,   9774,  -1283,  -5776,  -9780,  -9847,   1114,   2005,
+  2623,   2270,  -4484,  -4301,  -7238, -14604,  -9780,    202,
+ 10701,  14156,   9830,  -3973,  -5562,  -2605,  -1147,   4264,
+ 10313,   7171,   2784,  -5097,  -9350,   5486,   5318,   1831,
+  2294,  -1803,  -7586, -12347,  -5478,  -3914,  -7109,  -4890,
+ -1979,  -3944,   1039,  11508,  14442,   6813,   2228,  -3038,
+ -1426,  -4570,  -7013,    543,   -867,  -2718,   3317,   4320,
+  5500,  12303,  12192,  -1048,  -5932,  -3646,  -1676,  -2375,
+  5233,  10680,    -23,  -4545,  -2041,   -880,   6603,  11524,
+  2901,  -3164,  -4059,  -8697,  -3895,    695,  -1130,  -5063,
+ -4054,   -608,   7574,  18037,  16184,   9189,   2925,  -7356,
+-15839,  -9372,    104,    774,   6778,   9774,   5386,   3231,
+  1181,   5181,   5702,   2322,   3883,   3624,   -653,  -4994,
+ -1728,   1512,    -90,   2790,   4424,   4407,   4063,   2705,
+ -2460,  -3055,   1067,    398,    672,   4175,    659,  -1525,
+  3662,   2223,   3010,   2661,   -293,   -308,  -2498,  -3417,
+  1375,   2657,   2077,   5660,   8984,   7222,   6310,   6196,
+   604,  -1465,    625,   -905,  -1989,  -2498,  -3636,  -2626,
+  1870,   6480,   5422,   4642,   2870,     76,  -3443,  -3340,
+ -1178,   2063,    733,    649,   3536,   4119,   1963,   3073,
+  6344,   4399,   2677,   -122,  -7459,  -8478,  -4357,    914,
+  6085,   9476,  11630,   9667,   2245,  -1929,    770,   -176,
+ -3586,  -1931,  -1594,  -3634,   -714,   1907,   2416,   3611,
+  5830,   2918,  -1972,  -1422,  -2781,  -4329,   -561,   3286,
+  3615,   1770,   2387,   4598,   6821,   3110,    660,   2801,
+ -1529,  -3751,    482,   2474,    615,    118,   -306,   -205,
+  2044,   3037,   3845,   1805,   -223,  -1831,   -760,   -260,
+   921,   3787,   3928,   3271,   -265,  -1354,    739,  -1750,
+ -5224,  -4286,   -701,  -1786,  -3516,   1525,   4098,   2650,
+  1724
+};
+
+static const short tickdata_48000_secondary[] = {
+  -398,   -325,   -284,   -267,   -248,   -234,   -220,   -188,
+  -125,    -59,    -32,     -8,    -58,    -14,    -68,     41,
+   -74,     94,    -40,    -57,   -334,    433,   5444,   9056,
+  8183,   -778, -13178,  -8114,   3302,   6561,   4716,   3475,
+ -2879, -12718, -12730, -10122,  -7527,  -4851,  -7121,  -7073,
+ -4506,   3802,  11641,  11374,   3845,    262,   6235,   9411,
+  6439,   5544,  -7558, -13024, -10389,  -4040,   6708,  10320,
+  5466,  -3067, -10044,  -5100,   8474,  10017,   5428,  -6568,
+-13633, -10651,  -4367,   4756,   6337,  -3077, -11239,  -8436,
+  1696,  13151,   8033,   8133,    462, -11527, -12334,  -8107,
+ -5806,  -6298,  -7102,  -6089,  -4821,  -5369,   -790,   5676,
+  7285,  12334,  12824,  10156,   9253,   4620,  -6197, -12102,
+ -5411,   4034,  13266,   1750, -10283,  -7767,  -6264,  -2138,
+  7521,  12261,   4618,  -5913,  -4037,   9076,  14493,  10456,
+  8867,   7977,   1567,   -486,   5392,   2652,  -8193, -12148,
+ -9133,  -7509,  -6456,  -1242,   4772,    599,   4076,  11632,
+ 11221,   9075,   6935,   -949, -10631, -10555,  -2887,   8221,
+  6839,  -4203,  -2090,   6851,   9964,   8321,   6999,   5545,
+   703,  -6536, -11312, -12145,  -9545,  -8023,  -7430,  -6009,
+ -6081,  -3948,   1273,   5724,   9181,  13073,  10995,   9111,
+  8162,   3159,  -5443, -10451,  -9333,  -6869,  -5580,  -2916,
+  2617,   6062,   2991,   3144,   8585,   9080,   3366,    993,
+ -1968,  -3093,  -2447,  -2849,  -2181,   2599,   8007,  12221,
+  9457,   8270,  10125,   2212,  -4974,  -7325,  -3098,   3927,
+  7442,   8306,  10825,   9229,   7574,   2768,  -1149,  -4273,
+ -9090,  -9625,  -8202,  -6927,  -5429,   -307,   9101,  14207,
+ 11257,   9051,   8563,   6706,   1856,   -799,  -2893,  -4836,
+ -2195,   4310,   8036,   7489,   5766,   4711,   3888,   2595,
+ -4673, -13210, -14506, -12362, -10494,  -9238,  -7381,  -3175,
+  2227,   5129,   8467,   9223,   7200,   6268,   4413,   -657,
+ -7226, -11665, -12229,  -9925,  -5421,   3591,  10626,   4458,
+  2563,   4972,   5546,   3748,  -4616, -13006, -12441,  -7776,
+ -7831,  -3856,   1721,   1980,   1858,  -3071,   1034,   5780,
+  2484,  -4479,  -7375,  -4695,   -728,  -1359,  -2395,  -6728,
+-10561,  -2471,   9247,   6678,  -3147, -10432, -10538,  -3457,
+  5564,   8250,   -709, -14483,  -8417,   3156,  10095,   7976,
+   875,  -5867, -10708,  -9716,  -1061,   3491,  -4511, -10111,
+ -8992,  -3697,   6193,  10967,  10033,   7140,   2355,  -2313,
+ -4299,  -6966, -10904, -10072,  -8260,  -4383,   1412,   5697,
+  4426,   3190,   5289,   6759,   6348,   4991,  -5209, -15655,
+-10631,  -9998,  -5572,   6608,  10447,   6776,   2857,   1042,
+   470,   1787,   3697,  -1894, -12735, -13568, -10172,  -9802,
+ -3441,   7339,  10702,   8094,   6142,   5034,   4090,   3316,
+  2048,  -3488,  -9176, -12541,  -9252,  -1761,    176,  -2496,
+ -4232,  -3136,    252,   3487,   2944,  -5011, -14411, -12874,
+ -8990,  -9046, -11692, -11913, -10568,  -9054,  -2865,   7996,
+  9897,   6265,   3693,    120,   -471,  -1790,  -7834, -13557,
+-13925, -11390, -10171,  -9254,  -8409,  -7459,  -2796,   5620,
+  8941,   8730,   7102,   2965,   -576,  -1953,  -3474,  -3989,
+  1389,   6876,   5616,   4172,   2090,  -1041,  -5908, -11914,
+-14744, -13960, -12419, -11130, -10074,  -7883,  -1668,   1286,
+  4452,   8147,   6957,   5219,    952,  -5805,  -9224,  -7820,
+ -7975,  -8384,  -3442,   3508,   5040,   5629,   3567,  -2117,
+ -8937, -11756,  -7496,   -501,   1287,  -1931,  -7481, -11931,
+ -5726,   3950,   5277,   3626,  -2227, -11129, -15916, -13625,
+-10068,  -9354,  -9650,  -6792,   -220,   4345,   4493,   3071,
+  1228,  -1108,  -4474,  -8724, -12271, -13122, -11361,  -9961,
+ -8863,  -4826,  -1266,    484,    330,    970,   4863,   8279,
+  7166,   3893,  -1435,  -5813,  -4548,  -4738,  -5293,  -3458,
+  -588,   -122,  -3373,  -7051,  -6886,  -2744,   1252,    -85,
+ -6226, -10631, -11979,  -8652,  -2219,   3074,   3247,   -756,
+ -3291,   -392,   4794,   5858,    702,  -8724, -12344,  -8586,
+ -1911,   1821,    742,  -1369,  -1750,  -1284,  -1461,  -4312,
+ -6888,  -7016,  -5660,  -2375,   2047,   5180,   6067,   6307,
+  6304,   5323,   4103,   3316,   1139,  -8072, -15518, -14530,
+-12501, -10802,  -9941,  -8792,  -6299,  -1630,   5210,  10501,
+  8771,   6110,    938,  -5994,  -9184, -10397,  -9943,  -8378,
+ -6969,  -5550,  -2638,   2237,   7955,   9146,   6353,   5057,
+  5070,   3713,   1210,   -708,  -1960,  -2677,  -2792,  -3348,
+ -4910,  -4961,  -2196,   -917,  -2142,  -3204,  -3537,  -3293,
+ -1627,    722,   2039,   1859,    106,  -3765,  -7638,  -7860,
+ -4799,  -1310,   -108,  -1109,  -1875,   -750,   2185,   5299,
+  6058,   3800,    341,  -1694,  -2392,  -3386,  -4391,  -5395,
+ -5818,  -4146,   -615,   1953,   1593,    286,    500,   2264,
+  1982,    288,  -1565,  -2944,  -2642,  -1638,  -2339,  -4920,
+ -7060,  -7691,  -6358,  -3305,  -1384,   1602,   4400,   6339,
+  7097,   7076,   6286,   3678,   -642,  -3604,  -3324,  -2163,
+ -1816,   -783,   -589,   -557,    943,   3328,   5047,   5340,
+  4378,   2759,   1574,   1347,   -615,  -4506,  -6167,  -3246,
+  1552,   4083,   3519,   1770,    788,   1014,   1435,    925,
+  -469,  -1340,  -2661,  -4926,  -6388,  -6020,  -3890,  -1521,
+ -1139,  -2827,  -3707,  -3387,  -3174,  -1686,   -868,  -1097,
+ -1889,  -2084,   -802,   1818,   4709,   6871,   7811,   6748,
+  4174,   2578,   1914,    312,  -1490,  -1606,   -823,   -554,
+ -1444,  -3133,  -4180,  -2932,   -416,   1139,    455,  -1328,
+ -2024,   -734,   1166,   2213,   2249,   2049,   2272,   3161,
+  5029,   7501,   7382,   4804,   1054,  -2147,  -3209,  -2752,
+ -2074,  -1570,   -978,   -606,  -1251,  -1324,   1093,   4161,
+  5966,   4766,   1473,  -1564,  -2636,  -1949,  -1062,   -961,
+  -918,    -57,   2081,   4539,   6113,   5445,   2887,    -17,
+ -1615,  -1606,  -1440,  -2562,  -4249,  -4626,  -2827,  -1046,
+   188,    522,     16,  -1137,  -2359,  -2766,  -2354,  -1716,
+  -800,    162,   1707,   5942,   9068,   9008,   8804,   7415,
+  5334,   3794,   2417,    488,  -1857,  -5574,  -8428,  -7426,
+ -6040,  -3322,   -332,    513,    191,    527,   2317,   4544,
+  5357,   4455,   3051,   2280,   2101,   1126,    254,    890,
+  2155,   3058,   3242,   2515,   1272,    942,   1815,   2123,
+  1774,   1848,    711,  -1364,  -2647,  -2403,  -1374,   -339,
+   582,   1036,    207,   -465,    872,   1926,   2024,   2394,
+  2411,   2004,   1877,   2181,   2034,    708,   -983,  -1512,
+ -1658,  -1394,    -52,   1133,    752,   -354,   -318,    975,
+  2103,   2134,   1165,   -573,  -1580,     63,   1859,   1827,
+  1145,   1050,   1381,   1641,   1608,   1093,    105,   -478,
+  -154,   -119,   -772,  -1729,  -2187,  -1265,    220,   1200,
+  1444,   1230,    916,   1113,   2001,   3734,   4638,   4353,
+  3896,   3323,   3041,   3249,   3463,   2806,   1090,   -574,
+ -1133,   -323,    470,    157,   -238,   -668,   -980,  -1020,
+ -1065,  -1418,  -1830,  -1826,  -1546,  -1147,    123,   1757,
+  3012,   3486,   2986,   2417,   2340,   2326,   1819,   1026,
+   426,   -325,  -1446,  -2002,  -1937,  -1405,   -951,   -237,
+   806,   1321,    758,    -83,    -88,    755,   1464,   2081,
+  2291,   1833,   1119,    821,   1121,   1936,   2974,   3463,
+  2714,   1614,   1292,   1417,    735,   -859,  -2983,  -4513,
+ -4644,  -3842,  -2775,  -1579,   -253,   1187,   2516,   3587,
+  4483,   4999,   5616,   6025,   5578,   4116,   2066,    128,
+ -1028,   -986,     76,    782,    441,   -622,  -1629,  -1976,
+ -1369,   -544,   -451,  -1132,  -1832,  -1881,   -914,    248,
+   930,    979,   1083,   1331,   1582,   2019,   2736,   3147,
+  2359,    515,   -814,  -1211,   -984,   -434,   -763,  -2010,
+ -2525,  -1838,   -797,    232,   1328,   2020,   1960,   1674,
+  1127,    638,    919,   1469,   1958,   2635,   3427,   3462,
+  2290,    764,     66,    560,   1486,   1344,     33,  -1571,
+ -2177,  -1602,   -334,    848,   1370,   1137,    496,     75,
+   126,    -11,   -102,   -203,   -269,     53,    771,   1300,
+  1423,   1587,   1971,   1926,   1219,    559,    185,   -411,
+  -934,   -912,   -530,   -216,   -128,   -133,     83,    828,
+  1712,   2117,   2033,   1892,   1852,   1426,    357,   -648,
+  -907,   -463,    223,    600,   -172,  -1636,  -2516,  -2712,
+ -2506,  -1784,   -655,     -8,   -389,  -1400,  -2047,  -1546,
+     6,   1619,   2153,   1942,   1615,   1034,    748,    960
+};
+
+static const short tickdata_88200_normal[] = {
+  -797,   -718,   -639,   -598,   -557,   -543,   -529,   -505,
+  -482,   -471,   -460,   -442,   -425,   -370,   -315,   -223,
+  -132,   -106,    -81,    -42,     -4,    -62,   -120,    -72,
+   -25,    -90,   -155,     -2,    150,    -63,   -276,     99,
+   475,    -43,   -561,    -72,    416,  -1031,  -2478,   3215,
+  8908,  13569,  18230,  17786,  17342,   7587,  -2167, -15795,
+-29424, -21241, -13059,    502,  14064,  13333,  12602,   9786,
+  6970,   6951,   6932,  -8932, -24796, -25803, -26810, -23968,
+-21127, -18309, -15492, -12579,  -9666, -12174, -14682, -14360,
+-14039, -10688,  -7338,   3834,  15007,  22050,  29094,  22827,
+ 16561,   6126,  -4309,   2722,   9753,  14931,  20109,  16563,
+ 13018,  12321,  11624,  -2638, -16900, -22242, -27585, -23195,
+-18805, -11076,  -3348,  10338,  24024,  20840,  17656,  10185,
+  2714,  -9286, -21286, -19205, -17125,   -339,  16446,  18459,
+ 20472,  15477,  10483,  -2919, -16321, -23163, -30005, -23951,
+-17898, -10712,  -3527,   8193,  19914,  12294,   4675,  -9077,
+-22829, -22272, -21715, -11250,   -785,  13142,  27069,  21499,
+ 15929,  16115,  16302,   6982,  -2337, -16265, -30194, -26024,
+-21854, -17004, -12154, -11612, -11071, -12895, -14719, -13959,
+-13200, -11207,  -9215, -10442, -11669,  -6712,  -1756,   5282,
+ 12320,  13644,  14969,  21278,  27587,  26178,  24769,  21095,
+ 17421,  18455,  19490,   7941,  -3607, -15728, -27850, -21371,
+-14892,  -4718,   5455,  16464,  27474,  14939,   2405, -10721,
+-23848, -18611, -13375, -12781, -12188,  -5922,    344,  13707,
+ 27071,  24355,  21639,   5636, -10367, -12751, -15136,    553,
+ 16242,  22889,  29537,  25142,  20748,  19074,  17401,  16517,
+ 15634,   7159,  -1315,  -1055,   -795,   9274,  19343,   5127,
+ -9089, -17937, -26785, -23029, -19274, -17260, -15246, -14576,
+-13906,  -8236,  -2567,   3980,  10527,   4999,   -529,   5163,
+ 10856,  19963,  29070,  23548,  18026,  18147,  18268,  13243,
+  8219,  -5982, -20183, -22149, -24116, -16360,  -8604,   3967,
+ 16538,  15033,  13528,    903, -11722,  -6934,  -2146,   9075,
+ 20296,  20003,  19711,  16891,  14071,  13995,  13919,  10212,
+  6505,  -1990, -10486, -16397, -22309, -23460, -24611, -21780,
+-18950, -17326, -15703, -15184, -14666, -12856, -11046, -11905,
+-12765,  -8486,  -4207,   2721,   9649,  11864,  14080,  20670,
+ 27260,  24975,  22691,  20541,  18391,  17359,  16327,  10880,
+  5434,  -4310, -14055, -18583, -23111, -19819, -16528, -14179,
+-11830, -11177, -10525,  -5085,    354,   7326,  14298,  10254,
+  6210,   5604,   4998,  11071,  17145,  17683,  18222,  11562,
+  4902,   3036,   1170,  -2478,  -6127,  -6176,  -6226,  -4987,
+ -3748,  -5886,  -8025,  -3143,   1738,   7630,  13523,  19390,
+ 25258,  22151,  19044,  17752,  16460,  18596,  20732,  10619,
+   507,  -6703, -13914, -14487, -15061,  -7181,    699,   8133,
+ 15568,  14713,  13859,  18180,  22501,  20713,  18926,  17430,
+ 15934,  10703,   5472,   1214,  -3044,  -6354,  -9665, -15343,
+-21021, -19698, -18376, -16699, -15022, -13869, -12717, -10532,
+ -8347,   2897,  14142,  21878,  29615,  26310,  23005,  20564,
+ 18123,  17592,  17061,  14930,  12800,   6937,   1075,   -851,
+ -2778,  -5234,  -7691,  -9558, -11425,  -3610,   4204,  10194,
+ 16185,  15993,  15801,  13813,  11825,  10663,   9502,   8606,
+  7710,   6281,   4852,  -4023, -12899, -22306, -31714, -29595,
+-27476, -25003, -22530, -20907, -19284, -18260, -17237, -13279,
+ -9321,  -2901,   3519,   6640,   9761,  13393,  17026,  17810,
+ 18594,  16053,  13512,  12857,  12203,   9656,   7109,   -136,
+ -7382, -14453, -21524, -23682, -25841, -23793, -21746, -18050,
+-14354,  -4321,   5711,  13566,  21421,  14708,   7995,   6307,
+  4620,   8083,  11546,  11216,  10886,   8091,   5297,  -8540,
+-22378, -26474, -30571, -22725, -14880, -16078, -17277, -13246,
+ -9215,  -2896,   3423,   3704,   3986,   3832,   3679,  -2509,
+ -8697,  -1141,   6414,  10491,  14569,   5841,  -2887,  -9364,
+-15842, -14433, -13024,  -7093,  -1163,  -1817,  -2471,  -3337,
+ -4203,  -8919, -13635, -17795, -21955, -11565,  -1176,  12160,
+ 25496,  16248,   7001,  -4561, -16123, -20927, -25731, -20091,
+-14452,  -3073,   8305,  13953,  19602,  10416,   1231, -13909,
+-29050, -22447, -15845,  -2714,  10417,  16826,  23236,  17890,
+ 12545,   3549,  -5446, -11508, -17571, -21968, -26365, -16635,
+ -6906,   1790,  10486,   1446,  -7594, -13947, -20301, -19082,
+-17864, -11839,  -5814,   5742,  17299,  20582,  23865,  20827,
+ 17790,  14563,  11336,   4173,  -2990,  -5138,  -7286,  -9475,
+-11665, -16852, -22040, -21203, -20367, -18395, -16423, -12140,
+ -7857,  -1283,   5291,   9465,  13640,   9957,   6275,   6369,
+  6463,  10684,  14906,  13200,  11494,  13346,  15199,   4502,
+ -6194, -19197, -32201, -26733, -21265, -20575, -19886, -14668,
+ -9451,   5537,  20525,  20799,  21074,  14740,   8406,   5781,
+  3156,   1914,    673,   1058,   1443,   5412,   9382,   4083,
+ -1216, -13321, -25426, -26332, -27239, -23242, -19246, -19476,
+-19706, -10547,  -1388,  11595,  24578,  21626,  18675,  15952,
+ 13229,  11971,  10714,   9617,   8521,   7723,   6925,   5813,
+  4701,  -1326,  -7354, -13551, -19748, -23056, -26365, -20944,
+-15524,  -6203,   3118,    661,  -1796,  -5117,  -8439,  -8473,
+ -8508,  -5003,  -1499,   2719,   6937,   7062,   7188,  -1472,
+-10132, -20374, -30616, -27688, -24760, -20241, -15722, -17494,
+-19267, -22771, -26276, -23857, -21439, -21086, -20733, -16917,
+-13101,    937,  14976,  17783,  20590,  16613,  12637,   9837,
+  7038,   3068,   -901,   -929,   -957,  -2849,  -4741, -13663,
+-22585, -26850, -31115, -27489, -23863, -22395, -20928, -19911,
+-18895, -17961, -17028, -16196, -15365, -10288,  -5212,   4123,
+ 13459,  16223,  18988,  17926,  16864,  14779,  12695,   6615,
+   535,  -1240,  -3016,  -4148,  -5280,  -7952, -10625,  -4907,
+   811,   7377,  13943,  12571,  11199,   9625,   8051,   5706,
+  3361,   -299,  -3959,  -9889, -15820, -22710, -29601, -29491,
+-29381, -27639, -25897, -24330, -22763, -21785, -20808, -18926,
+-17045, -10231,  -3418,   -200,   3017,   6480,   9944,  14075,
+ 18206,  15086,  11967,  10706,   9446,   2264,  -4918, -12459,
+-20001, -17861, -15722, -15577, -15433, -16729, -18025, -12738,
+ -7452,    113,   7679,   9051,  10424,  10950,  11477,   8429,
+  5382,  -2236,  -9855, -17145, -24436, -23451, -22466, -12824,
+ -3183,    376,   3935,    916,  -2102,  -8230, -14359, -19202,
+-24045, -17049, -10054,    911,  11877,  10981,  10086,   7927,
+  5768,  -3121, -12011, -22389, -32767, -31634, -30502, -25596,
+-20690, -19585, -18481, -19161, -19841, -16757, -13674,  -6520,
+   633,   5408,  10184,   9399,   8615,   6802,   4989,   2880,
+   771,  -2108,  -4988,  -9515, -14042, -18825, -23609, -25309,
+-27009, -25039, -23069, -21533, -19998, -18803, -17608, -13030,
+ -8453,  -4695,   -937,    413,   1763,    881,      0,   1784,
+  3568,  10226,  16884,  16457,  16031,  13202,  10374,   4462,
+ -1450,  -6616, -11782, -10405,  -9028,  -9279,  -9531, -10182,
+-10833,  -8155,  -5478,  -2169,   1139,    -78,  -1295,  -6887,
+-12480, -14477, -16475, -12319,  -8164,  -2675,   2814,   1865,
+   917,  -5768, -12454, -17248, -22043, -23187, -24332, -19686,
+-15040,  -7186,    667,   5284,   9901,   6579,   3257,  -2273,
+ -7804,  -6061,  -4319,   2256,   8831,  10857,  12883,   7401,
+  1919,  -8342, -18604, -22132, -25661, -20228, -14796,  -6957,
+   881,   3113,   5345,   1754,  -1836,  -2826,  -3816,  -3395,
+ -2975,  -2285,  -1595,  -4721,  -7848, -10805, -13762, -13902,
+-14042, -12509, -10977,  -7115,  -3254,   1814,   6882,   9584,
+ 12287,  12153,  12019,  12638,  13258,  12448,  11638,  10085,
+  8532,   7846,   7161,   5472,   3784,  -6243, -16270, -24361,
+-32452, -30412, -28372, -26126, -23881, -22180, -20479, -19973,
+-19467, -17609, -15751, -12044,  -8337,   -955,   6426,  14035,
+ 21644,  19877,  18111,  15272,  12433,   6803,   1174,  -6513,
+-14201, -16891, -19581, -20456, -21332, -20152, -18972, -16888,
+-14804, -13843, -12883, -10468,  -8053,  -3225,   1602,   8568,
+ 15534,  17046,  18559,  15519,  12480,  11138,   9796,  10012,
+ 10228,   8280,   6332,   3265,    199,  -1253,  -2706,  -3984,
+ -5262,  -5379,  -5496,  -5640,  -5784,  -7757,  -9730, -10033,
+-10337,  -7328,  -4319,  -2948,  -1578,  -3219,  -4860,  -5901,
+ -6942,  -7043,  -7144,  -6665,  -6187,  -3257,   -327,   1789,
+  3905,   4163,   4421,   3053,   1686,  -2522,  -6731, -11001,
+-15271, -15512, -15754, -12133,  -8512,  -4681,   -851,   -390,
+    71,  -1817,  -3706,  -3748,  -3790,  -1211,   1368,   5510,
+  9652,  11335,  13018,  10764,   8510,   4680,    851,  -1366,
+ -3583,  -4270,  -4957,  -6102,  -7247,  -8326,  -9405, -10502,
+-11600, -11634, -11669,  -8069,  -4469,   -291,   3887,   3922,
+  3957,   2250,    543,    653,    763,   2683,   4603,   4248,
+  3894,   1867,   -159,  -2175,  -4191,  -5484,  -6778,  -5479,
+ -4180,  -3265,  -2351,  -5174,  -7998, -10779, -13560, -14683,
+-15807, -14554, -13301,  -9970,  -6639,  -4547,  -2456,    899,
+  4255,   7235,  10216,  12023,  13831,  14135,  14439,  14165,
+ 13891,  12387,  10883,   5935,    987,  -3144,  -7275,  -7107,
+ -6940,  -5645,  -4351,  -3973,  -3596,  -2428,  -1260,  -1208,
+ -1156,  -1127,  -1099,   1290,   3679,   6418,   9158,  10171,
+ 11184,  10525,   9867,   8019,   6172,   4678,   3184,   3060,
+  2936,    798,  -1339,  -5633,  -9927, -11410, -12893,  -8518,
+ -4143,   1431,   7006,   8026,   9046,   6987,   4929,   3221,
+  1514,   1611,   1708,   2365,   3023,   2560,   2098,    578,
+  -941,  -1887,  -2834,  -4320,  -5807,  -8482, -11158, -12357,
+-13557, -12281, -11005,  -7860,  -4716,  -2777,   -839,  -2897,
+ -4956,  -6255,  -7554,  -7185,  -6816,  -6623,  -6430,  -4810,
+ -3191,  -2349,  -1507,  -1947,  -2388,  -3382,  -4376,  -4209,
+ -4042,  -1775,    492,   3939,   7386,  10097,  12808,  14401,
+ 15995,  15121,  14248,  11385,   8523,   6785,   5048,   4361,
+  3674,   1783,   -108,  -2089,  -4071,  -3405,  -2740,  -1768,
+  -797,  -1122,  -1447,  -3251,  -5055,  -6958,  -8862,  -7806,
+ -6751,  -3918,  -1086,    607,   2301,   1540,    779,  -1287,
+ -3354,  -3818,  -4283,  -2179,    -76,   1974,   4025,   4422,
+  4820,   4442,   4065,   4114,   4164,   4891,   5618,   7564,
+  9511,  12259,  15008,  14878,  14748,  11747,   8747,   4464,
+   182,  -3044,  -6270,  -6392,  -6515,  -5564,  -4614,  -4098,
+ -3583,  -2985,  -2388,  -1640,   -893,  -1671,  -2450,  -2665,
+ -2881,   -248,   2384,   5754,   9124,  10880,  12636,  10478,
+  8320,   4106,   -108,  -2824,  -5541,  -5259,  -4978,  -3608,
+ -2239,  -2057,  -1875,  -1980,  -2085,  -1260,   -436,   1893,
+  4223,   6902,   9582,  11185,  12789,  11514,  10239,   6870,
+  3502,    459,  -2584,  -3231,  -3879,  -3083,  -2288,  -3166,
+ -4044,  -6152,  -8260,  -8940,  -9620,  -7662,  -5704,  -3765,
+ -1826,   -529,    767,    948,   1130,    331,   -467,  -1958,
+ -3450,  -4659,  -5869,  -5491,  -5114,  -4556,  -3999,  -2995,
+ -1991,  -1018,    -46,   1512,   3071,   7679,  12288,  15630,
+ 18972,  18371,  17770,  17657,  17545,  15396,  13247,  10904,
+  8561,   7525,   6489,   4354,   2220,    188,  -1843,  -6005,
+-10168, -13581, -16995, -15903, -14812, -13295, -11779,  -8644,
+ -5509,  -2225,   1059,   1035,   1011,    465,    -81,   1070,
+  2221,   5147,   8074,   9605,  11137,  10294,   9451,   7851,
+  6251,   5407,   4564,   4369,   4175,   3037,   1899,    987,
+    76,   1327,   2578,   4023,   5468,   6094,   6720,   6452,
+  6184,   4566,   2948,   2217,   1487,   2519,   3551,   3910,
+  4270,   3890,   3510,   3618,   3726,   2264,    803,  -1697,
+ -4198,  -5075,  -5952,  -4900,  -3849,  -2659,  -1470,   -431,
+   607,   1539,   2471,   1564,    657,   -219,  -1095,    362,
+  1819,   2957,   4095,   4067,   4039,   4552,   5065,   4878,
+  4692,   4092,   3493,   3762,   4031,   4442,   4853,   3648,
+  2444,    338,  -1767,  -2382,  -2998,  -3158,  -3318,  -3030,
+ -2742,  -1168,    406,   1637,   2868,   1858,    849,   -463,
+ -1776,   -664,    447,   2192,   3937,   4323,   4709,   3893,
+  3077,   1090,   -897,  -2073,  -3250,  -1460,    329,   2295,
+  4261,   3874,   3487,   2632,   1778,   2039,   2301,   2731,
+  3162,   3295,   3428,   3147,   2866,   1709,    553,   -251,
+ -1055,   -683,   -312,   -274,   -236,   -974,  -1712,  -2795,
+ -3879,  -4221,  -4564,  -2985,  -1406,    236,   1879,   2423,
+  2967,   2869,   2772,   2284,   1796,   1873,   1950,   2835,
+  3720,   5606,   7492,   8470,   9449,   9002,   8556,   8047,
+  7539,   6873,   6207,   6103,   5999,   6494,   6989,   6916,
+  6844,   5054,   3265,   1201,   -863,  -1653,  -2444,  -1562,
+  -681,    185,   1051,    621,    192,   -240,   -673,  -1152,
+ -1631,  -1902,  -2173,  -2048,  -1924,  -2154,  -2384,  -2999,
+ -3615,  -3695,  -3775,  -3482,  -3190,  -2803,  -2416,  -1032,
+   351,   2147,   3943,   5245,   6547,   6844,   7141,   6225,
+  5309,   4883,   4457,   4693,   4929,   4579,   4230,   3286,
+  2343,   1715,   1088,    302,   -484,  -1704,  -2924,  -3520,
+ -4116,  -3970,  -3824,  -3143,  -2463,  -2040,  -1618,   -633,
+   351,   1615,   2879,   2598,   2317,   1133,    -51,   -277,
+  -504,    431,   1366,   2139,   2913,   3585,   4257,   4449,
+  4641,   4008,   3375,   2549,   1724,   1657,   1591,   2212,
+  2834,   4005,   5176,   6241,   7307,   6632,   5957,   4638,
+  3319,   2946,   2574,   2710,   2847,   2061,   1275,   -611,
+ -2497,  -4932,  -7368,  -8682,  -9997,  -9355,  -8713,  -7617,
+ -6522,  -5268,  -4014,  -2618,  -1223,    365,   1954,   3421,
+  4888,   6053,   7219,   8191,   9163,   9674,  10185,  10895,
+ 11606,  11945,  12284,  11304,  10324,   8206,   6089,   3720,
+  1351,   -299,  -1950,  -2163,  -2377,  -1179,     19,    795,
+  1571,   1200,    829,   -399,  -1628,  -2698,  -3769,  -3904,
+ -4040,  -2955,  -1871,  -1119,   -367,   -981,  -1595,  -2536,
+ -3478,  -3818,  -4159,  -3139,  -2119,   -834,    450,   1193,
+  1936,   1949,   1963,   2093,   2223,   2535,   2847,   3103,
+  3359,   3985,   4611,   5545,   6479,   6238,   5997,   3868,
+  1740,    120,  -1499,  -1974,  -2450,  -2203,  -1956,  -1348,
+  -741,  -1224,  -1708,  -3290,  -4873,  -5009,  -5146,  -3855,
+ -2565,  -1571,   -577,    704,   1986,   3018,   4050,   4031,
+  4012,   3729,   3446,   2851,   2256,   1723,   1191,   1577,
+  1964,   2608,   3252,   3745,   4238,   5108,   5978,   6834,
+  7691,   6802,   5914,   4010,   2106,   1031,    -44,    428,
+   901,   1941,   2981,   2826,   2672,   1161,   -349,  -2138,
+ -3927,  -4233,  -4539,  -3461,  -2384,   -788,    807,   1783,
+  2760,   2735,   2711,   1969,   1227,    681,    135,    201,
+   268,    118,    -32,   -130,   -229,   -339,   -450,   -511,
+  -573,    -44,    484,   1426,   2369,   2612,   2855,   2847,
+  2839,   3368,   3897,   3996,   4095,   3320,   2546,   1828,
+  1110,    705,    300,   -375,  -1051,  -1596,  -2142,  -1905,
+ -1668,  -1151,   -635,   -436,   -238,   -261,   -285,   -259,
+  -233,    527,   1287,   2311,   3335,   3786,   4238,   4147,
+  4057,   3899,   3741,   3717,   3694,   3088,   2482,   1039,
+  -404,  -1245,  -2087,  -1785,  -1483,   -729,     25,    762,
+  1499,    781,     63,  -1564,  -3191,  -4147,  -5104,  -5286,
+ -5468,  -5183,  -4899,  -3974,  -3049,  -1686,   -324,    -48,
+   228,   -832,  -1892,  -3047,  -4203,  -4032,  -3861,  -2202,
+  -543,   1307,   3158,   3740,   4323,   4082,   3841,   3472,
+  3103,   2407,   1712,   1549,   1386,   1847,   2309,   2309
+};
+
+static const short tickdata_88200_accent[] = {
+     0,      0,      0,      0,      0,      0,      0,      0,
+     0,   -797,   -639,   -557,   -529,   -482,   -460,   -425,
+  -315,   -132,    -81,     -4,   -120,    -25,   -155,    150,
+  -276,    475,   -561,    416,  -2478,   8908,  18230,  17342,
+ -2167, -29424, -13059,  14064,  12602,   6970,   6932, -24796,
+-26810, -21127, -15492,  -9666, -14682, -14039,  -7338,  15007,
+ 29094,  16561,  -4309,   9753,  20109,  13018,  11624, -16900,
+-27585, -18805,  -3348,  24024,  17656,   2714, -21286, -17125,
+ 16446,  20472,  10483, -16321, -30005, -17898,  -3527,  19914,
+  4675, -22829, -21715,   -785,  27069,  15929,  16302,  -2337,
+-30194, -21854, -12154, -11071, -14719, -13200,  -9215, -11669,
+ -1756,  12320,  14969,  27587,  24769,  17421,  19490,  -3607,
+-27850, -14892,   5455,  27474,   2405, -23848, -13375, -12188,
+   344,  27071,  21639, -10367, -15136,  16242,  29537,  20748,
+ 17401,  15634,  -1315,   -795,  19343,  -9089, -26785, -19274,
+-15246, -13906,  -2567,  10527,   -529,  10856,  29070,  18026,
+ 18268,   8219, -20183, -24116,  -8604,  16538,  13528, -11722,
+ -2146,  20296,  19711,  14071,  13919,   6505, -10486, -22309,
+-24611, -18950, -15703, -14666, -11046, -12765,  -4207,   9649,
+ 14080,  27260,  22691,  18391,  16327,   5434, -14055, -23111,
+-16528, -11830, -10525,    354,  14298,   6210,   4998,  17145,
+ 18222,   4902,   1170,  -6127,  -6226,  -3748,  -8025,   1738,
+ 13523,  25258,  19044,  16460,  20732,    507, -13914, -15061,
+   699,  15568,  13859,  22501,  18926,  15934,   5472,  -3044,
+ -9665, -21021, -18376, -15022, -12717,  -8347,  14142,  29615,
+ 23005,  18123,  17061,  12800,   1075,  -2778,  -7691, -11425,
+  4204,  16185,  15801,  11825,   9502,   7710,   4852, -12899,
+-31714, -27476, -22530, -19284, -17237,  -9321,   3519,   9761,
+ 17026,  18594,  13512,  12203,   7109,  -7382, -21524, -25841,
+-21746, -14354,   5711,  21421,   7995,   4620,  11546,  10886,
+  5297, -22378, -30571, -14880, -17277,  -9215,   3423,   3986,
+  3679,  -8697,   6414,  14569,  -2887, -15842, -13024,  -1163,
+ -2471,  -4203, -13635, -21955,  -1176,  25496,   7001, -16123,
+-25731, -14452,   8305,  19602,   1231, -29050, -15845,  10417,
+ 23236,  12545,  -5446, -17571, -26365,  -6906,  10486,  -7594,
+-20301, -17864,  -5814,  17299,  23865,  17790,  11336,  -2990,
+ -7286, -11665, -22040, -20367, -16423,  -7857,   5291,  13640,
+  6275,   6463,  14906,  11494,  15199,  -6194, -32201, -21265,
+-19886,  -9451,  20525,  21074,   8406,   3156,    673,   1443,
+  9382,  -1216, -25426, -27239, -19246, -19706,  -1388,  24578,
+ 18675,  13229,  10714,   8521,   6925,   4701,  -7354, -19748,
+-26365, -15524,   3118,  -1796,  -8439,  -8508,  -1499,   6937,
+  7188, -10132, -30616, -24760, -15722, -19267, -26276, -21439,
+-20733, -13101,  14976,  20590,  12637,   7038,   -901,   -957,
+ -4741, -22585, -31115, -23863, -20928, -18895, -17028, -15365,
+ -5212,  13459,  18988,  16864,  12695,    535,  -3016,  -5280,
+-10625,    811,  13943,  11199,   8051,   3361,  -3959, -15820,
+-29601, -29381, -25897, -22763, -20808, -17045,  -3418,   3017,
+  9944,  18206,  11967,   9446,  -4918, -20001, -15722, -15433,
+-18025,  -7452,   7679,  10424,  11477,   5382,  -9855, -24436,
+-22466,  -3183,   3935,  -2102, -14359, -24045, -10054,  11877,
+ 10086,   5768, -12011, -32767, -30502, -20690, -18481, -19841,
+-13674,    633,  10184,   8615,   4989,    771,  -4988, -14042,
+-23609, -27009, -23069, -19998, -17608,  -8453,   -937,   1763,
+     0,   3568,  16884,  16031,  10374,  -1450, -11782,  -9028,
+ -9531, -10833,  -5478,   1139,  -1295, -12480, -16475,  -8164,
+  2814,    917, -12454, -22043, -24332, -15040,    667,   9901,
+  3257,  -7804,  -4319,   8831,  12883,   1919, -18604, -25661,
+-14796,    881,   5345,  -1836,  -3816,  -2975,  -1595,  -7848,
+-13762, -14042, -10977,  -3254,   6882,  12287,  12019,  13258,
+ 11638,   8532,   7161,   3784, -16270, -32452, -28372, -23881,
+-20479, -19467, -15751,  -8337,   6426,  21644,  18111,  12433,
+  1174, -14201, -19581, -21332, -18972, -14804, -12883,  -8053,
+  1602,  15534,  18559,  12480,   9796,  10228,   6332,    199,
+ -2706,  -5262,  -5496,  -5784,  -9730, -10337,  -4319,  -1578,
+ -4860,  -6942,  -7144,  -6187,   -327,   3905,   4421,   1686,
+ -6731, -15271, -15754,  -8512,   -851,     71,  -3706,  -3790,
+  1368,   9652,  13018,   8510,    851,  -3583,  -4957,  -7247,
+ -9405, -11600, -11669,  -4469,   3887,   3957,    543,    763,
+  4603,   3894,   -159,  -4191,  -6778,  -4180,  -2351,  -7998,
+-13560, -15807, -13301,  -6639,  -2456,   4255,  10216,  13831,
+ 14439,  13891,  10883,    987,  -7275,  -6940,  -4351,  -3596,
+ -1260,  -1156,  -1099,   3679,   9158,  11184,   9867,   6172,
+  3184,   2936,  -1339,  -9927, -12893,  -4143,   7006,   9046,
+  4929,   1514,   1708,   3023,   2098,   -941,  -2834,  -5807,
+-11158, -13557, -11005,  -4716,   -839,  -4956,  -7554,  -6816,
+ -6430,  -3191,  -1507,  -2388,  -4376,  -4042,    492,   7386,
+ 12808,  15995,  14248,   8523,   5048,   3674,   -108,  -4071,
+ -2740,   -797,  -1447,  -5055,  -8862,  -6751,  -1086,   2301,
+   779,  -3354,  -4283,    -76,   4025,   4820,   4065,   4164,
+  5618,   9511,  15008,  14748,   8747,    182,  -6270,  -6515,
+ -4614,  -3583,  -2388,   -893,  -2450,  -2881,   2384,   9124,
+ 12636,   8320,   -108,  -5541,  -4978,  -2239,  -1875,  -2085,
+  -436,   4223,   9582,  12789,  10239,   3502,  -2584,  -3879,
+ -2288,  -4044,  -8260,  -9620,  -5704,  -1826,    767,   1130,
+  -467,  -3450,  -5869,  -5114,  -3999,  -1991,    -46,   3071,
+ 12288,  18972,  17770,  17545,  13247,   8561,   6489,   2220,
+ -1843, -10168, -16995, -14812, -11779,  -5509,   1059,   1011,
+   -81,   2221,   8074,  11137,   9451,   6251,   4564,   4175,
+  1899,     76,   2578,   5468,   6720,   6184,   2948,   1487,
+  3551,   4270,   3510,   3726,    803,  -4198,  -5952,  -3849,
+ -1470,    607,   2471,    657,  -1095,   1819,   4095,   4039,
+  5065,   4692,   3493,   4031,   4853,   2444,  -1767,  -2998,
+ -3318,  -2742,    406,   2868,    849,  -1776,    447,   3937,
+  4709,   3077,   -897,  -3250,    329,   4261,   3487,   1778,
+  2301,   3162,   3428,   2866,    553,  -1055,   -312,   -236,
+ -1712,  -3879,  -4564,  -1406,   1879,   2967,   2772,   1796,
+  1950,   3720,   7492,   9449,   8556,   7539,   6207,   5999,
+  6989,   6844,   3265,   -863,  -2444,   -681,   1051,    192,
+  -673,  -1631,  -2173,  -1924,  -2384,  -3615,  -3775,  -3190,
+ -2416,    351,   3943,   6547,   7141,   5309,   4457,   4929,
+  4230,   2343,   1088,   -484,  -2924,  -4116,  -3824,  -2463,
+ -1618,    351,   2879,   2317,    -51,   -504,   1366,   2913,
+  4257,   4641,   3375,   1724,   1591,   2834,   5176,   7307,
+  5957,   3319,   2574,   2847,   1275,  -2497,  -7368,  -9997,
+ -8713,  -6522,  -4014,  -1223,   1954,   4888,   7219,   9163,
+ 10185,  11606,  12284,  10324,   6089,   1351,  -1950,  -2377,
+    19,   1571,    829,  -1628,  -3769,  -4040,  -1871,   -367,
+ -1595,  -3478,  -4159,  -2119,    450,   1936,   1963,   2223,
+  2847,   3359,   4611,   6479,   5997,   1740,  -1499,  -2450,
+ -1956,   -741,  -1708,  -4873,  -5146,  -2565,   -577,   1986,
+  4050,   4012,   3446,   2256,   1191,   1964,   3252,   4238,
+  5978,   7691,   5914,   2106,    -44,    901,   2981,   2672,
+  -349,  -3927,  -4539,  -2384,    807,   2760,   2711,   1227,
+   135,    268,    -32,   -229,   -450,   -573,    484,   2369,
+  2855,   2839,   3897,   4095,   2546,   1110,    300,  -1051,
+ -2142,  -1668,   -635,   -238,   -285,   -233,   1287,   3335,
+  4238,   4057,   3741,   3694,   2482,   -404,  -2087,  -1483,
+    25,   1499,     63,  -3191,  -5104,  -5468,  -4899,  -3049,
+  -324,    228,  -1892,  -4203,  -3861,   -543,   3158,   4323,
+  3841,   3103,   1712,   1386,   2309
+};
+
+static const short tickdata_88200_secondary[] = {
+  -398,   -358,   -319,   -298,   -278,   -271,   -264,   -252,
+  -241,   -235,   -230,   -221,   -212,   -184,   -157,   -111,
+   -66,    -53,    -40,    -21,     -2,    -31,    -60,    -36,
+   -12,    -44,    -77,     -1,     75,    -31,   -138,     49,
+   237,    -21,   -280,    -36,    208,   -515,  -1239,   1607,
+  4454,   6784,   9115,   8893,   8671,   3794,  -1083,  -7897,
+-14712, -10620,  -6529,    251,   7032,   6666,   6301,   4893,
+  3485,   3475,   3466,  -4466, -12398, -12901, -13405, -11984,
+-10563,  -9154,  -7746,  -6289,  -4833,  -6087,  -7341,  -7180,
+ -7019,  -5344,  -3669,   1917,   7503,  11025,  14547,  11413,
+  8280,   3063,  -2154,   1361,   4876,   7465,  10054,   8281,
+  6509,   6160,   5812,  -1319,  -8450, -11121, -13792, -11597,
+ -9402,  -5538,  -1674,   5169,  12012,  10420,   8828,   5092,
+  1357,  -4643, -10643,  -9602,  -8562,   -169,   8223,   9229,
+ 10236,   7738,   5241,  -1459,  -8160, -11581, -15002, -11975,
+ -8949,  -5356,  -1763,   4097,   9957,   6147,   2337,  -4538,
+-11414, -11135, -10857,  -5624,   -392,   6571,  13534,  10749,
+  7964,   8057,   8151,   3491,  -1168,  -8132, -15097, -13012,
+-10927,  -8502,  -6077,  -5806,  -5535,  -6447,  -7359,  -6979,
+ -6600,  -5603,  -4607,  -5220,  -5834,  -3356,   -878,   2641,
+  6160,   6822,   7484,  10638,  13793,  13088,  12384,  10547,
+  8710,   9227,   9745,   3971,  -1803,  -7864, -13925, -10685,
+ -7446,  -2359,   2727,   8232,  13737,   7469,   1202,  -5361,
+-11924,  -9305,  -6687,  -6390,  -6094,  -2961,    172,   6853,
+ 13535,  12177,  10819,   2818,  -5183,  -6375,  -7568,    276,
+  8121,  11444,  14768,  12571,  10374,   9537,   8700,   8258,
+  7817,   3580,   -657,   -527,   -397,   4637,   9671,   2563,
+ -4544,  -8968, -13392, -11514,  -9637,  -8630,  -7623,  -7288,
+ -6953,  -4118,  -1283,   1990,   5263,   2499,   -264,   2582,
+  5428,   9981,  14535,  11774,   9013,   9073,   9134,   6621,
+  4109,  -2991, -10091, -11074, -12058,  -8180,  -4302,   1983,
+  8269,   7516,   6764,    451,  -5861,  -3467,  -1073,   4537,
+ 10148,  10001,   9855,   8445,   7035,   6997,   6959,   5105,
+  3252,   -995,  -5243,  -8198, -11154, -11729, -12305, -10890,
+ -9475,  -8663,  -7851,  -7592,  -7333,  -6428,  -5523,  -5952,
+ -6382,  -4242,  -2103,   1360,   4824,   5932,   7040,  10335,
+ 13630,  12487,  11345,  10270,   9195,   8679,   8163,   5440,
+  2717,  -2155,  -7027,  -9291, -11555,  -9909,  -8264,  -7089,
+ -5915,  -5588,  -5262,  -2542,    177,   3663,   7149,   5127,
+  3105,   2802,   2499,   5535,   8572,   8841,   9111,   5781,
+  2451,   1518,    585,  -1239,  -3063,  -3088,  -3113,  -2493,
+ -1874,  -2943,  -4012,  -1571,    869,   3815,   6761,   9695,
+ 12629,  11075,   9522,   8876,   8230,   9298,  10366,   5309,
+   253,  -3352,  -6957,  -7243,  -7530,  -3590,    349,   4066,
+  7784,   7356,   6929,   9089,  11250,  10356,   9463,   8715,
+  7967,   5351,   2736,    607,  -1522,  -3177,  -4832,  -7671,
+-10510,  -9849,  -9188,  -8349,  -7511,  -6934,  -6358,  -5265,
+ -4173,   1449,   7071,  10939,  14807,  13154,  11502,  10281,
+  9061,   8795,   8530,   7465,   6400,   3468,    537,   -426,
+ -1389,  -2617,  -3845,  -4778,  -5712,  -1805,   2102,   5097,
+  8092,   7996,   7900,   6906,   5912,   5331,   4751,   4303,
+  3855,   3140,   2426,  -2011,  -6449, -11153, -15857, -14797,
+-13738, -12501, -11265, -10453,  -9642,  -9130,  -8618,  -6639,
+ -4660,  -1450,   1759,   3319,   4880,   6696,   8513,   8905,
+  9297,   8026,   6756,   6428,   6101,   4827,   3554,    -68,
+ -3691,  -7226, -10762, -11841, -12920, -11896, -10873,  -9025,
+ -7177,  -2161,   2855,   6782,  10710,   7353,   3997,   3153,
+  2310,   4041,   5773,   5608,   5443,   4045,   2648,  -4270,
+-11189, -13237, -15285, -11362,  -7440,  -8039,  -8638,  -6622,
+ -4607,  -1448,   1711,   1852,   1993,   1916,   1839,  -1254,
+ -4348,   -570,   3207,   5245,   7284,   2920,  -1443,  -4682,
+ -7921,  -7216,  -6512,  -3546,   -581,   -908,  -1235,  -1668,
+ -2101,  -4459,  -6817,  -8897, -10977,  -5782,   -588,   6080,
+ 12748,   8124,   3500,  -2280,  -8061, -10463, -12865, -10045,
+ -7226,  -1537,   4152,   6976,   9801,   5208,    615,  -6955,
+-14525, -11223,  -7922,  -1357,   5208,   8413,  11618,   8945,
+  6272,   1774,  -2723,  -5754,  -8785, -10983, -13182,  -8317,
+ -3453,    895,   5243,    723,  -3797,  -6973, -10150,  -9541,
+ -8932,  -5919,  -2907,   2871,   8649,  10290,  11932,  10413,
+  8895,   7281,   5668,   2086,  -1495,  -2569,  -3643,  -4737,
+ -5832,  -8426, -11020, -10601, -10183,  -9197,  -8211,  -6069,
+ -3928,   -641,   2645,   4732,   6820,   4978,   3137,   3184,
+  3231,   5342,   7453,   6600,   5747,   6673,   7599,   2251,
+ -3097,  -9598, -16100, -13366, -10632, -10287,  -9943,  -7334,
+ -4725,   2768,  10262,  10399,  10537,   7370,   4203,   2890,
+  1578,    957,    336,    528,    721,   2706,   4691,   2041,
+  -608,  -6660, -12713, -13166, -13619, -11621,  -9623,  -9738,
+ -9853,  -5273,   -694,   5797,  12289,  10813,   9337,   7975,
+  6614,   5985,   5357,   4808,   4260,   3861,   3462,   2906,
+  2350,   -663,  -3677,  -6775,  -9874, -11528, -13182, -10472,
+ -7762,  -3101,   1559,    330,   -898,  -2558,  -4219,  -4236,
+ -4254,  -2501,   -749,   1359,   3468,   3531,   3594,   -736,
+ -5066, -10187, -15308, -13844, -12380, -10120,  -7861,  -8747,
+ -9633, -11385, -13138, -11928, -10719, -10542, -10366,  -8458,
+ -6550,    469,   7488,   8891,  10295,   8306,   6318,   4918,
+  3519,   1534,   -450,   -464,   -478,  -1424,  -2370,  -6831,
+-11292, -13424, -15557, -13744, -11931, -11197, -10464,  -9955,
+ -9447,  -8980,  -8514,  -8098,  -7682,  -5144,  -2606,   2061,
+  6729,   8111,   9494,   8963,   8432,   7389,   6347,   3307,
+   267,   -620,  -1508,  -2074,  -2640,  -3976,  -5312,  -2453,
+   405,   3688,   6971,   6285,   5599,   4812,   4025,   2852,
+  1680,   -149,  -1979,  -4944,  -7910, -11355, -14800, -14745,
+-14690, -13819, -12948, -12164, -11381, -10892, -10404,  -9463,
+ -8522,  -5115,  -1709,   -100,   1508,   3240,   4972,   7037,
+  9103,   7543,   5983,   5353,   4723,   1132,  -2459,  -6229,
+-10000,  -8930,  -7861,  -7788,  -7716,  -8364,  -9012,  -6369,
+ -3726,     56,   3839,   4525,   5212,   5475,   5738,   4214,
+  2691,  -1118,  -4927,  -8572, -12218, -11725, -11233,  -6412,
+ -1591,    188,   1967,    458,  -1051,  -4115,  -7179,  -9600,
+-12022,  -8524,  -5027,    455,   5938,   5490,   5043,   3963,
+  2884,  -1560,  -6005, -11194, -16383, -15817, -15251, -12798,
+-10345,  -9792,  -9240,  -9580,  -9920,  -8378,  -6837,  -3260,
+   316,   2704,   5092,   4699,   4307,   3400,   2494,   1439,
+   385,  -1054,  -2494,  -4757,  -7021,  -9412, -11804, -12654,
+-13504, -12519, -11534, -10766,  -9999,  -9401,  -8804,  -6515,
+ -4226,  -2347,   -468,    206,    881,    440,      0,    892,
+  1784,   5113,   8442,   8228,   8015,   6601,   5187,   2231,
+  -725,  -3308,  -5891,  -5202,  -4514,  -4639,  -4765,  -5090,
+ -5416,  -4077,  -2739,  -1085,    569,    -39,   -647,  -3443,
+ -6240,  -7238,  -8237,  -6159,  -4082,  -1337,   1407,    932,
+   458,  -2884,  -6227,  -8624, -11021, -11593, -12166,  -9843,
+ -7520,  -3593,    333,   2641,   4950,   3289,   1628,  -1137,
+ -3902,  -3030,  -2159,   1128,   4415,   5428,   6441,   3700,
+   959,  -4171,  -9302, -11066, -12830, -10114,  -7398,  -3479,
+   440,   1556,   2672,    877,   -918,  -1413,  -1908,  -1697,
+ -1487,  -1142,   -797,  -2360,  -3924,  -5402,  -6881,  -6951,
+ -7021,  -6254,  -5488,  -3557,  -1627,    907,   3441,   4792,
+  6143,   6076,   6009,   6319,   6629,   6224,   5819,   5042,
+  4266,   3923,   3580,   2736,   1892,  -3121,  -8135, -12180,
+-16226, -15206, -14186, -13063, -11940, -11089, -10239,  -9986,
+ -9733,  -8804,  -7875,  -6021,  -4168,   -477,   3213,   7017,
+ 10822,   9938,   9055,   7635,   6216,   3401,    587,  -3256,
+ -7100,  -8445,  -9790, -10228, -10666, -10076,  -9486,  -8444,
+ -7402,  -6921,  -6441,  -5233,  -4026,  -1612,    801,   4284,
+  7767,   8523,   9279,   7759,   6240,   5569,   4898,   5006,
+  5114,   4140,   3166,   1632,     99,   -627,  -1353,  -1992,
+ -2631,  -2689,  -2748,  -2820,  -2892,  -3878,  -4865,  -5016,
+ -5168,  -3663,  -2159,  -1474,   -789,  -1609,  -2430,  -2950,
+ -3471,  -3521,  -3572,  -3332,  -3093,  -1628,   -163,    894,
+  1952,   2081,   2210,   1526,    843,  -1261,  -3365,  -5500,
+ -7635,  -7756,  -7877,  -6066,  -4256,  -2340,   -425,   -195,
+    35,   -909,  -1853,  -1874,  -1895,   -605,    684,   2755,
+  4826,   5667,   6509,   5382,   4255,   2340,    425,   -683,
+ -1791,  -2134,  -2478,  -3050,  -3623,  -4162,  -4702,  -5251,
+ -5800,  -5817,  -5834,  -4034,  -2234,   -145,   1943,   1960,
+  1978,   1124,    271,    326,    381,   1341,   2301,   2124,
+  1947,    934,    -79,  -1087,  -2095,  -2742,  -3389,  -2739,
+ -2090,  -1632,  -1175,  -2587,  -3999,  -5389,  -6780,  -7341,
+ -7903,  -7276,  -6650,  -4984,  -3319,  -2273,  -1228,    449,
+  2127,   3617,   5108,   6011,   6915,   7067,   7219,   7082,
+  6945,   6193,   5441,   2967,    493,  -1572,  -3637,  -3553,
+ -3470,  -2822,  -2175,  -1986,  -1798,  -1214,   -630,   -604,
+  -578,   -563,   -549,    645,   1839,   3209,   4579,   5085,
+  5592,   5262,   4933,   4009,   3086,   2339,   1592,   1530,
+  1468,    399,   -669,  -2816,  -4963,  -5704,  -6446,  -4258,
+ -2071,    716,   3503,   4013,   4523,   3493,   2464,   1610,
+   757,    805,    854,   1182,   1511,   1280,   1049,    289,
+  -470,   -943,  -1417,  -2160,  -2903,  -4241,  -5579,  -6178,
+ -6778,  -6140,  -5502,  -3930,  -2358,  -1388,   -419,  -1448,
+ -2478,  -3127,  -3777,  -3592,  -3408,  -3311,  -3215,  -2405,
+ -1595,  -1174,   -753,   -973,  -1194,  -1691,  -2188,  -2104,
+ -2021,   -887,    246,   1969,   3693,   5048,   6404,   7200,
+  7997,   7560,   7124,   5692,   4261,   3392,   2524,   2180,
+  1837,    891,    -54,  -1044,  -2035,  -1702,  -1370,   -884,
+  -398,   -560,   -723,  -1625,  -2527,  -3479,  -4431,  -3903,
+ -3375,  -1959,   -543,    303,   1150,    769,    389,   -644,
+ -1677,  -1909,  -2141,  -1089,    -38,    987,   2012,   2211,
+  2410,   2221,   2032,   2057,   2082,   2445,   2809,   3782,
+  4755,   6129,   7504,   7439,   7374,   5873,   4373,   2232,
+    91,  -1522,  -3135,  -3196,  -3257,  -2782,  -2307,  -2049,
+ -1791,  -1492,  -1194,   -820,   -446,   -835,  -1225,  -1332,
+ -1440,   -124,   1192,   2877,   4562,   5440,   6318,   5239,
+  4160,   2053,    -54,  -1412,  -2770,  -2629,  -2489,  -1804,
+ -1119,  -1028,   -937,   -989,  -1042,   -630,   -218,    946,
+  2111,   3451,   4791,   5592,   6394,   5756,   5119,   3435,
+  1751,    229,  -1292,  -1615,  -1939,  -1541,  -1144,  -1583,
+ -2022,  -3076,  -4130,  -4470,  -4810,  -3831,  -2852,  -1882,
+  -913,   -265,    383,    474,    565,    166,   -233,   -979,
+ -1725,  -2329,  -2934,  -2745,  -2557,  -2278,  -1999,  -1497,
+  -995,   -509,    -23,    756,   1535,   3839,   6144,   7815,
+  9486,   9185,   8885,   8828,   8772,   7697,   6623,   5451,
+  4280,   3762,   3244,   2177,   1110,     94,   -921,  -3002,
+ -5084,  -6790,  -8497,  -7951,  -7406,  -6647,  -5889,  -4321,
+ -2754,  -1112,    529,    517,    505,    232,    -40,    535,
+  1110,   2573,   4037,   4802,   5568,   5146,   4725,   3925,
+  3125,   2703,   2282,   2184,   2087,   1518,    949,    493,
+    38,    663,   1289,   2011,   2734,   3047,   3360,   3226,
+  3092,   2283,   1474,   1108,    743,   1259,   1775,   1955,
+  2135,   1945,   1755,   1809,   1863,   1132,    401,   -849,
+ -2099,  -2537,  -2976,  -2450,  -1924,  -1329,   -735,   -216,
+   303,    769,   1235,    781,    328,   -109,   -547,    181,
+   909,   1478,   2047,   2033,   2019,   2275,   2532,   2439,
+  2346,   2046,   1746,   1880,   2015,   2220,   2426,   1824,
+  1222,    169,   -883,  -1191,  -1499,  -1579,  -1659,  -1515,
+ -1371,   -584,    203,    818,   1434,    929,    424,   -232,
+  -888,   -332,    223,   1095,   1968,   2161,   2354,   1946,
+  1538,    545,   -448,  -1036,  -1625,   -730,    164,   1147,
+  2130,   1936,   1743,   1316,    889,   1019,   1150,   1365,
+  1581,   1647,   1714,   1573,   1433,    854,    276,   -125,
+  -527,   -341,   -156,   -137,   -118,   -487,   -856,  -1397,
+ -1939,  -2110,  -2282,  -1492,   -703,    118,    939,   1211,
+  1483,   1434,   1386,   1142,    898,    936,    975,   1417,
+  1860,   2803,   3746,   4235,   4724,   4501,   4278,   4023,
+  3769,   3436,   3103,   3051,   2999,   3246,   3494,   3458,
+  3422,   2527,   1632,    600,   -431,   -826,  -1222,   -781,
+  -340,     92,    525,    310,     96,   -120,   -336,   -575,
+  -815,   -950,  -1086,  -1024,   -962,  -1077,  -1192,  -1499,
+ -1807,  -1847,  -1887,  -1741,  -1595,  -1401,  -1208,   -516,
+   175,   1073,   1971,   2622,   3273,   3421,   3570,   3112,
+  2654,   2441,   2228,   2346,   2464,   2289,   2115,   1643,
+  1171,    857,    544,    151,   -242,   -852,  -1462,  -1760,
+ -2058,  -1985,  -1912,  -1571,  -1231,  -1020,   -809,   -317,
+   175,    807,   1439,   1298,   1158,    566,    -25,   -138,
+  -252,    215,    683,   1069,   1456,   1792,   2128,   2224,
+  2320,   2003,   1687,   1274,    862,    828,    795,   1106,
+  1417,   2002,   2588,   3120,   3653,   3315,   2978,   2318,
+  1659,   1473,   1287,   1355,   1423,   1030,    637,   -305,
+ -1248,  -2466,  -3684,  -4341,  -4998,  -4677,  -4356,  -3808,
+ -3261,  -2634,  -2007,  -1309,   -611,    183,    977,   1710,
+  2444,   3026,   3609,   4095,   4581,   4836,   5092,   5447,
+  5803,   5972,   6142,   5652,   5162,   4103,   3044,   1859,
+   675,   -150,   -975,  -1081,  -1188,   -589,      9,    397,
+   785,    599,    414,   -200,   -814,  -1349,  -1884,  -1952,
+ -2020,  -1477,   -935,   -559,   -183,   -490,   -797,  -1268,
+ -1739,  -1909,  -2079,  -1569,  -1059,   -417,    225,    596,
+   968,    974,    981,   1046,   1111,   1267,   1423,   1551,
+  1679,   1992,   2305,   2772,   3239,   3118,   2998,   1934,
+   870,     60,   -749,   -987,  -1225,  -1101,   -978,   -674,
+  -370,   -612,   -854,  -1645,  -2436,  -2504,  -2573,  -1927,
+ -1282,   -785,   -288,    352,    993,   1509,   2025,   2015,
+  2006,   1864,   1723,   1425,   1128,    861,    595,    788,
+   982,   1304,   1626,   1872,   2119,   2554,   2989,   3417,
+  3845,   3401,   2957,   2005,   1053,    515,    -22,    214,
+   450,    970,   1490,   1413,   1336,    581,   -174,  -1068,
+ -1963,  -2116,  -2269,  -1730,  -1192,   -394,    403,    891,
+  1380,   1367,   1355,    984,    613,    340,     67,    100,
+   134,     59,    -16,    -65,   -114,   -169,   -225,   -255,
+  -286,    -22,    242,    713,   1184,   1305,   1427,   1423,
+  1419,   1683,   1948,   1997,   2047,   1660,   1273,    914,
+   555,    352,    150,   -187,   -525,   -798,  -1071,   -952,
+  -834,   -575,   -317,   -218,   -119,   -130,   -142,   -129,
+  -116,    263,    643,   1155,   1667,   1893,   2119,   2073,
+  2028,   1949,   1870,   1858,   1847,   1544,   1241,    519,
+  -202,   -622,  -1043,   -892,   -741,   -364,     12,    380,
+   749,    390,     31,   -782,  -1595,  -2073,  -2552,  -2643,
+ -2734,  -2591,  -2449,  -1986,  -1524,   -843,   -162,    -24,
+   114,   -416,   -946,  -1523,  -2101,  -2015,  -1930,  -1100,
+  -271,    654,   1579,   1870,   2161,   2040,   1920,   1735,
+  1551,   1203,    856,    774,    693,    923,   1154,   1154
+};
+
+static const short tickdata_96000_normal[] = {
+  -797,   -724,   -651,   -607,   -570,   -548,   -535,   -518,
+  -497,   -479,   -468,   -458,   -442,   -425,   -377,   -327,
+  -250,   -166,   -118,    -94,    -66,    -31,    -16,    -69,
+  -117,    -73,    -30,    -77,   -137,    -56,     83,     47,
+  -148,   -156,    188,    394,    -81,   -557,   -115,    333,
+  -669,  -1998,    866,   6097,  10888,  15171,  18113,  17705,
+ 16366,   7404,  -1557, -13836, -26357, -23747, -16229,  -5854,
+  6605,  13794,  13122,  12021,   9433,   6969,   6951,   6934,
+ -5759, -20334, -25437, -26363, -25460, -22849, -20246, -17657,
+-15055, -12378,  -9702, -11938, -14243, -14442, -14147, -12091,
+ -9013,  -2659,   7605,  16811,  23283,  28506,  22749,  16991,
+  7691,  -1895,    524,   6984,  12471,  17228,  18823,  15566,
+ 12878,  12238,  11089,  -2014, -15117, -21140, -26049, -24813,
+-20780, -15182,  -8081,    843,  13417,  23566,  20640,  17715,
+ 10932,   4068,  -6135, -17160, -20089, -18178, -10200,   5220,
+ 16949,  18798,  20034,  15446,  10857,   -824, -13138, -20982,
+-27268, -26864, -21303, -15338,  -8736,  -1256,   9512,  19675,
+ 12675,   5675,  -6154, -18789, -22480, -21969, -16874,  -7260,
+  3393,  16188,  26303,  21185,  16068,  16095,  16267,   9487,
+   924, -10258, -23055, -28499, -24668, -20671, -16215, -12110,
+-11612, -11114, -12598, -14274, -14206, -13508, -12178, -10348,
+ -9644, -10771, -10739,  -6185,  -1580,   4886,  11352,  13354,
+ 14571,  18872,  24669,  26944,  25649,  23689,  20314,  17556,
+ 18507,  19457,   9240,  -1369, -12395, -23531, -24205, -18252,
+-10822,  -1475,   8069,  18184,  26533,  15017,   3501,  -8506,
+-20566, -20346, -15535, -13074, -12529, -10034,  -4277,   2766,
+ 15043,  27020,  24524,  22029,   9236,  -5466, -11827, -14018,
+ -8075,   6338,  18153,  24260,  28987,  24950,  20912,  19273,
+ 17735,  16765,  15954,  10920,   3134,  -1212,   -973,   1533,
+ 10784,  18365,   5304,  -7756, -16388, -24517, -24296, -20846,
+-18266, -16416, -15019, -14404, -12913,  -7704,  -2485,   3529,
+  9544,   6277,   1198,   2922,   8152,  14897,  23264,  27516,
+ 22443,  18040,  18151,  18262,  13871,   9255,  -1899, -14946,
+-21264, -23071, -21110, -13984,  -5775,   5774,  16443,  15061,
+ 13678,   3191,  -8407,  -8579,  -4180,   3394,  13703,  20199,
+ 19930,  19235,  16644,  14070,  14000,  13930,  11092,   7686,
+  1407,  -6397, -13072, -18503, -22625, -23683, -24292, -21692,
+-19091, -17539, -16047, -15336, -14860, -13681, -12018, -11373,
+-12163, -11828,  -7897,  -3817,   2547,   8912,  11449,  13484,
+ 18363,  24418,  26146,  24047,  21992,  20016,  18223,  17275,
+ 16326,  11323,   6319,  -1935, -10888, -16743, -20903, -21691,
+-18667, -15896, -13738, -11760, -11161, -10561,  -5833,   -835,
+  5234,  11639,  12124,   8408,   5982,   5425,   6288,  11868,
+ 17171,  17666,  18161,  12852,   6733,   3700,   1986,   -585,
+ -3937,  -6142,  -6188,  -6032,  -4894,  -3755,  -5699,  -7664,
+ -4363,    121,   5199,  10613,  16016,  21407,  24442,  21587,
+ 18914,  17727,  16540,  18288,  20251,  13716,   4425,  -3323,
+ -9948, -14125, -14652, -13435,  -6195,   1024,   7854,  14685,
+ 14884,  14099,  16613,  20583,  21651,  20009,  18458,  17084,
+ 15149,  10343,   5537,   1613,  -2298,  -5506,  -8547, -12965,
+-18181, -20467, -19252, -17946, -16405, -14913, -13855, -12796,
+-10859,  -8852,   -616,   9714,  18203,  25311,  28416,  25380,
+ 22516,  20274,  18103,  17615,  17127,  15369,  13412,   9099,
+  3713,    171,  -1598,  -3530,  -5787,  -7959,  -9674, -11389,
+ -4391,   2787,   8621,  14125,  16074,  15898,  14980,  13154,
+ 11534,  10467,   9423,   8600,   7777,   6504,   5191,  -1194,
+ -9348, -17779, -26422, -30959, -29012, -26996, -24724, -22479,
+-20988, -19497, -18477, -17537, -14763, -11126,  -6351,   -453,
+  4455,   7322,  10260,  13597,  16935,  17726,  18446,  16735,
+ 14401,  13139,  12538,  11168,   8828,   5342,  -1313,  -7956,
+-14452, -20949, -23331, -25314, -24458, -22577, -19851, -16456,
+-10842,  -1625,   7183,  14400,  21253,  15085,   8918,   6676,
+  5126,   6762,   9944,  11395,  11092,  10065,   7497,   3480,
+ -9232, -21945, -26013, -29777, -24883, -17674, -15554, -16655,
+-15664, -11961,  -7714,  -1908,   3444,   3702,   3961,   3858,
+  3717,   -459,  -6144,  -4872,   2069,   7815,  11561,  12987,
+  4968,  -3008,  -8959, -14910, -14750, -13455,  -9391,  -3942,
+ -1457,  -2058,  -2719,  -3515,  -4792,  -9125, -13458, -17300,
+-21123, -14487,  -4942,   6242,  18494,  21854,  13358,   4327,
+ -6295, -16453, -20866, -25280, -21078, -15897,  -6913,   3540,
+ 11129,  16318,  16501,   8062,  -1418, -15328, -28967, -22901,
+-16835,  -5750,   6313,  14302,  20191,  20863,  15952,  10015,
+  1750,  -6165, -11735, -17305, -21418, -25458, -19432, -10493,
+ -2123,   5866,   6983,  -1322,  -9023, -14860, -20224, -19105,
+-17985, -12931,  -7395,   1769,  12387,  18919,  21936,  22858,
+ 20068,  17245,  14280,  11291,   4710,  -1870,  -4627,  -6601,
+ -8599, -10611, -13934, -18700, -21809, -21041, -20145, -18333,
+-16521, -12702,  -8767,  -3214,   2825,   7560,  11396,  12236,
+  8852,   6295,   6381,   6700,  10578,  14457,  13519,  11952,
+ 12698,  14400,   9984,    157, -10420, -22367, -31312, -26288,
+-21264, -20631, -19998, -15940, -11146,   -551,  13218,  20643,
+ 20895,  19371,  13552,   8127,   5715,   3303,   2085,    944,
+   942,   1296,   3576,   7223,   7394,   2526,  -3788, -14909,
+-25471, -26304, -27137, -24016, -20345, -19394, -19605, -15298,
+ -6883,   2750,  14678,  24116,  21405,  18693,  16190,  13688,
+ 12285,  11130,  10069,   9062,   8181,   7448,   6633,   5611,
+  4098,  -1439,  -6977, -12660, -18353, -22043, -25082, -23485,
+-18505, -12086,  -3523,   2611,    353,  -1941,  -4992,  -8044,
+ -8466,  -8498,  -6273,  -3054,    504,   4379,   6976,   7091,
+  5889,  -2067, -10023, -19413, -28823, -28438, -25748, -22133,
+-17981, -16464, -18092, -20165, -23384, -26049, -23827, -21605,
+-21138, -20814, -18109, -14603,  -5730,   7167,  15993,  18572,
+ 19794,  16141,  12532,   9959,   7387,   3887,    240,   -918,
+  -944,  -1843,  -3582,  -7473, -15670, -23198, -27116, -31035,
+-27851, -24520, -22780, -21432, -20343, -19409, -18509, -17652,
+-16820, -16056, -14920, -10256,  -5592,   2664,  11241,  15342,
+ 17882,  18437,  17461,  16121,  14206,  11517,   5931,    479,
+ -1151,  -2782,  -3907,  -4947,  -6950,  -9405,  -7980,  -2727,
+  2780,   8813,  13754,  12493,  11233,   9792,   8346,   6336,
+  4181,   1279,  -2083,  -6368, -11816, -17499, -23830, -29592,
+-29490, -29389, -27922, -26321, -24839, -23399, -22262, -21363,
+-20149, -18420, -15767,  -9507,  -3337,   -381,   2574,   5722,
+  8904,  12500,  16295,  16782,  13916,  11596,  10438,   8503,
+  1904,  -4693, -11611, -18539, -18449, -16484, -15640, -15507,
+-15951, -17142, -16769, -11912,  -6884,     66,   7017,   8819,
+ 10080,  10776,  11259,   9934,   7134,   2763,  -4236, -11176,
+-17874, -24417, -23512, -22607, -14993,  -6135,  -1003,   2266,
+  2576,   -196,  -3863,  -9494, -14964, -19413, -23863, -17880,
+-11453,  -2172,   7902,  11378,  10556,   9235,   7252,   3712,
+ -4454, -12724, -22259, -31794, -31832, -30792, -27251, -22744,
+-20137, -19122, -18710, -19335, -19301, -16468, -13584,  -7012,
+  -440,   4304,   8691,   9708,   8987,   7810,   6144,   4395,
+  2458,    429,  -2216,  -4862,  -8949, -13108, -17450, -21845,
+-24544, -26105, -26245, -24435, -22723, -21312, -19923, -18825,
+-17727, -13860,  -9654,  -5986,  -2534,   -270,    969,   1471,
+   661,    301,   1940,   3609,   9726,  15843,  16558,  16166,
+ 14333,  11735,   7787,   2355,  -2870,  -7616, -11627, -10361,
+ -9096,  -9246,  -9477,  -9990, -10588,  -9377,  -6917,  -4216,
+ -1176,    872,   -245,  -1609,  -6747, -11885, -14102, -15938,
+-13773,  -9956,  -5488,   -445,   2505,   1634,   -169,  -6311,
+-12453, -16858, -21263, -22908, -23960, -21573, -17304, -11653,
+ -4437,   1907,   6149,   9548,   6495,   3443,  -1513,  -6594,
+ -6584,  -4983,   -784,   5255,   9590,  11452,  11718,   6681,
+  1405,  -8021, -17449, -21448, -24690, -22163, -17172, -11023,
+ -3822,   1592,   3643,   4783,   1485,  -1813,  -2739,  -3648,
+ -3500,  -3114,  -2569,  -1935,  -2923,  -5796,  -8624, -11340,
+-13776, -13904, -14033, -12729, -11321,  -8298,  -4750,   -561,
+  4094,   7878,  10361,  12259,  12136,  12046,  12615,  13184,
+ 12610,  11865,  10647,   9221,   8206,   7576,   6633,   5082,
+  2279,  -6932, -16144, -23602, -31036, -30934, -29060, -27066,
+-25003, -23168, -21605, -20349, -19884, -19292, -17585, -15878,
+-12600,  -9194,  -3262,   3519,  10420,  17411,  21003,  19380,
+ 17543,  14934,  12221,   7049,   1877,  -4927, -11990, -15899,
+-18370, -19991, -20795, -20970, -19886, -18672, -16757, -14843,
+-13939, -13057, -11101,  -8883,  -5277,   -841,   4475,  10875,
+ 15912,  17301,  18293,  15500,  12707,  11347,  10114,   9943,
+ 10141,   9217,   7427,   5239,   2422,    -82,  -1416,  -2745,
+ -3920,  -5094,  -5354,  -5461,  -5585,  -5718,  -6696,  -8509,
+ -9821, -10099,  -9923,  -7158,  -4394,  -3094,  -1834,  -2777,
+ -4285,  -5452,  -6408,  -6983,  -7075,  -7027,  -6587,  -5948,
+ -3257,   -565,   1445,   3389,   4079,   4316,   3720,   2463,
+   213,  -3653,  -7531, -11454, -15277, -15498, -15720, -12925,
+ -9598,  -6141,  -2622,   -640,   -217,   -483,  -2218,  -3711,
+ -3750,  -3788,  -1501,    868,   4370,   8176,  10598,  12144,
+ 12116,  10045,   7600,   4082,    684,  -1352,  -3389,  -4154,
+ -4785,  -5722,  -6774,  -7793,  -8784,  -9782, -10790, -11606,
+-11637, -11601,  -8294,  -4986,  -1231,   2607,   3908,   3940,
+  3188,   1620,    574,    675,   1003,   2766,   4530,   4290,
+  3964,   2437,    575,  -1280,  -3132,  -4700,  -5888,  -6477,
+ -5284,  -4117,  -3276,  -2436,  -4680,  -7274,  -9840, -12395,
+-14121, -15153, -15384, -14232, -12718,  -9657,  -6612,  -4691,
+ -2769,    123,   3206,   6061,   8800,  11018,  12678,  13916,
+ 14195,  14406,  14154,  13902,  12575,  11193,   7357,   2811,
+ -1285,  -5080,  -7210,  -7056,  -6648,  -5459,  -4327,  -3980,
+ -3633,  -2639,  -1566,  -1225,  -1178,  -1141,  -1115,   -307,
+  1887,   4141,   6658,   9164,  10095,  11025,  10681,  10076,
+  8758,   7061,   5518,   4145,   3149,   3035,   2695,    731,
+ -1232,  -5069,  -9014, -10974, -12336, -10514,  -6494,  -2017,
+  3103,   7229,   8166,   8930,   7038,   5147,   3541,   1972,
+  1577,   1666,   2028,   2632,   2872,   2447,   1851,    455,
+  -941,  -1810,  -2680,  -3958,  -5323,  -7395,  -9853, -11675,
+-12777, -13214, -12041, -10670,  -7781,  -4892,  -3044,  -1263,
+ -2279,  -4171,  -5654,  -6847,  -7415,  -7076,  -6774,  -6597,
+ -6349,  -4861,  -3373,  -2512,  -1738,  -1790,  -2195,  -2866,
+ -3779,  -4322,  -4169,  -3687,  -1604,    477,   3637,   6804,
+  9419,  11909,  13744,  15208,  15623,  14821,  13496,  10866,
+  8349,   6752,   5156,   4459,   3828,   2362,    624,  -1160,
+ -2981,  -3825,  -3214,  -2539,  -1647,   -811,  -1109,  -1408,
+ -2890,  -4547,  -6268,  -8017,  -8360,  -7390,  -5865,  -3263,
+  -831,    723,   2279,   1611,    912,   -757,  -2656,  -3623,
+ -4050,  -3402,  -1469,    449,   2333,   4062,   4427,   4792,
+  4499,   4152,   4099,   4144,   4545,   5213,   6323,   8111,
+ 10060,  12585,  15003,  14883,  14764,  12366,   9609,   6043,
+  2109,  -1330,  -4294,  -6307,  -6420,  -6378,  -5505,  -4631,
+ -4150,  -3676,  -3142,  -2593,  -1958,  -1271,  -1214,  -1929,
+ -2503,  -2701,  -2650,   -232,   2186,   5227,   8323,  10320,
+ 11933,  11516,   9533,   6818,   2947,   -634,  -3130,  -5532,
+ -5273,  -5014,  -3899,  -2641,  -2125,  -1958,  -1923,  -2020,
+ -1837,  -1080,   -115,   2024,   4164,   6617,   9079,  10754,
+ 12227,  12063,  10892,   8870,   5775,   2760,    -35,  -2636,
+ -3231,  -3826,  -3212,  -2481,  -2880,  -3687,  -5124,  -7061,
+ -8498,  -9122,  -9252,  -7453,  -5655,  -3874,  -2092,   -813,
+   378,    879,   1046,    765,     32,   -905,  -2275,  -3608,
+ -4719,  -5831,  -5533,  -5187,  -4709,  -4197,  -3434,  -2511,
+ -1602,   -708,    324,   1756,   3416,   7650,  11884,  15066,
+ 18136,  18570,  18017,  17713,  17609,  16806,  14831,  12822,
+ 10669,   8541,   7589,   6637,   4834,   2873,    975,   -890,
+ -3716,  -7540, -11149, -14285, -16858, -15855, -14852, -13475,
+-12082,  -9525,  -6645,  -3682,   -665,   1049,   1027,    884,
+   383,     -1,   1055,   2113,   4635,   7324,   9088,  10495,
+ 10715,   9940,   8911,   7441,   6103,   5328,   4561,   4382,
+  4204,   3300,   2254,   1346,    508,    631,   1780,   2984,
+  4311,   5542,   6117,   6692,   6485,   6239,   5031,   3544,
+  2546,   1875,   1886,   2835,   3631,   3962,   4246,   3897,
+  3548,   3598,   3697,   2766,   1424,   -431,  -2728,  -4488,
+ -5294,  -5774,  -4808,  -3841,  -2748,  -1655,   -678,    275,
+  1166,   2022,   2074,   1240,    416,   -388,   -931,    407,
+  1746,   2807,   3853,   4075,   4049,   4317,   4789,   4993,
+  4822,   4560,   4010,   3508,   3755,   4002,   4364,   4742,
+  4070,   2963,   1417,   -516,  -1967,  -2532,  -3024,  -3171,
+ -3317,  -3053,  -2788,  -1551,   -105,   1136,   2267,   2432,
+  1505,    496,   -709,  -1657,   -636,    384,   1952,   3555,
+  4207,   4561,   4270,   3520,   2331,    506,  -1147,  -2227,
+ -3160,  -1516,    127,   1914,   3720,   4011,   3656,   3075,
+  2290,   1861,   2101,   2368,   2763,   3159,   3283,   3405,
+  3217,   2959,   2186,   1124,    211,   -527,   -957,   -616,
+  -308,   -273,   -238,   -867,  -1545,  -2463,  -3459,  -4060,
+ -4375,  -3981,  -2531,  -1067,    441,   1902,   2402,   2902,
+  2889,   2799,   2460,   2012,   1832,   1903,   2226,   3039,
+  4002,   5735,   7468,   8378,   9277,   9116,   8706,   8260,
+  7793,   7260,   6648,   6180,   6084,   6045,   6500,   6954,
+  6927,   6860,   5613,   3969,   2181,    285,  -1149,  -1875,
+ -2267,  -1457,   -648,    147,    942,    710,    315,    -81,
+  -478,   -897,  -1337,  -1713,  -1962,  -2155,  -2040,  -1926,
+ -2131,  -2342,  -2837,  -3403,  -3661,  -3734,  -3654,  -3385,
+ -3093,  -2737,  -2294,  -1023,    247,   1866,   3516,   4829,
+  6026,   6701,   6973,   6814,   5973,   5226,   4835,   4464,
+  4681,   4898,   4653,   4332,   3640,   2773,   2052,   1476,
+   852,    130,   -651,  -1772,  -2893,  -3456,  -4004,  -4009,
+ -3875,  -3436,  -2811,  -2291,  -1903,  -1378,   -473,    453,
+  1614,   2776,   2643,   2385,   1517,    429,   -167,   -375,
+  -176,    682,   1511,   2221,   2929,   3547,   4164,   4406,
+  4583,   4249,   3667,   2998,   2239,   1704,   1643,   1672,
+  2243,   2814,   3873,   4949,   5948,   6927,   6927,   6307,
+  5429,   4217,   3230,   2888,   2584,   2709,   2835,   2193,
+  1471,     13,  -1719,  -3729,  -5967,  -7819,  -9027,  -9880,
+ -9290,  -8692,  -7685,  -6679,  -5550,  -4398,  -3159,  -1877,
+  -508,    951,   2375,   3723,   5033,   6104,   7175,   8075,
+  8968,   9530,   9999,  10580,  11232,  11739,  12050,  12057,
+ 11157,  10178,   8232,   6287,   4134,   1958,    257,  -1258,
+ -2056,  -2252,  -1972,   -872,    154,    867,   1566,   1225,
+   884,   -115,  -1244,  -2276,  -3260,  -3829,  -3953,  -3734,
+ -2738,  -1781,  -1090,   -399,   -904,  -1468,  -2265,  -3130,
+ -3665,  -3978,  -3763,  -2826,  -1829,   -649,    496,   1179,
+  1861,   1947,   1959,   2048,   2167,   2377,   2663,   2931,
+  3166,   3464,   4039,   4616,   5474,   6333,   6295,   6073,
+  4719,   2764,   1031,   -456,  -1629,  -2066,  -2422,  -2195,
+ -1968,  -1428,   -870,  -1082,  -1526,  -2568,  -4022,  -4925,
+ -5050,  -4863,  -3678,  -2509,  -1595,   -682,    464,   1641,
+  2656,   3604,   4040,   4023,   3920,   3660,   3349,   2802,
+  2255,   1766,   1277,   1483,   1838,   2346,   2938,   3464,
+  3917,   4471,   5271,   6069,   6855,   7642,   6924,   6108,
+  4581,   2831,   1528,    540,    133,    567,   1121,   2077,
+  2973,   2831,   2689,   1454,     66,  -1500,  -3144,  -4074,
+ -4355,  -4195,  -3205,  -2134,   -668,    797,   1698,   2595,
+  2741,   2719,   2275,   1593,    994,    493,    152,    213,
+   253,    115,    -22,   -116,   -206,   -305,   -407,   -482,
+  -539,   -378,    107,    678,   1544,   2379,   2602,   2826,
+  2848,   2841,   3176,   3662,   3944,   4034,   3852,   3141,
+  2438,   1778,   1118,    742,    370,   -202,   -823,  -1368,
+ -1869,  -2042,  -1825,  -1535,  -1061,   -616,   -434,   -251,
+  -257,   -279,   -267,   -243,    165,    864,   1658,   2598,
+  3425,   3840,   4234,   4151,   4068,   3931,   3786,   3726,
+  3704,   3409,   2853,   2040,    714,   -524,  -1298,  -2071,
+ -1815,  -1537,   -926,   -234,    448,   1125,   1202,    543,
+  -343,  -1838,  -3274,  -4153,  -5032,  -5257,  -5424,  -5274,
+ -5012,  -4419,  -3569,  -2563,  -1311,   -270,    -16,    194,
+  -778,  -1752,  -2801,  -3863,  -4096,  -3939,  -3093,  -1569,
+    12,   1712,   3238,   3773,   4308,   4107,   3886,   3571,
+  3232,   2707,   2068,   1645,   1496,   1498,   1922,   2309,
+  2308
+};
+
+static const short tickdata_96000_accent[] = {
+     0,      0,      0,      0,      0,      0,      0,      0,
+     0,   -797,   -651,   -570,   -535,   -497,   -468,   -442,
+  -377,   -250,   -118,    -66,    -16,   -117,    -30,   -137,
+    83,   -148,    188,    -81,   -115,   -669,    866,  10888,
+ 18113,  16366,  -1557, -26357, -16229,   6605,  13122,   9433,
+  6951,  -5759, -25437, -25460, -20246, -15055,  -9702, -14243,
+-14147,  -9013,   7605,  23283,  22749,   7691,    524,  12471,
+ 18823,  12878,  11089, -15117, -26049, -20780,  -8081,  13417,
+ 20640,  10932,  -6135, -20089, -10200,  16949,  20034,  10857,
+-13138, -27268, -21303,  -8736,   9512,  12675,  -6154, -22480,
+-16874,   3393,  26303,  16068,  16267,    924, -23055, -24668,
+-16215, -11612, -12598, -14206, -12178,  -9644, -10739,  -1580,
+ 11352,  14571,  24669,  25649,  20314,  18507,   9240, -12395,
+-24205, -10822,   8069,  26533,   3501, -20566, -15535, -12529,
+ -4277,  15043,  24524,   9236, -11827,  -8075,  18153,  28987,
+ 20912,  17735,  15954,   3134,   -973,  10784,   5304, -16388,
+-24296, -18266, -15019, -12913,  -2485,   9544,   1198,   8152,
+ 23264,  22443,  18151,  13871,  -1899, -21264, -21110,  -5775,
+ 16443,  13678,  -8407,  -4180,  13703,  19930,  16644,  14000,
+ 11092,   1407, -13072, -22625, -24292, -19091, -16047, -14860,
+-12018, -12163,  -7897,   2547,  11449,  18363,  26146,  21992,
+ 18223,  16326,   6319, -10888, -20903, -18667, -13738, -11161,
+ -5833,   5234,  12124,   5982,   6288,  17171,  18161,   6733,
+  1986,  -3937,  -6188,  -4894,  -5699,  -4363,   5199,  16016,
+ 24442,  18914,  16540,  20251,   4425,  -9948, -14652,  -6195,
+  7854,  14884,  16613,  21651,  18458,  15149,   5537,  -2298,
+ -8547, -18181, -19252, -16405, -13855, -10859,   -616,  18203,
+ 28416,  22516,  18103,  17127,  13412,   3713,  -1598,  -5787,
+ -9674,  -4391,   8621,  16074,  14980,  11534,   9423,   7777,
+  5191,  -9348, -26422, -29012, -24724, -20988, -18477, -14763,
+ -6351,   4455,  10260,  16935,  18446,  14401,  12538,   8828,
+ -1313, -14452, -23331, -24458, -19851, -10842,   7183,  21253,
+  8918,   5126,   9944,  11092,   7497,  -9232, -26013, -24883,
+-15554, -15664,  -7714,   3444,   3961,   3717,  -6144,   2069,
+ 11561,   4968,  -8959, -14750,  -9391,  -1457,  -2719,  -4792,
+-13458, -21123,  -4942,  18494,  13358,  -6295, -20866, -21078,
+ -6913,  11129,  16501,  -1418, -28967, -16835,   6313,  20191,
+ 15952,   1750, -11735, -21418, -19432,  -2123,   6983,  -9023,
+-20224, -17985,  -7395,  12387,  21936,  20068,  14280,   4710,
+ -4627,  -8599, -13934, -21809, -20145, -16521,  -8767,   2825,
+ 11396,   8852,   6381,  10578,  13519,  12698,   9984, -10420,
+-31312, -21264, -19998, -11146,  13218,  20895,  13552,   5715,
+  2085,    942,   3576,   7394,  -3788, -25471, -27137, -20345,
+-19605,  -6883,  14678,  21405,  16190,  12285,  10069,   8181,
+  6633,   4098,  -6977, -18353, -25082, -18505,  -3523,    353,
+ -4992,  -8466,  -6273,    504,   6976,   5889, -10023, -28823,
+-25748, -17981, -18092, -23384, -23827, -21138, -18109,  -5730,
+ 15993,  19794,  12532,   7387,    240,   -944,  -3582, -15670,
+-27116, -27851, -22780, -20343, -18509, -16820, -14920,  -5592,
+ 11241,  17882,  17461,  14206,   5931,  -1151,  -3907,  -6950,
+ -7980,   2780,  13754,  11233,   8346,   4181,  -2083, -11816,
+-23830, -29490, -27922, -24839, -22262, -20149, -15767,  -3337,
+  2574,   8904,  16295,  13916,  10438,   1904, -11611, -18449,
+-15640, -15951, -16769,  -6884,   7017,  10080,  11259,   7134,
+ -4236, -17874, -23512, -14993,  -1003,   2576,  -3863, -14964,
+-23863, -11453,   7902,  10556,   7252,  -4454, -22259, -31832,
+-27251, -20137, -18710, -19301, -13584,   -440,   8691,   8987,
+  6144,   2458,  -2216,  -8949, -17450, -24543, -26245, -22723,
+-19923, -17727,  -9654,  -2534,    969,    661,   1940,   9726,
+ 16558,  14333,   7787,  -2870, -11627,  -9096,  -9477, -10588,
+ -6917,  -1176,   -245,  -6747, -14102, -13773,  -5488,   2505,
+  -169, -12453, -21263, -23960, -17304,  -4437,   6149,   6495,
+ -1513,  -6584,   -784,   9590,  11718,   1405, -17449, -24690,
+-17172,  -3822,   3643,   1485,  -2739,  -3500,  -2569,  -2923,
+ -8624, -13776, -14033, -11321,  -4750,   4094,  10361,  12136,
+ 12615,  12609,  10647,   8206,   6633,   2279, -16144, -31036,
+-29060, -25003, -21605, -19884, -17585, -12600,  -3262,  10420,
+ 21003,  17543,  12221,   1877, -11990, -18370, -20795, -19886,
+-16757, -13939, -11101,  -5277,   4475,  15912,  18293,  12707,
+ 10114,  10141,   7427,   2422,  -1416,  -3920,  -5354,  -5585,
+ -6696,  -9821,  -9923,  -4394,  -1834,  -4285,  -6408,  -7075,
+ -6587,  -3256,   1445,   4079,   3720,    213,  -7531, -15277,
+-15720,  -9598,  -2622,   -217,  -2218,  -3750,  -1501,   4370,
+ 10598,  12116,   7600,    684,  -3389,  -4785,  -6774,  -8784,
+-10790, -11637,  -8293,  -1231,   3908,   3188,    574,   1002,
+  4530,   3964,    575,  -3132,  -5888,  -5284,  -3276,  -4680,
+ -9840, -14121, -15384, -12718,  -6612,  -2769,   3206,   8800,
+ 12678,  14195,  14154,  12574,   7357,  -1285,  -7210,  -6648,
+ -4327,  -3633,  -1566,  -1178,  -1115,   1887,   6658,  10095,
+ 10681,   8758,   5518,   3149,   2695,  -1232,  -9014, -12336,
+ -6494,   3103,   8166,   7038,   3541,   1577,   2028,   2872,
+  1851,   -940,  -2680,  -5323,  -9853, -12777, -12041,  -7781,
+ -3044,  -2279,  -5654,  -7415,  -6774,  -6349,  -3373,  -1738,
+ -2195,  -3779,  -4169,  -1604,   3637,   9419,  13744,  15623,
+ 13496,   8349,   5156,   3828,    624,  -2981,  -3214,  -1647,
+ -1109,  -2890,  -6268,  -8360,  -5865,   -831,   2279,    912,
+ -2656,  -4050,  -1469,   2333,   4427,   4499,   4099,   4545,
+  6323,  10060,  15003,  14764,   9609,   2109,  -4294,  -6420,
+ -5505,  -4150,  -3142,  -1958,  -1214,  -2503,  -2650,   2186,
+  8323,  11933,   9533,   2947,  -3130,  -5273,  -3899,  -2125,
+ -1923,  -1837,   -115,   4164,   9079,  12227,  10892,   5775,
+   -35,  -3231,  -3212,  -2880,  -5124,  -8498,  -9252,  -5655,
+ -2092,    378,   1046,     32,  -2275,  -4719,  -5533,  -4709,
+ -3434,  -1602,    324,   3416,  11884,  18136,  18017,  17609,
+ 14831,  10669,   7589,   4834,    975,  -3716, -11149, -16858,
+-14852, -12082,  -6645,   -665,   1027,    383,   1055,   4635,
+  9088,  10715,   8911,   6103,   4561,   4204,   2254,    508,
+  1780,   4311,   6117,   6485,   5031,   2546,   1886,   3631,
+  4246,   3548,   3697,   1424,  -2728,  -5294,  -4808,  -2748,
+  -678,   1166,   2074,    416,   -931,   1746,   3853,   4049,
+  4789,   4822,   4010,   3755,   4364,   4070,   1417,  -1967,
+ -3024,  -3317,  -2788,   -105,   2267,   1505,   -709,   -636,
+  1952,   4207,   4270,   2331,  -1147,  -3160,    127,   3720,
+  3656,   2290,   2101,   2763,   3283,   3217,   2186,    211,
+  -957,   -308,   -238,  -1545,  -3459,  -4375,  -2531,    441,
+  2402,   2888,   2460,   1832,   2226,   4002,   7468,   9277,
+  8706,   7793,   6648,   6084,   6500,   6927,   5613,   2181,
+ -1149,  -2267,   -648,    942,    315,   -478,  -1337,  -1962,
+ -2040,  -2131,  -2837,  -3661,  -3654,  -3093,  -2294,    247,
+  3516,   6026,   6973,   5973,   4835,   4681,   4653,   3640,
+  2052,    852,   -651,  -2893,  -4004,  -3875,  -2811,  -1903,
+  -473,   1614,   2643,   1517,   -167,   -176,   1511,   2929,
+  4164,   4583,   3667,   2239,   1643,   2243,   3873,   5948,
+  6927,   5429,   3230,   2584,   2835,   1471,  -1719,  -5967,
+ -9027,  -9290,  -7685,  -5550,  -3159,   -508,   2375,   5033,
+  7175,   8968,   9999,  11232,  12050,  11157,   8232,   4134,
+   257,  -2056,  -1972,    154,   1566,    884,  -1244,  -3260,
+ -3953,  -2738,  -1090,   -904,  -2265,  -3665,  -3763,  -1829,
+   496,   1861,   1959,   2167,   2663,   3166,   4039,   5474,
+  6295,   4719,   1031,  -1629,  -2422,  -1968,   -870,  -1526,
+ -4022,  -5050,  -3678,  -1595,    464,   2656,   4040,   3920,
+  3349,   2255,   1277,   1838,   2938,   3917,   5271,   6855,
+  6924,   4581,   1528,    133,   1121,   2973,   2689,     66,
+ -3144,  -4355,  -3205,   -668,   1698,   2741,   2275,    994,
+   152,    253,    -22,   -206,   -407,   -539,    107,   1544,
+  2602,   2848,   3176,   3944,   3852,   2438,   1118,    370,
+  -823,  -1869,  -1825,  -1061,   -434,   -257,   -267,    165,
+  1658,   3425,   4234,   4068,   3786,   3704,   2853,    714,
+ -1298,  -1815,   -926,    448,   1202,   -343,  -3274,  -5032,
+ -5424,  -5012,  -3569,  -1311,    -16,   -778,  -2801,  -4096,
+ -3093,     12,   3238,   4308,   3886,   3232,   2068,   1496,
+  1922
+};
+
+static const short tickdata_96000_secondary[] = {
+  -398,   -361,   -325,   -303,   -284,   -273,   -267,   -259,
+  -248,   -239,   -234,   -229,   -220,   -212,   -188,   -163,
+  -125,    -83,    -59,    -47,    -32,    -15,     -8,    -34,
+   -58,    -36,    -14,    -38,    -68,    -28,     41,     23,
+   -74,    -78,     94,    196,    -40,   -278,    -57,    166,
+  -334,   -999,    433,   3048,   5444,   7585,   9056,   8852,
+  8183,   3702,   -778,  -6917, -13178, -11873,  -8114,  -2926,
+  3302,   6897,   6561,   6010,   4716,   3484,   3475,   3467,
+ -2879, -10167, -12718, -13181, -12730, -11424, -10122,  -8828,
+ -7527,  -6189,  -4851,  -5969,  -7121,  -7221,  -7073,  -6045,
+ -4506,  -1329,   3802,   8405,  11641,  14253,  11374,   8495,
+  3845,   -947,    262,   3491,   6235,   8613,   9411,   7782,
+  6439,   6119,   5544,  -1007,  -7558, -10570, -13024, -12406,
+-10389,  -7590,  -4040,    421,   6708,  11783,  10320,   8857,
+  5466,   2034,  -3067,  -8580, -10044,  -9088,  -5100,   2610,
+  8474,   9399,  10017,   7722,   5428,   -412,  -6568, -10490,
+-13633, -13432, -10651,  -7668,  -4367,   -627,   4756,   9837,
+  6337,   2837,  -3077,  -9394, -11239, -10984,  -8436,  -3629,
+  1696,   8094,  13151,  10592,   8033,   8047,   8133,   4743,
+   462,  -5129, -11527, -14249, -12334, -10335,  -8107,  -6054,
+ -5805,  -5557,  -6298,  -7136,  -7102,  -6754,  -6089,  -5173,
+ -4821,  -5385,  -5369,  -3092,   -790,   2443,   5676,   6677,
+  7285,   9435,  12334,  13471,  12824,  11844,  10156,   8777,
+  9253,   9728,   4620,   -684,  -6197, -11765, -12102,  -9126,
+ -5411,   -738,   4034,   9092,  13266,   7508,   1750,  -4253,
+-10283, -10172,  -7767,  -6536,  -6264,  -5017,  -2138,   1383,
+  7521,  13509,  12261,  11014,   4618,  -2732,  -5913,  -7009,
+ -4037,   3169,   9076,  12129,  14493,  12474,  10456,   9636,
+  8867,   8382,   7977,   5460,   1567,   -605,   -486,    767,
+  5392,   9182,   2652,  -3877,  -8193, -12258, -12148, -10423,
+ -9133,  -8208,  -7509,  -7202,  -6456,  -3852,  -1242,   1764,
+  4772,   3138,    599,   1461,   4076,   7448,  11632,  13758,
+ 11221,   9020,   9075,   9131,   6935,   4627,   -949,  -7472,
+-10631, -11535, -10555,  -6992,  -2887,   2887,   8221,   7530,
+  6839,   1595,  -4203,  -4289,  -2090,   1697,   6851,  10099,
+  9964,   9617,   8321,   7034,   6999,   6964,   5545,   3842,
+   703,  -3198,  -6536,  -9251, -11312, -11841, -12145, -10845,
+ -9545,  -8769,  -8023,  -7668,  -7430,  -6840,  -6009,  -5686,
+ -6081,  -5913,  -3948,  -1908,   1273,   4456,   5724,   6742,
+  9181,  12209,  13073,  12023,  10995,  10007,   9111,   8637,
+  8162,   5661,   3159,   -967,  -5443,  -8371, -10451, -10845,
+ -9333,  -7948,  -6869,  -5880,  -5580,  -5280,  -2916,   -417,
+  2617,   5819,   6062,   4204,   2991,   2712,   3144,   5934,
+  8585,   8833,   9080,   6426,   3366,   1850,    993,   -292,
+ -1968,  -3070,  -3093,  -3016,  -2447,  -1877,  -2849,  -3831,
+ -2181,     60,   2599,   5306,   8007,  10703,  12221,  10793,
+  9457,   8863,   8270,   9144,  10125,   6858,   2212,  -1662,
+ -4974,  -7062,  -7325,  -6717,  -3098,    511,   3927,   7342,
+  7442,   7049,   8306,  10291,  10825,  10004,   9229,   8542,
+  7574,   5171,   2768,    806,  -1149,  -2752,  -4273,  -6482,
+ -9090, -10233,  -9625,  -8973,  -8202,  -7456,  -6927,  -6397,
+ -5429,  -4425,   -307,   4857,   9101,  12655,  14207,  12689,
+ 11257,  10136,   9051,   8807,   8563,   7684,   6706,   4549,
+  1856,     85,   -799,  -1765,  -2893,  -3979,  -4836,  -5694,
+ -2195,   1393,   4310,   7062,   8036,   7948,   7489,   6576,
+  5766,   5233,   4711,   4300,   3888,   3252,   2595,   -597,
+ -4673,  -8889, -13210, -15479, -14506, -13498, -12362, -11239,
+-10494,  -9748,  -9238,  -8768,  -7381,  -5562,  -3175,   -226,
+  2227,   3660,   5129,   6798,   8467,   8863,   9223,   8367,
+  7200,   6569,   6268,   5583,   4413,   2671,   -657,  -3978,
+ -7226, -10474, -11665, -12656, -12229, -11288,  -9925,  -8228,
+ -5421,   -812,   3591,   7199,  10626,   7542,   4458,   3338,
+  2563,   3381,   4972,   5697,   5546,   5032,   3748,   1739,
+ -4616, -10972, -13006, -14888, -12441,  -8837,  -7776,  -8327,
+ -7831,  -5980,  -3856,   -954,   1721,   1851,   1980,   1928,
+  1858,   -229,  -3071,  -2435,   1034,   3907,   5780,   6493,
+  2484,  -1503,  -4479,  -7455,  -7375,  -6727,  -4695,  -1971,
+  -728,  -1028,  -1359,  -1757,  -2395,  -4562,  -6728,  -8649,
+-10561,  -7243,  -2471,   3121,   9247,  10927,   6678,   2163,
+ -3147,  -8226, -10432, -12639, -10538,  -7948,  -3457,   1769,
+  5564,   8159,   8250,   4031,   -709,  -7664, -14483, -11450,
+ -8417,  -2875,   3156,   7151,  10095,  10431,   7976,   5007,
+   875,  -3082,  -5867,  -8652, -10708, -12728,  -9716,  -5246,
+ -1061,   2933,   3491,   -661,  -4511,  -7430, -10111,  -9552,
+ -8992,  -6465,  -3697,    884,   6193,   9459,  10967,  11428,
+ 10033,   8622,   7140,   5645,   2355,   -935,  -2313,  -3300,
+ -4299,  -5305,  -6966,  -9350, -10904, -10520, -10072,  -9166,
+ -8260,  -6350,  -4383,  -1606,   1412,   3780,   5697,   6117,
+  4426,   3147,   3190,   3349,   5289,   7228,   6759,   5976,
+  6348,   7199,   4991,     78,  -5209, -11183, -15655, -13143,
+-10631, -10315,  -9998,  -7969,  -5572,   -275,   6608,  10321,
+ 10447,   9685,   6776,   4063,   2857,   1651,   1042,    471,
+   470,    647,   1787,   3611,   3697,   1263,  -1894,  -7454,
+-12735, -13151, -13568, -12008, -10172,  -9697,  -9802,  -7649,
+ -3441,   1375,   7339,  12058,  10702,   9346,   8094,   6843,
+  6142,   5565,   5034,   4530,   4090,   3723,   3316,   2805,
+  2048,   -720,  -3488,  -6330,  -9176, -11021, -12541, -11742,
+ -9252,  -6043,  -1761,   1305,    176,   -970,  -2496,  -4021,
+ -4233,  -4249,  -3136,  -1526,    252,   2189,   3487,   3545,
+  2944,  -1033,  -5011,  -9706, -14411, -14219, -12874, -11066,
+ -8990,  -8232,  -9046, -10082, -11692, -13024, -11913, -10802,
+-10568, -10406,  -9054,  -7301,  -2865,   3583,   7996,   9286,
+  9897,   8070,   6265,   4979,   3693,   1943,    120,   -458,
+  -471,   -921,  -1790,  -3736,  -7834, -11598, -13557, -15517,
+-13925, -12259, -11390, -10716, -10171,  -9704,  -9254,  -8825,
+ -8409,  -8027,  -7459,  -5128,  -2796,   1332,   5620,   7670,
+  8941,   9218,   8730,   8060,   7102,   5758,   2965,    239,
+  -576,  -1391,  -1953,  -2473,  -3474,  -4702,  -3989,  -1363,
+  1389,   4406,   6876,   6246,   5616,   4895,   4172,   3167,
+  2090,    639,  -1041,  -3183,  -5908,  -8749, -11914, -14795,
+-14744, -14694, -13960, -13160, -12419, -11699, -11130, -10681,
+-10074,  -9210,  -7883,  -4753,  -1668,   -190,   1286,   2861,
+  4452,   6250,   8147,   8391,   6957,   5797,   5219,   4251,
+   952,  -2346,  -5805,  -9269,  -9224,  -8242,  -7820,  -7753,
+ -7975,  -8570,  -8384,  -5956,  -3442,     32,   3508,   4409,
+  5040,   5387,   5629,   4966,   3567,   1381,  -2117,  -5587,
+ -8937, -12208, -11756, -11303,  -7496,  -3067,   -501,   1133,
+  1287,    -98,  -1931,  -4746,  -7481,  -9706, -11931,  -8939,
+ -5726,  -1086,   3950,   5689,   5277,   4617,   3626,   1856,
+ -2227,  -6361, -11129, -15896, -15916, -15396, -13625, -11372,
+-10068,  -9561,  -9354,  -9667,  -9650,  -8233,  -6792,  -3506,
+  -220,   2151,   4345,   4854,   4493,   3904,   3071,   2197,
+  1228,    214,  -1108,  -2431,  -4474,  -6554,  -8724, -10922,
+-12271, -13052, -13122, -12217, -11361, -10656,  -9961,  -9412,
+ -8863,  -6929,  -4826,  -2992,  -1266,   -134,    484,    735,
+   330,    150,    970,   1804,   4863,   7921,   8279,   8083,
+  7166,   5867,   3893,   1177,  -1435,  -3808,  -5813,  -5180,
+ -4548,  -4623,  -4738,  -4994,  -5293,  -4688,  -3458,  -2108,
+  -588,    435,   -122,   -804,  -3373,  -5942,  -7051,  -7968,
+ -6886,  -4977,  -2744,   -222,   1252,    816,    -85,  -3156,
+ -6226,  -8429, -10631, -11453, -11979, -10786,  -8652,  -5826,
+ -2219,    953,   3074,   4773,   3247,   1721,   -756,  -3297,
+ -3291,  -2491,   -392,   2627,   4794,   5725,   5858,   3340,
+   702,  -4011,  -8724, -10724, -12344, -11081,  -8586,  -5511,
+ -1911,    795,   1821,   2391,    742,   -906,  -1369,  -1824,
+ -1750,  -1556,  -1284,   -967,  -1461,  -2897,  -4312,  -5670,
+ -6888,  -6952,  -7016,  -6364,  -5660,  -4148,  -2375,   -280,
+  2047,   3939,   5180,   6129,   6067,   6022,   6307,   6592,
+  6305,   5932,   5323,   4610,   4103,   3787,   3316,   2540,
+  1139,  -3466,  -8072, -11801, -15518, -15467, -14530, -13533,
+-12501, -11583, -10802, -10174,  -9941,  -9645,  -8792,  -7938,
+ -6299,  -4596,  -1630,   1759,   5210,   8705,  10501,   9690,
+  8771,   7466,   6110,   3524,    938,  -2463,  -5994,  -7949,
+ -9184,  -9995, -10397, -10485,  -9943,  -9336,  -8378,  -7421,
+ -6969,  -6528,  -5550,  -4441,  -2638,   -420,   2237,   5437,
+  7955,   8650,   9146,   7750,   6353,   5673,   5057,   4971,
+  5070,   4608,   3713,   2619,   1210,    -41,   -708,  -1372,
+ -1960,  -2547,  -2677,  -2730,  -2792,  -2859,  -3348,  -4254,
+ -4910,  -5049,  -4961,  -3578,  -2196,  -1546,   -917,  -1388,
+ -2142,  -2726,  -3204,  -3491,  -3537,  -3513,  -3293,  -2973,
+ -1628,   -282,    722,   1694,   2039,   2157,   1859,   1231,
+   106,  -1826,  -3765,  -5726,  -7638,  -7749,  -7860,  -6462,
+ -4799,  -3070,  -1310,   -320,   -108,   -242,  -1109,  -1855,
+ -1875,  -1894,   -750,    434,   2185,   4088,   5299,   6072,
+  6058,   5022,   3800,   2040,    341,   -676,  -1694,  -2076,
+ -2392,  -2860,  -3386,  -3896,  -4391,  -4890,  -5395,  -5803,
+ -5818,  -5800,  -4146,  -2492,   -615,   1303,   1953,   1969,
+  1593,    809,    286,    337,    501,   1382,   2264,   2145,
+  1982,   1218,    288,   -639,  -1565,  -2349,  -2944,  -3238,
+ -2642,  -2058,  -1638,  -1217,  -2339,  -3637,  -4920,  -6197,
+ -7060,  -7576,  -7691,  -7115,  -6358,  -4828,  -3305,  -2345,
+ -1384,     61,   1602,   3030,   4400,   5508,   6339,   6957,
+  7097,   7202,   7076,   6950,   6287,   5596,   3678,   1405,
+  -642,  -2539,  -3604,  -3527,  -3324,  -2729,  -2163,  -1990,
+ -1816,  -1319,   -783,   -612,   -589,   -570,   -557,   -153,
+   943,   2070,   3328,   4582,   5047,   5512,   5340,   5038,
+  4378,   3530,   2759,   2072,   1574,   1517,   1347,    366,
+  -615,  -2534,  -4506,  -5486,  -6167,  -5256,  -3246,  -1008,
+  1552,   3614,   4083,   4465,   3519,   2573,   1770,    986,
+   788,    833,   1014,   1315,   1435,   1223,    925,    227,
+  -470,   -905,  -1340,  -1978,  -2661,  -3697,  -4926,  -5837,
+ -6388,  -6606,  -6020,  -5334,  -3890,  -2446,  -1521,   -631,
+ -1139,  -2085,  -2827,  -3423,  -3707,  -3538,  -3387,  -3298,
+ -3174,  -2430,  -1686,  -1255,   -868,   -894,  -1097,  -1433,
+ -1889,  -2161,  -2084,  -1843,   -802,    238,   1818,   3402,
+  4709,   5954,   6871,   7603,   7811,   7410,   6748,   5433,
+  4174,   3376,   2578,   2229,   1914,   1181,    312,   -580,
+ -1490,  -1912,  -1606,  -1269,   -823,   -405,   -554,   -703,
+ -1444,  -2273,  -3133,  -4008,  -4180,  -3695,  -2932,  -1631,
+  -416,    361,   1139,    805,    455,   -379,  -1328,  -1811,
+ -2025,  -1700,   -734,    224,   1166,   2030,   2213,   2396,
+  2249,   2075,   2049,   2072,   2272,   2606,   3161,   4055,
+  5029,   6292,   7501,   7441,   7382,   6182,   4804,   3021,
+  1054,   -665,  -2147,  -3153,  -3209,  -3188,  -2752,  -2315,
+ -2074,  -1837,  -1570,  -1296,   -978,   -635,   -606,   -964,
+ -1251,  -1350,  -1324,   -115,   1093,   2613,   4161,   5160,
+  5966,   5758,   4766,   3409,   1473,   -317,  -1564,  -2765,
+ -2636,  -2507,  -1949,  -1320,  -1062,   -978,   -961,  -1009,
+  -918,   -539,    -57,   1012,   2081,   3308,   4539,   5377,
+  6113,   6031,   5445,   4434,   2887,   1380,    -17,  -1318,
+ -1615,  -1912,  -1606,  -1240,  -1440,  -1843,  -2562,  -3530,
+ -4249,  -4561,  -4626,  -3726,  -2827,  -1937,  -1046,   -406,
+   188,    439,    522,    382,     16,   -452,  -1137,  -1804,
+ -2359,  -2915,  -2766,  -2593,  -2354,  -2098,  -1716,  -1255,
+  -800,   -354,    162,    877,   1707,   3825,   5942,   7533,
+  9068,   9285,   9008,   8856,   8804,   8402,   7415,   6410,
+  5334,   4270,   3794,   3318,   2417,   1436,    488,   -444,
+ -1857,  -3770,  -5574,  -7142,  -8428,  -7927,  -7426,  -6737,
+ -6040,  -4762,  -3322,  -1840,   -332,    524,    513,    441,
+   191,      0,    527,   1056,   2317,   3661,   4544,   5247,
+  5357,   4969,   4455,   3720,   3051,   2663,   2280,   2191,
+  2101,   1649,   1126,    672,    254,    315,    890,   1492,
+  2155,   2771,   3058,   3346,   3242,   3119,   2515,   1772,
+  1272,    937,    942,   1417,   1815,   1980,   2123,   1948,
+  1774,   1799,   1848,   1383,    711,   -216,  -1364,  -2244,
+ -2647,  -2887,  -2403,  -1920,  -1374,   -827,   -339,    137,
+   582,   1010,   1036,    619,    207,   -194,   -465,    203,
+   872,   1403,   1926,   2037,   2024,   2158,   2394,   2496,
+  2411,   2280,   2004,   1753,   1877,   2000,   2181,   2370,
+  2034,   1481,    708,   -258,   -983,  -1266,  -1512,  -1585,
+ -1658,  -1526,  -1394,   -775,    -52,    568,   1133,   1216,
+   752,    247,   -354,   -828,   -318,    191,    975,   1777,
+  2103,   2280,   2134,   1759,   1165,    253,   -573,  -1113,
+ -1580,   -758,     63,    956,   1859,   2005,   1827,   1537,
+  1145,    930,   1050,   1183,   1381,   1579,   1641,   1702,
+  1608,   1479,   1093,    561,    105,   -263,   -478,   -307,
+  -154,   -136,   -119,   -433,   -772,  -1231,  -1729,  -2030,
+ -2187,  -1990,  -1265,   -533,    220,    950,   1200,   1450,
+  1444,   1399,   1230,   1006,    916,    951,   1113,   1519,
+  2001,   2867,   3734,   4189,   4638,   4558,   4353,   4130,
+  3896,   3629,   3323,   3089,   3041,   3022,   3249,   3476,
+  3463,   3430,   2806,   1984,   1090,    142,   -574,   -937,
+ -1133,   -728,   -323,     73,    470,    354,    157,    -40,
+  -238,   -448,   -668,   -856,   -980,  -1077,  -1020,   -963,
+ -1065,  -1171,  -1418,  -1701,  -1830,  -1866,  -1826,  -1692,
+ -1546,  -1368,  -1147,   -512,    123,    932,   1757,   2414,
+  3012,   3350,   3486,   3406,   2986,   2612,   2417,   2231,
+  2340,   2448,   2326,   2166,   1819,   1386,   1026,    737,
+   426,     65,   -325,   -886,  -1446,  -1728,  -2002,  -2004,
+ -1937,  -1718,  -1405,  -1145,   -951,   -689,   -237,    226,
+   806,   1387,   1321,   1192,    758,    215,    -83,   -187,
+   -88,    341,    755,   1110,   1464,   1773,   2081,   2202,
+  2291,   2124,   1833,   1498,   1119,    852,    821,    835,
+  1121,   1407,   1936,   2474,   2974,   3463,   3463,   3153,
+  2714,   2108,   1614,   1443,   1292,   1354,   1417,   1096,
+   735,      6,   -859,  -1864,  -2983,  -3909,  -4513,  -4939,
+ -4644,  -4345,  -3842,  -3339,  -2775,  -2199,  -1579,   -938,
+  -253,    475,   1187,   1861,   2516,   3051,   3587,   4037,
+  4483,   4764,   4999,   5289,   5616,   5869,   6025,   6028,
+  5578,   5089,   4116,   3143,   2066,    978,    128,   -629,
+ -1028,  -1126,   -986,   -436,     76,    433,    782,    612,
+   441,    -58,   -622,  -1138,  -1629,  -1914,  -1976,  -1867,
+ -1369,   -890,   -544,   -199,   -451,   -733,  -1132,  -1565,
+ -1832,  -1988,  -1881,  -1412,   -914,   -324,    248,    589,
+   930,    973,    979,   1023,   1083,   1188,   1331,   1465,
+  1582,   1731,   2019,   2307,   2736,   3166,   3147,   3036,
+  2359,   1382,    515,   -227,   -814,  -1033,  -1211,  -1097,
+  -984,   -713,   -434,   -540,   -763,  -1284,  -2010,  -2462,
+ -2525,  -2431,  -1838,  -1254,   -797,   -340,    232,    820,
+  1328,   1802,   2020,   2011,   1960,   1830,   1674,   1401,
+  1127,    883,    638,    741,    919,   1173,   1469,   1732,
+  1958,   2235,   2635,   3034,   3427,   3820,   3462,   3054,
+  2290,   1415,    764,    270,     66,    283,    560,   1038,
+  1486,   1415,   1344,    727,     33,   -749,  -1571,  -2036,
+ -2177,  -2097,  -1602,  -1067,   -334,    398,    848,   1297,
+  1370,   1359,   1137,    796,    496,    246,     75,    106,
+   126,     57,    -11,    -57,   -102,   -152,   -203,   -241,
+  -269,   -188,     53,    339,    771,   1189,   1300,   1412,
+  1423,   1420,   1587,   1830,   1971,   2016,   1926,   1570,
+  1219,    889,    559,    371,    185,   -101,   -411,   -683,
+  -934,  -1021,   -912,   -767,   -530,   -307,   -216,   -125,
+  -128,   -139,   -133,   -121,     83,    431,    828,   1298,
+  1712,   1919,   2117,   2075,   2033,   1965,   1892,   1862,
+  1852,   1704,   1426,   1020,    357,   -262,   -648,  -1035,
+  -907,   -768,   -463,   -117,    223,    562,    600,    271,
+  -172,   -919,  -1636,  -2076,  -2516,  -2628,  -2712,  -2636,
+ -2506,  -2209,  -1784,  -1281,   -655,   -135,     -8,     97,
+  -389,   -876,  -1400,  -1931,  -2047,  -1969,  -1546,   -784,
+     6,    856,   1619,   1886,   2153,   2053,   1942,   1785,
+  1615,   1353,   1034,    822,    748,    749,    960,   1154,
+  1153
+};
+
+static const struct {
+  int rate;
+  const short* data[VOICE_VARIANT_NUMBER];
+  int frames[VOICE_VARIANT_NUMBER];
+} tickdata_rates[] = {
+  { 44100,
+    { tickdata_44100_normal, tickdata_44100_accent, tickdata_44100_secondary },
+    { 956, 487, 956 } },
+  { 48000,
+    { tickdata_48000_normal, tickdata_48000_accent, tickdata_48000_secondary },
+    { 1040, 529, 1040 } },
+  { 88200,
+    { tickdata_88200_normal, tickdata_88200_accent, tickdata_88200_secondary },
+    { 1912, 965, 1912 } },
+  { 96000,
+    { tickdata_96000_normal, tickdata_96000_accent, tickdata_96000_secondary },
+    { 2081, 1049, 2081 } }
+};
@@ -0,0 +1,405 @@
+/*
+ * timeline.c: setlists, compiled into a schedule of ticks
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "dsp.h"
+#include "timeline.h"
+#include "smf.h"
+
+/* maximum length of a line in a setlist file */
+#define TIMELINE_MAX_LINE 1024
+
+/*
+ * returns new, empty timeline
+ */
+timeline_t* timeline_new(void)
+{
+  return (timeline_t*) g_malloc0(sizeof(timeline_t));
+}
+
+/*
+ * destroys timeline, including compiled schedule
+ */
+void timeline_delete(timeline_t* timeline)
+{
+  int i;
+
+  for (i = 0; i < timeline->n_sections; i++) {
+    if (timeline->sections[i].name) free(timeline->sections[i].name);
+    if (timeline->sections[i].soundname) free(timeline->sections[i].soundname);
+    if (timeline->sections[i].durations) free(timeline->sections[i].durations);
+  }
+  if (timeline->sections) free(timeline->sections);
+  if (timeline->events) free(timeline->events);
+  if (timeline->bars) free(timeline->bars);
+  free(timeline);
+}
+
+/*
+ * returns 1 if <unit> is a note value a tick can have (a power of 2 up to
+ * TIMELINE_MAX_UNIT), 0 otherwise
+ */
+int timeline_valid_unit(int unit)
+{
+  return unit >= 1 && unit <= TIMELINE_MAX_UNIT && !(unit & (unit - 1));
+}
+
+/*
+ * sets the field <key> of <section> to <value>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int set_field(timeline_section_t* section,
+                     const char* key, const char* value)
+{
+  char* end;
+  int i;
+
+  if (!strcmp(key, "name")) {
+    if (section->name) free(section->name);
+    section->name = strdup(value);
+  } else if (!strcmp(key, "bars")) {
+    section->bars = strtol(value, &end, 10);
+    if (*end || section->bars < 1)
+      return -1;
+  } else if (!strcmp(key, "meter")) {
+    section->meter = strtol(value, &end, 10);
+    section->unit = 4;
+    if (*end == '/')
+      section->unit = strtol(end + 1, &end, 10);
+    if (*end || section->meter < 1 || section->meter > MAX_METER ||
+        !timeline_valid_unit(section->unit))
+      return -1;
+  } else if (!strcmp(key, "bpm")) {
+    section->bpm = strtod(value, &end);
+    if (*end || section->bpm < MIN_BPM || section->bpm > MAX_BPM)
+      return -1;
+  } else if (!strcmp(key, "ramp")) {
+    section->ramp_bpm = strtod(value, &end);
+    if (*end || section->ramp_bpm < MIN_BPM || section->ramp_bpm > MAX_BPM)
+      return -1;
+  } else if (!strcmp(key, "shape")) {
+    if (!strcmp(value, "linear"))
+      section->ramp_exponential = 0;
+    else if (!strcmp(value, "exponential"))
+      section->ramp_exponential = 1;
+    else
+      return -1;
+  } else if (!strcmp(key, "accents")) {
+    if (strlen(value) > MAX_METER)
+      return -1;
+    for (i = 0; i < MAX_METER; i++) {
+      section->accents[i] = !value[i] || value[i] == '0' ? DSP_BEAT_NORMAL :
+                            value[i] == '-' ? DSP_BEAT_OFF : DSP_BEAT_ACCENT;
+      if (!value[i])
+        break;
+    }
+    for (; i < MAX_METER; i++)
+      section->accents[i] = DSP_BEAT_NORMAL;
+  } else if (!strcmp(key, "sound")) {
+    if (section->soundname) free(section->soundname);
+    section->soundname = strdup(value);
+  } else if (!strcmp(key, "volume")) {
+    section->gain = strtod(value, &end) / 100.0;
+    if (*end || section->gain < 0.0 || section->gain > 1.0)
+      return -1;
+  } else {
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * appends section described by <line> to timeline: whitespace separated
+ * fields "key=value" with keys name, bars, meter (number of ticks, optionally
+ * with their note value, e.g. 6/8; default: quarter notes), bpm (ticks per
+ * minute), ramp (tempo at end of section), shape (linear, exponential),
+ * accents ('1' accentuated, '-' off, '0' normal), sound and volume (in
+ * percent), e.g.
+ *
+ *   name=Intro bars=8 meter=4 bpm=120 accents=1000
+ *
+ * fields not specified are taken over from the preceding section;
+ * empty lines and comments (starting with '#') are ignored
+ *
+ * returns 0 on success, -1 otherwise (timeline unchanged then)
+ */
+int timeline_add_section(timeline_t* timeline, const char* line)
+{
+  timeline_section_t section;
+  char* copy;
+  char* state;
+  char* field;
+  int result = 0;
+
+  line += strspn(line, " \t\r\n");
+  if (*line == '\0' || *line == '#')
+    return 0;
+
+  if (timeline->n_sections > 0) {
+    section = timeline->sections[timeline->n_sections - 1];
+    section.ramp_bpm = 0.0;
+  } else {
+    memset(&section, 0, sizeof(section));
+    section.bars = 1;
+    section.meter = DEFAULT_METER;
+    section.unit = 4;
+    section.accents[0] = DSP_BEAT_ACCENT;
+    section.bpm = DEFAULT_SPEED;
+    section.gain = 1.0;
+  }
+  section.name = NULL;
+  section.durations = NULL;
+  if (section.soundname)
+    section.soundname = strdup(section.soundname);
+
+  copy = strdup(line);
+  for (field = strtok_r(copy, " \t\r\n", &state);
+       field && result == 0;
+       field = strtok_r(NULL, " \t\r\n", &state))
+  {
+    char* value = strchr(field, '=');
+
+    if (!value) {
+      result = -1;
+    } else {
+      *value++ = '\0';
+      result = set_field(&section, field, value);
+    }
+    if (result == -1)
+      fprintf(stderr, "Warning: Bad timeline field \"%s\".\n", field);
+  }
+  free(copy);
+
+  if (result == -1) {
+    if (section.name) free(section.name);
+    if (section.soundname) free(section.soundname);
+    return -1;
+  }
+
+  timeline->sections = (timeline_section_t*) g_realloc(timeline->sections,
+      (timeline->n_sections + 1) * sizeof(timeline_section_t));
+  timeline->sections[timeline->n_sections++] = section;
+
+  return 0;
+}
+
+/*
+ * returns new timeline read from setlist file <filename>, one section
+ * per line (see timeline_add_section()), or from the tempo map of
+ * Standard MIDI File <filename>, NULL on error
+ */
+timeline_t* timeline_load(const char* filename)
+{
+  timeline_t* result;
+  char line[TIMELINE_MAX_LINE];
+  FILE* fp;
+  int lineno = 0;
+
+  if (!(fp = fopen(filename, "r"))) {
+    perror(filename);
+    return NULL;
+  }
+
+  result = timeline_new();
+  if (fread(line, 1, 4, fp) == 4 && !memcmp(line, "MThd", 4)) {
+    rewind(fp);
+    if (smf_read(fp, result) == -1) {
+      fprintf(stderr, "%s: Error in MIDI file.\n", filename);
+      timeline_delete(result);
+      result = NULL;
+    }
+    fclose(fp);
+    return result;
+  }
+  rewind(fp);
+
+  while (fgets(line, sizeof(line), fp)) {
+    lineno++;
+    if (timeline_add_section(result, line) == -1) {
+      fprintf(stderr, "%s:%d: Error in timeline.\n", filename, lineno);
+      timeline_delete(result);
+      fclose(fp);
+      return NULL;
+    }
+  }
+  fclose(fp);
+
+  return result;
+}
+
+/*
+ * returns length in seconds of tick <n> of <section>
+ */
+static double section_duration(const timeline_section_t* section, int n)
+{
+  double progress = (double) n / (section->bars * section->meter);
+
+  if (section->durations)
+    return section->durations[n];
+  else if (section->ramp_bpm <= 0.0)
+    return 60.0 / section->bpm;
+  else if (section->ramp_exponential)
+    return 60.0 / (section->bpm * pow(section->ramp_bpm / section->bpm,
+                                      progress));
+  else
+    return 60.0 / (section->bpm + (section->ramp_bpm - section->bpm) *
+                                  progress);
+}
+
+/*
+ * compiles the sections of <timeline> into the schedule of ticks at <rate>,
+ * getting the voices of ticks from <voice> (called with <object>)
+ *
+ * tick positions are accumulated exactly and rounded to frames only
+ * individually, so they don't drift over the whole timeline
+ *
+ * returns 0 on success, -1 if a voice isn't available (silence then)
+ */
+int timeline_compile(timeline_t* timeline, int rate,
+                     timeline_voice_t voice, void* object)
+{
+  double time = 0.0; /* in frames */
+  int result = 0;
+  int n_events = 0;
+  int n_bars = 0;
+  int i, n;
+
+  for (i = 0; i < timeline->n_sections; i++) {
+    n_bars += timeline->sections[i].bars;
+    n_events += timeline->sections[i].bars * timeline->sections[i].meter;
+  }
+
+  if (timeline->events) free(timeline->events);
+  if (timeline->bars) free(timeline->bars);
+  timeline->events =
+    (timeline_event_t*) g_malloc(MAX(n_events, 1) * sizeof(timeline_event_t));
+  timeline->bars = (int*) g_malloc(MAX(n_bars, 1) * sizeof(int));
+  timeline->n_events = 0;
+  timeline->n_bars = 0;
+  timeline->rate = rate;
+
+  for (i = 0; i < timeline->n_sections; i++) {
+    timeline_section_t* section = &timeline->sections[i];
+
+    for (n = 0; n < section->meter; n++) {
+      int v = voice(object, section, n);
+
+      if (v == -1) {
+        v = 0;
+        result = -1;
+      }
+      section->voices[n] = v;
+    }
+
+    for (n = 0; n < section->bars * section->meter; n++) {
+      timeline_event_t* event = &timeline->events[timeline->n_events];
+      int beat = n % section->meter;
+
+      if (beat == 0)
+        timeline->bars[timeline->n_bars++] = timeline->n_events;
+
+      event->frame = llrint(time);
+      event->gain = section->gain;
+      event->voice = section->voices[beat];
+      event->beat = beat;
+      event->section = i;
+      timeline->n_events++;
+
+      time += rate * section_duration(section, n);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * returns number of first event at or after <frame>
+ * (n_events if there is none), by binary search
+ */
+int timeline_find(timeline_t* timeline, long long frame)
+{
+  int low = 0;
+  int high = timeline->n_events;
+
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+
+    if (timeline->events[middle].frame < frame)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low;
+}
+
+/*
+ * returns start frame of <bar> (counted from 0) in compiled timeline,
+ * -1 if not available
+ */
+long long timeline_bar_frame(timeline_t* timeline, int bar)
+{
+  if (bar < 0 || bar >= timeline->n_bars)
+    return -1;
+  return timeline->events[timeline->bars[bar]].frame;
+}
+
+/*
+ * returns start of <bar> (counted from 0) as MIDI song position: the number
+ * of sixteenth notes before it, counted in the note value of the ticks of
+ * each section (rounded down within 32nd notes); -1 if not available
+ */
+int timeline_bar_sixteenths(timeline_t* timeline, int bar)
+{
+  long long thirtyseconds = 0;
+  int i;
+
+  if (bar < 0 || bar >= timeline->n_bars)
+    return -1;
+
+  for (i = 0; i < timeline->n_sections && bar > 0; i++) {
+    timeline_section_t* section = &timeline->sections[i];
+    int bars = MIN(bar, section->bars);
+
+    thirtyseconds += (long long) bars * section->meter * 32 / section->unit;
+    bar -= bars;
+  }
+  return thirtyseconds / 2;
+}
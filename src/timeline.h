@@ -0,0 +1,99 @@
+/*
+ * Timeline (setlist) interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "globals.h"
+
+/*
+ * shortest note value of a tick (e.g. 32 for 7/32): 3 MIDI clock pulses
+ */
+#define TIMELINE_MAX_UNIT 32
+#define TIMELINE_MAX_UNIT_POWER 5 /* of 2 */
+
+/*
+ * part of a timeline with constant meter and accents, and constant or
+ * continuously changing tempo
+ */
+typedef struct timeline_section_t {
+  char* name;               /* NULL: unnamed */
+  int bars;                 /* length in cycles of meter */
+  int meter;
+  int unit;                 /* note value of a tick, e.g. 8 for 6/8 */
+  int accents[MAX_METER];   /* DSP_BEAT_* values for each tick of meter */
+  double bpm;               /* tempo at start of section */
+  double ramp_bpm;          /* tempo at end of section, 0.0: constant */
+  int ramp_exponential;     /* 0: linear ramp, 1: exponential ramp */
+  char* soundname;          /* NULL: default sound of player */
+  double gain;              /* volume of section (0.0 ... 1.0) */
+  double* durations;        /* exact length of each tick in seconds
+                               (e.g. from a tempo map), NULL: from bpm */
+
+  /* set up on compilation: voices for each tick of meter */
+  unsigned char voices[MAX_METER];
+} timeline_section_t;
+
+/*
+ * a tick of the compiled timeline
+ */
+typedef struct timeline_event_t {
+  long long frame;          /* start, counted from beginning of timeline */
+  float gain;
+  unsigned char voice;      /* sound bank voice */
+  unsigned char beat;       /* number of tick in bar */
+  unsigned short section;   /* number of section */
+} timeline_event_t;
+
+typedef struct timeline_t {
+  timeline_section_t* sections;
+  int n_sections;
+
+  /* compiled schedule */
+  int rate;                 /* frames per second, 0: not compiled */
+  timeline_event_t* events; /* ordered by frame */
+  int n_events;
+  int* bars;                /* bar index: number of first event of bar */
+  int n_bars;
+} timeline_t;
+
+/*
+ * returns voice for tick <beat> of <section>, -1 on error
+ */
+typedef int (*timeline_voice_t) (void* object,
+                                 const timeline_section_t* section, int beat);
+
+timeline_t* timeline_new(void);
+void timeline_delete(timeline_t* timeline);
+int timeline_add_section(timeline_t* timeline, const char* line);
+timeline_t* timeline_load(const char* filename);
+int timeline_valid_unit(int unit);
+
+int timeline_compile(timeline_t* timeline, int rate,
+                     timeline_voice_t voice, void* object);
+int timeline_find(timeline_t* timeline, long long frame);
+long long timeline_bar_frame(timeline_t* timeline, int bar);
+int timeline_bar_sixteenths(timeline_t* timeline, int bar);
+
+#endif /* TIMELINE_H */
@@ -0,0 +1,252 @@
+/*
+ * wavfile.c: writing of WAV files (offline rendering)
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+/* GNU headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* GTK+ headers */
+#include <glib.h>
+
+#ifdef USE_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* own headers */
+#include "globals.h"
+#include "wavfile.h"
+
+/* size of RIFF WAVE header with PCM "fmt " chunk */
+#define WAVFILE_HEADER_SIZE 44
+
+/*
+ * writes <value> as little endian number of <bytes> bytes to <dest>
+ */
+static void put_le(unsigned char* dest, unsigned long value, int bytes)
+{
+  int i;
+
+  for (i = 0; i < bytes; i++)
+    dest[i] = (unsigned char) (value >> (8 * i) & 0xff);
+}
+
+/*
+ * returns little endian number of <bytes> bytes at <src>
+ */
+static unsigned long get_le(const unsigned char* src, int bytes)
+{
+  unsigned long result = 0;
+  int i;
+
+  for (i = 0; i < bytes; i++)
+    result |= (unsigned long) src[i] << (8 * i);
+  return result;
+}
+
+/*
+ * writes the header of <wav> according to the data written so far
+ *
+ * returns 0 on success, -1 otherwise
+ */
+static int write_header(wavfile_t* wav)
+{
+  unsigned char header[WAVFILE_HEADER_SIZE] =
+    "RIFF____WAVEfmt ____________________data____";
+  int blockalign = wav->channels * wav->bits / 8;
+
+  put_le(&header[4], WAVFILE_HEADER_SIZE - 8 + wav->size, 4);
+  put_le(&header[16], 16, 4);                      /* fmt chunk size */
+  put_le(&header[20], wav->tag, 2);
+  put_le(&header[22], wav->channels, 2);
+  put_le(&header[24], wav->rate, 4);
+  put_le(&header[28], wav->rate * blockalign, 4);  /* bytes per second */
+  put_le(&header[32], blockalign, 2);
+  put_le(&header[34], wav->bits, 2);
+  put_le(&header[40], wav->size, 4);
+
+  if (fseek(wav->fp, 0, SEEK_SET) == -1 ||
+      fwrite(header, WAVFILE_HEADER_SIZE, 1, wav->fp) != 1)
+  {
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * creates WAV file <filename> for frames of <channels> channels at <rate> Hz
+ * with samples of <bits> bits in encoding <tag> (WAVFILE_*)
+ *
+ * returns new wavfile object, NULL on error
+ */
+wavfile_t* wavfile_open_encoded(const char* filename, int rate, int channels,
+                                int tag, int bits)
+{
+  wavfile_t* result;
+
+  result = (wavfile_t*) g_malloc(sizeof(wavfile_t));
+  result->rate = rate;
+  result->channels = channels;
+  result->tag = tag;
+  result->bits = bits;
+  result->size = 0;
+
+  if (!(result->fp = fopen(filename, "wb"))) {
+    perror(filename);
+    free(result);
+    return NULL;
+  }
+
+  /* placeholder, completed by wavfile_close() */
+  if (write_header(result) == -1) {
+    perror(filename);
+    fclose(result->fp);
+    free(result);
+    return NULL;
+  }
+
+  return result;
+}
+
+/*
+ * creates WAV file <filename> for 16 bit signed little endian frames
+ * of <channels> channels at <rate> Hz
+ *
+ * returns new wavfile object, NULL on error
+ */
+wavfile_t* wavfile_open(const char* filename, int rate, int channels)
+{
+  return wavfile_open_encoded(filename, rate, channels, WAVFILE_PCM, 16);
+}
+
+/*
+ * appends <size> bytes of sample <data> to <wav>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int wavfile_write(wavfile_t* wav, const unsigned char* data, int size)
+{
+  if (fwrite(data, 1, size, wav->fp) != (size_t) size)
+    return -1;
+  wav->size += size;
+  return 0;
+}
+
+/*
+ * completes header and closes file, destroying <wav>
+ *
+ * returns 0 on success, -1 otherwise
+ */
+int wavfile_close(wavfile_t* wav)
+{
+  int result = write_header(wav);
+
+  if (fclose(wav->fp) == EOF)
+    result = -1;
+  free(wav);
+
+  return result;
+}
+
+/*
+ * maps WAV file <filename> for reading its frames in place, without
+ * decoding
+ *
+ * returns new wavmap object, NULL if <filename> isn't a RIFF WAVE file
+ * with 16 bit PCM frames in host byte order (or on error)
+ */
+wavmap_t* wavfile_map(const char* filename)
+{
+  wavmap_t* result;
+  const unsigned char* data;
+  struct stat st;
+  size_t pos = 12;
+  int fmt = 0;
+  int fd;
+
+  if (G_BYTE_ORDER != G_LITTLE_ENDIAN)
+    return NULL;
+
+  if ((fd = open(filename, O_RDONLY)) == -1)
+    return NULL;
+  if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) ||
+      st.st_size < WAVFILE_HEADER_SIZE)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  result = (wavmap_t*) g_malloc0(sizeof(wavmap_t));
+  result->length = st.st_size;
+  result->map = mmap(NULL, result->length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (result->map == MAP_FAILED) {
+    free(result);
+    return NULL;
+  }
+  data = (const unsigned char*) result->map;
+
+  if (memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4)) {
+    wavfile_unmap(result);
+    return NULL;
+  }
+
+  /* chunks, each padded to an even size */
+  while (pos + 8 <= result->length) {
+    size_t size = get_le(data + pos + 4, 4);
+
+    if (!memcmp(data + pos, "fmt ", 4) && size >= 16 &&
+        pos + 8 + size <= result->length)
+    {
+      result->channels = get_le(data + pos + 10, 2);
+      result->rate = get_le(data + pos + 12, 4);
+      fmt = get_le(data + pos + 8, 2) == 1 &&       /* PCM */
+            get_le(data + pos + 22, 2) == 16 &&     /* bits per sample */
+            result->channels > 0 && result->rate > 0;
+    } else if (!memcmp(data + pos, "data", 4) && fmt) {
+      size = MIN(size, result->length - pos - 8);
+      result->frames = (const short*) (data + pos + 8);
+      result->n = size / (2 * result->channels);
+      return result;
+    }
+    pos += 8 + size + (size & 1);
+  }
+
+  wavfile_unmap(result);
+  return NULL;
+}
+
+/*
+ * unmaps file of <wav>, destroying <wav>
+ */
+void wavfile_unmap(wavmap_t* wav)
+{
+  munmap(wav->map, wav->length);
+  free(wav);
+}
@@ -0,0 +1,71 @@
+/*
+ * WAV file writer interface
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2003, 2004, 2005, 2006 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef WAVFILE_H
+#define WAVFILE_H
+
+#include <stdio.h>
+
+/* sample encodings of written WAV files (format tags) */
+#define WAVFILE_PCM   1 /* signed little endian, unsigned with 8 bits */
+#define WAVFILE_FLOAT 3 /* IEEE float, little endian */
+#define WAVFILE_ALAW  6
+#define WAVFILE_MULAW 7
+
+/*
+ * RIFF WAVE file (16 bit signed PCM data unless opened with another
+ * encoding), written sequentially
+ */
+typedef struct wavfile_t {
+  FILE* fp;
+  int rate;
+  int channels;
+  int tag;          /* WAVFILE_* */
+  int bits;         /* per sample */
+  long size;        /* number of data bytes written */
+} wavfile_t;
+
+/*
+ * RIFF WAVE file with 16 bit signed PCM data in host byte order, mapped into
+ * memory for reading: only the pages of frames used are ever read
+ */
+typedef struct wavmap_t {
+  void* map;        /* whole file */
+  size_t length;    /* number of bytes mapped */
+  const short* frames; /* interleaved frames, in map */
+  int n;            /* number of frames */
+  int rate;
+  int channels;
+} wavmap_t;
+
+wavfile_t* wavfile_open(const char* filename, int rate, int channels);
+wavfile_t* wavfile_open_encoded(const char* filename, int rate, int channels,
+                                int tag, int bits);
+int wavfile_write(wavfile_t* wav, const unsigned char* data, int size);
+int wavfile_close(wavfile_t* wav);
+
+wavmap_t* wavfile_map(const char* filename);
+void wavfile_unmap(wavmap_t* wav);
+
+#endif /* WAVFILE_H */
@@ -0,0 +1,128 @@
+/*
+ * benchsessions.c: Benchmark of sessions.c (not part of "make check")
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+#include <glib.h>
+
+/* Include from code under test */
+#include "sessions.h"
+
+#define RATE 48000
+#define CHANNELS 2
+#define SECONDS 10 /* of output per run, default */
+
+/*
+ * starts session <session> at <bpm> in 4/4 with <subdivision> sub beats and
+ * <sound>, at the next fragment
+ */
+static void start_session(comm_t* session, double bpm, int subdivision,
+			  const char* sound) {
+	dsp_params_t* params = dsp_params_new();
+	double* volume = (double*) g_malloc(sizeof(double));
+
+	params->frequency = bpm / 60.0;
+	params->meter = 4;
+	params->accents[0] = DSP_BEAT_ACCENT;
+	params->subdivision = subdivision;
+	params->soundname = strdup(sound);
+	*volume = 0.5;
+	comm_client_query(session, MESSAGE_TYPE_SET_PARAMS, params);
+	comm_client_query(session, MESSAGE_TYPE_SET_VOLUME, volume);
+	comm_client_query(session, MESSAGE_TYPE_START_METRONOME, NULL);
+}
+
+/*
+ * returns microseconds of rendering <seconds> of output of <n> sessions
+ * with different tempos and sub beats, mixed on all channels and rendered
+ * with <workers>, -1.0 on error
+ */
+static double render_many(comm_t* comm, int n, int workers, int seconds) {
+	sessions_t* sessions = sessions_new(comm, CHANNELS, workers);
+	short* data = (short*) g_malloc(RATE * CHANNELS * sizeof(short));
+	gint64 start;
+	double result = -1.0;
+	int i;
+
+	for (i = 0; i < n; i++)
+		start_session(sessions_add(sessions, i % 3 ? i % CHANNELS :
+					   SESSIONS_MIXED),
+			      60.0 + 13.0 * i, 1 + i % 4,
+			      i % 2 ? "<sine>" : "<default>");
+	if (dsp_offline_start(sessions->device, RATE, CHANNELS,
+			      AFMT_S16_NE) == 0) {
+		start = g_get_monotonic_time();
+		for (i = 0; i < seconds; i++)
+			dsp_offline_render(sessions->device, data, RATE);
+		result = g_get_monotonic_time() - start;
+		dsp_offline_stop(sessions->device);
+	}
+	sessions_delete(sessions);
+	free(data);
+
+	return result;
+}
+
+/*
+ * prints the processing time per session for increasing numbers of
+ * sessions, rendered by the audio thread alone and with workers
+ *
+ * usage: benchsessions [SECONDS]
+ */
+int main(int argc, char* argv[]) {
+	comm_t* comm = comm_new();
+	int workers = MAX((int) g_get_num_processors() - 1, 1);
+	int seconds = argc > 1 ? atoi(argv[1]) : SECONDS;
+	int n;
+
+	if (seconds < 1) {
+		fprintf(stderr, "Usage: %s [SECONDS]\n", argv[0]);
+		return 1;
+	}
+	for (n = 1; n <= SESSIONS_MAX; n *= 4) {
+		int w;
+
+		for (w = 0; w <= workers; w += workers) {
+			double elapsed = render_many(comm, n, w, seconds);
+
+			if (elapsed < 0.0) {
+				fprintf(stderr, "Error: Couldn't render.\n");
+				comm_delete(comm);
+				return 1;
+			}
+			printf("Sessions: %2d, workers: %2d: %7.1f us per session "
+			       "and second of output\n", n, w,
+			       elapsed / (n * seconds));
+		}
+	}
+	comm_delete(comm);
+	return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * testbeatshm.c: Unit Tests for beatshm.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "beatshm.h"
+
+#define RATE 44100
+#define DELAY 0.5     /* seconds of output delay */
+#define READS 1000000 /* samples taken while the record is written */
+
+static char* name = NULL;
+static beatshm_t* shm = NULL;
+static volatile int writing;
+
+void setup_beatshm(void) {
+	name = g_strdup_printf("/testbeatshm-%d", getpid());
+	shm = beatshm_new(name);
+	assert(shm != NULL);
+	beatshm_start(shm, RATE);
+	beatshm_anchor(shm, 0, DELAY); /* frame 0 heard after DELAY */
+}
+
+void teardown_beatshm(void) {
+	if (shm)
+		beatshm_delete(shm);
+	free(name);
+}
+
+/*
+ * Test external beatshm_publish(): position and time seen by reader
+ */
+START_TEST(test__beatshm_publish__position) {
+	const beatshm_record_t* record = beatshm_attach(name);
+	beatshm_record_t beat;
+	int64_t now = beatshm_now();
+
+	fail_unless(record != NULL, "Error: Couldn't attach!");
+	beatshm_read(record, &beat);
+	fail_unless(!beat.running, "Error: Running before first tick!");
+
+	/* 3/4 at 120 BPM with 2 sub beats, first tick at 0.5 s */
+	beatshm_publish(shm, RATE / 2, RATE / 2, 0, 0, 3, 4, 2);
+	beatshm_read(record, &beat);
+	fail_unless(beat.running && beat.bar == 0 && beat.beat == 0 &&
+		    beat.subbeat == 0 && beat.meter == 3 && beat.unit == 4 &&
+		    beat.subdivision == 2 && fabs(beat.bpm - 120.0) < 1e-9,
+		    "Error: Bad position of first tick!");
+	fail_unless(llabs(beat.tick_time - (now + (int64_t) ((DELAY + 0.5) *
+						  1e9))) < 10000000 &&
+		    beat.tick_length == 500000000,
+		    "Error: Bad time of first tick: %lld ns from now!",
+		    (long long) (beat.tick_time - now));
+	fail_unless(beatshm_next_tick(&beat, beat.tick_time + 1) ==
+		    beat.tick_time + 250000000,
+		    "Error: Bad extrapolation to next sub beat!");
+
+	beatshm_publish(shm, RATE * 3 / 4, RATE / 2, 0, 1, 3, 4, 2);
+	beatshm_publish(shm, RATE, RATE / 2, 1, 0, 3, 4, 2);
+	beatshm_publish(shm, RATE * 3 / 2, RATE / 2, 2, 0, 3, 4, 2);
+	beatshm_publish(shm, RATE * 2, RATE / 2, 0, 0, 3, 4, 2);
+	beatshm_read(record, &beat);
+	fail_unless(beat.bar == 1 && beat.beat == 0 && beat.subbeat == 0,
+		    "Error: Bar not counted!");
+
+	beatshm_stop(shm);
+	beatshm_read(record, &beat);
+	fail_unless(!beat.running, "Error: Stop not exported!");
+
+	beatshm_detach(record);
+	beatshm_delete(shm);
+	shm = NULL;
+	fail_unless(beatshm_attach(name) == NULL,
+		    "Error: Object not removed!");
+}
+END_TEST
+
+static gpointer writer(gpointer data __attribute((unused))) {
+	long long frame = 0;
+	int i = 0;
+
+	while (writing) {
+		int ticklen = 1000 + i % 1000;
+
+		beatshm_publish(shm, frame, ticklen, i % 7, i % 7, 7, 8, 7);
+		frame += ticklen;
+		i++;
+	}
+	return NULL;
+}
+
+/*
+ * Test external beatshm_read(): consistent copies while being written
+ */
+START_TEST(test__beatshm_read__consistent) {
+	const beatshm_record_t* record = beatshm_attach(name);
+	beatshm_record_t beat;
+	GThread* thread;
+	int torn = 0;
+	int i;
+
+	fail_unless(record != NULL, "Error: Couldn't attach!");
+	writing = 1;
+	thread = g_thread_new("writer", writer, NULL);
+
+	for (i = 0; i < READS; i++) {
+		beatshm_read(record, &beat);
+		if (beat.running &&
+		    (beat.beat != beat.subbeat ||
+		     fabs(beat.bpm * beat.tick_length / 60e9 - 1.0) > 1e-6))
+			torn++;
+	}
+
+	writing = 0;
+	g_thread_join(thread);
+	beatshm_detach(record);
+	fail_unless(torn == 0, "Error: %d of %d copies inconsistent!",
+		    torn, READS);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Beat Export");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_beatshm, teardown_beatshm);
+	tcase_add_test(tc_extern, test__beatshm_publish__position);
+	tcase_add_test(tc_extern, test__beatshm_read__consistent);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,290 @@
+/*
+ * testclock.c: Unit Tests for the MIDI clock output of dsp.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "dsp.h"
+#include "timeline.h"
+#include "midiclock.h"
+
+#define RATE 48000
+
+/* maximum number of recorded clock events */
+#define MAX_EVENTS 1024
+
+/*
+ * clock event queued by the dsp object
+ */
+typedef struct clock_event_t {
+	char type;       /* 'T': tick, 'P': pulse, 'L': song position */
+	long long frame;
+	int value;       /* tick: beat, song position: sixteenths */
+} clock_event_t;
+
+static clock_event_t events[MAX_EVENTS];
+static int n_events = 0;
+
+static comm_t* comm = NULL;
+
+/*
+ * stub of the sequencer queue: the events are recorded instead of being
+ * sent (see midiclock.c)
+ */
+static void record(char type, long long frame, int value) {
+	fail_unless(n_events < MAX_EVENTS, "Error: Too many clock events!");
+	events[n_events].type = type;
+	events[n_events].frame = frame;
+	events[n_events].value = value;
+	n_events++;
+}
+
+midiclock_t* midiclock_new(const char* destination __attribute((unused)),
+			   int note) {
+	midiclock_t* result = (midiclock_t*) g_malloc0(sizeof(midiclock_t));
+
+	result->note = note;
+	return result;
+}
+
+midiclock_t* midiclock_new_input(const char* source __attribute((unused))) {
+	return NULL;
+}
+
+void midiclock_delete(midiclock_t* clock) {
+	free(clock);
+}
+
+void midiclock_start(midiclock_t* clock, int rate) {
+	clock->rate = rate;
+}
+
+void midiclock_stop(midiclock_t* clock __attribute((unused))) {}
+
+void midiclock_anchor(midiclock_t* clock __attribute((unused)),
+		      long long frame __attribute((unused)),
+		      double delay __attribute((unused))) {}
+
+void midiclock_tick(midiclock_t* clock __attribute((unused)),
+		    long long frame, int beat) {
+	record('T', frame, beat);
+}
+
+void midiclock_pulse(midiclock_t* clock __attribute((unused)),
+		     long long frame) {
+	record('P', frame, 0);
+}
+
+void midiclock_locate(midiclock_t* clock __attribute((unused)),
+		      long long frame, int sixteenths) {
+	record('L', frame, sixteenths);
+}
+
+void midiclock_flush(midiclock_t* clock __attribute((unused))) {}
+
+int midiclock_receive(midiclock_t* clock __attribute((unused)),
+		      midiclock_input_t* input __attribute((unused))) {
+	return 0;
+}
+
+/*
+ * returns new dsp object sending MIDI clock, rendering offline at 120 BPM
+ * in 4/4 or <timeline> (taken over, NULL: none)
+ */
+static dsp_t* start_clock(timeline_t* timeline) {
+	dsp_t* result = dsp_new(comm);
+
+	dsp_set_midiclock(result, midiclock_new(NULL, -1));
+	result->params->frequency = 2.0;
+	result->params->meter = 4;
+	dsp_set_timeline(result, timeline);
+	fail_unless(dsp_offline_start(result, RATE, 1, AFMT_S16_NE) == 0,
+			"Error: Couldn't start rendering!");
+	n_events = 0;
+	return result;
+}
+
+static void stop_clock(dsp_t* clocked) {
+	dsp_offline_stop(clocked);
+	dsp_delete(clocked);
+}
+
+/*
+ * checks the recorded events from number <first> on: <ticks> ticks of
+ * <ticklen> frames with <pulses> clock pulses each, starting at <frame>
+ * with beat <beat> of <meter>
+ *
+ * returns the number of the event after them
+ */
+static int check_ticks(int first, long long frame, int ticks, int ticklen,
+		       int pulses, int beat, int meter) {
+	int n = first;
+	int t, p;
+
+	for (t = 0; t < ticks; t++) {
+		for (p = 0; p < pulses; p++, n++) {
+			long long expected = frame + p * ticklen / pulses;
+
+			fail_unless(n < n_events, "Error: Event %d missing!",
+				    n);
+			fail_unless(events[n].type == (p ? 'P' : 'T') &&
+				    events[n].frame == expected &&
+				    (p || events[n].value == beat),
+					"Error: Event %d is %c at frame %lld "
+					"(%d) instead of %c at %lld!", n,
+					events[n].type, events[n].frame,
+					events[n].value, p ? 'P' : 'T',
+					expected);
+		}
+		frame += ticklen;
+		beat = (beat + 1) % meter;
+	}
+	return n;
+}
+
+void setup_clock(void) {
+	comm = comm_new();
+}
+
+void teardown_clock(void) {
+	comm_delete(comm);
+	comm = NULL;
+}
+
+/*
+ * Test external dsp_offline_render(): 24 clock pulses per tick, at their
+ * frame in any size of fragments
+ */
+START_TEST(test__dsp_offline_render__clock_pulses) {
+	int pieces[] = { 4800, 997, 1 };
+	short data[4800];
+	unsigned int p;
+
+	for (p = 0; p < sizeof(pieces) / sizeof(pieces[0]); p++) {
+		dsp_t* clocked = start_clock(NULL);
+		int frames;
+
+		for (frames = 0; frames < 3 * RATE / 2; frames += pieces[p])
+			dsp_offline_render(clocked, data,
+					   MIN(pieces[p], 3 * RATE / 2 - frames));
+		fail_unless(check_ticks(0, 0, 3, RATE / 2, MIDICLOCK_PPQN,
+					0, 4) == n_events,
+				"Error: %d events in pieces of %d frames!",
+				n_events, pieces[p]);
+		stop_clock(clocked);
+	}
+}
+END_TEST
+
+/*
+ * Test external dsp_offline_render(): clock pulses of timeline sections
+ * following the note value of their ticks
+ */
+START_TEST(test__dsp_offline_render__clock_units) {
+	timeline_t* timeline = timeline_new();
+	short data[4800];
+	dsp_t* clocked;
+	int frames;
+	int n;
+
+	/* eighths, quarters and half notes at 120 ticks per minute */
+	timeline_add_section(timeline, "bars=1 meter=2/8 bpm=120");
+	timeline_add_section(timeline, "bars=1 meter=2 bpm=120");
+	timeline_add_section(timeline, "bars=1 meter=1/2 bpm=120");
+	timeline_add_section(timeline, "bars=1 meter=1 bpm=120");
+	clocked = start_clock(timeline);
+	for (frames = 0; frames < 5 * RATE / 2; frames += 4800)
+		dsp_offline_render(clocked, data, 4800);
+
+	n = check_ticks(0, 0, 2, RATE / 2, MIDICLOCK_PPQN / 2, 0, 2);
+	n = check_ticks(n, RATE, 2, RATE / 2, MIDICLOCK_PPQN, 0, 2);
+	n = check_ticks(n, 2 * RATE, 1, RATE / 2, MIDICLOCK_PPQN * 2, 0, 1);
+	fail_unless(n == n_events, "Error: %d events instead of %d!",
+		    n_events, n);
+	stop_clock(clocked);
+}
+END_TEST
+
+/*
+ * Test MESSAGE_TYPE_SEEK_BAR: song position in sixteenths of the note
+ * values of the sections before the bar, ticks continued from there
+ */
+START_TEST(test__dsp_seek_bar__song_position) {
+	timeline_t* timeline = timeline_new();
+	int* bar = (int*) g_malloc(sizeof(int));
+	int repeat_flag = 1;
+	int get_volume = 0;
+	short data[4800];
+	dsp_t* clocked;
+	long long frame;
+	int i;
+
+	timeline_add_section(timeline, "bars=2 meter=6/8 bpm=240");
+	timeline_add_section(timeline, "bars=2 meter=4 bpm=120");
+	clocked = start_clock(timeline);
+	dsp_offline_render(clocked, data, 4800);
+
+	/* the second bar of 4/4: 2 bars of 6/8 and a bar of 4/4 before */
+	*bar = 3;
+	comm_client_query(comm, MESSAGE_TYPE_SEEK_BAR, bar);
+	frame = clocked->framepos;
+	n_events = 0;
+	dsp_handle_queries(clocked, &repeat_flag, &get_volume);
+	for (i = 0; i < 5; i++) /* a tick */
+		dsp_offline_render(clocked, data, 4800);
+	fail_unless(n_events > 1 && events[0].type == 'L' &&
+		    events[0].frame == frame && events[0].value == 40,
+			"Error: Song position %d instead of 40!",
+			events[0].value);
+	fail_unless(check_ticks(1, frame, 1, RATE / 2, MIDICLOCK_PPQN, 0, 4) ==
+		    n_events, "Error: %d events after seeking!", n_events);
+	stop_clock(clocked);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("MIDI Clock");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_clock, teardown_clock);
+	tcase_add_test(tc_extern, test__dsp_offline_render__clock_pulses);
+	tcase_add_test(tc_extern, test__dsp_offline_render__clock_units);
+	tcase_add_test(tc_extern, test__dsp_seek_bar__song_position);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
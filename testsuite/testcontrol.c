@@ -0,0 +1,201 @@
+/*
+ * testcontrol.c: Unit Tests for control.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "control.h"
+#include "dsp.h"
+
+#define ROUND_TRIPS 100
+
+static comm_t* comm = NULL;
+static GThread* audio_thread = NULL;
+static control_t* control = NULL;
+static char* path = NULL;
+static int fd = -1;
+
+static control_profile_t profiles[] = {
+	{ "Waltz", "90", "3", "100" },
+	{ "Rock", "120", "4", "1010" }
+};
+
+static gpointer audio_loop(gpointer data) {
+	dsp_t* dsp = dsp_new((comm_t*) data);
+
+	dsp_main_loop(dsp);
+	dsp_delete(dsp);
+	return NULL;
+}
+
+/* audio thread (not playing) with control socket and connected client */
+void setup_control(void) {
+	comm = comm_new();
+	audio_thread = g_thread_new("metro", audio_loop, comm);
+
+	path = g_strdup_printf("/tmp/testcontrol-%d.sock", getpid());
+	control = control_new(path, comm);
+	assert(control != NULL);
+	control_set_profiles(control, profiles, 2);
+
+	fd = control_connect(path);
+	assert(fd != -1);
+}
+
+void teardown_control(void) {
+	close(fd);
+	control_delete(control);
+	comm_client_query(comm, MESSAGE_TYPE_STOP_SERVER, NULL);
+	g_thread_join(audio_thread);
+	comm_delete(comm);
+	free(path);
+}
+
+/*
+ * Test external control_request(): batch applied at once
+ */
+START_TEST(test__control_request__batch) {
+	control_batch_t batch;
+	control_status_t status;
+
+	control_batch_init(&batch);
+	fail_unless(control_add_tempo(&batch, 133.5) == 0 &&
+		    control_add_meter(&batch, 3) == 0 &&
+		    control_add_accents(&batch, "102") == 0 &&
+		    control_add_volume(&batch, 50) == 0 &&
+		    control_add_sound(&batch, "<wood freq=1500>") == 0,
+		    "Error: Couldn't compose batch!");
+
+	fail_unless(control_request(fd, &batch, &status) == 0,
+		    "Error: Request failed!");
+	fail_unless(status.result == CONTROL_OK && !status.running,
+		    "Error: Bad result %d!", status.result);
+	fail_unless(fabs(status.bpm - 133.5) < 0.001 && status.meter == 3 &&
+		    status.volume == 50,
+		    "Error: Batch not applied: %f BPM, meter %d, volume %d!",
+		    status.bpm, status.meter, status.volume);
+	fail_unless(status.accents[0] == DSP_BEAT_ACCENT &&
+		    status.accents[1] == DSP_BEAT_NORMAL &&
+		    status.accents[2] == DSP_BEAT_OFF,
+		    "Error: Bad accents!");
+}
+END_TEST
+
+/*
+ * Test external control_request(): bad batch applied not at all
+ */
+START_TEST(test__control_request__bad) {
+	control_batch_t batch;
+	control_status_t status;
+
+	control_batch_init(&batch);
+	control_add_meter(&batch, 5);
+	control_add_tempo(&batch, 5000.0); /* beyond MAX_BPM */
+	fail_unless(control_request(fd, &batch, &status) == 0 &&
+		    status.result == CONTROL_BAD_REQUEST,
+		    "Error: Bad request accepted!");
+	fail_unless(status.meter != 5, "Error: Part of bad batch applied!");
+
+	control_batch_init(&batch);
+	fail_unless(control_add_sound(&batch, "") == -1,
+		    "Error: Empty sound accepted!");
+	control_add_profile(&batch, "Polka");
+	fail_unless(control_request(fd, &batch, &status) == 0 &&
+		    status.result == CONTROL_NO_PROFILE,
+		    "Error: Unknown profile accepted!");
+}
+END_TEST
+
+/*
+ * Test external control_request(): loading profiles by name and number
+ */
+START_TEST(test__control_request__profile) {
+	control_batch_t batch;
+	control_status_t status;
+
+	control_batch_init(&batch);
+	control_add_profile(&batch, "Waltz");
+	fail_unless(control_request(fd, &batch, &status) == 0 &&
+		    status.result == CONTROL_OK && status.meter == 3 &&
+		    fabs(status.bpm - 90.0) < 0.001 &&
+		    status.accents[0] == DSP_BEAT_ACCENT,
+		    "Error: Profile not loaded by name!");
+
+	control_batch_init(&batch);
+	control_add_profile(&batch, "2");
+	fail_unless(control_request(fd, &batch, &status) == 0 &&
+		    status.result == CONTROL_OK && status.meter == 4 &&
+		    fabs(status.bpm - 120.0) < 0.001 &&
+		    status.accents[2] == DSP_BEAT_ACCENT,
+		    "Error: Profile not loaded by number!");
+}
+END_TEST
+
+/*
+ * Test external control_request(): consecutive requests on one connection
+ */
+START_TEST(test__control_request__repeated) {
+	control_batch_t batch;
+	control_status_t status;
+	int i;
+
+	for (i = 0; i < ROUND_TRIPS; i++) {
+		control_batch_init(&batch);
+		control_add_tempo(&batch, 60.0 + i);
+		fail_unless(control_request(fd, &batch, &status) == 0 &&
+			    status.result == CONTROL_OK &&
+			    fabs(status.bpm - (60.0 + i)) < 0.001,
+			    "Error: Request %d failed!", i);
+	}
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Control");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_control, teardown_control);
+	tcase_add_test(tc_extern, test__control_request__batch);
+	tcase_add_test(tc_extern, test__control_request__bad);
+	tcase_add_test(tc_extern, test__control_request__profile);
+	tcase_add_test(tc_extern, test__control_request__repeated);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -30,11 +30,23 @@
 #include <math.h>
 #include <string.h>
 
+/* OSS headers */
+#include <sys/soundcard.h>
+
 /* Unit Test common code */
 #include "common.h"
 
 /* Include from code under test */
 #include "dsp.h"
+#include "mixer.h"
+
+/* the default tick and its tables, as included by dsp.c */
+#include "tickdata.c"
+
+#define RATE 48000
+
+/* of tables prepared at build time, maybe on another architecture */
+#define TABLE_TOLERANCE 1
 
 static dsp_t* dsp = NULL;
 
@@ -50,6 +62,95 @@ void teardown_dsp(void) {
 	dsp = NULL;
 }
 
+/*
+ * returns new parameter block at <bpm> with <accents> as string of 0 and 1
+ * (its length being the meter), applied at <quantize>
+ */
+static dsp_params_t* new_params(double bpm, const char* accents,
+				dsp_quantize_t quantize) {
+	dsp_params_t* result = dsp_params_new();
+	int i;
+
+	result->frequency = bpm / 60.0;
+	result->meter = strlen(accents);
+	for (i = 0; i < result->meter; i++)
+		result->accents[i] = accents[i] == '1' ?
+			DSP_BEAT_ACCENT : DSP_BEAT_NORMAL;
+	result->soundname = strdup("<default>");
+	result->quantize = quantize;
+
+	return result;
+}
+
+/*
+ * hands parameter block <params> to <played> via <comm>, like the client
+ */
+static void send_params(dsp_t* played, comm_t* comm, dsp_params_t* params) {
+	int repeat_flag = 1;
+	int get_volume = 0;
+
+	comm_client_query(comm, MESSAGE_TYPE_SET_PARAMS, params);
+	dsp_handle_queries(played, &repeat_flag, &get_volume);
+}
+
+/*
+ * returns new dsp object rendering offline at full volume with parameter
+ * block <params> on the channels of <channel_map>
+ */
+static dsp_t* start_offline(comm_t* comm, const char* channel_map,
+			    dsp_params_t* params) {
+	dsp_t* result = dsp_new(comm);
+
+	result->channel_map = dsp_channel_map_new(channel_map);
+	send_params(result, comm, params);
+	fail_unless(dsp_offline_start(result, RATE,
+				      result->channel_map->channels,
+				      AFMT_S16_NE) == 0,
+			"Error: Couldn't start rendering!");
+	result->volume = 1.0;
+
+	return result;
+}
+
+static void stop_offline(dsp_t* rendered) {
+	dsp_offline_stop(rendered);
+	dsp_delete(rendered);
+}
+
+/*
+ * stores the frames of <data> (<frames> of <channels>) at which the sync
+ * pulse on <channel> starts in <onsets>, at most <max>
+ *
+ * returns the number of onsets found
+ */
+static int find_onsets(const float* data, int channels, int channel,
+		       int frames, int* onsets, int max) {
+	int result = 0;
+	int i;
+
+	for (i = 0; i < frames && result < max; i++) {
+		if (data[i * channels + channel] > 0.99f &&
+		    (i == 0 || data[(i - 1) * channels + channel] == 0.0f))
+			onsets[result++] = i;
+	}
+	return result;
+}
+
+/*
+ * returns 1 if <channel> of frames <from> ... <to> of <data> isn't silent,
+ * 0 otherwise
+ */
+static int sounding(const float* data, int channels, int channel,
+		    int from, int to) {
+	int i;
+
+	for (i = from; i < to; i++) {
+		if (data[i * channels + channel] != 0.0f)
+			return 1;
+	}
+	return 0;
+}
+
 /*
  * Test external dsp_get_volume()
  */
@@ -104,6 +205,805 @@ START_TEST(test__dsp_set_volume__0765) {
 }
 END_TEST
 
+/*
+ * Test external dsp_params_set_layers()
+ */
+START_TEST(test__dsp_params_set_layers__3_5) {
+	dsp_params_t* params;
+
+	RESOURCE_GUARD_START();
+	params = dsp_params_new();
+	fail_unless(dsp_params_set_layers(params, "100;1-000,<sine>") == 0,
+			"Error: Valid layers rejected!");
+	fail_unless(params->n_layers == 2,
+			"Error: %d layers instead of 2!", params->n_layers);
+	fail_unless(params->layers[0].pulses == 3 &&
+		    params->layers[0].soundname == NULL,
+			"Error: Bad first layer!");
+	fail_unless(params->layers[1].pulses == 5 &&
+		    params->layers[1].accents[0] == DSP_BEAT_ACCENT &&
+		    params->layers[1].accents[1] == DSP_BEAT_OFF &&
+		    params->layers[1].accents[2] == DSP_BEAT_NORMAL &&
+		    !strcmp(params->layers[1].soundname, "<sine>"),
+			"Error: Bad second layer!");
+	dsp_params_delete(params);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external dsp_params_set_layers(): invalid specification
+ */
+START_TEST(test__dsp_params_set_layers__invalid) {
+	dsp_params_t* params;
+
+	RESOURCE_GUARD_START();
+	params = dsp_params_new();
+	dsp_params_set_layers(params, "10");
+	fail_unless(dsp_params_set_layers(params, "1;1;1;1;1;1;1;1;1") == -1,
+			"Error: Too many layers accepted!");
+	fail_unless(params->n_layers == 1 && params->layers[0].pulses == 2,
+			"Error: Layers changed on error!");
+	fail_unless(dsp_params_set_layers(params, "") == 0 &&
+		    params->n_layers == 0,
+			"Error: Layers not cleared!");
+	dsp_params_delete(params);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external dsp_params_set_ramp()
+ */
+START_TEST(test__dsp_params_set_ramp__valid) {
+	dsp_params_t* params;
+
+	RESOURCE_GUARD_START();
+	params = dsp_params_new();
+	fail_unless(dsp_params_set_ramp(params, "exponential 180 30 seconds") == 0,
+			"Error: Valid ramp rejected!");
+	fail_unless(epsilon_cmp(params->ramp_target, 3.0) &&
+		    epsilon_cmp(params->ramp_length, 30.0) &&
+		    params->ramp_shape == DSP_RAMP_EXPONENTIAL &&
+		    params->ramp_unit == DSP_RAMP_SECONDS,
+			"Error: Bad ramp set!");
+	fail_unless(dsp_params_set_ramp(params, " ") == 0 &&
+		    params->ramp_target == 0.0,
+			"Error: Ramp not switched off!");
+	dsp_params_delete(params);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external dsp_params_set_ramp(): invalid specifications
+ */
+START_TEST(test__dsp_params_set_ramp__invalid) {
+	dsp_params_t* params;
+
+	RESOURCE_GUARD_START();
+	params = dsp_params_new();
+	fail_unless(dsp_params_set_ramp(params, "linear 120 0 bars") == -1,
+			"Error: Empty ramp accepted!");
+	fail_unless(dsp_params_set_ramp(params, "sudden 120 4 bars") == -1,
+			"Error: Bad shape accepted!");
+	fail_unless(dsp_params_set_ramp(params, "linear 120 4 beats") == -1,
+			"Error: Bad unit accepted!");
+	fail_unless(dsp_params_set_ramp(params, "linear 120 4 bars x") == -1,
+			"Error: Trailing garbage accepted!");
+	fail_unless(params->ramp_target == 0.0, "Error: Ramp set on error!");
+	dsp_params_delete(params);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external dsp_locate(): ticks continued from position in bar
+ */
+START_TEST(test__dsp_locate__position) {
+	comm_t* comm = comm_new();
+	dsp_t* located = dsp_new(comm);
+	int accents[3] = { DSP_BEAT_ACCENT, DSP_BEAT_NORMAL, DSP_BEAT_NORMAL };
+	float data[RATE];
+	int i;
+
+	fail_unless(dsp_offline_start(located, RATE, 1, AFMT_S16_NE) == 0 &&
+		    dsp_pin_voices(located, "<default>") == 0,
+			"Error: Couldn't start rendering!");
+	located->volume = 1.0;
+	dsp_set_rhythm(located, 3, accents, 1);
+
+	/* 120 BPM, middle of the third tick: next bar after 1/4 s */
+	dsp_locate(located, 2.0, 2.5);
+	dsp_offline_render_float(located, data, RATE);
+	for (i = 0; i < RATE / 4 && data[i] == 0.0; i++);
+	fail_unless(i == RATE / 4 && located->cyclepos == 1,
+			"Error: Sound before frame %d or bad beat %d!",
+			i, located->cyclepos);
+
+	/* right at the start of a tick */
+	dsp_locate(located, 2.0, 1.0);
+	dsp_offline_render_float(located, data, 100);
+	for (i = 0; i < 100 && data[i] == 0.0; i++);
+	fail_unless(i < 100 && located->cyclepos == 1,
+			"Error: Tick at located position missing!");
+
+	dsp_offline_stop(located);
+	dsp_delete(located);
+	comm_delete(comm);
+}
+END_TEST
+
+/*
+ * Test external dsp_offline_render(): native 32 bit, 24 bit and floating
+ * point formats carry the same ticks as 16 bit
+ */
+START_TEST(test__dsp_offline_render__native_formats) {
+	int formats[] = { AFMT_S32_LE, AFMT_S24_LE, AFMT_FLOAT };
+	comm_t* comm = comm_new();
+	dsp_t* reference = dsp_new(comm);
+	short ref[RATE / 2];
+	gint32 data[RATE / 2];
+	unsigned int f;
+	int i;
+
+	fail_unless(dsp_offline_start(reference, RATE, 1, AFMT_S16_NE) == 0 &&
+		    dsp_pin_voices(reference, "<default>") == 0,
+			"Error: Couldn't start 16 bit rendering!");
+	reference->volume = 1.0;
+	dsp_offline_render(reference, ref, RATE / 2);
+	dsp_offline_stop(reference);
+	dsp_delete(reference);
+
+	for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+		dsp_t* native = dsp_new(comm);
+
+		fail_unless(dsp_offline_start(native, RATE, 1, formats[f]) == 0 &&
+			    dsp_pin_voices(native, "<default>") == 0,
+				"Error: Couldn't start rendering in %x!",
+				formats[f]);
+		native->volume = 1.0;
+		dsp_offline_render(native, data, RATE / 2);
+		for (i = 0; i < RATE / 2; i++) {
+			gint32 expected = formats[f] == AFMT_S32_LE ?
+				ref[i] * 65536 : ref[i] * 256;
+			gint32 sample = GINT32_FROM_LE(data[i]);
+
+			if (formats[f] == AFMT_FLOAT ?
+			    ((float*) data)[i] != ref[i] / 32768.0f :
+			    sample != expected)
+				break;
+		}
+		fail_unless(i == RATE / 2,
+				"Error: Frame %d differs from 16 bit in %x!",
+				i, formats[f]);
+		dsp_offline_stop(native);
+		dsp_delete(native);
+	}
+	comm_delete(comm);
+}
+END_TEST
+
+/*
+ * Test external dsp_channel_map_new()
+ */
+START_TEST(test__dsp_channel_map_new__click_cue_pulse) {
+	dsp_channel_map_t* map;
+
+	RESOURCE_GUARD_START();
+	map = dsp_channel_map_new("click, click,cue,pulse,none");
+	fail_unless(map != NULL && map->channels == 5 &&
+		    map->buses[0] == DSP_BUS_CLICK &&
+		    map->buses[1] == DSP_BUS_CLICK &&
+		    map->buses[2] == DSP_BUS_CUE &&
+		    map->buses[3] == DSP_BUS_PULSE &&
+		    map->buses[4] == DSP_BUS_SILENCE,
+			"Error: Bad channel map!");
+	dsp_channel_map_delete(map);
+	fail_unless(dsp_channel_map_new("") == NULL &&
+		    dsp_channel_map_new("click,drums") == NULL,
+			"Error: Bad channel map accepted!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external dsp_offline_render_float(): sync pulse starting at the frame
+ * of each tick, accents only on the cue channel
+ */
+START_TEST(test__dsp_offline_render_float__channel_map) {
+	comm_t* comm = comm_new();
+	dsp_t* routed = dsp_new(comm);
+	int accents[3] = { DSP_BEAT_ACCENT, DSP_BEAT_NORMAL, DSP_BEAT_NORMAL };
+	int tick = RATE / 2;
+	int channels = 4;
+	float* data = (float*) g_malloc(4 * tick * channels * sizeof(float));
+	int i, t;
+
+	routed->channel_map = dsp_channel_map_new("click,click,cue,pulse");
+	fail_unless(dsp_offline_start(routed, RATE, channels, AFMT_S16_NE) == 0 &&
+		    dsp_pin_voices(routed, "<default>") == 0,
+			"Error: Couldn't start rendering!");
+	routed->volume = 1.0;
+	dsp_set_rhythm(routed, 3, accents, 1);
+	dsp_locate(routed, 2.0, 0.0); /* 120 BPM */
+	dsp_offline_render_float(routed, data, 4 * tick);
+
+	for (t = 0; t < 4; t++) {
+		float* frame = data + t * tick * channels;
+		int cue = 0;
+
+		fail_unless(frame[3] > 0.99f && (t == 0 || frame[-1] == 0.0f) &&
+			    frame[(tick / 20) * channels + 3] == 0.0f,
+				"Error: No pulse at frame of tick %d!", t);
+		for (i = 0; i < tick; i++) {
+			fail_unless(frame[i * channels] ==
+				    frame[i * channels + 1],
+					"Error: Click channels differ!");
+			cue |= frame[i * channels + 2] != 0.0f;
+		}
+		/* the first tick was started before the rhythm was set */
+		fail_unless(t == 0 || cue == (t == 3),
+				"Error: Cue channel at tick %d is %d!", t, cue);
+	}
+
+	dsp_offline_stop(routed);
+	dsp_delete(routed);
+	comm_delete(comm);
+	free(data);
+}
+END_TEST
+
+/* returns 1 if tickdata.c has tables for <rate>, 0 otherwise */
+static int tabled(int rate) {
+	unsigned int i;
+
+	for (i = 0; i < sizeof(tickdata_rates) / sizeof(tickdata_rates[0]);
+	     i++) {
+		if (tickdata_rates[i].rate == rate)
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * Test external dsp_pin_voices(): default tick taken from tables prepared at
+ * build time for common rates, prepared at other rates, each as
+ * soundbank_render_variant() prepares it at the rate
+ */
+START_TEST(test__dsp_pin_voices__tables) {
+	int rates[] = { 44100, RATE, 88200, 96000, 32000 };
+	unsigned int r;
+
+	for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+		comm_t* comm = comm_new();
+		dsp_t* pinned = dsp_new(comm);
+		int voices = 0;
+		int i;
+
+		fail_unless(dsp_offline_start(pinned, rates[r], 1,
+					      AFMT_S16_NE) == 0 &&
+			    dsp_pin_voices(pinned, "<default>") == 0,
+				"Error: Couldn't start rendering!");
+		for (i = 0; i < pinned->bank->n_voices; i++) {
+			voice_t* voice = &pinned->bank->voices[i];
+			short* expected;
+			int frames;
+			int n;
+
+			if (!voice->name || strcmp(voice->name, "<default>"))
+				continue;
+			voices++;
+			fail_unless(voice->shared == tabled(rates[r]),
+					"Error: Voice at %d Hz %s!", rates[r],
+					voice->shared ? "shared" : "prepared");
+			if (voice->variant == VOICE_VARIANT_NORMAL)
+				fail_unless(voice->frames ==
+					    956 * rates[r] / 44100,
+						"Error: Bad length at %d Hz!",
+						rates[r]);
+
+			frames = soundbank_render_variant(tickdata,
+				sizeof(tickdata) / sizeof(short),
+				TICKDATA_RATE, 1, voice->variant, rates[r],
+				&expected, pinned->fixed_point, 0);
+			fail_unless(voice->frames == frames,
+					"Error: Variant %d at %d Hz: %d frames "
+					"instead of %d!", voice->variant,
+					rates[r], voice->frames, frames);
+			for (n = 0; n < frames &&
+			     abs(voice->data[n] - expected[n]) <=
+			     TABLE_TOLERANCE; n++);
+			fail_unless(n == frames,
+					"Error: Variant %d at %d Hz, frame %d: "
+					"%d instead of %d!", voice->variant,
+					rates[r], n, voice->data[n], expected[n]);
+			free(expected);
+		}
+		fail_unless(voices > 0, "Error: No voices pinned!");
+
+		dsp_offline_stop(pinned);
+		dsp_delete(pinned);
+		comm_delete(comm);
+	}
+}
+END_TEST
+
+/*
+ * Test external dsp_pin_voices(): WAV file mapped and ending at its first
+ * silence, however long the file
+ */
+START_TEST(test__dsp_pin_voices__wav_trimmed) {
+	char* filename = g_strdup_printf("/tmp/testdsp-%d.wav", getpid());
+	wavfile_t* wav = wavfile_open(filename, RATE, 2);
+	short* frames = (short*) g_malloc0(RATE * 2 * sizeof(short));
+	comm_t* comm = comm_new();
+	dsp_t* pinned = dsp_new(comm);
+	int click = RATE / 100;
+	int i;
+
+	/* 10 ms of sound, 0.5 s of silence, sound up to 5 s */
+	for (i = 0; i < click * 2; i++)
+		frames[i] = i % 2 ? 10000 : -10000;
+	fail_unless(wav != NULL &&
+		    wavfile_write(wav, (unsigned char*) frames,
+				  RATE * 2 * sizeof(short)) == 0,
+			"Error: Couldn't write WAV file!");
+	for (i = 0; i < RATE * 2; i++)
+		frames[i] = 10000;
+	for (i = 0; i < 4; i++)
+		wavfile_write(wav, (unsigned char*) frames,
+			      RATE * 2 * sizeof(short));
+	wavfile_close(wav);
+
+	fail_unless(dsp_offline_start(pinned, RATE, 1, AFMT_S16_NE) == 0 &&
+		    dsp_pin_voices(pinned, filename) == 0,
+			"Error: Couldn't load WAV file!");
+	for (i = 0; i < pinned->bank->n_voices; i++) {
+		voice_t* voice = &pinned->bank->voices[i];
+
+		if (voice->name && !strcmp(voice->name, filename) &&
+		    voice->variant == VOICE_VARIANT_NORMAL)
+			fail_unless(voice->frames == click,
+					"Error: Voice of %d frames!",
+					voice->frames);
+	}
+	fail_unless(pinned->frames_map != NULL, "Error: File not mapped!");
+
+	dsp_offline_stop(pinned);
+	dsp_delete(pinned);
+	comm_delete(comm);
+	unlink(filename);
+	free(frames);
+	free(filename);
+}
+END_TEST
+
+/*
+ * Test external dsp_set_backing(): track starting exactly at the bar of its
+ * offset, looping over its first bar
+ */
+START_TEST(test__dsp_set_backing__offset_loop) {
+	char* filename = g_strdup_printf("/tmp/testdsp-%d.wav", getpid());
+	comm_t* comm = comm_new();
+	dsp_t* backed = dsp_new(comm);
+	const char* suffixes[] = { "@0", "@x", ":2-1" };
+	char* spec;
+	wavfile_t* wav;
+	short* frames;
+	float* data;
+	int barlen;
+	int i;
+
+	fail_unless(dsp_offline_start(backed, RATE, 1, AFMT_S16_NE) == 0,
+			"Error: Couldn't start rendering!");
+	barlen = backed->ticklen * backed->params->meter;
+	dsp_offline_stop(backed);
+
+	/* first bar positive, second one negative */
+	frames = (short*) g_malloc(2 * barlen * sizeof(short));
+	for (i = 0; i < 2 * barlen; i++)
+		frames[i] = i < barlen ? 1000 : -1000;
+	wav = wavfile_open(filename, RATE, 1);
+	fail_unless(wav != NULL &&
+		    wavfile_write(wav, (unsigned char*) frames,
+				  2 * barlen * sizeof(short)) == 0,
+			"Error: Couldn't write WAV file!");
+	wavfile_close(wav);
+
+	fail_unless(backing_new("") == NULL &&
+		    backing_new("/nonexistent.wav") == NULL,
+			"Error: Bad file accepted!");
+	for (i = 0; i < 3; i++) {
+		spec = g_strdup_printf("%s%s", filename, suffixes[i]);
+		fail_unless(backing_new(spec) == NULL,
+				"Error: Bad specification %s accepted!", spec);
+		free(spec);
+	}
+
+	/* from the second bar of the click on */
+	spec = g_strdup_printf("%s@2:1-1", filename);
+	dsp_set_backing(backed, backing_new(spec));
+	free(spec);
+	fail_unless(backed->backing != NULL, "Error: No backing track!");
+	fail_unless(dsp_offline_start(backed, RATE, 1, AFMT_S16_NE) == 0 &&
+		    dsp_pin_voices(backed, "<default>") == 0,
+			"Error: Couldn't start rendering!");
+	backed->volume = 0.0;
+
+	data = (float*) g_malloc(4 * barlen * sizeof(float));
+	dsp_offline_render_float(backed, data, 4 * barlen);
+	for (i = 0; i < barlen && data[i] == 0.0f; i++);
+	fail_unless(i == barlen, "Error: Track before its bar at frame %d!", i);
+	for (i = barlen; i < 4 * barlen && data[i] == data[barlen]; i++);
+	fail_unless(data[barlen] > 0.0f && i == 4 * barlen,
+			"Error: Track not looped at frame %d!", i);
+
+	dsp_offline_stop(backed);
+	dsp_delete(backed);
+	comm_delete(comm);
+	unlink(filename);
+	free(frames);
+	free(data);
+	free(filename);
+}
+END_TEST
+
+/*
+ * Test MESSAGE_TYPE_SET_PARAMS: tempo, meter and accents of a block kept
+ * up to the exact frame of its quantization point, switched there as a
+ * whole, a pending block replaced by a newer one
+ */
+START_TEST(test__dsp_set_params__quantized) {
+	comm_t* comm = comm_new();
+	int tick = RATE / 2; /* 120 BPM */
+	int channels = 2;    /* cue, pulse */
+	float* data = (float*) g_malloc(8 * tick * channels * sizeof(float));
+	int beat[] = { 0, tick, 2 * tick, 4 * tick };
+	int bar[] = { 0, tick, 2 * tick, 3 * tick, 4 * tick, 11 * tick / 2,
+		      7 * tick };
+	int now[] = { 0, tick, 2 * tick, 3 * tick, 5 * tick, 7 * tick };
+	int onsets[16];
+	int n;
+	dsp_t* quantized;
+
+	/* at the next beat: 60 BPM, 3/4 from the third tick on */
+	quantized = start_offline(comm, "cue,pulse",
+				  new_params(120.0, "1000", DSP_QUANTIZE_NOW));
+	dsp_offline_render_float(quantized, data, 3 * tick / 2);
+	send_params(quantized, comm, new_params(60.0, "111",
+						DSP_QUANTIZE_BEAT));
+	fail_unless(quantized->params->meter == 4 &&
+		    quantized->pending != NULL,
+			"Error: Block applied before its beat!");
+	dsp_offline_render_float(quantized, data + 3 * tick / 2 * channels,
+				 5 * tick - 3 * tick / 2);
+	n = find_onsets(data, channels, 1, 5 * tick, onsets, 16);
+	fail_unless(n == 4 && !memcmp(onsets, beat, sizeof(beat)),
+			"Error: %d ticks, third one at frame %d!", n, onsets[2]);
+	fail_unless(!sounding(data, channels, 0, tick, 2 * tick) &&
+		    sounding(data, channels, 0, 2 * tick, 3 * tick),
+			"Error: Accents not switched at the beat!");
+	stop_offline(quantized);
+
+	/* at the next bar, the first block replaced by the second one */
+	quantized = start_offline(comm, "cue,pulse",
+				  new_params(120.0, "1000", DSP_QUANTIZE_NOW));
+	dsp_offline_render_float(quantized, data, 3 * tick / 2);
+	send_params(quantized, comm, new_params(60.0, "10", DSP_QUANTIZE_BAR));
+	dsp_offline_render_float(quantized, data + 3 * tick / 2 * channels,
+				 tick);
+	send_params(quantized, comm, new_params(80.0, "111",
+						DSP_QUANTIZE_BAR));
+	fail_unless(quantized->params->meter == 4 &&
+		    quantized->pending->meter == 3,
+			"Error: Pending block not replaced!");
+	dsp_offline_render_float(quantized, data + 5 * tick / 2 * channels,
+				 8 * tick - 5 * tick / 2);
+	n = find_onsets(data, channels, 1, 8 * tick, onsets, 16);
+	fail_unless(n == 7 && !memcmp(onsets, bar, sizeof(bar)),
+			"Error: %d ticks, fifth one at frame %d!", n, onsets[4]);
+	fail_unless(!sounding(data, channels, 0, tick, 4 * tick) &&
+		    sounding(data, channels, 0, 4 * tick, 5 * tick) &&
+		    sounding(data, channels, 0, 11 * tick / 2, 6 * tick),
+			"Error: Accents not switched at the bar!");
+	stop_offline(quantized);
+
+	/* immediately, within the fourth tick: meter shrinking to 2 */
+	quantized = start_offline(comm, "cue,pulse",
+				  new_params(120.0, "1000", DSP_QUANTIZE_NOW));
+	dsp_offline_render_float(quantized, data, 7 * tick / 2);
+	send_params(quantized, comm, new_params(60.0, "10", DSP_QUANTIZE_NOW));
+	fail_unless(quantized->params->meter == 2 &&
+		    quantized->cyclepos == 0 && quantized->ticklen == 2 * tick,
+			"Error: Block not applied at once, tick %d!",
+			quantized->cyclepos);
+	dsp_offline_render_float(quantized, data + 7 * tick / 2 * channels,
+				 8 * tick - 7 * tick / 2);
+	n = find_onsets(data, channels, 1, 8 * tick, onsets, 16);
+	fail_unless(n == 6 && !memcmp(onsets, now, sizeof(now)),
+			"Error: %d ticks, fifth one at frame %d!", n, onsets[4]);
+	fail_unless(!sounding(data, channels, 0, 5 * tick, 7 * tick) &&
+		    sounding(data, channels, 0, 7 * tick, 8 * tick),
+			"Error: Bad accents after shrinking meter!");
+	stop_offline(quantized);
+
+	comm_delete(comm);
+	free(data);
+}
+END_TEST
+
+/*
+ * renders <frames> of <rendered> to <data> in pieces of <piece> frames
+ */
+static void render_pieces(dsp_t* rendered, float* data, int frames,
+			  int piece) {
+	int i;
+
+	for (i = 0; i < frames; i += piece)
+		dsp_offline_render_float(rendered,
+					 data + i * rendered->channels,
+					 MIN(piece, frames - i));
+}
+
+/*
+ * returns new parameter block at 120 BPM without meter, with <subdivision>
+ * sub beats of sound "<wood>" at <subgain>
+ */
+static dsp_params_t* new_subbeats(int subdivision, double subgain) {
+	dsp_params_t* result = new_params(120.0, "1", DSP_QUANTIZE_NOW);
+
+	result->subdivision = subdivision;
+	result->subsound = strdup("<wood>");
+	result->subgain = subgain;
+
+	return result;
+}
+
+/*
+ * Test external dsp_offline_render_float(): sub beats starting at their
+ * frame in the tick with the sub beat sound and volume, the same output
+ * for any size of fragments
+ */
+START_TEST(test__dsp_offline_render_float__subbeats) {
+	comm_t* comm = comm_new();
+	int tick = RATE / 2; /* 120 BPM */
+	int channels = 2;    /* click, pulse */
+	int subdivisions[] = { 2, 3, 5, 7 };
+	int pieces[] = { 1, 997, RATE };
+	float* data = (float*) g_malloc(2 * tick * channels * sizeof(float));
+	float* other = (float*) g_malloc(2 * tick * channels * sizeof(float));
+	unsigned int d, p;
+
+	for (d = 0; d < sizeof(subdivisions) / sizeof(subdivisions[0]); d++) {
+		int n = subdivisions[d];
+		dsp_t* subdivided = start_offline(comm, "click,pulse",
+						  new_subbeats(n, 0.5));
+		voice_t* voice =
+			&subdivided->bank->voices[subdivided->params->subvoice];
+		int gain = mixer_gain(0.5);
+		int onsets[2 * DSP_MAX_SUBDIVISION + 1];
+		int found;
+		int i, k;
+
+		render_pieces(subdivided, data, 2 * tick, 4800);
+		found = find_onsets(data, channels, 1, 2 * tick, onsets,
+				    2 * DSP_MAX_SUBDIVISION + 1);
+		fail_unless(found == 2 * n,
+				"Error: %d onsets for %d sub beats!", found, n);
+		for (k = 0; k < 2 * n; k++)
+			fail_unless(onsets[k] == k / n * tick +
+						 k % n * tick / n,
+					"Error: Sub beat %d of %d at frame %d!",
+					k, n, onsets[k]);
+
+		/* after the tick has faded, only the sub beat is heard */
+		fail_unless(!strcmp(voice->name, "<wood>"),
+				"Error: Sub beat sound %s!", voice->name);
+		for (i = 0; i < MIN(voice->frames, tick / n); i++)
+			fail_unless(data[(tick / n + i) * channels] ==
+				    ((voice->data[i] * gain) >>
+				     MIXER_GAIN_SHIFT) / 32768.0f,
+					"Error: Sub beat of %d differs at "
+					"frame %d!", n, i);
+		stop_offline(subdivided);
+
+		for (p = 0; p < sizeof(pieces) / sizeof(pieces[0]); p++) {
+			subdivided = start_offline(comm, "click,pulse",
+						   new_subbeats(n, 0.5));
+			render_pieces(subdivided, other, 2 * tick, pieces[p]);
+			fail_unless(!memcmp(data, other, 2 * tick * channels *
+					    sizeof(float)),
+					"Error: Output of %d sub beats differs "
+					"in pieces of %d frames!", n, pieces[p]);
+			stop_offline(subdivided);
+		}
+	}
+
+	comm_delete(comm);
+	free(data);
+	free(other);
+}
+END_TEST
+
+/*
+ * stores the frames at which the first <n> ticks of a tempo ramp from
+ * <from> to <to> BPM over <length> bars of <meter> or seconds (<unit>)
+ * start in <onsets>, each tick lasting a period of the curve at its start
+ */
+static void ramp_onsets(double from, double to, double length,
+			dsp_ramp_unit_t unit, dsp_ramp_shape_t shape,
+			int meter, int* onsets, int n) {
+	long long position = 0;
+	int k;
+
+	from /= 60.0;
+	to /= 60.0;
+	for (k = 0; k < n; k++) {
+		double progress = unit == DSP_RAMP_BARS ?
+			k / (length * meter) : position / (length * RATE);
+		double frequency;
+
+		progress = MIN(progress, 1.0);
+		frequency = shape == DSP_RAMP_EXPONENTIAL ?
+			from * pow(to / from, progress) :
+			from + (to - from) * progress;
+		onsets[k] = position;
+		position += (int) rint(RATE / frequency);
+	}
+}
+
+/*
+ * returns new parameter block in 4/4, ramping from <from> to <to> BPM
+ */
+static dsp_params_t* new_ramp(double from, double to, double length,
+			      dsp_ramp_unit_t unit, dsp_ramp_shape_t shape) {
+	dsp_params_t* result = new_params(from, "1000", DSP_QUANTIZE_NOW);
+
+	result->ramp_target = to / 60.0;
+	result->ramp_length = length;
+	result->ramp_unit = unit;
+	result->ramp_shape = shape;
+
+	return result;
+}
+
+/*
+ * Test external dsp_offline_render_float(): ticks of linear and exponential
+ * tempo ramps starting at the frames given by the curve, the target tempo
+ * kept after the ramp
+ */
+START_TEST(test__dsp_offline_render_float__ramps) {
+	struct {
+		double from, to, length;
+		dsp_ramp_unit_t unit;
+		dsp_ramp_shape_t shape;
+	} ramps[] = {
+		{ 60.0, 120.0, 2.0, DSP_RAMP_BARS, DSP_RAMP_LINEAR },
+		{ 180.0, 90.0, 3.0, DSP_RAMP_SECONDS, DSP_RAMP_EXPONENTIAL }
+	};
+	comm_t* comm = comm_new();
+	int frames = 16 * RATE;
+	float* data = (float*) g_malloc(frames * sizeof(float));
+	unsigned int r;
+
+	for (r = 0; r < sizeof(ramps) / sizeof(ramps[0]); r++) {
+		dsp_t* ramped = start_offline(comm, "pulse",
+					      new_ramp(ramps[r].from,
+						       ramps[r].to,
+						       ramps[r].length,
+						       ramps[r].unit,
+						       ramps[r].shape));
+		int expected[32];
+		int onsets[32];
+		int target = rint(RATE * 60.0 / ramps[r].to);
+		int k;
+
+		ramp_onsets(ramps[r].from, ramps[r].to, ramps[r].length,
+			    ramps[r].unit, ramps[r].shape, 4, expected, 32);
+		render_pieces(ramped, data, frames, 4800);
+		fail_unless(find_onsets(data, 1, 0, frames, onsets, 32) >= 24,
+				"Error: Ticks of ramp %d missing!", r);
+		for (k = 0; k < 24; k++)
+			fail_unless(onsets[k] == expected[k],
+					"Error: Tick %d of ramp %d at frame %d "
+					"instead of %d!", k, r, onsets[k],
+					expected[k]);
+		fail_unless(onsets[23] - onsets[22] == target &&
+			    ramped->ticklen == target,
+				"Error: Target of ramp %d not reached!", r);
+		stop_offline(ramped);
+	}
+
+	comm_delete(comm);
+	free(data);
+}
+END_TEST
+
+/*
+ * returns contents of file <filename>, <size> bytes, NULL on error
+ */
+static unsigned char* read_file(const char* filename, long* size) {
+	FILE* f = fopen(filename, "rb");
+	unsigned char* result;
+
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	*size = ftell(f);
+	rewind(f);
+	result = (unsigned char*) g_malloc(*size);
+	if (fread(result, 1, *size, f) != (size_t) *size) {
+		free(result);
+		result = NULL;
+	}
+	fclose(f);
+	return result;
+}
+
+/*
+ * Test external dsp_render(): a tempo ramp rendered to the same file on
+ * every run, in any size of fragments
+ */
+START_TEST(test__dsp_render__ramp_reproducible) {
+	char* filenames[2];
+	unsigned char* files[2];
+	long sizes[2];
+	comm_t* comm = comm_new();
+	int frames = 6 * RATE;
+	short* pieces[2];
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		dsp_t* rendered = dsp_new(comm);
+
+		filenames[i] = g_strdup_printf("/tmp/testdsp-%d-%d.wav",
+					       getpid(), i);
+		fail_unless(dsp_render(rendered,
+				       new_ramp(60.0, 200.0, 4.0,
+						DSP_RAMP_SECONDS,
+						DSP_RAMP_EXPONENTIAL),
+				       filenames[i], 5.0) == 0,
+				"Error: Couldn't render ramp!");
+		dsp_delete(rendered);
+		files[i] = read_file(filenames[i], &sizes[i]);
+		fail_unless(files[i] != NULL, "Error: Couldn't read %s!",
+			    filenames[i]);
+	}
+	fail_unless(sizes[0] == sizes[1] &&
+		    !memcmp(files[0], files[1], sizes[0]),
+			"Error: Renders of ramp differ!");
+
+	for (i = 0; i < 2; i++) {
+		dsp_t* rendered = dsp_new(comm);
+		int piece = i ? 4800 : 1013;
+		int f;
+
+		send_params(rendered, comm, new_ramp(60.0, 200.0, 4.0,
+						      DSP_RAMP_BARS,
+						      DSP_RAMP_LINEAR));
+		fail_unless(dsp_offline_start(rendered, RATE, 1,
+					      AFMT_S16_NE) == 0,
+				"Error: Couldn't start rendering!");
+		pieces[i] = (short*) g_malloc(frames * sizeof(short));
+		for (f = 0; f < frames; f += piece)
+			dsp_offline_render(rendered, pieces[i] + f,
+					   MIN(piece, frames - f));
+		stop_offline(rendered);
+	}
+	fail_unless(!memcmp(pieces[0], pieces[1], frames * sizeof(short)),
+			"Error: Ramp differs in other fragments!");
+
+	for (i = 0; i < 2; i++) {
+		unlink(filenames[i]);
+		free(filenames[i]);
+		free(files[i]);
+		free(pieces[i]);
+	}
+	comm_delete(comm);
+}
+END_TEST
+
 Suite *test_suite(void) {
 	Suite *s = suite_create("DSP");
 	TCase *tc_extern = tcase_create("Extern Functions");
@@ -113,6 +1013,21 @@ Suite *test_suite(void) {
 	tcase_add_test(tc_extern, test__dsp_get_volume__0123);
 	tcase_add_test(tc_extern, test__dsp_set_volume__0);
 	tcase_add_test(tc_extern, test__dsp_set_volume__0765);
+	tcase_add_test(tc_extern, test__dsp_params_set_layers__3_5);
+	tcase_add_test(tc_extern, test__dsp_params_set_layers__invalid);
+	tcase_add_test(tc_extern, test__dsp_params_set_ramp__valid);
+	tcase_add_test(tc_extern, test__dsp_params_set_ramp__invalid);
+	tcase_add_test(tc_extern, test__dsp_locate__position);
+	tcase_add_test(tc_extern, test__dsp_channel_map_new__click_cue_pulse);
+	tcase_add_test(tc_extern, test__dsp_offline_render_float__channel_map);
+	tcase_add_test(tc_extern, test__dsp_offline_render__native_formats);
+	tcase_add_test(tc_extern, test__dsp_pin_voices__tables);
+	tcase_add_test(tc_extern, test__dsp_pin_voices__wav_trimmed);
+	tcase_add_test(tc_extern, test__dsp_set_backing__offset_loop);
+	tcase_add_test(tc_extern, test__dsp_set_params__quantized);
+	tcase_add_test(tc_extern, test__dsp_offline_render_float__subbeats);
+	tcase_add_test(tc_extern, test__dsp_offline_render_float__ramps);
+	tcase_add_test(tc_extern, test__dsp_render__ramp_reproducible);
 	suite_add_tcase(s, tc_extern);
 	
 	return s;
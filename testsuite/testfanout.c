@@ -0,0 +1,260 @@
+/*
+ * testfanout.c: Unit Tests for fanout.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+#include <fcntl.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "afmt.h"
+#include "fanout.h"
+
+#define RATE 8000
+#define FRAGMENT 160    /* frames per fragment, mono 16 bit */
+#define FRAGMENTS 100
+#define DELAY 10        /* milliseconds of second sink */
+#define HEADER 44       /* bytes of WAV header */
+
+/*
+ * returns the frames of WAV file <filename>, their number in <frames>
+ */
+static short* read_wav(const char* filename, int* frames) {
+	FILE* f = fopen(filename, "rb");
+	short* result;
+	long size;
+
+	assert(f != NULL && fseek(f, 0, SEEK_END) == 0);
+	size = ftell(f) - HEADER;
+	result = (short*) g_malloc(size);
+	assert(fseek(f, HEADER, SEEK_SET) == 0 &&
+	       fread(result, 1, size, f) == (size_t) size);
+	fclose(f);
+
+	*frames = size / sizeof(short);
+	return result;
+}
+
+/*
+ * Test external fanout_new(): sinks and delays parsed
+ */
+START_TEST(test__fanout_new__spec) {
+	fanout_t* fanout;
+
+	fanout = fanout_new("device@12,oss:/dev/dsp1,wav:/tmp/take.wav@3.5");
+	fail_unless(fanout != NULL && fanout->n == 2 &&
+		    fanout->delay == 0.012 &&
+		    fanout->sinks[0].type == FANOUT_SINK_OSS &&
+		    !strcmp(fanout->sinks[0].target, "/dev/dsp1") &&
+		    fanout->sinks[0].delay == 0.0 &&
+		    fanout->sinks[1].type == FANOUT_SINK_WAV &&
+		    !strcmp(fanout->sinks[1].target, "/tmp/take.wav") &&
+		    fanout->sinks[1].delay == 0.0035,
+			"Error: Bad sinks!");
+	fanout_delete(fanout);
+
+	fail_unless(fanout_new("") == NULL &&
+		    fanout_new("wav") == NULL &&
+		    fanout_new("mp3:take.mp3") == NULL &&
+		    fanout_new("oss@-1") == NULL &&
+		    fanout_new("pulse@soon") == NULL &&
+		    fanout_new("oss,oss,oss,oss,oss,oss,oss,oss,oss") == NULL,
+			"Error: Bad sinks accepted!");
+}
+END_TEST
+
+/*
+ * Test external fanout_write(): each fragment written to all sinks, from a
+ * few shared buffers, delayed for latency compensation
+ */
+START_TEST(test__fanout_write__delayed) {
+	char* a = g_strdup_printf("/tmp/testfanout-%d-a.wav", getpid());
+	char* b = g_strdup_printf("/tmp/testfanout-%d-b.wav", getpid());
+	char* spec = g_strdup_printf("wav:%s,wav:%s@%d", a, b, DELAY);
+	fanout_t* fanout = fanout_new(spec);
+	unsigned char* buffers[FANOUT_POOL(2)];
+	int n_buffers = 0;
+	short* data[2];
+	int frames[2];
+	int delay = RATE * DELAY / 1000;
+	int i, j;
+
+	fail_unless(fanout_next(fanout) == NULL,
+			"Error: Buffer before start!");
+	fail_unless(fanout_start(fanout, RATE, 1, AFMT_S16_LE, 2,
+				 FRAGMENT * 2) == 0,
+			"Error: Couldn't open sinks!");
+	fail_unless(g_async_queue_length(fanout->pool) == FANOUT_POOL(2),
+			"Error: %d buffers for two sinks!",
+			g_async_queue_length(fanout->pool));
+	for (i = 0; i < FRAGMENTS; i++) {
+		short* fragment = (short*) fanout_next(fanout);
+
+		for (j = 0; j < n_buffers && buffers[j] != (void*) fragment;
+		     j++);
+		if (j == n_buffers && n_buffers < FANOUT_POOL(2))
+			buffers[n_buffers++] = (void*) fragment;
+		fail_unless(j < FANOUT_POOL(2),
+				"Error: Buffer allocated while writing!");
+
+		for (j = 0; j < FRAGMENT; j++)
+			fragment[j] = i * FRAGMENT + j + 1;
+		fanout_write(fanout, FRAGMENT * 2);
+		usleep(1000);
+	}
+	fail_unless(fanout->sinks[0].dropped == 0 &&
+		    fanout->sinks[1].dropped == 0,
+			"Error: Fragments dropped!");
+	fanout_stop(fanout);
+
+	data[0] = read_wav(a, &frames[0]);
+	data[1] = read_wav(b, &frames[1]);
+	fail_unless(frames[0] == FRAGMENTS * FRAGMENT &&
+		    frames[1] == FRAGMENTS * FRAGMENT + delay,
+			"Error: Bad lengths %d, %d!", frames[0], frames[1]);
+	for (i = 0; i < frames[0]; i++) {
+		fail_unless(data[0][i] == i + 1 && data[1][delay + i] == i + 1,
+				"Error: Bad frame %d!", i);
+	}
+	for (i = 0; i < delay; i++)
+		fail_unless(data[1][i] == 0, "Error: Delay not silent!");
+
+	fanout_delete(fanout);
+	unlink(a);
+	unlink(b);
+	free(data[0]);
+	free(data[1]);
+	free(spec);
+	free(a);
+	free(b);
+}
+END_TEST
+
+/*
+ * Test external fanout_start(): WAV sinks recording other sample formats
+ * of the sound device, a sink failing to open left out
+ */
+START_TEST(test__fanout_start__wav_formats) {
+	char* a = g_strdup_printf("/tmp/testfanout-%d-a.wav", getpid());
+	char* b = g_strdup_printf("/tmp/testfanout-%d-b.wav", getpid());
+	char* spec = g_strdup_printf("wav:/nonexistent/take.wav,wav:%s", a);
+	static const int formats[] = { AFMT_S32_BE, AFMT_FLOAT, AFMT_S24_LE };
+	static const int tags[] = { 1, 3, 1 };
+	unsigned char header[HEADER];
+	FILE* fp;
+	unsigned int f;
+
+	for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+		fanout_t* fanout = fanout_new(spec);
+		unsigned char* fragment;
+		unsigned char* data;
+		int frames;
+		int tempfd = dup(STDERR_FILENO);
+		int devnull = open("/dev/null", O_WRONLY);
+		int i;
+
+		/* not closed: the sinks would take its descriptor */
+		dup2(devnull, STDERR_FILENO);
+		close(devnull);
+		fail_unless(fanout_start(fanout, RATE, 1, formats[f], 4,
+					 FRAGMENT * 4) == 0,
+				"Error: Sinks not started without bad one!");
+		dup2(tempfd, STDERR_FILENO);
+		close(tempfd);
+		fail_unless(!fanout->sinks[0].open && fanout->sinks[1].open,
+				"Error: Bad sink not left out!");
+
+		fragment = fanout_next(fanout);
+		for (i = 0; i < FRAGMENT; i++) {
+			guint32 sample = formats[f] == AFMT_S24_LE ?
+				0x00123456 + i : 0x12345678 + i;
+			int j;
+
+			for (j = 0; j < 4; j++)
+				fragment[4 * i + (formats[f] == AFMT_S32_BE ?
+						  3 - j : j)] = sample >> (8 * j);
+		}
+		fanout_write(fanout, FRAGMENT * 4);
+		fanout_stop(fanout);
+		fanout_delete(fanout);
+
+		data = (unsigned char*) read_wav(a, &frames);
+		rename(a, b);
+		fail_unless(frames * sizeof(short) == FRAGMENT * 4,
+				"Error: %d bytes recorded!",
+				frames * (int) sizeof(short));
+		for (i = 0; i < FRAGMENT; i++) {
+			guint32 expected = formats[f] == AFMT_S24_LE ?
+				(0x00123456 + i) << 8 : 0x12345678 + i;
+
+			fail_unless(data[4 * i] == (expected & 0xff) &&
+				    data[4 * i + 1] == (expected >> 8 & 0xff) &&
+				    data[4 * i + 2] == (expected >> 16 & 0xff) &&
+				    data[4 * i + 3] == expected >> 24,
+					"Error: Bad sample %d of format %d!",
+					i, formats[f]);
+		}
+		free(data);
+
+		/* encoding, block align and bits per sample in header */
+		fp = fopen(b, "rb");
+		assert(fp != NULL && fread(header, 1, HEADER, fp) == HEADER);
+		fclose(fp);
+		fail_unless(header[20] == tags[f] && header[32] == 4 &&
+			    header[34] == 32,
+				"Error: Bad header of format %d!", formats[f]);
+		unlink(b);
+	}
+	free(spec);
+	free(a);
+	free(b);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Fanout");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_test(tc_extern, test__fanout_new__spec);
+	tcase_add_test(tc_extern, test__fanout_write__delayed);
+	tcase_add_test(tc_extern, test__fanout_start__wav_formats);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,210 @@
+/*
+ * testgtickd-static.c: Unit Tests for static functions of gtickd.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test, without its main() */
+#define main gtickd_main
+#include "gtickd.c"
+#undef main
+
+static gtickd_t* gtickd = NULL;
+
+/* home directory with the rc file */
+static char home[] = "/tmp/testgtickd.XXXXXX";
+
+/* returns result of gtickd_parse() on the NULL terminated <args> */
+static int parse(char* args[]) {
+	int argc = 0;
+
+	while (args[argc])
+		argc++;
+	optind = 0; /* reinitialize getopt_long() */
+	return gtickd_parse(gtickd, argc, args);
+}
+
+/* writes rc file with <contents> */
+static void write_rc(const char* contents) {
+	char* filename = get_rc_filename();
+	FILE* fp = fopen(filename, "w");
+
+	assert(fp != NULL);
+	fputs(contents, fp);
+	fclose(fp);
+	free(filename);
+}
+
+/*
+ * checks the parameter block of the parsed setting: <bpm>, <meter>,
+ * <accents> as string of '0' and '1' and <soundname>
+ */
+static void check_params(double bpm, int meter, const char* accents,
+			 const char* soundname) {
+	dsp_params_t* params = get_params(gtickd);
+	int i;
+
+	fail_unless(epsilon_cmp(params->frequency, bpm / 60.0),
+			"Error: %f Hz instead of %f BPM!",
+			params->frequency, bpm);
+	fail_unless(params->meter == meter,
+			"Error: Meter %d instead of %d!", params->meter, meter);
+	for (i = 0; accents[i]; i++)
+		fail_unless(params->accents[i] == (accents[i] == '1' ?
+					DSP_BEAT_ACCENT : DSP_BEAT_NORMAL),
+				"Error: Bad accent of tick %d!", i);
+	fail_unless(params->soundname && !strcmp(params->soundname, soundname),
+			"Error: Sound %s instead of %s!",
+			params->soundname, soundname);
+	dsp_params_delete(params);
+}
+
+void setup_gtickd(void) {
+	assert(mkdtemp(home) != NULL);
+	setenv("HOME", home, 1);
+	gtickd = gtickd_new();
+	assert(gtickd != NULL);
+}
+
+void teardown_gtickd(void) {
+	char* filename = get_rc_filename();
+
+	gtickd_delete(gtickd);
+	gtickd = NULL;
+	unlink(filename);
+	free(filename);
+	rmdir(home);
+	strcpy(home, "/tmp/testgtickd.XXXXXX");
+}
+
+/*
+ * Test static gtickd_parse(): setting from the command line only
+ */
+START_TEST(test__gtickd_parse__command_line) {
+	char* args[] = { "gtickd", "--no-rc", "-b", "90", "--meter=3",
+			 "-a", "101", "--sound", "<wood>", "-o", "SubBeats=2",
+			 NULL };
+	dsp_params_t* params;
+
+	write_rc("Speed = 150\nMeter = 6\n");
+	fail_unless(parse(args) == 0, "Error: Command line not accepted!");
+	check_params(90.0, 3, "101", "<wood>");
+	params = get_params(gtickd);
+	fail_unless(params->subdivision == 2, "Error: Sub beats not set!");
+	dsp_params_delete(params);
+	fail_unless(gtickd->render_filename == NULL &&
+			gtickd->n_sessions == 0,
+			"Error: Rendering or sessions without option!");
+}
+END_TEST
+
+/*
+ * Test static gtickd_parse(): setting from the rc file, partly overridden
+ * by the command line
+ */
+START_TEST(test__gtickd_parse__rc_file) {
+	char* defaults[] = { "gtickd", NULL };
+	char* args[] = { "gtickd", "--bpm=60", "-s", "<default>", NULL };
+
+	write_rc("# rc file\n"
+		 "SampleFilename = <wood>\n"
+		 "Speed = 150\n"
+		 "Meter = 6\n"
+		 "Accents = 100100\n");
+	fail_unless(parse(defaults) == 0, "Error: rc file not accepted!");
+	check_params(150.0, 6, "100100", "<wood>");
+	fail_unless(parse(args) == 0, "Error: Command line not accepted!");
+	check_params(60.0, 6, "100100", "<default>");
+}
+END_TEST
+
+/*
+ * Test static gtickd_parse(): offline rendering and sessions
+ */
+START_TEST(test__gtickd_parse__modes) {
+	char* args[] = { "gtickd", "-n", "--render=out.wav", "-l", "2.5",
+			 "-S", "4", "--mix", "-w", "-3", NULL };
+
+	fail_unless(parse(args) == 0, "Error: Command line not accepted!");
+	fail_unless(gtickd->render_filename &&
+			!strcmp(gtickd->render_filename, "out.wav") &&
+			epsilon_cmp(gtickd->render_length, 2.5),
+			"Error: Bad offline rendering!");
+	fail_unless(gtickd->n_sessions == 4 && gtickd->mixed &&
+			gtickd->workers == 0, "Error: Bad sessions!");
+}
+END_TEST
+
+/*
+ * Test static gtickd_parse(): bad command lines
+ */
+START_TEST(test__gtickd_parse__bad) {
+	char* speed[] = { "gtickd", "-n", "-b", "1001", NULL };
+	char* meter[] = { "gtickd", "-n", "-m", "0", NULL };
+	char* sessions[] = { "gtickd", "-n", "-S", "0", NULL };
+	char* option[] = { "gtickd", "-n", "-o", "Speed", NULL };
+	char* unknown[] = { "gtickd", "-n", "-o", "Unknown=1", NULL };
+	int tempfd = dup(STDERR_FILENO);
+
+	close(STDERR_FILENO);
+	fail_unless(parse(speed) == -1, "Error expected for bad speed");
+	fail_unless(parse(meter) == -1, "Error expected for bad meter");
+	fail_unless(parse(sessions) == -1,
+			"Error expected for bad number of sessions");
+	fail_unless(parse(option) == -1, "Error expected for option "
+			"without value");
+	fail_unless(parse(unknown) == -1,
+			"Error expected for unknown option");
+	dup2(tempfd, STDERR_FILENO);
+	close(tempfd);
+	check_params(DEFAULT_SPEED, DEFAULT_METER, "1",
+		     DEFAULT_SAMPLE_FILENAME);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Gtickd-static");
+	TCase *tc_static = tcase_create("Static Functions");
+
+	tcase_add_checked_fixture(tc_static, setup_gtickd, teardown_gtickd);
+	tcase_add_test(tc_static, test__gtickd_parse__command_line);
+	tcase_add_test(tc_static, test__gtickd_parse__rc_file);
+	tcase_add_test(tc_static, test__gtickd_parse__modes);
+	tcase_add_test(tc_static, test__gtickd_parse__bad);
+	suite_add_tcase(s, tc_static);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
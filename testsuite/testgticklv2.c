@@ -0,0 +1,204 @@
+/*
+ * testgticklv2.c: Unit Tests for gticklv2.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <glib.h>
+
+#include <lv2/core/lv2.h>
+#include <lv2/urid/urid.h>
+#include <lv2/atom/atom.h>
+#include <lv2/time/time.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+#define RATE 48000
+#define FRAMES (RATE * 2) /* 2 seconds */
+#define BLOCK 512         /* frames per call of run() */
+#define BEAT (RATE / 2)   /* 120 BPM */
+
+/* the host reports half a beat after beat 2 (of 4) at this frame, off the
+   beats of the plugin running free before */
+#define POSITION (BEAT / 2 + 100)
+#define POSITION_BAR_BEAT 1.5
+
+/* ports, see gtick.ttl */
+enum {
+	PORT_CONTROL,
+	PORT_OUT,
+	PORT_VOLUME,
+	PORT_BPM,
+	PORT_METER,
+	PORT_SUBDIVISION,
+	PORT_ACCENT
+};
+
+/* atom sequence of the control port: up to one time:Position with 4
+   properties, each a float */
+typedef struct {
+	LV2_Atom_Property_Body body;
+	float value;
+	uint32_t pad;
+} property_t;
+
+typedef struct {
+	LV2_Atom_Sequence sequence;
+	LV2_Atom_Event event;
+	LV2_Atom_Object_Body object;
+	property_t properties[4];
+} control_t;
+
+/* URIDs of the map feature: index + 1 */
+static const char* uris[32];
+static int n_uris;
+
+static LV2_URID map_uri(LV2_URID_Map_Handle handle __attribute((unused)),
+			const char* uri) {
+	int i;
+
+	for (i = 0; i < n_uris; i++) {
+		if (!strcmp(uris[i], uri))
+			return i + 1;
+	}
+	uris[n_uris++] = uri;
+	return n_uris;
+}
+
+static void set_property(property_t* property, const char* key, float value)
+{
+	property->body.key = map_uri(NULL, key);
+	property->body.value.type = map_uri(NULL, LV2_ATOM__Float);
+	property->body.value.size = sizeof(float);
+	property->value = value;
+}
+
+/*
+ * sets <control> to an empty sequence, with the position of the host if
+ * the block at <pos> contains frame POSITION
+ */
+static void set_control(control_t* control, int pos) {
+	memset(control, 0, sizeof(control_t));
+	control->sequence.atom.type = map_uri(NULL, LV2_ATOM__Sequence);
+	control->sequence.atom.size = sizeof(LV2_Atom_Sequence_Body);
+	if (POSITION < pos || POSITION >= pos + BLOCK)
+		return;
+
+	control->event.time.frames = POSITION - pos;
+	control->event.body.type = map_uri(NULL, LV2_ATOM__Object);
+	control->event.body.size =
+		sizeof(control_t) - offsetof(control_t, object);
+	control->object.otype = map_uri(NULL, LV2_TIME__Position);
+	set_property(&control->properties[0], LV2_TIME__barBeat,
+		     POSITION_BAR_BEAT);
+	set_property(&control->properties[1], LV2_TIME__beatsPerBar, 4.0);
+	set_property(&control->properties[2], LV2_TIME__beatsPerMinute, 120.0);
+	set_property(&control->properties[3], LV2_TIME__speed, 1.0);
+	control->sequence.atom.size +=
+		sizeof(control_t) - offsetof(control_t, event);
+}
+
+/* returns 1 if frames <from> ... <to> of <data> are silent, 0 otherwise */
+static int silent(const float* data, int from, int to) {
+	int i;
+
+	for (i = from; i < to; i++) {
+		if (data[i] != 0.0f)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Test external lv2_descriptor(): instantiated by a host, free running at
+ * the tempo of the ports, then clicks on the beat frames of the host's
+ * transport position
+ */
+START_TEST(test__lv2_descriptor__position) {
+	const LV2_Descriptor* descriptor = lv2_descriptor(0);
+	LV2_URID_Map map = { NULL, map_uri };
+	LV2_Feature map_feature = { LV2_URID__map, &map };
+	const LV2_Feature* features[] = { &map_feature, NULL };
+	float volume = 1.0f;
+	float bpm = 120.0f;
+	float meter = 4.0f;
+	float subdivision = 1.0f;
+	float accent = 1.0f;
+	control_t control;
+	float* out = (float*) g_malloc(FRAMES * sizeof(float));
+	LV2_Handle plugin;
+	/* the next beats after the position reported */
+	int beat = POSITION + (2.0 - POSITION_BAR_BEAT) * BEAT;
+	int pos;
+
+	fail_unless(descriptor && !lv2_descriptor(1),
+		    "Error: Bad descriptors!");
+	fail_unless(!descriptor->instantiate(descriptor, RATE, "/",
+					     features + 1),
+		    "Error: Instantiated without URID map!");
+	plugin = descriptor->instantiate(descriptor, RATE, "/", features);
+	fail_unless(plugin != NULL, "Error: Not instantiated!");
+
+	descriptor->connect_port(plugin, PORT_CONTROL, &control);
+	descriptor->connect_port(plugin, PORT_VOLUME, &volume);
+	descriptor->connect_port(plugin, PORT_BPM, &bpm);
+	descriptor->connect_port(plugin, PORT_METER, &meter);
+	descriptor->connect_port(plugin, PORT_SUBDIVISION, &subdivision);
+	descriptor->connect_port(plugin, PORT_ACCENT, &accent);
+	descriptor->activate(plugin);
+	for (pos = 0; pos < FRAMES; pos += BLOCK) {
+		set_control(&control, pos);
+		descriptor->connect_port(plugin, PORT_OUT, out + pos);
+		descriptor->run(plugin, MIN(BLOCK, FRAMES - pos));
+	}
+	descriptor->cleanup(plugin);
+
+	fail_unless(!silent(out, 0, 100), "Error: First tick missing!");
+	fail_unless(silent(out, POSITION, beat) &&
+		    !silent(out, beat, beat + 100),
+		    "Error: Tick after position not at frame %d!", beat);
+	fail_unless(silent(out, beat + BEAT - 1000, beat + BEAT) &&
+		    !silent(out, beat + BEAT, beat + BEAT + 100),
+		    "Error: Next tick not at frame %d!", beat + BEAT);
+	free(out);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("LV2 Plugin");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_test(tc_extern, test__lv2_descriptor__position);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,352 @@
+/*
+ * testhttpd.c: Unit Tests for httpd.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "httpd.h"
+#include "beatshm.h"
+
+#define RATE 44100
+#define DELAY 0.05   /* seconds of output delay */
+#define CLIENTS 32   /* WebSocket clients at the same time */
+#define TIMEOUT 2000 /* milliseconds to wait for a frame */
+#define PAYLOAD_SIZE 1024
+
+/* example of RFC 6455 */
+#define KEY "dGhlIHNhbXBsZSBub25jZQ=="
+#define ACCEPT "s3pPLMBiTxaQ9kYGzzhZRbK+xOo="
+
+static char* name = NULL;
+static beatshm_t* shm = NULL;
+static httpd_t* httpd = NULL;
+
+/* beat export of a running metronome and HTTP server on loopback */
+void setup_httpd(void) {
+	name = g_strdup_printf("/testhttpd-%d", getpid());
+	shm = beatshm_new(name);
+	assert(shm != NULL);
+	beatshm_start(shm, RATE);
+	beatshm_anchor(shm, 0, DELAY);
+
+	httpd = httpd_new("127.0.0.1:0", name);
+	assert(httpd != NULL);
+}
+
+void teardown_httpd(void) {
+	httpd_delete(httpd);
+	beatshm_delete(shm);
+	free(name);
+}
+
+static int connect_client(void) {
+	struct sockaddr_in address;
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(httpd->port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	assert(fd != -1 &&
+	       connect(fd, (struct sockaddr*) &address, sizeof(address)) == 0);
+	return fd;
+}
+
+/*
+ * reads up to <size> - 1 bytes to <buffer> until <end> was received
+ *
+ * returns number of bytes read
+ */
+static int read_until(int fd, char* buffer, int size, const char* end) {
+	struct pollfd p = { fd, POLLIN, 0 };
+	int n = 0;
+	int r;
+
+	buffer[0] = '\0';
+	while (n < size - 1 && !strstr(buffer, end) &&
+	       poll(&p, 1, TIMEOUT) == 1 &&
+	       (r = read(fd, buffer + n, size - 1 - n)) > 0) {
+		n += r;
+		buffer[n] = '\0';
+	}
+	return n;
+}
+
+/* returns response to HTTP request <request> */
+static char* request(const char* request) {
+	char buffer[8192];
+	int fd = connect_client();
+
+	assert(write(fd, request, strlen(request)) == (ssize_t) strlen(request));
+	read_until(fd, buffer, sizeof(buffer), "</html>");
+	close(fd);
+	return g_strdup(buffer);
+}
+
+/* WebSocket handshake of client */
+#define HANDSHAKE \
+	"GET /beat HTTP/1.1\r\n" \
+	"Host: localhost\r\n" \
+	"Upgrade: websocket\r\n" \
+	"Connection: keep-alive, Upgrade\r\n" \
+	"Sec-WebSocket-Key: " KEY "\r\n" \
+	"Sec-WebSocket-Version: 13\r\n\r\n"
+
+/* returns WebSocket connection to /beat, -1 if handshake failed */
+static int open_websocket(void) {
+	const char* request = HANDSHAKE;
+	char buffer[1024];
+	int fd = connect_client();
+
+	assert(write(fd, request, strlen(request)) == (ssize_t) strlen(request));
+	/* no event before the response: the metronome hasn't ticked yet */
+	read_until(fd, buffer, sizeof(buffer), "\r\n\r\n");
+	if (!strstr(buffer, "101 Switching Protocols") ||
+	    !strstr(buffer, "Sec-WebSocket-Accept: " ACCEPT "\r\n")) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/* reads <size> bytes from <fd> to <data>, returns -1 on timeout */
+static int read_all(int fd, void* data, int size) {
+	struct pollfd p = { fd, POLLIN, 0 };
+	int n = 0;
+	int r;
+
+	while (n < size && poll(&p, 1, TIMEOUT) == 1 &&
+	       (r = read(fd, (char*) data + n, size - n)) > 0)
+		n += r;
+	return n < size ? -1 : 0;
+}
+
+/*
+ * reads a complete frame (unmasked, shorter than PAYLOAD_SIZE) from <fd>
+ * to <payload>
+ *
+ * returns opcode, -1 on error
+ */
+static int read_frame(int fd, char* payload) {
+	unsigned char header[4];
+	int length;
+
+	if (read_all(fd, header, 2) == -1 || header[1] == 127)
+		return -1;
+	length = header[1];
+	if (length == 126) {
+		if (read_all(fd, header + 2, 2) == -1)
+			return -1;
+		length = header[2] << 8 | header[3];
+	}
+	if (length >= PAYLOAD_SIZE || read_all(fd, payload, length) == -1)
+		return -1;
+	payload[length] = '\0';
+	return header[0] & 0x0F;
+}
+
+/*
+ * writes masked client frame of <opcode> with text <payload> (shorter than
+ * 58 bytes) to <frame>
+ *
+ * returns length of frame
+ */
+static int encode_frame(unsigned char* frame, int opcode,
+			const char* payload) {
+	int i;
+
+	frame[0] = 0x80 | opcode;
+	frame[1] = 0x80 | strlen(payload);
+	for (i = 0; i < 4; i++)
+		frame[2 + i] = i + 1;
+	for (i = 0; payload[i]; i++)
+		frame[6 + i] = payload[i] ^ frame[2 + (i & 3)];
+	return 6 + i;
+}
+
+/* sends masked client frame of <opcode> with text <payload> */
+static void write_frame(int fd, int opcode, const char* payload) {
+	unsigned char frame[64];
+	int n = encode_frame(frame, opcode, payload);
+
+	assert(write(fd, frame, n) == n);
+}
+
+/*
+ * Test external httpd_new(): page and errors served
+ */
+START_TEST(test__httpd_new__page) {
+	char* response;
+
+	response = request("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	fail_unless(strstr(response, "HTTP/1.1 200 OK\r\n") &&
+		    strstr(response, "text/html") &&
+		    strstr(response, "new WebSocket("),
+		    "Error: Page not served!");
+	free(response);
+
+	response = request("GET /nothing HTTP/1.1\r\n\r\n");
+	fail_unless(strstr(response, "404 Not Found") != NULL,
+		    "Error: Missing file found!");
+	free(response);
+
+	response = request("GET /beat HTTP/1.1\r\n\r\n");
+	fail_unless(strstr(response, "400 Bad Request") != NULL,
+		    "Error: Plain request of WebSocket accepted!");
+	free(response);
+
+	response = request("POST / HTTP/1.1\r\n\r\n");
+	fail_unless(strstr(response, "405 Method Not Allowed") != NULL,
+		    "Error: POST accepted!");
+	free(response);
+}
+END_TEST
+
+/*
+ * Test external httpd_new(): each tick pushed to all WebSocket clients
+ */
+START_TEST(test__httpd_new__beats) {
+	int fds[CLIENTS];
+	char payload[PAYLOAD_SIZE];
+	int i;
+
+	for (i = 0; i < CLIENTS; i++) {
+		fds[i] = open_websocket();
+		fail_unless(fds[i] != -1, "Error: Handshake %d failed!", i);
+	}
+
+	/* 3/4 at 120 BPM with 2 sub beats */
+	beatshm_publish(shm, 0, RATE / 2, 0, 0, 3, 4, 2);
+	for (i = 0; i < CLIENTS; i++) {
+		fail_unless(read_frame(fds[i], payload) == 0x1 &&
+			    strstr(payload, "\"running\":true,\"bar\":0,"
+				   "\"beat\":0,\"meter\":3,\"unit\":4,"
+				   "\"bpm\":120.000,") &&
+			    strstr(payload, "{\"in\":") &&
+			    strstr(payload, "\"bar\":1,\"beat\":0}]}"),
+			    "Error: Bad first event at client %d: %s", i,
+			    payload);
+	}
+
+	usleep(20000); /* sub beats aren't pushed */
+	beatshm_publish(shm, RATE / 4, RATE / 2, 0, 1, 3, 4, 2);
+	usleep(20000);
+	beatshm_publish(shm, RATE / 2, RATE / 2, 1, 0, 3, 4, 2);
+	for (i = 0; i < CLIENTS; i++) {
+		fail_unless(read_frame(fds[i], payload) == 0x1 &&
+			    strstr(payload, "\"bar\":0,\"beat\":1,"),
+			    "Error: Bad second event at client %d: %s", i,
+			    payload);
+	}
+
+	beatshm_stop(shm);
+	for (i = 0; i < CLIENTS; i++) {
+		fail_unless(read_frame(fds[i], payload) == 0x1 &&
+			    !strcmp(payload, "{\"running\":false}"),
+			    "Error: Bad stop event at client %d: %s", i,
+			    payload);
+		close(fds[i]);
+	}
+}
+END_TEST
+
+/*
+ * Test external httpd_new(): WebSocket ping and close answered
+ */
+START_TEST(test__httpd_new__control_frames) {
+	char payload[PAYLOAD_SIZE];
+	int fd = open_websocket();
+
+	fail_unless(fd != -1, "Error: Handshake failed!");
+	write_frame(fd, 0x9, "hello");
+	fail_unless(read_frame(fd, payload) == 0xA && !strcmp(payload, "hello"),
+		    "Error: Ping not answered!");
+	write_frame(fd, 0x8, "");
+	fail_unless(read_frame(fd, payload) == 0x8,
+		    "Error: Close not answered!");
+	fail_unless(read(fd, payload, 1) == 0, "Error: Connection not closed!");
+	close(fd);
+}
+END_TEST
+
+/*
+ * Test external httpd_new(): frame sent with the handshake in one packet
+ * answered
+ */
+START_TEST(test__httpd_new__frame_after_handshake) {
+	const char* response =
+		"HTTP/1.1 101 Switching Protocols\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Accept: " ACCEPT "\r\n\r\n";
+	unsigned char packet[1024];
+	char payload[PAYLOAD_SIZE];
+	int fd = connect_client();
+	int n = strlen(HANDSHAKE);
+
+	memcpy(packet, HANDSHAKE, n);
+	n += encode_frame(packet + n, 0x9, "early");
+	assert(write(fd, packet, n) == n);
+	fail_unless(read_all(fd, payload, strlen(response)) == 0 &&
+		    !strncmp(payload, response, strlen(response)),
+		    "Error: Handshake failed!");
+	fail_unless(read_frame(fd, payload) == 0xA && !strcmp(payload, "early"),
+		    "Error: Ping with handshake not answered!");
+	close(fd);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("HTTP Server");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_set_timeout(tc_extern, 20);
+	tcase_add_checked_fixture(tc_extern, setup_httpd, teardown_httpd);
+	tcase_add_test(tc_extern, test__httpd_new__page);
+	tcase_add_test(tc_extern, test__httpd_new__beats);
+	tcase_add_test(tc_extern, test__httpd_new__control_frames);
+	tcase_add_test(tc_extern, test__httpd_new__frame_after_handshake);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
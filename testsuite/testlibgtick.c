@@ -0,0 +1,240 @@
+/*
+ * testlibgtick.c: Unit Tests for libgtick.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test: the installed interface only */
+#include "gtick.h"
+
+#define RATE 48000
+#define CHANNELS 2
+#define FRAMES (RATE * 4) /* 4 seconds */
+#define BLOCK 1000        /* frames per call of gtick_engine_render() */
+#define ENGINES 4         /* rendering at the same time */
+
+/*
+ * returns new parameter block: <bpm> in 3/4 with <subdivision> sub beats
+ */
+static gtick_params_t* new_params(double bpm, int subdivision) {
+	int accents[] = { GTICK_BEAT_ACCENT, GTICK_BEAT_NORMAL,
+			  GTICK_BEAT_OFF };
+	gtick_params_t* params = gtick_params_new();
+
+	assert(gtick_params_set_bpm(params, bpm) == 0 &&
+	       gtick_params_set_meter(params, 3, accents) == 0 &&
+	       gtick_params_set_subdivision(params, subdivision, 0.5) == 0);
+	return params;
+}
+
+/*
+ * returns FRAMES of output of a new engine with <params>, rendered in
+ * blocks of BLOCK frames
+ */
+static gpointer render(gtick_params_t* params) {
+	gtick_engine_t* engine = gtick_engine_new();
+	short* result = (short*) g_malloc(FRAMES * CHANNELS * sizeof(short));
+	int pos;
+
+	assert(gtick_engine_set_params(engine, params) == 0 &&
+	       gtick_engine_set_volume(engine, 0.5) == 0 &&
+	       gtick_engine_render_start(engine, RATE, CHANNELS) == 0);
+	for (pos = 0; pos < FRAMES; pos += BLOCK)
+		assert(gtick_engine_render(engine, result + pos * CHANNELS,
+					   MIN(BLOCK, FRAMES - pos)) == 0);
+	gtick_engine_render_stop(engine);
+	gtick_engine_delete(engine);
+
+	return result;
+}
+
+/* returns 1 if frames <from> ... <to> of <data> are silent, 0 otherwise */
+static int silent(const short* data, int from, int to) {
+	int i;
+
+	for (i = from * CHANNELS; i < to * CHANNELS; i++) {
+		if (data[i])
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Test external gtick_params_set_*(): bad arguments rejected
+ */
+START_TEST(test__gtick_params__arguments) {
+	gtick_params_t* params = gtick_params_new();
+	gtick_params_t* copy;
+	int accents[] = { GTICK_BEAT_ACCENT, 7 };
+
+	fail_unless(gtick_api_version() == GTICK_API_VERSION,
+		    "Error: Bad API version!");
+	fail_unless(gtick_params_set_bpm(params, 0.5) == -1 &&
+		    gtick_params_set_bpm(params, GTICK_MAX_BPM + 1) == -1 &&
+		    gtick_params_set_bpm(params, 120.0) == 0,
+		    "Error: BPM not checked!");
+	fail_unless(gtick_params_set_meter(params, 0, NULL) == -1 &&
+		    gtick_params_set_meter(params, 2, accents) == -1 &&
+		    gtick_params_set_meter(params, 1, accents) == 0 &&
+		    gtick_params_set_meter(params, GTICK_MAX_METER, NULL) == 0,
+		    "Error: Meter not checked!");
+	fail_unless(gtick_params_set_subdivision(params, 0, 0.5) == -1 &&
+		    gtick_params_set_subdivision(params, 2, 1.5) == -1 &&
+		    gtick_params_set_subdivision(params, 3, 0.5) == 0,
+		    "Error: Sub beats not checked!");
+	fail_unless(gtick_params_set_layers(params, "10;x,<sine>") == 0 &&
+		    gtick_params_set_layers(params, "") == 0 &&
+		    gtick_params_set_ramp(params, "linear 160 16 bars") == 0 &&
+		    gtick_params_set_ramp(params, "curved 160 16 bars") == -1,
+		    "Error: Layers or ramp not checked!");
+	fail_unless(gtick_params_set_quantize(params, GTICK_QUANTIZE_BAR) == 0 &&
+		    gtick_params_set_quantize(params, 42) == -1,
+		    "Error: Quantization not checked!");
+
+	copy = gtick_params_copy(params);
+	fail_unless(gtick_params_set_sound(copy, "<sine>") == 0,
+		    "Error: Sound not set!");
+	gtick_params_delete(params);
+	gtick_params_delete(copy);
+}
+END_TEST
+
+/*
+ * Test external gtick_engine_render(): ticks at the frames of the tempo
+ */
+START_TEST(test__gtick_engine_render__ticks) {
+	gtick_params_t* params = new_params(120.0, 1);
+	short* data = render(params);
+	int tick = RATE / 2;
+
+	fail_unless(!silent(data, 0, 100), "Error: First tick missing!");
+	fail_unless(silent(data, tick - 1000, tick) &&
+		    !silent(data, tick, tick + 100),
+		    "Error: Second tick not at frame %d!", tick);
+	fail_unless(silent(data, 2 * tick - 1000, 3 * tick),
+		    "Error: Third tick not off!");
+	fail_unless(!silent(data, 3 * tick, 3 * tick + 100),
+		    "Error: Second bar not started!");
+	free(data);
+	gtick_params_delete(params);
+}
+END_TEST
+
+/*
+ * Test external gtick_engine_render(): engines in concurrent threads
+ * independent of each other
+ */
+START_TEST(test__gtick_engine_render__concurrent) {
+	gtick_params_t* params[ENGINES];
+	short* expected[ENGINES];
+	GThread* threads[ENGINES];
+	int i;
+
+	for (i = 0; i < ENGINES; i++) {
+		params[i] = new_params(60.0 + 37.0 * i, 1 + i);
+		expected[i] = render(params[i]);
+	}
+
+	for (i = 0; i < ENGINES; i++)
+		threads[i] = g_thread_new("engine", (GThreadFunc) render,
+					  params[i]);
+	for (i = 0; i < ENGINES; i++) {
+		short* data = g_thread_join(threads[i]);
+
+		fail_unless(!memcmp(data, expected[i],
+				    FRAMES * CHANNELS * sizeof(short)),
+			    "Error: Output of engine %d changed!", i);
+		free(data);
+		free(expected[i]);
+		gtick_params_delete(params[i]);
+	}
+}
+END_TEST
+
+/*
+ * Test external gtick_engine_set_params(): change at next tick while
+ * rendering
+ */
+START_TEST(test__gtick_engine_set_params__quantized) {
+	gtick_engine_t* engine = gtick_engine_new();
+	gtick_params_t* params = new_params(60.0, 1);
+	short* data = (short*) g_malloc(FRAMES * CHANNELS * sizeof(short));
+
+	fail_unless(gtick_engine_render(engine, data, BLOCK) == -1,
+		    "Error: Rendered without start!");
+	gtick_engine_set_params(engine, params);
+	fail_unless(gtick_engine_render_start(engine, RATE, CHANNELS) == 0,
+		    "Error: Couldn't start rendering!");
+	fail_unless(gtick_engine_start(engine) == -1,
+		    "Error: Playback started while rendering!");
+
+	/* 120 BPM from the second tick (at 1 s) on */
+	gtick_engine_render(engine, data, RATE / 4);
+	gtick_params_set_bpm(params, 120.0);
+	gtick_params_set_quantize(params, GTICK_QUANTIZE_BEAT);
+	gtick_engine_set_params(engine, params);
+	gtick_engine_render(engine, data + RATE / 4 * CHANNELS,
+			    FRAMES - RATE / 4);
+
+	fail_unless(silent(data, RATE - 1000, RATE) &&
+		    !silent(data, RATE, RATE + 100),
+		    "Error: Tick before the change not kept!");
+	/* third tick off, then the next bar at 2 s instead of 3 s */
+	fail_unless(silent(data, RATE * 3 / 2 - 1000, RATE * 2) &&
+		    !silent(data, RATE * 2, RATE * 2 + 100),
+		    "Error: New tempo not applied at tick!");
+
+	gtick_engine_render_stop(engine);
+	free(data);
+	gtick_params_delete(params);
+	gtick_engine_delete(engine);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Engine Library");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_set_timeout(tc_extern, 20);
+	tcase_add_test(tc_extern, test__gtick_params__arguments);
+	tcase_add_test(tc_extern, test__gtick_engine_render__ticks);
+	tcase_add_test(tc_extern, test__gtick_engine_render__concurrent);
+	tcase_add_test(tc_extern, test__gtick_engine_set_params__quantized);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,260 @@
+/*
+ * testmixer.c: Unit Tests for mixer.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "mixer.h"
+
+/* odd size to cover vectorized and scalar parts */
+#define N 37
+
+/*
+ * Test external mixer_add(): accumulation equals scalar reference
+ */
+START_TEST(test__mixer_add__reference) {
+	int dest[N];
+	int expected[N];
+	short src[N];
+	int gains[] = { 0, 1, 12345, MIXER_UNITY - 1, MIXER_UNITY };
+	unsigned int g;
+	int i;
+
+	RESOURCE_GUARD_START();
+	for (g = 0; g < sizeof(gains) / sizeof(int); g++) {
+		for (i = 0; i < N; i++) {
+			src[i] = i % 2 ? SHRT_MAX - i * 997 : SHRT_MIN + i * 1009;
+			dest[i] = expected[i] = i * 3 - 50;
+			expected[i] += (src[i] * gains[g]) >> MIXER_GAIN_SHIFT;
+		}
+		mixer_add(dest, src, N, gains[g]);
+		for (i = 0; i < N; i++) {
+			fail_unless(dest[i] == expected[i],
+			  "Error: Sample %d, gain %d: %d instead of %d!",
+			  i, gains[g], dest[i], expected[i]);
+		}
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_add(): unity gain keeps samples
+ */
+START_TEST(test__mixer_add__unity) {
+	int dest[N];
+	short src[N];
+	int i;
+
+	RESOURCE_GUARD_START();
+	memset(dest, 0, sizeof(dest));
+	for (i = 0; i < N; i++)
+		src[i] = SHRT_MIN + i * 1771;
+	mixer_add(dest, src, N, mixer_gain(1.0));
+	for (i = 0; i < N; i++) {
+		fail_unless(dest[i] == src[i],
+			    "Error: Sample %d changed (%d -> %d)!",
+			    i, src[i], dest[i]);
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_encode_s16_le(): saturation and byte order
+ */
+START_TEST(test__mixer_encode_s16_le__saturation) {
+	int src[N];
+	unsigned char dest[N * 2];
+	int i;
+
+	RESOURCE_GUARD_START();
+	for (i = 0; i < N; i++)
+		src[i] = (i - N / 2) * 4000;
+	mixer_encode_s16_le(dest, src, N);
+	for (i = 0; i < N; i++) {
+		short expected = src[i] > SHRT_MAX ? SHRT_MAX :
+				 src[i] < SHRT_MIN ? SHRT_MIN : src[i];
+		short sample = dest[i * 2] | dest[i * 2 + 1] << 8;
+
+		fail_unless(sample == expected,
+			    "Error: Sample %d encoded as %d instead of %d!",
+			    i, sample, expected);
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_encode_s32_le() and mixer_encode_s32_be(): full scale
+ * 32 bit and 24 bit in the lower bits, byte order
+ */
+START_TEST(test__mixer_encode_s32__byte_order) {
+	int src[] = { 1, -1, 40000 };
+	unsigned char le[sizeof(src)];
+	unsigned char be[sizeof(src)];
+	unsigned char le32[] = { 0x00, 0x00, 0x01, 0x00,
+				 0x00, 0x00, 0xff, 0xff,
+				 0x00, 0x00, 0xff, 0x7f };
+	unsigned char le24[] = { 0x00, 0x01, 0x00, 0x00,
+				 0x00, 0xff, 0xff, 0xff,
+				 0x00, 0xff, 0x7f, 0x00 };
+	int i;
+
+	RESOURCE_GUARD_START();
+	mixer_encode_s32_le(le, src, 3, 32);
+	mixer_encode_s32_be(be, src, 3, 32);
+	for (i = 0; i < (int) sizeof(le); i++) {
+		fail_unless(le[i] == le32[i] && be[i] == le32[i ^ 3],
+			    "Error: Bad 32 bit byte %d!", i);
+	}
+	mixer_encode_s32_le(le, src, 3, 24);
+	mixer_encode_s32_be(be, src, 3, 24);
+	for (i = 0; i < (int) sizeof(le); i++) {
+		fail_unless(le[i] == le24[i] && be[i] == le24[i ^ 3],
+			    "Error: Bad 24 bit byte %d!", i);
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_encode_float(): scale and saturation
+ */
+START_TEST(test__mixer_encode_float__saturation) {
+	int src[] = { 0, 16384, -32768, 40000, -40000 };
+	float expected[] = { 0.0, 0.5, -1.0, 32767.0 / 32768.0, -1.0 };
+	float dest[5];
+	int i;
+
+	RESOURCE_GUARD_START();
+	mixer_encode_float(dest, src, 5);
+	for (i = 0; i < 5; i++) {
+		fail_unless(dest[i] == expected[i],
+			    "Error: Sample %d encoded as %g instead of %g!",
+			    i, dest[i], expected[i]);
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_resample(): fixed point within 1 of floating point,
+ * for down and up sampling of stereo data
+ */
+START_TEST(test__mixer_resample__fixed_point) {
+	int rates[] = { 8000, 44100, 48000, 96000 };
+	short from[2 * 441];
+	unsigned int r;
+	int i;
+
+	RESOURCE_GUARD_START();
+	for (i = 0; i < 2 * 441; i++)
+		from[i] = i * 7919 % 65536 - 32768;
+	for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+		short* reference;
+		short* fixed;
+		int frames;
+
+		frames = mixer_resample(from, 441, 44100, 2, rates[r],
+					&reference, 0);
+		fail_unless(mixer_resample(from, 441, 44100, 2, rates[r],
+					   &fixed, 1) == frames,
+				"Error: Bad number of frames at %d Hz!", rates[r]);
+		for (i = 0; i < frames && abs(fixed[i] - reference[i]) <= 1;
+		     i++);
+		fail_unless(i == frames,
+				"Error: Frame %d at %d Hz: %d instead of %d!",
+				i, rates[r], fixed[i], reference[i]);
+		free(reference);
+		free(fixed);
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_route(): mono added to one channel only
+ */
+START_TEST(test__mixer_route__channel) {
+	int src[] = { 1, 2, 3 };
+	int dest[] = { 10, 20, 30, 40, 50, 60 };
+	int expected[] = { 10, 21, 30, 42, 50, 63 };
+
+	RESOURCE_GUARD_START();
+	mixer_route(dest, 2, 1, src, 3);
+	fail_unless(!memcmp(dest, expected, sizeof(dest)),
+		    "Error: Bad routing to channel 1!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external mixer_interleave(): buses played on several channels
+ */
+START_TEST(test__mixer_interleave__buses) {
+	int click[] = { 1, 2, 3 };
+	int pulse[] = { 7, 0, 0 };
+	const int* routes[] = { click, click, pulse };
+	int dest[9];
+	int expected[] = { 1, 1, 7, 2, 2, 0, 3, 3, 0 };
+
+	RESOURCE_GUARD_START();
+	mixer_interleave(dest, routes, 3, 3);
+	fail_unless(!memcmp(dest, expected, sizeof(dest)),
+		    "Error: Bad interleaving!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Mixer");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_test(tc_extern, test__mixer_add__reference);
+	tcase_add_test(tc_extern, test__mixer_add__unity);
+	tcase_add_test(tc_extern, test__mixer_encode_s16_le__saturation);
+	tcase_add_test(tc_extern, test__mixer_encode_s32__byte_order);
+	tcase_add_test(tc_extern, test__mixer_encode_float__saturation);
+	tcase_add_test(tc_extern, test__mixer_resample__fixed_point);
+	tcase_add_test(tc_extern, test__mixer_route__channel);
+	tcase_add_test(tc_extern, test__mixer_interleave__buses);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
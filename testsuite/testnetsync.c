@@ -0,0 +1,166 @@
+/*
+ * testnetsync.c: Unit Tests for netsync.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "netsync.h"
+
+/* loopback, apart from the port of real instances */
+#define SPEC ",239.255.71.84:7172,127.0.0.1"
+
+#define RATE 44100
+#define LENGTH 0.1    /* seconds per tick */
+#define METER 4
+#define SKEW 12.345   /* leader clock ahead of followers */
+#define DURATION 2.0  /* seconds of test run */
+#define FOLLOWERS 3
+
+/*
+ * follower process: returns 0 if the leader's bars are predicted within
+ * 1 ms after DURATION, 1 otherwise
+ */
+static int follower(double origin) {
+	netsync_t* sync = netsync_new("follower" SPEC);
+	double start;
+	double bar;
+	double length;
+	double error;
+	int meter;
+
+	if (!sync)
+		return 1;
+	netsync_start(sync, RATE);
+	netsync_anchor(sync, 0, 0.0); /* frame 0 heard now */
+
+	start = netsync_time(sync);
+	while (netsync_time(sync) - start < DURATION) {
+		netsync_poll(sync);
+		usleep(1000);
+	}
+
+	if (!netsync_follow(sync, &bar, &length, &meter) ||
+	    meter != METER || fabs(length - LENGTH * RATE) > 0.01) {
+		fprintf(stderr, "Error: Leader not followed!\n");
+		return 1;
+	}
+	/* bar start in local time vs. leader's (in leader time - SKEW) */
+	error = fmod(sync->offset + bar / RATE - (origin - SKEW),
+		     METER * LENGTH);
+	if (error > METER * LENGTH / 2)
+		error -= METER * LENGTH;
+	if (error < -METER * LENGTH / 2)
+		error += METER * LENGTH;
+	netsync_delete(sync);
+
+	if (fabs(error) > 0.001) {
+		fprintf(stderr, "Error: Bar off by %f ms!\n", error * 1000);
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Test external netsync_follow(): several followers over loopback
+ */
+START_TEST(test__netsync_follow__loopback) {
+	netsync_t* leader = netsync_new("leader" SPEC);
+	pid_t pids[FOLLOWERS];
+	double start;
+	int tick = 0;
+	int status;
+	int i;
+
+	fail_unless(leader != NULL, "Error: Couldn't create leader!");
+	leader->skew = SKEW;
+	netsync_start(leader, RATE);
+	netsync_anchor(leader, 0, 0.0);
+
+	for (i = 0; i < FOLLOWERS; i++) {
+		pids[i] = fork();
+		fail_unless(pids[i] != -1, "Error: Couldn't fork!");
+		if (pids[i] == 0)
+			_exit(follower(leader->offset));
+	}
+
+	/* publish ticks, answer offset measurements */
+	start = netsync_time(leader);
+	while (netsync_time(leader) - start < DURATION + 0.5) {
+		if (leader->offset + tick * LENGTH <= netsync_time(leader)) {
+			netsync_publish(leader, llrint(tick * LENGTH * RATE),
+					LENGTH, METER, tick % METER);
+			tick++;
+		}
+		netsync_poll(leader);
+		usleep(500);
+	}
+	netsync_delete(leader);
+
+	for (i = 0; i < FOLLOWERS; i++) {
+		fail_unless(waitpid(pids[i], &status, 0) == pids[i] &&
+			    WIFEXITED(status) && WEXITSTATUS(status) == 0,
+			    "Error: Follower %d failed!", i);
+	}
+}
+END_TEST
+
+/*
+ * Test external netsync_new(): bad specifications
+ */
+START_TEST(test__netsync_new__bad_spec) {
+	fail_unless(netsync_new("boss") == NULL &&
+		    netsync_new("leader,10.0.0.1") == NULL &&
+		    netsync_new("follower,239.255.71.84:7172,no.where") == NULL,
+		    "Error: Bad specification accepted!");
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Netsync");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_set_timeout(tc_extern, 10);
+	tcase_add_test(tc_extern, test__netsync_follow__loopback);
+	tcase_add_test(tc_extern, test__netsync_new__bad_spec);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
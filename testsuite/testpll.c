@@ -0,0 +1,187 @@
+/*
+ * testpll.c: Unit Tests for pll.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "pll.h"
+
+/* MIDI clock at 120 BPM and 44100 Hz: 24 pulses per quarter */
+#define PERIOD_120 (44100 * 0.5 / 24)
+#define PERIOD_140 (44100 * 60.0 / 140 / 24)
+
+/* 1 ms at 44100 Hz */
+#define MS 44.1
+
+static pll_t* pll = NULL;
+static unsigned int seed;
+
+/* returns deterministic pseudo random jitter in [-amount, amount] */
+static double jitter(double amount) {
+	seed = seed * 1103515245 + 12345;
+	return amount * (((seed >> 8) & 0xFFFF) / 32767.5 - 1.0);
+}
+
+/*
+ * feeds <n> pulses of <period> from <*time> with <amount> of jitter,
+ * returns maximum deviation of the predicted pulse from the exact grid in
+ * the last half of the pulses
+ */
+static double feed(double* time, double period, int n, double amount) {
+	double result = 0.0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pll_input(pll, *time + jitter(amount));
+		if (i >= n / 2)
+			result = MAX(result, fabs(pll_predict(pll, pll->count + 1)
+						  - (*time + period)));
+		*time += period;
+	}
+	return result;
+}
+
+void setup_pll(void) {
+	pll = pll_new();
+	assert(pll != NULL);
+	seed = 4711;
+}
+
+void teardown_pll(void) {
+	pll_delete(pll);
+	pll = NULL;
+}
+
+/*
+ * Test external pll_input(): exact pulses
+ */
+START_TEST(test__pll_input__exact) {
+	double time = 1000.0;
+
+	RESOURCE_GUARD_START();
+	feed(&time, PERIOD_120, 10, 0.0);
+	fail_unless(epsilon_cmp(pll->period, PERIOD_120),
+			"Error: Period %f instead of %f!",
+			pll->period, PERIOD_120);
+	fail_unless(pll->count == 9, "Error: Bad pulse count!");
+	fail_unless(!pll_locked(pll), "Error: Locked too early!");
+	feed(&time, PERIOD_120, PLL_LOCK_PULSES, 0.0);
+	fail_unless(pll_locked(pll), "Error: Not locked!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external pll_input(): jitter is filtered and reported
+ */
+START_TEST(test__pll_input__jitter) {
+	double time = 0.0;
+	double deviation;
+
+	RESOURCE_GUARD_START();
+	deviation = feed(&time, PERIOD_120, 2000, 2 * MS);
+	fail_unless(pll_locked(pll), "Error: Not locked with 2 ms jitter!");
+	fail_unless(fabs(pll->period - PERIOD_120) < 0.1 * MS,
+			"Error: Period %f instead of %f!",
+			pll->period, PERIOD_120);
+	/* uniform jitter of +-2 ms has RMS 1.15 ms */
+	fail_unless(pll->jitter > 0.8 * MS && pll->jitter < 1.6 * MS,
+			"Error: Jitter %f ms reported!", pll->jitter / MS);
+	/* sub millisecond alignment from 4 ms peak to peak */
+	fail_unless(deviation < 1.0 * MS,
+			"Error: Prediction off by %f ms!", deviation / MS);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external pll_input(): tempo change of master
+ */
+START_TEST(test__pll_input__tempo_change) {
+	double time = 0.0;
+	double deviation;
+
+	RESOURCE_GUARD_START();
+	feed(&time, PERIOD_120, 500, 1 * MS);
+	deviation = feed(&time, PERIOD_140, 500, 1 * MS);
+	fail_unless(fabs(pll->period - PERIOD_140) < 0.1 * MS,
+			"Error: Period %f instead of %f!",
+			pll->period, PERIOD_140);
+	fail_unless(deviation < 0.5 * MS,
+			"Error: Prediction off by %f ms!", deviation / MS);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external pll_input(): missing pulses, dropout and renumbering
+ */
+START_TEST(test__pll_input__dropout) {
+	double time = 0.0;
+
+	RESOURCE_GUARD_START();
+	feed(&time, PERIOD_120, 100, 0.0);
+	time += PERIOD_120; /* one pulse lost */
+	pll_input(pll, time);
+	fail_unless(pll->count == 101 && pll_locked(pll),
+			"Error: Missing pulse not skipped!");
+	time += 10 * PERIOD_120;
+	pll_input(pll, time);
+	fail_unless(!pll_locked(pll) && pll->pulses == 1,
+			"Error: Lock kept after dropout!");
+	pll_renumber(pll, 0);
+	pll_input(pll, time + PERIOD_120);
+	fail_unless(pll->count == 0, "Error: Pulse not renumbered!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("PLL");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_pll, teardown_pll);
+	tcase_add_test(tc_extern, test__pll_input__exact);
+	tcase_add_test(tc_extern, test__pll_input__jitter);
+	tcase_add_test(tc_extern, test__pll_input__tempo_change);
+	tcase_add_test(tc_extern, test__pll_input__dropout);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,204 @@
+/*
+ * testsessions.c: Unit Tests for sessions.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <string.h>
+
+/* OSS headers */
+#include <sys/soundcard.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "sessions.h"
+
+#define RATE 48000
+#define CHANNELS 2
+#define MANY 16              /* sessions of workers test */
+#define WORKERS 4
+
+static comm_t* comm = NULL;
+
+/*
+ * starts session <session> at <bpm> in 4/4 with <subdivision> sub beats and
+ * <sound>, at the next fragment
+ */
+static void start_session(comm_t* session, double bpm, int subdivision,
+			  const char* sound) {
+	dsp_params_t* params = dsp_params_new();
+	double* volume = (double*) g_malloc(sizeof(double));
+
+	params->frequency = bpm / 60.0;
+	params->meter = 4;
+	params->accents[0] = DSP_BEAT_ACCENT;
+	params->subdivision = subdivision;
+	params->soundname = strdup(sound);
+	*volume = 0.5;
+	comm_client_query(session, MESSAGE_TYPE_SET_PARAMS, params);
+	comm_client_query(session, MESSAGE_TYPE_SET_VOLUME, volume);
+	comm_client_query(session, MESSAGE_TYPE_START_METRONOME, NULL);
+}
+
+/*
+ * returns 1 if <channel> of frames <from> ... <to> of <data> is silent,
+ * 0 otherwise
+ */
+static int silent(const short* data, int channel, int from, int to) {
+	int i;
+
+	for (i = from; i < to; i++) {
+		if (data[i * CHANNELS + channel])
+			return 0;
+	}
+	return 1;
+}
+
+/* returns 1 if all channels of <frames> of <data> are equal, 0 otherwise */
+static int same_channels(const short* data, int frames) {
+	int i;
+
+	for (i = 0; i < frames * CHANNELS; i++) {
+		if (data[i] != data[i - i % CHANNELS])
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * returns <frames> of output of <n> sessions with different tempos and
+ * sub beats, mixed on all channels and rendered with <workers>
+ */
+static short* render_many(int n, int workers, int frames) {
+	sessions_t* sessions = sessions_new(comm, CHANNELS, workers);
+	short* result = (short*) g_malloc(frames * CHANNELS * sizeof(short));
+	int i;
+
+	for (i = 0; i < n; i++)
+		start_session(sessions_add(sessions, i % 3 ? i % CHANNELS :
+					   SESSIONS_MIXED),
+			      60.0 + 13.0 * i, 1 + i % 4,
+			      i % 2 ? "<sine>" : "<default>");
+	assert(dsp_offline_start(sessions->device, RATE, CHANNELS,
+				 AFMT_S16_NE) == 0);
+	dsp_offline_render(sessions->device, result, frames);
+	dsp_offline_stop(sessions->device);
+	sessions_delete(sessions);
+
+	return result;
+}
+
+void setup_sessions(void) {
+	comm = comm_new();
+}
+
+void teardown_sessions(void) {
+	comm_delete(comm);
+	comm = NULL;
+}
+
+/*
+ * Test external sessions_add(): each session on its own channel, started
+ * independently
+ */
+START_TEST(test__sessions_add__routing) {
+	sessions_t* sessions = sessions_new(comm, CHANNELS, 0);
+	comm_t* left = sessions_add(sessions, 0);
+	comm_t* right = sessions_add(sessions, 1);
+	comm_t* both = sessions_add(sessions, SESSIONS_MIXED);
+	short data[RATE * CHANNELS];
+
+	fail_unless(dsp_offline_start(sessions->device, RATE, CHANNELS,
+				      AFMT_S16_NE) == 0,
+		    "Error: Couldn't start rendering!");
+
+	/* 120 BPM on the left only */
+	start_session(left, 120.0, 1, "<default>");
+	dsp_offline_render(sessions->device, data, RATE);
+	fail_unless(!silent(data, 0, 0, 100) &&
+		    silent(data, 0, RATE / 2 - 1000, RATE / 2) &&
+		    !silent(data, 0, RATE / 2, RATE / 2 + 100),
+		    "Error: Ticks of left session missing!");
+	fail_unless(silent(data, 1, 0, RATE),
+		    "Error: Stopped session on the right heard!");
+
+	/* 60 BPM on the right from the next fragment on */
+	start_session(right, 60.0, 1, "<sine>");
+	dsp_offline_render(sessions->device, data, RATE);
+	fail_unless(!silent(data, 1, 0, 100) && silent(data, 1, 1000, RATE),
+		    "Error: Right session not started!");
+
+	/* on both channels, without the others */
+	comm_client_query(left, MESSAGE_TYPE_STOP_METRONOME, NULL);
+	comm_client_query(right, MESSAGE_TYPE_STOP_METRONOME, NULL);
+	start_session(both, 30.0, 1, "<default>");
+	dsp_offline_render(sessions->device, data, RATE);
+	fail_unless(same_channels(data, RATE) && !silent(data, 0, 0, 100) &&
+		    silent(data, 0, 5000, RATE),
+		    "Error: Mixed session not on both channels!");
+
+	dsp_offline_stop(sessions->device);
+	sessions_delete(sessions);
+}
+END_TEST
+
+/*
+ * Test external sessions_new(): rendering by workers doesn't change the
+ * output
+ */
+START_TEST(test__sessions_new__workers) {
+	short* expected = render_many(MANY, 0, RATE * 4);
+	short* data = render_many(MANY, WORKERS, RATE * 4);
+
+	fail_unless(!silent(data, 0, 0, RATE * 4),
+		    "Error: Sessions not rendered!");
+	fail_unless(!memcmp(data, expected, RATE * 4 * CHANNELS * sizeof(short)),
+		    "Error: Output of workers differs!");
+	free(data);
+	free(expected);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Sessions");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_sessions, teardown_sessions);
+	tcase_add_test(tc_extern, test__sessions_add__routing);
+	tcase_add_test(tc_extern, test__sessions_new__workers);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
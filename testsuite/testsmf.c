@@ -0,0 +1,245 @@
+/*
+ * testsmf.c: Unit Tests for smf.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "timeline.h"
+#include "smf.h"
+
+static timeline_t* timeline = NULL;
+
+/* format 0, 480 ticks per quarter: 3/4 at 120 BPM, second bar at 60 BPM */
+static const unsigned char song_3_4[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+	'M', 'T', 'r', 'k', 0, 0, 0, 44,
+	0x00, 0xFF, 0x58, 0x04, 0x03, 0x02, 0x18, 0x08,
+	0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+	0x00, 0x90, 0x3C, 0x64,			/* note on */
+	0x83, 0x60, 0x3C, 0x00,			/* running status */
+	0x00, 0xC0, 0x05,			/* program change */
+	0x87, 0x40, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40,
+	0x00, 0xF0, 0x02, 0x7E, 0xF7,		/* SysEx */
+	0x8B, 0x20, 0xFF, 0x2F, 0x00
+};
+
+/*
+ * format 1, 96 ticks per quarter: tempo change in the middle of the first
+ * beat (track 0), song length of 1 bar 4/4 from track 1
+ */
+static const unsigned char song_mid_beat[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0x00, 0x60,
+	'M', 'T', 'r', 'k', 0, 0, 0, 18,
+	0x00, 0xFF, 0x51, 0x03, 0x09, 0x27, 0xC0,
+	0x30, 0xFF, 0x51, 0x03, 0x04, 0x93, 0xE0,
+	0x00, 0xFF, 0x2F, 0x00,
+	'X', 'y', 'z', 'w', 0, 0, 0, 2, 0x12, 0x34,	/* unknown chunk */
+	'M', 'T', 'r', 'k', 0, 0, 0, 13,
+	0x00, 0x90, 0x3C, 0x64,
+	0x83, 0x00, 0x80, 0x3C, 0x00,
+	0x00, 0xFF, 0x2F, 0x00
+};
+
+/* format 0, 480 ticks per quarter: 8 eighths in 6/8 */
+static const unsigned char song_6_8[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+	'M', 'T', 'r', 'k', 0, 0, 0, 13,
+	0x00, 0xFF, 0x58, 0x04, 0x06, 0x03, 0x0C, 0x08,
+	0x8F, 0x00, 0xFF, 0x2F, 0x00
+};
+
+/* time signature with a bogus denominator byte (2^48) */
+static const unsigned char song_bad_unit[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+	'M', 'T', 'r', 'k', 0, 0, 0, 13,
+	0x00, 0xFF, 0x58, 0x04, 0x06, 0x30, 0x0C, 0x08,
+	0x8F, 0x00, 0xFF, 0x2F, 0x00
+};
+
+/* time signature of 6/64: shorter ticks than TIMELINE_MAX_UNIT */
+static const unsigned char song_short_unit[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+	'M', 'T', 'r', 'k', 0, 0, 0, 13,
+	0x00, 0xFF, 0x58, 0x04, 0x06, 0x06, 0x0C, 0x08,
+	0x8F, 0x00, 0xFF, 0x2F, 0x00
+};
+
+/* SMPTE time division */
+static const unsigned char song_smpte[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0xE7, 0x28,
+	'M', 'T', 'r', 'k', 0, 0, 0, 4, 0x00, 0xFF, 0x2F, 0x00
+};
+
+/* truncated inside of a meta event */
+static const unsigned char song_truncated[] = {
+	'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0,
+	'M', 'T', 'r', 'k', 0, 0, 0, 8, 0x00, 0xFF, 0x51, 0x03, 0x07
+};
+
+/* returns result of smf_read() on a temporary file with <size> bytes <data> */
+static int read_song(const unsigned char* data, size_t size) {
+	FILE* fp = tmpfile();
+	int result;
+
+	assert(fp != NULL);
+	fwrite(data, 1, size, fp);
+	rewind(fp);
+	result = smf_read(fp, timeline);
+	fclose(fp);
+	return result;
+}
+
+/* voice stub */
+static int voice(void* object __attribute((unused)),
+		 const timeline_section_t* section __attribute((unused)),
+		 int beat __attribute((unused))) {
+	return 1;
+}
+
+void setup_smf(void) {
+	timeline = timeline_new();
+	assert(timeline != NULL);
+}
+
+void teardown_smf(void) {
+	timeline_delete(timeline);
+	timeline = NULL;
+}
+
+/*
+ * Test external smf_read(): tempo change at bar line, skipped events
+ */
+START_TEST(test__smf_read__tempo) {
+	static const long long frames[] = {0, 24000, 48000, 72000, 120000, 168000};
+	int i;
+
+	RESOURCE_GUARD_START();
+	fail_unless(read_song(song_3_4, sizeof(song_3_4)) == 0,
+			"Error: MIDI file not accepted!");
+	fail_unless(timeline->n_sections == 1 &&
+			timeline->sections[0].meter == 3 &&
+			timeline->sections[0].bars == 2,
+			"Error: Bad time signature!");
+	timeline_compile(timeline, 48000, voice, NULL);
+	fail_unless(timeline->n_events == 6,
+			"Error: %d events instead of 6!", timeline->n_events);
+	for (i = 0; i < 6; i++)
+		fail_unless(timeline->events[i].frame == frames[i],
+				"Error: Tick %d at frame %lld instead of %lld!",
+				i, timeline->events[i].frame, frames[i]);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external smf_read(): tempo change within a beat, tempo map and song
+ * length in different tracks
+ */
+START_TEST(test__smf_read__mid_beat) {
+	static const long long frames[] = {0, 450, 750, 1050};
+	int i;
+
+	RESOURCE_GUARD_START();
+	fail_unless(read_song(song_mid_beat, sizeof(song_mid_beat)) == 0,
+			"Error: MIDI file not accepted!");
+	timeline_compile(timeline, 1000, voice, NULL);
+	fail_unless(timeline->n_events == 4,
+			"Error: %d events instead of 4!", timeline->n_events);
+	/* 48 ticks at 0.6 s and 48 ticks at 0.3 s per 96 ticks */
+	for (i = 0; i < 4; i++)
+		fail_unless(timeline->events[i].frame == frames[i],
+				"Error: Tick %d at frame %lld instead of %lld!",
+				i, timeline->events[i].frame, frames[i]);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external smf_read(): beat of time signature, incomplete last bar
+ */
+START_TEST(test__smf_read__partial_bar) {
+	RESOURCE_GUARD_START();
+	fail_unless(read_song(song_6_8, sizeof(song_6_8)) == 0,
+			"Error: MIDI file not accepted!");
+	fail_unless(timeline->n_sections == 2 &&
+			timeline->sections[0].meter == 6 &&
+			timeline->sections[1].meter == 2,
+			"Error: Bad sections!");
+	fail_unless(timeline->sections[0].unit == 8 &&
+			timeline->sections[1].unit == 8,
+			"Error: Ticks not eighths!");
+	fail_unless(epsilon_cmp(timeline->sections[0].durations[0], 0.25),
+			"Error: Bad duration of eighth!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external smf_read(): unsupported and broken files
+ */
+START_TEST(test__smf_read__bad) {
+	RESOURCE_GUARD_START();
+	fail_unless(read_song(song_smpte, sizeof(song_smpte)) == -1,
+			"Error expected for SMPTE time division");
+	fail_unless(read_song(song_truncated, sizeof(song_truncated)) == -1,
+			"Error expected for truncated file");
+	fail_unless(read_song(song_bad_unit, sizeof(song_bad_unit)) == -1,
+			"Error expected for bogus denominator");
+	fail_unless(read_song(song_short_unit, sizeof(song_short_unit)) == -1,
+			"Error expected for 64th notes");
+	fail_unless(read_song((const unsigned char*) "RIFF", 4) == -1,
+			"Error expected for other file type");
+	fail_unless(timeline->n_sections == 0, "Error: Sections added!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Standard MIDI File");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_smf, teardown_smf);
+	tcase_add_test(tc_extern, test__smf_read__tempo);
+	tcase_add_test(tc_extern, test__smf_read__mid_beat);
+	tcase_add_test(tc_extern, test__smf_read__partial_bar);
+	tcase_add_test(tc_extern, test__smf_read__bad);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
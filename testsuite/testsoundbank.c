@@ -0,0 +1,212 @@
+/*
+ * testsoundbank.c: Unit Tests for soundbank.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "soundbank.h"
+
+static soundbank_t* bank = NULL;
+static int prepare_count;
+
+static const short table[4] = { 1, 2, 3, 4 };
+
+/*
+ * voice preparation stub: 4 frames per voice, "<missing>" isn't available,
+ * "<table>" is read-only data
+ */
+static int prepare(void* object __attribute((unused)), const char* name,
+		   voice_variant_t variant, const short** data, int* shared) {
+	short* result;
+	int i;
+
+	if (!strcmp(name, "<missing>"))
+		return -1;
+
+	prepare_count++;
+	if (!strcmp(name, "<table>")) {
+		*data = table;
+		*shared = 1;
+		return 4;
+	}
+	result = (short*)g_malloc(4 * sizeof(short));
+	for (i = 0; i < 4; i++)
+		result[i] = variant;
+	*data = result;
+	*shared = 0;
+	return 4;
+}
+
+void setup_soundbank(void) {
+	prepare_count = 0;
+	bank = soundbank_new(prepare, NULL);
+	assert(bank != NULL);
+}
+
+void teardown_soundbank(void) {
+	soundbank_delete(bank);
+	bank = NULL;
+}
+
+/*
+ * Test external soundbank_acquire(): same sound and variant is shared
+ */
+START_TEST(test__soundbank_acquire__shared) {
+	int a, b, c;
+
+	RESOURCE_GUARD_START();
+	a = soundbank_acquire(bank, "<default>", VOICE_VARIANT_ACCENT);
+	b = soundbank_acquire(bank, "<default>", VOICE_VARIANT_ACCENT);
+	c = soundbank_acquire(bank, "<default>", VOICE_VARIANT_SECONDARY);
+	fail_unless(a != SOUNDBANK_SILENCE && a == b,
+			"Error: Voice not shared (%d, %d)!", a, b);
+	fail_unless(c != a, "Error: Variants not distinguished!");
+	fail_unless(prepare_count == 2,
+			"Error: %d preparations for 2 voices!", prepare_count);
+	fail_unless(bank->voices[a].refcount == 2,
+			"Error: Bad reference count (%d)!", bank->voices[a].refcount);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external soundbank_release(): slots are freed and reused
+ */
+START_TEST(test__soundbank_release__reuse) {
+	int a, b;
+
+	RESOURCE_GUARD_START();
+	a = soundbank_acquire(bank, "a.wav", VOICE_VARIANT_NORMAL);
+	b = soundbank_acquire(bank, "b.wav", VOICE_VARIANT_NORMAL);
+	soundbank_release(bank, a);
+	fail_unless(bank->voices[a].name == NULL && bank->voices[a].data == NULL,
+			"Error: Unused voice not freed!");
+	fail_unless(soundbank_acquire(bank, "c.wav", VOICE_VARIANT_NORMAL) == a,
+			"Error: Free slot not reused!");
+	soundbank_release(bank, a);
+	soundbank_release(bank, b);
+	fail_unless(bank->n_voices == 1,
+			"Error: %d slots left in empty bank!", bank->n_voices);
+	soundbank_release(bank, SOUNDBANK_SILENCE);
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external soundbank_acquire(): unavailable sound
+ */
+START_TEST(test__soundbank_acquire__missing) {
+	RESOURCE_GUARD_START();
+	fail_unless(soundbank_acquire(bank, "<missing>",
+				      VOICE_VARIANT_NORMAL) == -1,
+			"Error expected for unavailable sound");
+	fail_unless(bank->n_voices == 1, "Error: Slot used by failed voice!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external soundbank_release(): read-only data isn't freed
+ */
+START_TEST(test__soundbank_release__table) {
+	int a;
+
+	RESOURCE_GUARD_START();
+	a = soundbank_acquire(bank, "<table>", VOICE_VARIANT_NORMAL);
+	fail_unless(a != -1 && bank->voices[a].data == table &&
+		    bank->voices[a].shared,
+			"Error: Table not used!");
+	soundbank_release(bank, a);
+	fail_unless(bank->voices[a].data == NULL && table[3] == 4,
+			"Error: Table voice not released!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external soundbank_render_variant(): resampled to device rate,
+ * accents pitched up, secondary ticks at half amplitude
+ */
+START_TEST(test__soundbank_render_variant__rates) {
+	short frames[441];
+	short* normal;
+	short* accent;
+	short* secondary;
+	int i;
+
+	for (i = 0; i < 441; i++)
+		frames[i] = i < 220 ? SHRT_MAX : 1000;
+
+	fail_unless(soundbank_render_variant(frames, 441, 44100, 1,
+					     VOICE_VARIANT_NORMAL, 48000,
+					     &normal, 0, 0) == 480,
+			"Error: Bad length at 48 kHz!");
+	fail_unless(soundbank_render_variant(frames, 441, 44100, 1,
+					     VOICE_VARIANT_ACCENT, 48000,
+					     &accent, 0, 0) == 240,
+			"Error: Accent not pitched up!");
+	fail_unless(soundbank_render_variant(frames, 441, 44100, 1,
+					     VOICE_VARIANT_SECONDARY, 48000,
+					     &secondary, 0, 0) == 480,
+			"Error: Bad length of secondary tick!");
+	fail_unless(normal[0] == SHRT_MAX && normal[479] == 1000 &&
+		    accent[0] == SHRT_MAX && accent[239] == 1000 &&
+		    secondary[0] == SHRT_MAX / 2 && secondary[479] == 500,
+			"Error: Bad frames!");
+	free(normal);
+	free(accent);
+	free(secondary);
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Sound Bank");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_soundbank, teardown_soundbank);
+	tcase_add_test(tc_extern, test__soundbank_acquire__shared);
+	tcase_add_test(tc_extern, test__soundbank_release__reuse);
+	tcase_add_test(tc_extern, test__soundbank_acquire__missing);
+	tcase_add_test(tc_extern, test__soundbank_release__table);
+	tcase_add_test(tc_extern, test__soundbank_render_variant__rates);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,216 @@
+/*
+ * testsynth.c: Unit Tests for synth.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "synth.h"
+#include "mixer.h"
+
+#define RATE 48000
+/* largest difference of fixed point from floating point, -54 dB */
+#define FIXED_POINT_TOLERANCE (SHRT_MAX / 512)
+
+/*
+ * returns peak level of <frames> frames at <data>
+ */
+static int peak(const short* data, int frames) {
+	int result = 0;
+	int i;
+
+	for (i = 0; i < frames; i++)
+		result = MAX(result, abs(data[i]));
+	return result;
+}
+
+/*
+ * Test external synth_parse(): models, parameters and their units
+ */
+START_TEST(test__synth_parse__names) {
+	synth_params_t params;
+
+	fail_unless(synth_parse(&params, "<sine>") == 0 &&
+		    params.model == SYNTH_SINE && params.freq == 880.0 &&
+		    params.length == 0.010,
+			"Error: Bad default sine!");
+	fail_unless(synth_parse(&params,
+				"<wood freq=1500 decay=25 gain=0.5>") == 0 &&
+		    params.model == SYNTH_WOOD && params.freq == 1500.0 &&
+		    params.decay == 0.025 && params.gain == 0.5,
+			"Error: Bad wood block!");
+	fail_unless(synth_parse(&params, "<fm ratio=3.5 index=8>") == 0 &&
+		    params.model == SYNTH_FM && params.ratio == 3.5 &&
+		    params.index == 8.0 && params.freq == 1000.0,
+			"Error: Bad FM!");
+
+	fail_unless(synth_parse(&params, "<default>") == -1 &&
+		    synth_parse(&params, "<pulse>") == -1 &&
+		    synth_parse(&params, "sine") == -1 &&
+		    synth_parse(&params, "<>") == -1 &&
+		    synth_parse(&params, "<noise q>") == -1 &&
+		    synth_parse(&params, "<noise q=0>") == -1 &&
+		    synth_parse(&params, "<noise freq=1k>") == -1 &&
+		    synth_parse(&params, "<sine pitch=440>") == -1,
+			"Error: Bad sound accepted!");
+}
+END_TEST
+
+/*
+ * Test external synth_render(): sine at device rate, exact length, full
+ * level and the number of periods expected
+ */
+START_TEST(test__synth_render__sine) {
+	synth_params_t params;
+	short* data;
+	int crossings = 0;
+	int frames;
+	int i;
+
+	fail_unless(synth_parse(&params, "<sine freq=1000 length=20>") == 0,
+			"Error: Sine not parsed!");
+	frames = synth_render(&params, RATE, &data, MIXER_FIXED_POINT);
+	fail_unless(frames == RATE / 50, "Error: Bad length %d!", frames);
+	fail_unless(peak(data, frames) == SHRT_MAX, "Error: Bad level!");
+	for (i = 1; i < frames; i++) {
+		if (data[i - 1] < 0 && data[i] >= 0)
+			crossings++;
+	}
+	fail_unless(crossings >= 19 && crossings <= 20,
+			"Error: Bad frequency: %d periods!", crossings);
+	free(data);
+}
+END_TEST
+
+/*
+ * Test external synth_render(): all models sound and decay
+ */
+START_TEST(test__synth_render__decay) {
+	const char* names[] = { "<fm>", "<noise>", "<wood>", "<wood freq=9000>" };
+	unsigned int n;
+
+	for (n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+		synth_params_t params;
+		short* data;
+		int frames;
+		int quarter;
+
+		fail_unless(synth_parse(&params, names[n]) == 0,
+				"Error: %s not parsed!", names[n]);
+		frames = synth_render(&params, RATE, &data, MIXER_FIXED_POINT);
+		quarter = frames / 4;
+		fail_unless(frames > 0 && peak(data, quarter) == SHRT_MAX &&
+			    peak(data + frames - quarter, quarter) < SHRT_MAX / 10,
+				"Error: %s doesn't decay!", names[n]);
+		free(data);
+	}
+}
+END_TEST
+
+/*
+ * Test external synth_render(): fixed point within FIXED_POINT_TOLERANCE of
+ * floating point for all models, including steep filters and FM
+ */
+START_TEST(test__synth_render__fixed_point) {
+	const char* names[] = { "<sine>", "<sine freq=15000 length=500>",
+				"<fm>", "<fm ratio=3.5 index=8>", "<noise>",
+				"<noise freq=200 q=50>", "<wood>",
+				"<wood freq=9000 decay=1>" };
+	unsigned int n;
+
+	for (n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+		synth_params_t params;
+		short* reference;
+		short* fixed;
+		int frames;
+		int i;
+
+		fail_unless(synth_parse(&params, names[n]) == 0,
+				"Error: %s not parsed!", names[n]);
+		frames = synth_render(&params, RATE, &reference, 0);
+		fail_unless(synth_render(&params, RATE, &fixed, 1) == frames,
+				"Error: Bad length of fixed point %s!", names[n]);
+		for (i = 0; i < frames &&
+		     abs(fixed[i] - reference[i]) <= FIXED_POINT_TOLERANCE; i++);
+		fail_unless(i == frames,
+				"Error: %s at frame %d: %d instead of %d!",
+				names[n], i, fixed[i], reference[i]);
+		free(reference);
+		free(fixed);
+	}
+}
+END_TEST
+
+/*
+ * Test external synth_render(): fixed point output is the same on every
+ * architecture
+ */
+START_TEST(test__synth_render__fixed_point_stable) {
+	const char* names[] = { "<sine>", "<fm>", "<noise>", "<wood>" };
+	guint32 expected[] = { 0x93ed7099, 0xd5648d4f, 0xe23f03b7, 0x2bd584e3 };
+	unsigned int n;
+
+	for (n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+		synth_params_t params;
+		short* data;
+		guint32 hash = 0;
+		int frames;
+		int i;
+
+		synth_parse(&params, names[n]);
+		frames = synth_render(&params, RATE, &data, 1);
+		for (i = 0; i < frames; i++)
+			hash = hash * 31 + (unsigned short) data[i];
+		fail_unless(hash == expected[n],
+				"Error: %s rendered as %08x instead of %08x!",
+				names[n], hash, expected[n]);
+		free(data);
+	}
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Synth");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_test(tc_extern, test__synth_parse__names);
+	tcase_add_test(tc_extern, test__synth_render__sine);
+	tcase_add_test(tc_extern, test__synth_render__decay);
+	tcase_add_test(tc_extern, test__synth_render__fixed_point);
+	tcase_add_test(tc_extern, test__synth_render__fixed_point_stable);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}
@@ -0,0 +1,232 @@
+/*
+ * testtimeline.c: Unit Tests for timeline.c
+ *
+ * This file is part of GTick
+ *
+ *
+ * Copyright (c) 2008 Roland Stigge <stigge@antcom.de>
+ *
+ * GTick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GTick is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GTick; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <glib.h>
+
+/* Unit Test common code */
+#include "common.h"
+
+/* Include from code under test */
+#include "dsp.h"
+#include "timeline.h"
+
+static timeline_t* timeline = NULL;
+
+/* voice stub: accentuated ticks get voice 2, others voice 1, "<missing>" -1 */
+static int voice(void* object __attribute((unused)),
+		 const timeline_section_t* section, int beat) {
+	if (section->soundname && !strcmp(section->soundname, "<missing>"))
+		return -1;
+	return section->accents[beat] == DSP_BEAT_ACCENT ? 2 : 1;
+}
+
+void setup_timeline(void) {
+	timeline = timeline_new();
+	assert(timeline != NULL);
+}
+
+void teardown_timeline(void) {
+	timeline_delete(timeline);
+	timeline = NULL;
+}
+
+/*
+ * Test external timeline_add_section(): fields are inherited
+ */
+START_TEST(test__timeline_add_section__inherit) {
+	RESOURCE_GUARD_START();
+	fail_unless(timeline_add_section(timeline,
+				"name=Intro bars=2 meter=3 bpm=90 accents=1-0")
+			== 0, "Error: Section not accepted!");
+	fail_unless(timeline_add_section(timeline, "# comment") == 0 &&
+			timeline_add_section(timeline, "  \n") == 0,
+			"Error: Comment not accepted!");
+	fail_unless(timeline_add_section(timeline, "bpm=120 volume=50") == 0,
+			"Error: Section not accepted!");
+	fail_unless(timeline->n_sections == 2,
+			"Error: %d sections instead of 2!", timeline->n_sections);
+	fail_unless(timeline->sections[1].meter == 3 &&
+			timeline->sections[1].bars == 2 &&
+			timeline->sections[1].accents[1] == DSP_BEAT_OFF,
+			"Error: Fields not inherited!");
+	fail_unless(timeline->sections[1].name == NULL,
+			"Error: Name inherited!");
+	fail_unless(epsilon_cmp(timeline->sections[1].gain, 0.5),
+			"Error: Bad volume!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_add_section(): bad fields
+ */
+START_TEST(test__timeline_add_section__bad) {
+	RESOURCE_GUARD_START();
+	fail_unless(timeline_add_section(timeline, "bars=0") == -1,
+			"Error expected for zero bars");
+	fail_unless(timeline_add_section(timeline, "tempo=120") == -1,
+			"Error expected for unknown key");
+	fail_unless(timeline_add_section(timeline, "meter") == -1,
+			"Error expected for missing value");
+	fail_unless(timeline_add_section(timeline, "meter=6/6") == -1 &&
+			timeline_add_section(timeline, "meter=3/64") == -1,
+			"Error expected for bad note value");
+	fail_unless(timeline->n_sections == 0,
+			"Error: Bad section added!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_bar_sixteenths(): song position in the note value
+ * of each section
+ */
+START_TEST(test__timeline_bar_sixteenths__units) {
+	RESOURCE_GUARD_START();
+	fail_unless(timeline_add_section(timeline, "bars=2 meter=6/8") == 0 &&
+			timeline_add_section(timeline, "bars=2 meter=4") == 0 &&
+			timeline_add_section(timeline, "bars=1 meter=3/2") == 0,
+			"Error: Sections not accepted!");
+	fail_unless(timeline->sections[0].unit == 8 &&
+			timeline->sections[1].unit == 4,
+			"Error: Bad note values!");
+	fail_unless(timeline_compile(timeline, 44100, voice, NULL) == 0,
+			"Error: Compilation failed!");
+	fail_unless(timeline_bar_sixteenths(timeline, 0) == 0 &&
+			timeline_bar_sixteenths(timeline, 1) == 12 &&
+			timeline_bar_sixteenths(timeline, 3) == 40 &&
+			timeline_bar_sixteenths(timeline, 4) == 56 &&
+			timeline_bar_sixteenths(timeline, 5) == -1,
+			"Error: Bad song positions!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_compile(): event frames and voices
+ */
+START_TEST(test__timeline_compile__frames) {
+	RESOURCE_GUARD_START();
+	timeline_add_section(timeline, "bars=2 meter=2 bpm=60 accents=10");
+	timeline_add_section(timeline, "bars=1 meter=3 bpm=120 accents=100");
+	fail_unless(timeline_compile(timeline, 44100, voice, NULL) == 0,
+			"Error: Compilation failed!");
+	fail_unless(timeline->n_events == 7,
+			"Error: %d events instead of 7!", timeline->n_events);
+	fail_unless(timeline->events[3].frame == 3 * 44100 &&
+			timeline->events[4].frame == 4 * 44100 &&
+			timeline->events[6].frame == 5 * 44100,
+			"Error: Bad event frames!");
+	fail_unless(timeline->events[4].voice == 2 &&
+			timeline->events[5].voice == 1 &&
+			timeline->events[5].beat == 1 &&
+			timeline->events[5].section == 1,
+			"Error: Bad event voices!");
+	fail_unless(timeline->n_bars == 3 &&
+			timeline_bar_frame(timeline, 2) == 4 * 44100 &&
+			timeline_bar_frame(timeline, 3) == -1,
+			"Error: Bad bar index!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_compile(): ramps don't drift
+ */
+START_TEST(test__timeline_compile__ramp) {
+	double time = 0.0;
+	int n;
+
+	RESOURCE_GUARD_START();
+	timeline_add_section(timeline,
+			"bars=100 meter=4 bpm=60 ramp=180 shape=exponential");
+	timeline_compile(timeline, 48000, voice, NULL);
+	for (n = 0; n < 400; n++) {
+		fail_unless(timeline->events[n].frame == llrint(time),
+				"Error: Event %d at %lld instead of %.0f!",
+				n, timeline->events[n].frame, time);
+		time += 48000 * 60.0 / (60.0 * pow(3.0, n / 400.0));
+	}
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_compile(): unavailable sound
+ */
+START_TEST(test__timeline_compile__missing) {
+	RESOURCE_GUARD_START();
+	timeline_add_section(timeline, "sound=<missing>");
+	fail_unless(timeline_compile(timeline, 44100, voice, NULL) == -1,
+			"Error expected for unavailable sound");
+	fail_unless(timeline->events[0].voice == 0,
+			"Error: Unavailable sound not silent!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+/*
+ * Test external timeline_find()
+ */
+START_TEST(test__timeline_find) {
+	RESOURCE_GUARD_START();
+	timeline_add_section(timeline, "bars=4 meter=4 bpm=60");
+	timeline_compile(timeline, 1000, voice, NULL);
+	fail_unless(timeline_find(timeline, 0) == 0, "Error: Bad event!");
+	fail_unless(timeline_find(timeline, 1) == 1, "Error: Bad event!");
+	fail_unless(timeline_find(timeline, 5000) == 5, "Error: Bad event!");
+	fail_unless(timeline_find(timeline, 15001) == 16,
+			"Error: Event after end!");
+	RESOURCE_GUARD_END();
+}
+END_TEST
+
+Suite *test_suite(void) {
+	Suite *s = suite_create("Timeline");
+	TCase *tc_extern = tcase_create("Extern Functions");
+
+	tcase_add_checked_fixture(tc_extern, setup_timeline, teardown_timeline);
+	tcase_add_test(tc_extern, test__timeline_add_section__inherit);
+	tcase_add_test(tc_extern, test__timeline_add_section__bad);
+	tcase_add_test(tc_extern, test__timeline_compile__frames);
+	tcase_add_test(tc_extern, test__timeline_compile__ramp);
+	tcase_add_test(tc_extern, test__timeline_compile__missing);
+	tcase_add_test(tc_extern, test__timeline_find);
+	tcase_add_test(tc_extern, test__timeline_bar_sixteenths__units);
+	suite_add_tcase(s, tc_extern);
+
+	return s;
+}
+
+int main(int argc __attribute((unused)), char* argv[] __attribute((unused))) {
+	return test_suite_run(test_suite());
+}